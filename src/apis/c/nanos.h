@@ -115,6 +115,8 @@
  *   - 5025: Changed WD priority from unsigned to int.
  *   - 5029: Adding implicit parameter to work descriptor flags.
  *   - 5030: Adding instrumentation support to wrap main function.
+ *   - 5031: Adding nanos_submit_batch service.
+ *   - 5032: Adding nanos_get_num_prefetched_tasks service.
  * - nanos interface family: worksharing
  *   - 1000: First implementation of work-sharing services (create and next-item)
  * - nanos interface family: deps_api
@@ -213,6 +215,7 @@ NANOS_API_DECL(nanos_err_t, nanos_create_sliced_wd, ( nanos_wd_t *uwd, size_t nu
                                      nanos_wd_props_t *props, nanos_wd_dyn_props_t *dyn_props, size_t num_copies, nanos_copy_data_t **copies, size_t num_dimensions, nanos_region_dimension_internal_t **dimensions ));
 
 NANOS_API_DECL(nanos_err_t, nanos_submit, ( nanos_wd_t wd, size_t num_data_accesses, nanos_data_access_t *data_accesses, nanos_team_t team ));
+NANOS_API_DECL(nanos_err_t, nanos_submit_batch, ( size_t num_wds, nanos_wd_t *wds, size_t *num_data_accesses, nanos_data_access_t **data_accesses, nanos_team_t team ));
 
 NANOS_API_DECL(nanos_err_t, nanos_create_wd_and_run_compact, ( nanos_const_wd_definition_t *const_data, nanos_wd_dyn_props_t *dyn_props,
                                                                size_t data_size, void * data, size_t num_data_accesses, nanos_data_access_t *data_accesses,
@@ -231,6 +234,7 @@ NANOS_API_DECL(nanos_err_t, nanos_get_num_total_tasks, ( unsigned int *total_tas
 NANOS_API_DECL(nanos_err_t, nanos_get_num_nonready_tasks, ( unsigned int *nonready_tasks ));
 NANOS_API_DECL(nanos_err_t, nanos_get_num_running_tasks, ( unsigned int *running_tasks ));
 NANOS_API_DECL(nanos_err_t, nanos_get_num_blocked_tasks, ( unsigned int *blocked_tasks ));
+NANOS_API_DECL(nanos_err_t, nanos_get_num_prefetched_tasks, ( unsigned int *prefetched_tasks ));
 
 NANOS_API_DECL(nanos_err_t, nanos_in_final, ( bool *result ));
 NANOS_API_DECL(nanos_err_t, nanos_set_final, ( bool value ));
@@ -21,6 +21,45 @@
  *  \brief 
  */
 #include "nanos_reduction.h"
+#include "bulkreducer_decl.hpp"
+
+using namespace nanos;
+
+#define NANOS_REDUCTION_ARRAY_DEF(Op,BulkOp,Type,BulkType) \
+   void nanos_reduction_bop_array_##Op##_##Type ( void *arg1, void *arg2, int n) \
+   { \
+      static bulk_reducer_t bulk = BulkReducer::get( BulkReducer::BulkOp, BulkReducer::BulkType ); \
+      bulk( arg1, arg2, n ); \
+   }
+
+#define NANOS_REDUCTION_ARRAY_INT_TYPES_DEF(Op,BulkOp) \
+   NANOS_REDUCTION_ARRAY_DEF(Op,BulkOp,int,INT) \
+   NANOS_REDUCTION_ARRAY_DEF(Op,BulkOp,uint,UINT) \
+   NANOS_REDUCTION_ARRAY_DEF(Op,BulkOp,long,LONG) \
+   NANOS_REDUCTION_ARRAY_DEF(Op,BulkOp,ulong,ULONG) \
+   NANOS_REDUCTION_ARRAY_DEF(Op,BulkOp,longlong,LONGLONG) \
+   NANOS_REDUCTION_ARRAY_DEF(Op,BulkOp,ulonglong,ULONGLONG)
+
+#define NANOS_REDUCTION_ARRAY_REAL_TYPES_DEF(Op,BulkOp) \
+   NANOS_REDUCTION_ARRAY_DEF(Op,BulkOp,float,FLOAT) \
+   NANOS_REDUCTION_ARRAY_DEF(Op,BulkOp,double,DOUBLE)
+
+//! Both the scalar and the array built-in reducers are mapped to the same bulk loop
+#define NANOS_REDUCTION_BULK_REGISTER(Op,BulkOp,Type,BulkType) \
+   BulkReducer::registerReducer( ( const void * ) &nanos_reduction_bop_##Op##_##Type, BulkReducer::BulkOp, BulkReducer::BulkType ); \
+   BulkReducer::registerReducer( ( const void * ) &nanos_reduction_bop_array_##Op##_##Type, BulkReducer::BulkOp, BulkReducer::BulkType );
+
+#define NANOS_REDUCTION_BULK_INT_TYPES_REGISTER(Op,BulkOp) \
+   NANOS_REDUCTION_BULK_REGISTER(Op,BulkOp,int,INT) \
+   NANOS_REDUCTION_BULK_REGISTER(Op,BulkOp,uint,UINT) \
+   NANOS_REDUCTION_BULK_REGISTER(Op,BulkOp,long,LONG) \
+   NANOS_REDUCTION_BULK_REGISTER(Op,BulkOp,ulong,ULONG) \
+   NANOS_REDUCTION_BULK_REGISTER(Op,BulkOp,longlong,LONGLONG) \
+   NANOS_REDUCTION_BULK_REGISTER(Op,BulkOp,ulonglong,ULONGLONG)
+
+#define NANOS_REDUCTION_BULK_REAL_TYPES_REGISTER(Op,BulkOp) \
+   NANOS_REDUCTION_BULK_REGISTER(Op,BulkOp,float,FLOAT) \
+   NANOS_REDUCTION_BULK_REGISTER(Op,BulkOp,double,DOUBLE)
 
 NANOS_REDUCTION_INT_TYPES_DEF(add,NANOS_REDUCTION_OP_ADD)
 NANOS_REDUCTION_REAL_TYPES_DEF(add,NANOS_REDUCTION_OP_ADD)
@@ -54,6 +93,50 @@ NANOS_REDUCTION_REAL_TYPES_DEF(max,NANOS_REDUCTION_OP_MAX)
 NANOS_REDUCTION_INT_TYPES_DEF(min,NANOS_REDUCTION_OP_MIN)
 NANOS_REDUCTION_REAL_TYPES_DEF(min,NANOS_REDUCTION_OP_MIN)
 
+NANOS_REDUCTION_ARRAY_INT_TYPES_DEF(add,ADD)
+NANOS_REDUCTION_ARRAY_REAL_TYPES_DEF(add,ADD)
+
+NANOS_REDUCTION_ARRAY_INT_TYPES_DEF(prod,PROD)
+NANOS_REDUCTION_ARRAY_REAL_TYPES_DEF(prod,PROD)
+
+NANOS_REDUCTION_ARRAY_INT_TYPES_DEF(and,AND)
+
+NANOS_REDUCTION_ARRAY_INT_TYPES_DEF(or,OR)
+
+NANOS_REDUCTION_ARRAY_INT_TYPES_DEF(xor,XOR)
+
+NANOS_REDUCTION_ARRAY_INT_TYPES_DEF(max,MAX)
+NANOS_REDUCTION_ARRAY_REAL_TYPES_DEF(max,MAX)
+
+NANOS_REDUCTION_ARRAY_INT_TYPES_DEF(min,MIN)
+NANOS_REDUCTION_ARRAY_REAL_TYPES_DEF(min,MIN)
+
+namespace {
+   //! \brief Registers the built-in reducers with their bulk loops when the library is loaded
+   struct BuiltinBulkReducers {
+      BuiltinBulkReducers ()
+      {
+         NANOS_REDUCTION_BULK_INT_TYPES_REGISTER(add,ADD)
+         NANOS_REDUCTION_BULK_REAL_TYPES_REGISTER(add,ADD)
+
+         NANOS_REDUCTION_BULK_INT_TYPES_REGISTER(prod,PROD)
+         NANOS_REDUCTION_BULK_REAL_TYPES_REGISTER(prod,PROD)
+
+         NANOS_REDUCTION_BULK_INT_TYPES_REGISTER(and,AND)
+
+         NANOS_REDUCTION_BULK_INT_TYPES_REGISTER(or,OR)
+
+         NANOS_REDUCTION_BULK_INT_TYPES_REGISTER(xor,XOR)
+
+         NANOS_REDUCTION_BULK_INT_TYPES_REGISTER(max,MAX)
+         NANOS_REDUCTION_BULK_REAL_TYPES_REGISTER(max,MAX)
+
+         NANOS_REDUCTION_BULK_INT_TYPES_REGISTER(min,MIN)
+         NANOS_REDUCTION_BULK_REAL_TYPES_REGISTER(min,MIN)
+      }
+   } builtinBulkReducers;
+}
+
 NANOS_REDUCTION_CLEANUP_DEF(char, char)
 NANOS_REDUCTION_CLEANUP_DEF(uchar, unsigned char)
 NANOS_REDUCTION_CLEANUP_DEF(schar, signed char)
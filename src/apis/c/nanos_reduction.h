@@ -87,6 +87,21 @@ extern "C"
    __attribute__((alias(NANOS_STRINGIZE(nanos_reduction_bop_##Op## _##Type)))) \
    void nanos_reduction_vop_##Op##_##Type##_ ( int n, void *arg1, void *arg2); \
 
+#define NANOS_REDUCTION_ARRAY_DECL(Op,Type)\
+   void nanos_reduction_bop_array_##Op##_##Type ( void *arg1, void *arg2, int n); \
+
+#define NANOS_REDUCTION_ARRAY_INT_TYPES_DECL(Op) \
+   NANOS_REDUCTION_ARRAY_DECL(Op,int) \
+   NANOS_REDUCTION_ARRAY_DECL(Op,uint) \
+   NANOS_REDUCTION_ARRAY_DECL(Op,long) \
+   NANOS_REDUCTION_ARRAY_DECL(Op,ulong) \
+   NANOS_REDUCTION_ARRAY_DECL(Op,longlong) \
+   NANOS_REDUCTION_ARRAY_DECL(Op,ulonglong)
+
+#define NANOS_REDUCTION_ARRAY_REAL_TYPES_DECL(Op) \
+   NANOS_REDUCTION_ARRAY_DECL(Op,float) \
+   NANOS_REDUCTION_ARRAY_DECL(Op,double)
+
 #define NANOS_REDUCTION_INT_TYPES_DECL(Op) \
    NANOS_REDUCTION_DECL(Op,char) \
    NANOS_REDUCTION_DECL(Op,uchar) \
@@ -167,6 +182,25 @@ NANOS_REDUCTION_REAL_TYPES_DECL(max)
 NANOS_REDUCTION_INT_TYPES_DECL(min)
 NANOS_REDUCTION_REAL_TYPES_DECL(min)
 
+// ARRAY REDUCTION BUILTIN DECLARATION (element-wise over n elements, vectorized)
+NANOS_REDUCTION_ARRAY_INT_TYPES_DECL(add)
+NANOS_REDUCTION_ARRAY_REAL_TYPES_DECL(add)
+
+NANOS_REDUCTION_ARRAY_INT_TYPES_DECL(prod)
+NANOS_REDUCTION_ARRAY_REAL_TYPES_DECL(prod)
+
+NANOS_REDUCTION_ARRAY_INT_TYPES_DECL(and)
+
+NANOS_REDUCTION_ARRAY_INT_TYPES_DECL(or)
+
+NANOS_REDUCTION_ARRAY_INT_TYPES_DECL(xor)
+
+NANOS_REDUCTION_ARRAY_INT_TYPES_DECL(max)
+NANOS_REDUCTION_ARRAY_REAL_TYPES_DECL(max)
+
+NANOS_REDUCTION_ARRAY_INT_TYPES_DECL(min)
+NANOS_REDUCTION_ARRAY_REAL_TYPES_DECL(min)
+
 
 #define NANOS_REDUCTION_CLEANUP_DECL(Op, Type) \
    void nanos_reduction_default_cleanup_##Op ( void *r);
@@ -28,6 +28,7 @@
 #include "synchronizedcondition.hpp"
 #include "instrumentationmodule_decl.hpp"
 #include "instrumentation.hpp"
+#include "os.hpp"
 
 /*! \defgroup capi_sync Synchronization services.
  *  \ingroup capi
@@ -38,6 +39,60 @@
 
 using namespace nanos;
 
+#ifdef NANOS_INSTRUMENTATION_ENABLED
+namespace {
+   /*! \brief Acquire time (in nsecs) of a held user lock
+    *
+    *  Entries are found from the address of the lock, not from the thread, as an untied task
+    *  may release a lock in a different thread than the one it acquired it in.
+    */
+   struct HeldLock {
+      nanos_lock_t       *lock;
+      unsigned long long  since;
+   };
+
+   const size_t heldLocksSize = 1024;
+   const size_t heldLocksProbes = 4;
+   HeldLock heldLocks[heldLocksSize];
+
+   inline unsigned long long lockTime ()
+   {
+      return (unsigned long long) ( OS::getMonotonicTime() * 1.0e9 );
+   }
+
+   inline size_t heldLockSlot ( nanos_lock_t *lock, size_t probe )
+   {
+      return ( (size_t) lock / sizeof( nanos_lock_t ) + probe ) % heldLocksSize;
+   }
+
+   //! \brief Records when the lock was acquired. Not recorded if all the entries of the lock are taken
+   inline void lockAcquired ( nanos_lock_t *lock, unsigned long long when )
+   {
+      for ( size_t probe = 0; probe < heldLocksProbes; probe++ ) {
+         HeldLock &held = heldLocks[heldLockSlot( lock, probe )];
+         if ( compareAndSwap( &held.lock, (nanos_lock_t *) NULL, lock ) ) {
+            held.since = when;
+            return;
+         }
+      }
+   }
+
+   //! \brief Returns for how long the lock has been held, or 0 if its acquire time was not recorded
+   inline unsigned long long lockReleased ( nanos_lock_t *lock )
+   {
+      for ( size_t probe = 0; probe < heldLocksProbes; probe++ ) {
+         HeldLock &held = heldLocks[heldLockSlot( lock, probe )];
+         if ( held.lock != lock ) continue;
+         unsigned long long time = lockTime() - held.since;
+         memoryFence();
+         held.lock = NULL;
+         return time;
+      }
+      return 0;
+   }
+}
+#endif
+
 NANOS_API_DEF(nanos_err_t, nanos_wg_wait_completion, ( nanos_wg_t uwg, bool avoid_flush ))
 {
    if ( myThread->getCurrentWD()->isFinal() ) return NANOS_OK;
@@ -224,7 +279,20 @@ NANOS_API_DEF(nanos_err_t, nanos_set_lock, ( nanos_lock_t *lock ))
 
    try {
       Lock &l = *( Lock * ) lock;
+#ifdef NANOS_INSTRUMENTATION_ENABLED
+      unsigned long long begin = lockTime();
+      if ( !l.tryAcquire() ) {
+         l++;
+         static nanos_event_key_t wait_key = ID->getEventKey("lock-wait");
+         unsigned long long end = lockTime();
+         nanos_event_value_t wait = (nanos_event_value_t) ( end - begin );
+         sys.getInstrumentation()->raisePointEvents(1, &wait_key, &wait);
+         begin = end;
+      }
+      lockAcquired( lock, begin );
+#else
       l++;
+#endif
    } catch ( nanos_err_t e) {
       return e;
    }
@@ -244,6 +312,14 @@ NANOS_API_DEF(nanos_err_t, nanos_unset_lock, ( nanos_lock_t *lock ))
 
    try {
       Lock &l = *( Lock * ) lock;
+#ifdef NANOS_INSTRUMENTATION_ENABLED
+      unsigned long long held = lockReleased( lock );
+      if ( held != 0 ) {
+         static nanos_event_key_t hold_key = ID->getEventKey("lock-hold");
+         nanos_event_value_t value = (nanos_event_value_t) held;
+         sys.getInstrumentation()->raisePointEvents(1, &hold_key, &value);
+      }
+#endif
       l--;
    } catch ( nanos_err_t e) {
       return e;
@@ -266,6 +342,7 @@ NANOS_API_DEF(nanos_err_t, nanos_try_lock, ( nanos_lock_t *lock, bool *result ))
       Lock &l = *( Lock * ) lock;
 
       *result = l.tryAcquire();
+      NANOS_INSTRUMENT ( if ( *result ) lockAcquired( lock, lockTime() ); )
    } catch ( nanos_err_t e) {
       return e;
    }
@@ -30,6 +30,7 @@
 #include "plugin.hpp"
 #include "instrumentation.hpp"
 #include "instrumentationmodule_decl.hpp"
+#include <vector>
 
 //! \defgroup capi_wd WorkDescriptor services.
 //! \ingroup capi
@@ -242,6 +243,83 @@ NANOS_API_DEF(nanos_err_t, nanos_submit, ( nanos_wd_t uwd, size_t num_data_acces
 }
 
 
+/*! \brief Submits a batch of WorkDescriptors
+ *
+ *  Equivalent to calling nanos_submit for every WorkDescriptor in order, but the dependencies
+ *  of the whole batch are resolved at once and the ready tasks are queued together.
+ *
+ *  \param num_wds number of WorkDescriptors in the batch
+ *  \param uwds WorkDescriptors to submit
+ *  \param num_data_accesses number of data accesses of each WorkDescriptor (NULL if none has dependencies)
+ *  \param data_accesses data accesses of each WorkDescriptor
+ *  \param team must be NULL
+ *  \sa nanos_submit
+ */
+NANOS_API_DEF(nanos_err_t, nanos_submit_batch, ( size_t num_wds, nanos_wd_t *uwds, size_t *num_data_accesses, nanos_data_access_t **data_accesses, nanos_team_t team ))
+{
+   NANOS_INSTRUMENT( InstrumentStateAndBurst inst("api","submit",NANOS_SCHEDULING) );
+
+   try {
+      if ( num_wds == 0 ) return NANOS_OK;
+      ensure( uwds,"NULL WD array received" );
+
+      if ( team != NULL ) {
+         warning( "Submitting to another team not implemented yet" );
+      }
+
+      WD ** wds = ( WD ** ) uwds;
+      WD * current = myThread->getCurrentWD();
+
+      // Without data accesses every WD is submitted as independent
+      std::vector<size_t> no_deps;
+      size_t * num_deps = num_data_accesses;
+      if ( num_deps == NULL || data_accesses == NULL ) {
+         no_deps.resize( num_wds, 0 );
+         num_deps = &no_deps[0];
+      }
+
+      NANOS_INSTRUMENT ( static InstrumentationDictionary *ID = sys.getInstrumentation()->getInstrumentationDictionary(); )
+
+      NANOS_INSTRUMENT ( static nanos_event_key_t create_wd_id = ID->getEventKey("create-wd-id"); )
+      NANOS_INSTRUMENT ( static nanos_event_key_t create_wd_ptr = ID->getEventKey("create-wd-ptr"); )
+      NANOS_INSTRUMENT ( static nanos_event_key_t wd_num_deps = ID->getEventKey("wd-num-deps"); )
+      NANOS_INSTRUMENT ( static nanos_event_key_t wd_deps_ptr = ID->getEventKey("wd-deps-ptr"); )
+
+      NANOS_INSTRUMENT ( nanos_event_key_t Keys[4]; )
+      NANOS_INSTRUMENT ( nanos_event_value_t Values[4]; )
+
+      NANOS_INSTRUMENT ( Keys[0] = create_wd_id; )
+      NANOS_INSTRUMENT ( Keys[1] = create_wd_ptr; )
+      NANOS_INSTRUMENT ( Keys[2] = wd_num_deps; )
+      NANOS_INSTRUMENT ( Keys[3] = wd_deps_ptr; )
+
+      for ( size_t i = 0; i < num_wds; i++ ) {
+         ensure( wds[i],"NULL WD received" );
+
+         if ( sys.getVerboseCopies() ) {
+            *myThread->_file << "Submitting WD " << wds[i]->getId() << " " << (wds[i]->getDescription() == NULL ? "n/a" : wds[i]->getDescription()) << std::endl;
+         }
+
+         sys.setupWD( *wds[i], current );
+
+         NANOS_INSTRUMENT ( Values[0] = (nanos_event_value_t) wds[i]->getId(); )
+         NANOS_INSTRUMENT ( Values[1] = (nanos_event_value_t) wds[i]; )
+         NANOS_INSTRUMENT ( Values[2] = (nanos_event_value_t) num_deps[i]; )
+         NANOS_INSTRUMENT ( Values[3] = (nanos_event_value_t) ( data_accesses != NULL ? data_accesses[i] : NULL ); )
+
+         NANOS_INSTRUMENT( sys.getInstrumentation()->raisePointEvents(4, Keys, Values); )
+
+         NANOS_INSTRUMENT (sys.getInstrumentation()->raiseOpenPtPEvent ( NANOS_WD_DOMAIN, (nanos_event_id_t) wds[i]->getId(), 0, 0 );)
+      }
+
+      sys.submitBatchWithDependencies( num_wds, wds, num_deps, ( DataAccess ** ) data_accesses );
+   } catch ( nanos_err_t e) {
+      return e;
+   }
+
+   return NANOS_OK;
+}
+
 /*! \brief Creates a new WorkDescriptor and execute it inmediately
  *
  *  \param const_data_ext
@@ -523,6 +601,23 @@ NANOS_API_DEF(nanos_err_t, nanos_get_num_blocked_tasks, ( unsigned int *blocked_
 
 }
 
+/*! \brief Get number of tasks whose copies were started ahead of their execution
+ *
+ *  \param prefetched_tasks
+ */
+NANOS_API_DEF(nanos_err_t, nanos_get_num_prefetched_tasks, ( unsigned int *prefetched_tasks ))
+{
+   NANOS_INSTRUMENT( InstrumentStateAndBurst inst("api","get_num_prefetched_tasks",NANOS_RUNTIME) );
+
+   try {
+      *prefetched_tasks = sys.getSMPPlugin()->getPrefetchedTasks();
+   } catch ( nanos_err_t e ) {
+      return e;
+   }
+
+   return NANOS_OK;
+}
+
 
 /*! \brief Sets copies of a wd
  *
@@ -26,6 +26,7 @@
 #include "gpumemoryspace_decl.hpp"
 #include "smpprocessor.hpp"
 #include "system_decl.hpp"
+#include "regioncache.hpp"
 #include <fstream>
 #include <sstream>
 #include <vector>
@@ -306,12 +307,17 @@ class GPUPlugin : public ArchPlugin
          if ( _gpuThreads->size() ) {
             int soft_inv = 0;
             int hard_inv = 0;
+            std::size_t evicted = 0;
+            std::size_t written_back = 0;
             for ( unsigned int idx = 0; idx < _gpus->size(); idx += 1 ) {
                soft_inv += sys.getSeparateMemory( (*_gpus)[idx]->getMemorySpaceId() ).getSoftInvalidationCount();
                hard_inv += sys.getSeparateMemory( (*_gpus)[idx]->getMemorySpaceId() ).getHardInvalidationCount();
+               evicted += sys.getSeparateMemory( (*_gpus)[idx]->getMemorySpaceId() ).getCache().getEvictedBytes();
+               written_back += sys.getSeparateMemory( (*_gpus)[idx]->getMemorySpaceId() ).getCache().getTransferredReplacedOutData();
             }
             message0("GPUs Soft invalidations: " << soft_inv);
             message0("GPUs Hard invalidations: " << hard_inv);
+            message0("GPUs Evicted bytes: " << evicted << " (written back: " << written_back << ")");
          }
       }
 
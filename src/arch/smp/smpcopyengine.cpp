@@ -0,0 +1,170 @@
+/*************************************************************************************/
+/*      Copyright 2015 Barcelona Supercomputing Center                               */
+/*                                                                                   */
+/*      This file is part of the NANOS++ library.                                    */
+/*                                                                                   */
+/*      NANOS++ is free software: you can redistribute it and/or modify              */
+/*      it under the terms of the GNU Lesser General Public License as published by  */
+/*      the Free Software Foundation, either version 3 of the License, or            */
+/*      (at your option) any later version.                                          */
+/*                                                                                   */
+/*      NANOS++ is distributed in the hope that it will be useful,                   */
+/*      but WITHOUT ANY WARRANTY; without even the implied warranty of               */
+/*      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                */
+/*      GNU Lesser General Public License for more details.                          */
+/*                                                                                   */
+/*      You should have received a copy of the GNU Lesser General Public License     */
+/*      along with NANOS++.  If not, see <http://www.gnu.org/licenses/>.             */
+/*************************************************************************************/
+
+#include "smpcopyengine_decl.hpp"
+#include "atomic.hpp"
+#include "os.hpp"
+#include <string.h>
+#include <stdint.h>
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#include <emmintrin.h>
+#define NANOS_SMP_STREAMING_STORES
+#endif
+
+using namespace nanos;
+using namespace nanos::ext;
+
+namespace {
+
+//! \brief Rows at least this long are worth copying with non-temporal stores
+const size_t minStreamingRow = 256;
+
+template <size_t N>
+void copyFixedRows ( char *dst, const char *src, size_t count, size_t ld )
+{
+   // A constant size memcpy is expanded inline into (vector) moves
+   for ( size_t i = 0; i < count; i++, dst += ld, src += ld ) ::memcpy( dst, src, N );
+}
+
+void copyRows ( char *dst, const char *src, size_t len, size_t count, size_t ld )
+{
+   switch ( len ) {
+      case 4:   copyFixedRows<4>( dst, src, count, ld ); break;
+      case 8:   copyFixedRows<8>( dst, src, count, ld ); break;
+      case 16:  copyFixedRows<16>( dst, src, count, ld ); break;
+      case 32:  copyFixedRows<32>( dst, src, count, ld ); break;
+      case 64:  copyFixedRows<64>( dst, src, count, ld ); break;
+      case 128: copyFixedRows<128>( dst, src, count, ld ); break;
+      default:
+         for ( size_t i = 0; i < count; i++, dst += ld, src += ld ) ::memcpy( dst, src, len );
+   }
+}
+
+void streamCopy ( char *dst, const char *src, size_t len )
+{
+#ifdef NANOS_SMP_STREAMING_STORES
+   // Non-temporal stores need an aligned destination
+   size_t head = ( 16 - ( (uintptr_t) dst & 15 ) ) & 15;
+   if ( head > len ) head = len;
+   ::memcpy( dst, src, head );
+   len -= head;
+
+   __m128i *d = (__m128i *) ( dst + head );
+   const __m128i *s = (const __m128i *) ( src + head );
+   for ( ; len >= 64; len -= 64, d += 4, s += 4 ) {
+      __m128i v0 = _mm_loadu_si128( s );
+      __m128i v1 = _mm_loadu_si128( s + 1 );
+      __m128i v2 = _mm_loadu_si128( s + 2 );
+      __m128i v3 = _mm_loadu_si128( s + 3 );
+      _mm_stream_si128( d, v0 );
+      _mm_stream_si128( d + 1, v1 );
+      _mm_stream_si128( d + 2, v2 );
+      _mm_stream_si128( d + 3, v3 );
+   }
+   for ( ; len >= 16; len -= 16, d++, s++ ) _mm_stream_si128( d, _mm_loadu_si128( s ) );
+   ::memcpy( d, s, len );
+#else
+   ::memcpy( dst, src, len );
+#endif
+}
+
+void streamFence ()
+{
+#ifdef NANOS_SMP_STREAMING_STORES
+   // Streaming stores are weakly ordered: make them visible before the transfer is completed
+   _mm_sfence();
+#endif
+}
+
+} // namespace
+
+size_t SMPCopyEngine::_chunkSize = 64 * 1024;
+size_t SMPCopyEngine::_streamingThreshold = 4 * 1024 * 1024;
+SMPCopyEngine::Stats * SMPCopyEngine::_stats = NULL;
+unsigned int SMPCopyEngine::_numStats = 0;
+
+void SMPCopyEngine::prepareConfig ( Config &config )
+{
+   config.registerConfigOption ( "smp-transfer-chunk-size", NEW Config::SizeVar( _chunkSize ),
+                                 "Defines the size of the pieces in which private memory transfers are split, to be copied in parallel (0 disables splitting)" );
+   config.registerArgOption( "smp-transfer-chunk-size", "smp-transfer-chunk-size" );
+   config.registerEnvOption( "smp-transfer-chunk-size", "NX_SMP_TRANSFER_CHUNK_SIZE" );
+
+   config.registerConfigOption ( "smp-transfer-streaming-threshold", NEW Config::SizeVar( _streamingThreshold ),
+                                 "Defines the size from which private memory transfers use non-temporal stores (0 disables them)" );
+   config.registerArgOption( "smp-transfer-streaming-threshold", "smp-transfer-streaming-threshold" );
+   config.registerEnvOption( "smp-transfer-streaming-threshold", "NX_SMP_TRANSFER_STREAMING_THRESHOLD" );
+}
+
+void SMPCopyEngine::initStats ( unsigned int numMemorySpaces )
+{
+   finiStats();
+   _stats = NEW Stats[numMemorySpaces];
+   _numStats = numMemorySpaces;
+}
+
+void SMPCopyEngine::finiStats ()
+{
+   _numStats = 0;
+   delete[] _stats;
+   _stats = NULL;
+}
+
+void SMPCopyEngine::copy ( char *dst, const char *src, size_t len, size_t count, size_t ld, bool streaming )
+{
+   if ( count == 1 || len == ld ) {
+      if ( streaming ) streamCopy( dst, src, len * count );
+      else ::memcpy( dst, src, len * count );
+   } else if ( streaming && len >= minStreamingRow ) {
+      for ( size_t i = 0; i < count; i++, dst += ld, src += ld ) streamCopy( dst, src, len );
+   } else {
+      copyRows( dst, src, len, count, ld );
+      streaming = false;
+   }
+   if ( streaming ) streamFence();
+}
+
+void SMPCopyEngine::transfer ( memory_space_id_t id, char *dst, const char *src, size_t len, size_t count, size_t ld, bool streaming )
+{
+   double start = OS::getMonotonicTime();
+   copy( dst, src, len, count, ld, streaming );
+   double elapsed = OS::getMonotonicTime() - start;
+
+   if ( id < _numStats ) {
+      _stats[id]._bytes += (unsigned long long) ( len * count );
+      _stats[id]._nsecs += (unsigned long long) ( elapsed * 1e9 );
+   }
+}
+
+unsigned long long SMPCopyEngine::getBytes ( memory_space_id_t id )
+{
+   return id < _numStats ? _stats[id]._bytes.value() : 0;
+}
+
+double SMPCopyEngine::getSeconds ( memory_space_id_t id )
+{
+   return id < _numStats ? _stats[id]._nsecs.value() / 1e9 : 0.0;
+}
+
+double SMPCopyEngine::getBandwidth ( memory_space_id_t id )
+{
+   double seconds = getSeconds( id );
+   return seconds > 0.0 ? getBytes( id ) / seconds / 1e6 : 0.0;
+}
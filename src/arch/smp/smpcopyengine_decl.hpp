@@ -0,0 +1,91 @@
+/*************************************************************************************/
+/*      Copyright 2015 Barcelona Supercomputing Center                               */
+/*                                                                                   */
+/*      This file is part of the NANOS++ library.                                    */
+/*                                                                                   */
+/*      NANOS++ is free software: you can redistribute it and/or modify              */
+/*      it under the terms of the GNU Lesser General Public License as published by  */
+/*      the Free Software Foundation, either version 3 of the License, or            */
+/*      (at your option) any later version.                                          */
+/*                                                                                   */
+/*      NANOS++ is distributed in the hope that it will be useful,                   */
+/*      but WITHOUT ANY WARRANTY; without even the implied warranty of               */
+/*      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                */
+/*      GNU Lesser General Public License for more details.                          */
+/*                                                                                   */
+/*      You should have received a copy of the GNU Lesser General Public License     */
+/*      along with NANOS++.  If not, see <http://www.gnu.org/licenses/>.             */
+/*************************************************************************************/
+
+#ifndef _NANOS_SMP_COPY_ENGINE_DECL
+#define _NANOS_SMP_COPY_ENGINE_DECL
+
+#include <stddef.h>
+#include "atomic_decl.hpp"
+#include "config.hpp"
+#include "nanos-int.h"
+
+namespace nanos {
+namespace ext {
+
+   /*! \brief Copy kernels of the SMP device (private memory transfers)
+    *
+    *  The transfer queue splits large transfers in chunks of about _chunkSize bytes, small
+    *  enough to stay in cache, which idle threads copy in parallel. Transfers of at least
+    *  _streamingThreshold bytes are copied with non-temporal stores: they would not fit in
+    *  cache anyway, and the copying thread is not the one that reads the data afterwards.
+    *  Strided rows of the usual small sizes are copied with fixed-size moves instead of a
+    *  call to memcpy per row.
+    *
+    *  The bytes copied to or from every memory space, and the time spent copying them, are
+    *  accumulated to report the copy bandwidth.
+    */
+   class SMPCopyEngine
+   {
+      public:
+         static size_t  _chunkSize;           //!< Size of the pieces queued by the transfer queue
+         static size_t  _streamingThreshold;  //!< Transfers of at least these bytes use non-temporal stores (0: never)
+
+      private:
+         struct Stats {
+            Atomic<unsigned long long>  _bytes;
+            Atomic<unsigned long long>  _nsecs;   //!< Time spent copying, added over all the copying threads
+
+            Stats () : _bytes( 0 ), _nsecs( 0 ) {}
+         };
+
+         static Stats         *_stats;         //!< By memory space id
+         static unsigned int   _numStats;
+
+         //! \brief Constructor (disabled, only static members)
+         SMPCopyEngine ();
+
+      public:
+         //! \brief Registers the copy configuration options
+         static void prepareConfig ( Config &config );
+
+         //! \brief Creates the statistics of the memory spaces with an id below 'numMemorySpaces'
+         static void initStats ( unsigned int numMemorySpaces );
+         static void finiStats ();
+
+         //! \brief Whether a transfer of 'bytes' should use non-temporal stores
+         static bool useStreaming ( size_t bytes ) { return _streamingThreshold > 0 && bytes >= _streamingThreshold; }
+
+         /*! \brief Copies 'count' rows of 'len' bytes, separated by 'ld' bytes both in 'dst' and in 'src'
+          *  Streaming copies are fenced before returning.
+          */
+         static void copy ( char *dst, const char *src, size_t len, size_t count, size_t ld, bool streaming );
+
+         //! \brief Times a copy and accounts it to memory space 'id'
+         static void transfer ( memory_space_id_t id, char *dst, const char *src, size_t len, size_t count, size_t ld, bool streaming );
+
+         static unsigned long long getBytes ( memory_space_id_t id );
+         static double getSeconds ( memory_space_id_t id );
+         //! \brief Copy bandwidth of memory space 'id', in MB/s (0 if nothing was copied)
+         static double getBandwidth ( memory_space_id_t id );
+   };
+
+} // namespace ext
+} // namespace nanos
+
+#endif
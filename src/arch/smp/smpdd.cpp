@@ -37,6 +37,7 @@ SMPDevice &nanos::ext::getSMPDevice() {
 }
 
 size_t SMPDD::_stackSize = 256*1024;
+SMPStackPool SMPDD::_stackPool;
 
 //! \brief Registers the Device's configuration options
 //! \param reference to a configuration object.
@@ -50,6 +51,9 @@ void SMPDD::prepareConfig ( Config &config )
    //! \note Get the stack size for this specific device
    config.registerConfigOption ( "smp-stack-size", NEW Config::SizeVar( _stackSize ), "Defines SMP::task stack size" );
    config.registerArgOption("smp-stack-size", "smp-stack-size");
+
+   //! \note Get the stack pool options (guard pages, committed idle stacks)
+   SMPStackPool::prepareConfig( config );
 }
 
 void SMPDD::initStack ( WD *wd )
@@ -78,8 +82,8 @@ void SMPDD::lazyInit ( WD &wd, bool isUserLevelThread, WD *previous )
    verbose0("Task " << wd.getId() << " initialization"); 
    if (isUserLevelThread) {
       if (previous == NULL) {
-         _stack = (void *) NEW char[_stackSize];
-         verbose0("   new stack created: " << _stackSize << " bytes");
+         _stack = _stackPool.acquire( _stackSize );
+         verbose0("   new stack acquired: " << _stackSize << " bytes");
       } else {
          verbose0("   reusing stacks");
          SMPDD &oldDD = (SMPDD &) previous->getActiveDevice();
@@ -24,6 +24,7 @@
 #include "smpdevice_decl.hpp"
 #include "workdescriptor_fwd.hpp"
 #include "config.hpp"
+#include "smpstackpool_decl.hpp"
 
 namespace nanos {
 namespace ext {
@@ -38,6 +39,7 @@ namespace ext {
          void               *_stack;             //!< Stack base
          void               *_state;             //!< Stack pointer
          static size_t       _stackSize;         //!< Stack size
+         static SMPStackPool _stackPool;         //!< Recycled stacks
       protected:
          SMPDD( work_fct w, Device *dd ) : DD( dd, w ),_stack( 0 ),_state( 0 ) {}
          SMPDD( Device *dd ) : DD( dd, NULL ), _stack( 0 ),_state( 0 ) {}
@@ -51,7 +53,7 @@ namespace ext {
          //! \brief Assignment operator
          const SMPDD & operator= ( const SMPDD &wd );
          //! \brief Destructor
-         virtual ~SMPDD() { if ( _stack ) delete[] (char *) _stack; }
+         virtual ~SMPDD() { if ( _stack ) _stackPool.release( _stack, _stackSize ); }
 
          bool hasStack() { return _state != NULL; }
 
@@ -71,6 +73,9 @@ namespace ext {
 
          static void prepareConfig( Config &config );
 
+         //! \brief Gives the stacks cached by the calling thread back to the pool (on thread exit)
+         static void releaseThreadStacks() { _stackPool.flushLocal( _stackSize ); }
+
          virtual void lazyInit (WD &wd, bool isUserLevelThread, WD *previous);
          virtual size_t size ( void ) { return sizeof(SMPDD); }
          virtual SMPDD *copyTo ( void *toAddr );
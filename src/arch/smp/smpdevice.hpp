@@ -28,6 +28,7 @@
 #include "copydescriptor.hpp"
 #include "system_decl.hpp"
 #include "smptransferqueue.hpp"
+#include "smpcopyengine_decl.hpp"
 #include "globalregt.hpp"
 
 namespace nanos {
@@ -71,7 +72,7 @@ std::size_t SMPDevice::getMemCapacity( SeparateMemoryAddressSpace &mem ) {
 
 void SMPDevice::_copyIn( uint64_t devAddr, uint64_t hostAddr, std::size_t len, SeparateMemoryAddressSpace &mem, DeviceOps *ops, WD const *wd, void *hostObject, reg_t hostRegionId ) {
    if ( sys.getSMPPlugin()->asyncTransfersEnabled() ) {
-      _transferQueue.addTransfer( ops, ((char *) devAddr), ((char *) hostAddr), len, 1, 0, true );
+      _transferQueue.addTransfer( ops, mem.getMemorySpaceId(), ((char *) devAddr), ((char *) hostAddr), len, 1, 0, true );
    } else {
       ops->addOp();
       NANOS_INSTRUMENT ( static InstrumentationDictionary *ID = sys.getInstrumentation()->getInstrumentationDictionary(); )
@@ -85,7 +86,7 @@ void SMPDevice::_copyIn( uint64_t devAddr, uint64_t hostAddr, std::size_t len, S
             *myThread->_file << buff << std::endl;
          }
       }
-      ::memcpy( (void *) devAddr, (void *) hostAddr, len );
+      ext::SMPCopyEngine::transfer( mem.getMemorySpaceId(), (char *) devAddr, (char *) hostAddr, len, 1, 0, ext::SMPCopyEngine::useStreaming( len ) );
       NANOS_INSTRUMENT( sys.getInstrumentation()->raiseCloseBurstEvent( key, (nanos_event_value_t) 0 ); )
       ops->completeOp();
    }
@@ -93,7 +94,7 @@ void SMPDevice::_copyIn( uint64_t devAddr, uint64_t hostAddr, std::size_t len, S
 
 void SMPDevice::_copyOut( uint64_t hostAddr, uint64_t devAddr, std::size_t len, SeparateMemoryAddressSpace &mem, DeviceOps *ops, WD const *wd, void *hostObject, reg_t hostRegionId ) {
    if ( sys.getSMPPlugin()->asyncTransfersEnabled() ) {
-      _transferQueue.addTransfer( ops, ((char *) hostAddr), ((char *) devAddr), len, 1, 0, true );
+      _transferQueue.addTransfer( ops, mem.getMemorySpaceId(), ((char *) hostAddr), ((char *) devAddr), len, 1, 0, true );
    } else {
       ops->addOp();
       NANOS_INSTRUMENT ( static InstrumentationDictionary *ID = sys.getInstrumentation()->getInstrumentationDictionary(); )
@@ -107,7 +108,7 @@ void SMPDevice::_copyOut( uint64_t hostAddr, uint64_t devAddr, std::size_t len,
             //*myThread->_file << "WATCH update host: old value " << *((double *) sys._watchAddr )<< std::endl;
          }
       }
-      ::memcpy( (void *) hostAddr, (void *) devAddr, len );
+      ext::SMPCopyEngine::transfer( mem.getMemorySpaceId(), (char *) hostAddr, (char *) devAddr, len, 1, 0, ext::SMPCopyEngine::useStreaming( len ) );
       if (sys._watchAddr != NULL ) {
          if ((uint64_t )sys._watchAddr >= hostAddr && (uint64_t )sys._watchAddr < hostAddr + len) {
             char buff[256];
@@ -123,7 +124,7 @@ void SMPDevice::_copyOut( uint64_t hostAddr, uint64_t devAddr, std::size_t len,
 
 bool SMPDevice::_copyDevToDev( uint64_t devDestAddr, uint64_t devOrigAddr, std::size_t len, SeparateMemoryAddressSpace &memDest, SeparateMemoryAddressSpace &memorig, DeviceOps *ops, WD const *wd, void *hostObject, reg_t hostRegionId ) {
    if ( sys.getSMPPlugin()->asyncTransfersEnabled() ) {
-      _transferQueue.addTransfer( ops, ((char *) devDestAddr), ((char *) devOrigAddr), len, 1, 0, true );
+      _transferQueue.addTransfer( ops, memDest.getMemorySpaceId(), ((char *) devDestAddr), ((char *) devOrigAddr), len, 1, 0, true );
    } else {
       ops->addOp();
       NANOS_INSTRUMENT ( static InstrumentationDictionary *ID = sys.getInstrumentation()->getInstrumentationDictionary(); )
@@ -140,7 +141,7 @@ bool SMPDevice::_copyDevToDev( uint64_t devDestAddr, uint64_t devOrigAddr, std::
             *myThread->_file << buff << std::endl;
          }
       }
-      ::memcpy( (void *) devDestAddr, (void *) devOrigAddr, len );
+      ext::SMPCopyEngine::transfer( memDest.getMemorySpaceId(), (char *) devDestAddr, (char *) devOrigAddr, len, 1, 0, ext::SMPCopyEngine::useStreaming( len ) );
       NANOS_INSTRUMENT( sys.getInstrumentation()->raiseCloseBurstEvent( key, (nanos_event_value_t) 0 ); )
       ops->completeOp();
    }
@@ -149,15 +150,13 @@ bool SMPDevice::_copyDevToDev( uint64_t devDestAddr, uint64_t devOrigAddr, std::
 
 void SMPDevice::_copyInStrided1D( uint64_t devAddr, uint64_t hostAddr, std::size_t len, std::size_t numChunks, std::size_t ld, SeparateMemoryAddressSpace &mem, DeviceOps *ops, WD const *wd, void *hostObject, reg_t hostRegionId ) {
    if ( sys.getSMPPlugin()->asyncTransfersEnabled() ) {
-      _transferQueue.addTransfer( ops, ((char *) devAddr), ((char *) hostAddr), len, numChunks, ld, true );
+      _transferQueue.addTransfer( ops, mem.getMemorySpaceId(), ((char *) devAddr), ((char *) hostAddr), len, numChunks, ld, true );
    } else {
       ops->addOp();
       NANOS_INSTRUMENT ( static InstrumentationDictionary *ID = sys.getInstrumentation()->getInstrumentationDictionary(); )
       NANOS_INSTRUMENT ( static nanos_event_key_t key = ID->getEventKey("cache-copy-in"); )
       NANOS_INSTRUMENT( sys.getInstrumentation()->raiseOpenBurstEvent( key, (nanos_event_value_t) 2 ); )
-      for ( std::size_t count = 0; count < numChunks; count += 1) {
-         ::memcpy( ((char *) devAddr) + count * ld, ((char *) hostAddr) + count * ld, len );
-      }
+      ext::SMPCopyEngine::transfer( mem.getMemorySpaceId(), (char *) devAddr, (char *) hostAddr, len, numChunks, ld, ext::SMPCopyEngine::useStreaming( len * numChunks ) );
       NANOS_INSTRUMENT( sys.getInstrumentation()->raiseCloseBurstEvent( key, (nanos_event_value_t) 0 ); )
       ops->completeOp();
    }
@@ -165,15 +164,13 @@ void SMPDevice::_copyInStrided1D( uint64_t devAddr, uint64_t hostAddr, std::size
 
 void SMPDevice::_copyOutStrided1D( uint64_t hostAddr, uint64_t devAddr, std::size_t len, std::size_t numChunks, std::size_t ld, SeparateMemoryAddressSpace &mem, DeviceOps *ops, WD const *wd, void *hostObject, reg_t hostRegionId ) {
    if ( sys.getSMPPlugin()->asyncTransfersEnabled() ) {
-      _transferQueue.addTransfer( ops, ((char *) hostAddr), ((char *) devAddr), len, numChunks, ld, false );
+      _transferQueue.addTransfer( ops, mem.getMemorySpaceId(), ((char *) hostAddr), ((char *) devAddr), len, numChunks, ld, false );
    } else {
       ops->addOp();
       NANOS_INSTRUMENT ( static InstrumentationDictionary *ID = sys.getInstrumentation()->getInstrumentationDictionary(); )
       NANOS_INSTRUMENT ( static nanos_event_key_t key = ID->getEventKey("cache-copy-out"); )
       NANOS_INSTRUMENT( sys.getInstrumentation()->raiseOpenBurstEvent( key, (nanos_event_value_t) 2 ); )
-      for ( std::size_t count = 0; count < numChunks; count += 1) {
-         ::memcpy( ((char *) hostAddr) + count * ld, ((char *) devAddr) + count * ld, len );
-      }
+      ext::SMPCopyEngine::transfer( mem.getMemorySpaceId(), (char *) hostAddr, (char *) devAddr, len, numChunks, ld, ext::SMPCopyEngine::useStreaming( len * numChunks ) );
       NANOS_INSTRUMENT( sys.getInstrumentation()->raiseCloseBurstEvent( key, (nanos_event_value_t) 0 ); )
       ops->completeOp();
    }
@@ -181,15 +178,13 @@ void SMPDevice::_copyOutStrided1D( uint64_t hostAddr, uint64_t devAddr, std::siz
 
 bool SMPDevice::_copyDevToDevStrided1D( uint64_t devDestAddr, uint64_t devOrigAddr, std::size_t len, std::size_t numChunks, std::size_t ld, SeparateMemoryAddressSpace &memDest, SeparateMemoryAddressSpace &memOrig, DeviceOps *ops, WD const *wd, void *hostObject, reg_t hostRegionId ) {
    if ( sys.getSMPPlugin()->asyncTransfersEnabled() ) {
-      _transferQueue.addTransfer( ops, ((char *) devDestAddr), ((char *) devOrigAddr), len, numChunks, ld, true );
+      _transferQueue.addTransfer( ops, memDest.getMemorySpaceId(), ((char *) devDestAddr), ((char *) devOrigAddr), len, numChunks, ld, true );
    } else {
       ops->addOp();
       NANOS_INSTRUMENT ( static InstrumentationDictionary *ID = sys.getInstrumentation()->getInstrumentationDictionary(); )
       NANOS_INSTRUMENT ( static nanos_event_key_t key = ID->getEventKey("cache-copy-in"); )
       NANOS_INSTRUMENT( sys.getInstrumentation()->raiseOpenBurstEvent( key, (nanos_event_value_t) 2 ); )
-      for ( std::size_t count = 0; count < numChunks; count += 1) {
-         ::memcpy( ((char *) devDestAddr) + count * ld, ((char *) devOrigAddr) + count * ld, len );
-      }
+      ext::SMPCopyEngine::transfer( memDest.getMemorySpaceId(), (char *) devDestAddr, (char *) devOrigAddr, len, numChunks, ld, ext::SMPCopyEngine::useStreaming( len * numChunks ) );
       NANOS_INSTRUMENT( sys.getInstrumentation()->raiseCloseBurstEvent( key, (nanos_event_value_t) 0 ); )
       ops->completeOp();
    }
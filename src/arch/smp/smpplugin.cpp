@@ -24,6 +24,8 @@
 #include "atomic.hpp"
 #include "debug.hpp"
 #include "smpprocessor.hpp"
+#include "smpcopyengine_decl.hpp"
+#include "evictionpolicy_decl.hpp"
 #include "os.hpp"
 #include "osallocator_decl.hpp"
 
@@ -84,6 +86,7 @@ nanos::PE * smpProcessorFactory ( int id, int uid )
       cfg.setOptionsSection( "SMP Arch", "SMP specific options" );
       SMPProcessor::prepareConfig( cfg );
       SMPDD::prepareConfig( cfg );
+      SMPCopyEngine::prepareConfig( cfg );
       cfg.registerConfigOption ( "smp-num-pes", NEW Config::PositiveVar ( _requestedCPUs ), "CPUs requested." );
       cfg.registerArgOption ( "smp-num-pes", "smp-cpus" );
       cfg.registerEnvOption( "smp-num-pes", "NX_SMP_CPUS" );
@@ -267,6 +270,7 @@ nanos::PE * smpProcessorFactory ( int id, int uid )
          (*_cpusByCpuId)[ *it ] = cpu;
          count += 1;
       }
+      SMPCopyEngine::initStats( sys.getSeparateMemoryAddressSpacesCount() + 1 );
 
 #ifdef NANOS_DEBUG_ENABLED
       if ( sys.getVerbose() ) {
@@ -336,25 +340,40 @@ nanos::PE * smpProcessorFactory ( int id, int uid )
          SeparateMemoryAddressSpace &mem = sys.getSeparateMemory( 1 );
          std::cerr << "memkind: SMP soft replacements: " << mem.getSoftInvalidationCount() << std::endl;
          std::cerr << "memkind: SMP hard replacements: " << mem.getHardInvalidationCount() << std::endl;
+         std::cerr << "memkind: SMP evictions: " << mem.getCache().getEvictedChunks() << " chunks, " << mem.getCache().getEvictedBytes() << " bytes" << std::endl;
          std::cerr << "memkind: SMP Xfer IN bytes: " << mem.getCache().getTransferredInData() << std::endl;
          std::cerr << "memkind: SMP Xfer OUT bytes: " << mem.getCache().getTransferredOutData() << std::endl;
          std::cerr << "memkind: SMP Xfer OUT (Replacements) bytes: " << mem.getCache().getTransferredReplacedOutData() << std::endl;
+         std::cerr << "memkind: SMP Xfer bandwidth: " << SMPCopyEngine::getBandwidth( 1 ) << " MB/s (" << SMPCopyEngine::getBytes( 1 ) << " bytes in " << SMPCopyEngine::getSeconds( 1 ) << " s)" << std::endl;
          SimpleAllocator *allocator = (SimpleAllocator *) mem.getSpecificData();
          delete allocator;
       } else if ( _smpPrivateMemory ) {
          std::size_t total_in = 0;
          std::size_t total_out = 0;
+         std::size_t total_evicted = 0;
+         std::size_t total_written_back = 0;
+         unsigned int total_prefetched = 0;
+         unsigned long long total_copied = 0;
+         double total_seconds = 0.0;
          for ( std::vector<SMPProcessor *>::const_iterator it = _cpus->begin(); it != _cpus->end(); it++ ) {
             if ( (*it)->getMemorySpaceId() > 0 ) {
                SeparateMemoryAddressSpace &mem = sys.getSeparateMemory( (*it)->getMemorySpaceId() );
                if ( (*it)->isActive() ) {
                   std::cerr << "PrivateMem: cpu " << (*it)->getId()  << " SMP soft replacements: " << mem.getSoftInvalidationCount() << std::endl;
                   std::cerr << "PrivateMem: cpu " << (*it)->getId()  << " SMP hard replacements: " << mem.getHardInvalidationCount() << std::endl;
+                  std::cerr << "PrivateMem: cpu " << (*it)->getId()  << " SMP evictions: " << mem.getCache().getEvictedChunks() << " chunks, " << mem.getCache().getEvictedBytes() << " bytes" << std::endl;
                   std::cerr << "PrivateMem: cpu " << (*it)->getId()  << " Xfer IN bytes: " << mem.getCache().getTransferredInData() << std::endl;
                   std::cerr << "PrivateMem: cpu " << (*it)->getId()  << " Xfer OUT bytes: " << mem.getCache().getTransferredOutData() << std::endl;
                   std::cerr << "PrivateMem: cpu " << (*it)->getId()  << " Xfer OUT (Replacements) bytes: " << mem.getCache().getTransferredReplacedOutData() << std::endl;
+                  std::cerr << "PrivateMem: cpu " << (*it)->getId()  << " prefetched tasks: " << (*it)->getPrefetchedTasks() << std::endl;
+                  std::cerr << "PrivateMem: cpu " << (*it)->getId()  << " Xfer bandwidth: " << SMPCopyEngine::getBandwidth( (*it)->getMemorySpaceId() ) << " MB/s (" << SMPCopyEngine::getBytes( (*it)->getMemorySpaceId() ) << " bytes in " << SMPCopyEngine::getSeconds( (*it)->getMemorySpaceId() ) << " s)" << std::endl;
                   total_in += mem.getCache().getTransferredInData();
                   total_out += mem.getCache().getTransferredOutData();
+                  total_evicted += mem.getCache().getEvictedBytes();
+                  total_written_back += mem.getCache().getTransferredReplacedOutData();
+                  total_prefetched += (*it)->getPrefetchedTasks();
+                  total_copied += SMPCopyEngine::getBytes( (*it)->getMemorySpaceId() );
+                  total_seconds += SMPCopyEngine::getSeconds( (*it)->getMemorySpaceId() );
                }
                SimpleAllocator *allocator = (SimpleAllocator *) mem.getSpecificData();
                delete allocator;
@@ -362,7 +381,12 @@ nanos::PE * smpProcessorFactory ( int id, int uid )
          }
          std::cerr << "Total IN bytes: " << total_in << std::endl;
          std::cerr << "Total OUT bytes: " << total_out << std::endl;
+         std::cerr << "Total evicted bytes: " << total_evicted << " (written back: " << total_written_back << ", policy: "
+                   << ( sys.getEvictionPolicy() != NULL ? sys.getEvictionPolicy()->getName() : "built-in" ) << ")" << std::endl;
+         std::cerr << "Total prefetched tasks: " << total_prefetched << std::endl;
+         std::cerr << "Total Xfer bandwidth: " << ( total_seconds > 0.0 ? total_copied / total_seconds / 1e6 : 0.0 ) << " MB/s" << std::endl;
       }
+      SMPCopyEngine::finiStats();
    }
 
    void SMPPlugin::addPEs( PEList &pes ) const
@@ -1036,6 +1060,14 @@ nanos::PE * smpProcessorFactory ( int id, int uid )
       return _asyncSMPTransfers;
    }
 
+   unsigned int SMPPlugin::getPrefetchedTasks() const {
+      unsigned int prefetched = 0;
+      for ( std::vector<SMPProcessor *>::const_iterator it = _cpus->begin(); it != _cpus->end(); it++ ) {
+         prefetched += (*it)->getPrefetchedTasks();
+      }
+      return prefetched;
+   }
+
 }
 }
 
@@ -206,6 +206,10 @@ class SMPPlugin : public SMPBasePlugin
     */
    virtual std::string getBindingMaskString() const;
 
+   /*! \brief Number of tasks whose copies were started ahead of their execution, over all the CPUs
+    */
+   virtual unsigned int getPrefetchedTasks() const;
+
 protected:
 
    void applyCpuMask ( std::map<unsigned int, BaseThread *> &workers );
@@ -32,12 +32,13 @@ using namespace nanos::ext;
 
 bool SMPProcessor::_useUserThreads = true;
 size_t SMPProcessor::_threadsStackSize = 0;
+unsigned int SMPProcessor::_prefetchDepth = 0;
 System::CachePolicyType SMPProcessor::_cachePolicy = System::DEFAULT;
 size_t SMPProcessor::_cacheDefaultSize = 1048580;
 
 SMPProcessor::SMPProcessor( int bindingId, memory_space_id_t memId, bool active, unsigned int numaNode, unsigned int socket ) :
    PE( &getSMPDevice(), memId, 0 /* always local node */, numaNode, true, socket, true ),
-   _bindingId( bindingId ), _reserved( false ), _active( active ), _futureThreads( 0 ) {}
+   _bindingId( bindingId ), _reserved( false ), _active( active ), _futureThreads( 0 ), _prefetchedTasks( 0 ) {}
 
 void SMPProcessor::prepareConfig ( Config &config )
 {
@@ -47,6 +48,11 @@ void SMPProcessor::prepareConfig ( Config &config )
    config.registerConfigOption ( "thread-stack-size", NEW Config::SizeVar( _threadsStackSize ), "Defines thread stack size" );
    config.registerArgOption( "thread-stack-size", "thread-stack-size" );
    config.registerEnvOption( "thread-stack-size", "OMP_STACKSIZE" );
+
+   config.registerConfigOption ( "smp-prefetch", NEW Config::UintVar( _prefetchDepth ),
+                                 "Defines the number of ready tasks whose copies are started ahead of their execution by every SMP thread with a private memory (defaults to 0)" );
+   config.registerArgOption( "smp-prefetch", "smp-prefetch" );
+   config.registerEnvOption( "smp-prefetch", "NX_SMP_PREFETCH" );
 }
 
 WorkDescriptor & SMPProcessor::getWorkerWD () const
@@ -89,6 +95,8 @@ BaseThread &SMPProcessor::createThread ( WorkDescriptor &helper, SMPMultiThread
    ensure( helper.canRunIn( getSMPDevice() ),"Incompatible worker thread" );
    SMPThread &th = *NEW SMPThread( helper, this, this );
    th.stackSize( _threadsStackSize ).useUserThreads( _useUserThreads );
+   // Only threads with a private memory have copies to start in advance
+   if ( getMemorySpaceId() != 0 ) th.setMaxPrefetch( _prefetchDepth );
 
    return th;
 }
@@ -25,6 +25,7 @@
 #include "processingelement_decl.hpp"
 
 #include "config.hpp"
+#include "atomic.hpp"
 
 // xlc/icc compilers require the next include to emit the vtable of WDDeque
 #include <wddeque.hpp>
@@ -40,12 +41,14 @@ namespace ext {
          // config variables
          static bool _useUserThreads;
          static size_t _threadsStackSize;
+         static unsigned int _prefetchDepth;
          static size_t _cacheDefaultSize;
          static System::CachePolicyType _cachePolicy;
          unsigned int _bindingId;
          bool _reserved;
          bool _active;
          unsigned int _futureThreads;
+         Atomic<unsigned int> _prefetchedTasks; //!< Tasks whose copies were started ahead of their execution by its threads
 
          // disable copy constructor and assignment operator
          SMPProcessor( const SMPProcessor &pe );
@@ -83,6 +86,8 @@ namespace ext {
          //virtual void* newGetAddressDependent( CopyData const &cd );
          void setNumFutureThreads( unsigned int nthreads );
          unsigned int getNumFutureThreads() const;
+         void increasePrefetchedTasks() { _prefetchedTasks++; }
+         unsigned int getPrefetchedTasks() const { return _prefetchedTasks.value(); }
    };
 
 } // namespace ext
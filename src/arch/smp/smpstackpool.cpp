@@ -0,0 +1,175 @@
+/*************************************************************************************/
+/*      Copyright 2015 Barcelona Supercomputing Center                               */
+/*                                                                                   */
+/*      This file is part of the NANOS++ library.                                    */
+/*                                                                                   */
+/*      NANOS++ is free software: you can redistribute it and/or modify              */
+/*      it under the terms of the GNU Lesser General Public License as published by  */
+/*      the Free Software Foundation, either version 3 of the License, or            */
+/*      (at your option) any later version.                                          */
+/*                                                                                   */
+/*      NANOS++ is distributed in the hope that it will be useful,                   */
+/*      but WITHOUT ANY WARRANTY; without even the implied warranty of               */
+/*      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                */
+/*      GNU Lesser General Public License for more details.                          */
+/*                                                                                   */
+/*      You should have received a copy of the GNU Lesser General Public License     */
+/*      along with NANOS++.  If not, see <http://www.gnu.org/licenses/>.             */
+/*************************************************************************************/
+
+#include "smpstackpool_decl.hpp"
+#include "lock.hpp"
+#include "debug.hpp"
+#include <sys/mman.h>
+#include <unistd.h>
+#include <string.h>
+#include <errno.h>
+#include <stdint.h>
+
+#ifndef MAP_NORESERVE
+#define MAP_NORESERVE 0
+#endif
+#ifndef MAP_STACK
+#define MAP_STACK 0
+#endif
+
+using namespace nanos;
+using namespace nanos::ext;
+
+namespace {
+   const int      localCacheSize = 4;   //!< Stacks kept in (and refilled to) the per-thread cache
+   const size_t   colourStep = 64;      //!< Offset between consecutive stack colours
+   //! \brief Per-thread cache of idle stacks (linked through the stacks themselves)
+   __thread void  *localStacks = NULL;
+   __thread int    localCount = 0;
+   __thread size_t localColour = 0;
+}
+
+// Options are static (and constant initialized) as they can be set before the pool is constructed
+int SMPStackPool::_guardPages = 1;
+int SMPStackPool::_highWater = 0;
+
+SMPStackPool::SMPStackPool () : _pageSize( (size_t) sysconf( _SC_PAGESIZE ) ), _free( NULL ), _idle( 0 ), _lock() {}
+
+void SMPStackPool::prepareConfig ( Config &config )
+{
+   config.registerConfigOption ( "smp-stack-guard-pages", NEW Config::IntegerVar( _guardPages ),
+                                 "Defines the number of guard pages below each SMP::task stack (0 disables them)" );
+   config.registerArgOption( "smp-stack-guard-pages", "smp-stack-guard-pages" );
+
+   config.registerConfigOption ( "smp-stack-pool-high-water", NEW Config::IntegerVar( _highWater ),
+                                 "Defines how many idle SMP::task stacks keep their memory committed (0: all of them)" );
+   config.registerArgOption( "smp-stack-pool-high-water", "smp-stack-pool-high-water" );
+}
+
+size_t SMPStackPool::getGuardSize () const
+{
+   return _guardPages > 0 ? _guardPages * _pageSize : 0;
+}
+
+size_t SMPStackPool::getMappedSize ( size_t stackSize ) const
+{
+   // One extra page leaves room for the colour offset
+   return ( ( stackSize + _pageSize - 1 ) / _pageSize + 1 ) * _pageSize + getGuardSize();
+}
+
+char * SMPStackPool::getPageStart ( void *stack ) const
+{
+   return (char *) ( (uintptr_t) stack & ~( (uintptr_t) _pageSize - 1 ) );
+}
+
+void * SMPStackPool::map ( size_t stackSize )
+{
+   size_t guard = getGuardSize();
+   char *base = (char *) mmap( NULL, getMappedSize( stackSize ), PROT_READ | PROT_WRITE,
+                               MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE | MAP_STACK, -1, 0 );
+   if ( base == MAP_FAILED ) fatal( "Cannot map a " << stackSize << " bytes stack: " << strerror( errno ) );
+
+   if ( guard > 0 && mprotect( base, guard, PROT_NONE ) != 0 )
+      fatal( "Cannot protect stack guard pages: " << strerror( errno ) );
+
+   // Stacks starting at the same page offset make the tops of all the stacks (where contexts
+   // are saved) compete for the same cache sets, so each new stack is shifted a bit
+   localColour = ( localColour + colourStep ) % _pageSize;
+
+   return base + guard + localColour;
+}
+
+void SMPStackPool::trim ( void *stack, size_t stackSize )
+{
+   // The first page holds the link to the next idle stack: releasing it would drop the link
+   char *start = getPageStart( stack ) + _pageSize;
+   char *end = getPageStart( stack ) + getMappedSize( stackSize ) - getGuardSize();
+   if ( end > start ) madvise( start, end - start, MADV_DONTNEED );
+}
+
+void SMPStackPool::pushGlobal ( FreeStack *first, int count, size_t stackSize )
+{
+   // The chain is already linked. Trimming is done before it is published, as once in the
+   // list another thread may already be using its stacks (the unlocked count is just a hint)
+   FreeStack *last = first;
+   int idle = _idle;
+   for ( FreeStack *node = first; node != NULL; node = node->_next ) {
+      if ( _highWater > 0 && ++idle > _highWater ) trim( node, stackSize );
+      last = node;
+   }
+
+   LockBlock_noinst guard( _lock );
+   last->_next = _free;
+   _free = first;
+   _idle += count;
+}
+
+SMPStackPool::FreeStack * SMPStackPool::takeGlobal ( int max, int &taken )
+{
+   taken = 0;
+
+   LockBlock_noinst guard( _lock );
+   FreeStack *head = _free;
+   FreeStack *last = NULL;
+   for ( FreeStack *node = head; node != NULL && taken < max; node = node->_next ) {
+      last = node;
+      taken++;
+   }
+   if ( last == NULL ) return NULL;
+
+   _free = last->_next;
+   last->_next = NULL;
+   _idle -= taken;
+   return head;
+}
+
+void * SMPStackPool::acquire ( size_t stackSize )
+{
+   FreeStack *stack = (FreeStack *) localStacks;
+   if ( stack == NULL ) {
+      // Refill this thread's cache with (at most) a cache worth of stacks
+      stack = takeGlobal( localCacheSize, localCount );
+      if ( stack == NULL ) return map( stackSize );
+   }
+
+   localStacks = stack->_next;
+   localCount--;
+   return stack;
+}
+
+void SMPStackPool::release ( void *stack, size_t stackSize )
+{
+   FreeStack *node = (FreeStack *) stack;
+   if ( localCount < localCacheSize ) {
+      node->_next = (FreeStack *) localStacks;
+      localStacks = node;
+      localCount++;
+   } else {
+      node->_next = NULL;
+      pushGlobal( node, 1, stackSize );
+   }
+}
+
+void SMPStackPool::flushLocal ( size_t stackSize )
+{
+   // The cached stacks are already chained: they are given back in one go
+   if ( localStacks != NULL ) pushGlobal( (FreeStack *) localStacks, localCount, stackSize );
+   localStacks = NULL;
+   localCount = 0;
+}
@@ -0,0 +1,96 @@
+/*************************************************************************************/
+/*      Copyright 2015 Barcelona Supercomputing Center                               */
+/*                                                                                   */
+/*      This file is part of the NANOS++ library.                                    */
+/*                                                                                   */
+/*      NANOS++ is free software: you can redistribute it and/or modify              */
+/*      it under the terms of the GNU Lesser General Public License as published by  */
+/*      the Free Software Foundation, either version 3 of the License, or            */
+/*      (at your option) any later version.                                          */
+/*                                                                                   */
+/*      NANOS++ is distributed in the hope that it will be useful,                   */
+/*      but WITHOUT ANY WARRANTY; without even the implied warranty of               */
+/*      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                */
+/*      GNU Lesser General Public License for more details.                          */
+/*                                                                                   */
+/*      You should have received a copy of the GNU Lesser General Public License     */
+/*      along with NANOS++.  If not, see <http://www.gnu.org/licenses/>.             */
+/*************************************************************************************/
+
+#ifndef _NANOS_SMP_STACK_POOL_DECL
+#define _NANOS_SMP_STACK_POOL_DECL
+
+#include <stddef.h>
+#include "lock_decl.hpp"
+#include "config.hpp"
+
+namespace nanos {
+namespace ext {
+
+   /*! \brief Pool of user-level thread stacks
+    *
+    *  Stacks are mmap'ed (so their pages are only committed when touched) and
+    *  optionally protected by guard pages at their lowest addresses, so a stack
+    *  overflow raises SIGSEGV instead of silently corrupting memory. Each stack
+    *  starts at a different offset within its first page (cache colouring).
+    *
+    *  Released stacks are kept in a small per-thread cache and, when it is full,
+    *  in a global list. The global list is protected by a lock that is only held
+    *  to link or unlink a few nodes: a thread which runs out of stacks takes at
+    *  most a cache worth of them, and a finishing thread gives its whole cache
+    *  back at once. Stacks stay in the list while others are refilling, so no
+    *  thread maps new stacks just because the list is being accessed.
+    *  Stacks released to the global list above the high-water mark (if any) give
+    *  their pages back to the OS (madvise DONTNEED) while keeping the mapping,
+    *  except for the first one, which holds the link to the next idle stack.
+    */
+   class SMPStackPool
+   {
+      private:
+         struct FreeStack {
+            FreeStack  *_next;
+         };
+
+         size_t                _pageSize;            //!< System page size
+         static int            _guardPages;          //!< Guard pages below each stack
+         static int            _highWater;           //!< Idle stacks in the global list keeping their pages
+         FreeStack            *_free;                //!< Global list of idle stacks
+         int                   _idle;                //!< Number of stacks in the global list
+         Lock                  _lock;                //!< Protects the global list
+
+         //! \brief Copy constructor (disabled)
+         SMPStackPool ( const SMPStackPool &p );
+         //! \brief Assignment operator (disabled)
+         const SMPStackPool & operator= ( const SMPStackPool &p );
+
+         size_t getGuardSize () const;
+         size_t getMappedSize ( size_t stackSize ) const;
+         char * getPageStart ( void *stack ) const;
+
+         //! \brief Maps a new stack (and its guard pages)
+         void * map ( size_t stackSize );
+         //! \brief Gives the pages of 'stack' (but the one holding its link) back to the OS
+         void trim ( void *stack, size_t stackSize );
+         //! \brief Pushes the chain of 'count' stacks starting at 'first' to the global list
+         void pushGlobal ( FreeStack *first, int count, size_t stackSize );
+         //! \brief Detaches up to 'max' stacks from the global list ('taken' returns how many)
+         FreeStack * takeGlobal ( int max, int &taken );
+
+      public:
+         SMPStackPool ();
+
+         //! \brief Registers the pool configuration options
+         static void prepareConfig ( Config &config );
+
+         //! \brief Returns a stack of 'stackSize' bytes (recycled if possible)
+         void * acquire ( size_t stackSize );
+         //! \brief Gives back a 'stack' obtained from acquire with the same 'stackSize'
+         void release ( void *stack, size_t stackSize );
+         //! \brief Moves the stacks cached by the calling thread to the global list
+         void flushLocal ( size_t stackSize );
+   };
+
+} // namespace ext
+} // namespace nanos
+
+#endif
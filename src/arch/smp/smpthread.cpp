@@ -160,6 +160,58 @@ void SMPThread::switchHelperDependent ( WD *oldWD, WD *newWD, void *oldState  )
    dd.setState( (intptr_t *) oldState );
 }
 
+WD * SMPThread::getNextWD ()
+{
+   if ( _prefetching ) return NULL;
+   WD *next = BaseThread::getNextWD();
+   // The scheduler goes to the ready queues next, tasks left there can be prefetched again
+   if ( next == NULL ) _prefetchYield = false;
+   return next;
+}
+
+void SMPThread::prefetchInputs ()
+{
+   if ( !canPrefetch() || _prefetchStall != NULL || _prefetchYield || getTeam() == NULL || !sys.getSchedulerConf().getSchedulerEnabled() ) return;
+
+   // Only ready tasks: the immediate successors given by atPrefetch still depend on the current one
+   _prefetching = true;
+   while ( canPrefetch() && _prefetchStall == NULL ) {
+      WD *next = getTeam()->getSchedulePolicy().atIdle( this, 0 );
+      if ( next == NULL ) break;
+
+      // Nothing to transfer ahead: leave it to whichever thread gets it first
+      if ( next->started() || next->getNumCopies() == 0 || next->_mcontrol.isMemoryAllocated() ) {
+         getTeam()->getSchedulePolicy().queue( this, *next );
+         _prefetchYield = true;
+         break;
+      }
+
+      next->_mcontrol.preInit();
+      next->_mcontrol.initialize( *runningOn() );
+      bool allocated = next->_mcontrol.allocateTaskMemory();
+      // An eviction started for this task must complete before any other allocation
+      while ( !allocated && next->_mcontrol.isInvalidating() ) {
+         processTransfers();
+         allocated = next->_mcontrol.allocateTaskMemory();
+      }
+      if ( allocated ) {
+         next->init();
+      } else {
+         _prefetchStall = next;
+      }
+      addNextWD( next );
+      ( (SMPProcessor *) runningOn() )->increasePrefetchedTasks();
+   }
+   _prefetching = false;
+}
+
+void SMPThread::preStartWorkDependent ( WD &wd )
+{
+   // Start the copies of the next tasks, they are transferred while this one waits for its own and runs
+   if ( &wd == _prefetchStall ) _prefetchStall = NULL;
+   prefetchInputs();
+}
+
 bool SMPThread::inlineWorkDependent ( WD &wd )
 {
    // Now the WD will be inminently run
@@ -38,16 +38,35 @@ namespace ext {
    {
       private:
          bool           _useUserThreads;
+         bool           _prefetching;   //!< Looking for tasks to prefetch, the next WD queue must be skipped
+         WD            *_prefetchStall; //!< Prefetched task that did not fit in the cache, no more are prefetched until it runs
+         bool           _prefetchYield; //!< A task without copies was left in the ready queues, no more are prefetched until the next WD queue is drained
          PThread        _pthread;
 
          // disable copy constructor and assignment operator
          SMPThread( const SMPThread &th );
          const SMPThread & operator= ( const SMPThread &th );
+
+         /*! \brief Takes ready tasks to run next and starts their copies
+          *
+          *  Up to the prefetch depth of the thread, tasks are taken from the ready queues and moved
+          *  to its next WD queue (so no other thread will run them), and their memory is allocated
+          *  and copies issued, so that transfers overlap with the execution of the current task.
+          *  Only tasks with copies are claimed: the first one without any is queued back, and prefetching
+          *  waits until this thread takes work from the ready queues again, so that it is not passed over twice.
+          *  A task that does not fit in the cache yet is queued anyway and allocated when it is run, and
+          *  prefetching stops until then: tasks queued behind it must not hold the memory it waits for.
+          */
+         void prefetchInputs();
         
       public:
          // constructor
          SMPThread( WD &w, PE *pe, SMPProcessor *core ) :
-               BaseThread( sys.getSMPPlugin()->getNewSMPThreadId(), w, pe, NULL ), _useUserThreads( true ), _pthread(core) {}
+               BaseThread( sys.getSMPPlugin()->getNewSMPThreadId(), w, pe, NULL ), _useUserThreads( true ), _prefetching( false ), _prefetchStall( NULL ), _prefetchYield( false ), _pthread(core)
+         {
+            // No prefetching unless the processor asks for it
+            setMaxPrefetch( 0 );
+         }
 
          // named parameter idiom
          SMPThread & stackSize( size_t size );
@@ -61,6 +80,7 @@ namespace ext {
          virtual void initializeDependent( void ) {}
          virtual void runDependent ( void );
 
+         virtual void preStartWorkDependent( WD &work );
          virtual bool inlineWorkDependent( WD &work );
          virtual void preOutlineWorkDependent( WD &work ) { fatal( "SMPThread does not support preOutlineWorkDependent()" ); }
          virtual void outlineWorkDependent( WD &work ) { fatal( "SMPThread does not support outlineWorkDependent()" ); }
@@ -72,6 +92,8 @@ namespace ext {
 
          virtual void idle( bool debug = false );
 
+         virtual WD * getNextWD();
+
          virtual void switchToNextThread() {
             fatal( "SMPThread does not support switchToNextThread()" );
          }
@@ -95,7 +117,7 @@ namespace ext {
          virtual void unlock() { _pthread.mutexUnlock(); }
          virtual void initMain() { _pthread.initMain(); };
          virtual void start() { _pthread.start( this ); }
-         virtual void finish() { _pthread.finish(); BaseThread::finish(); }
+         virtual void finish() { SMPDD::releaseThreadStacks(); _pthread.finish(); BaseThread::finish(); }
          virtual void join() { _pthread.join(); joined(); }
          virtual void bind() { _pthread.bind(); }
          /** \brief SMP specific yield implementation */
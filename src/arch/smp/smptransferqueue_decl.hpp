@@ -4,20 +4,23 @@
 #include <list>
 #include "atomic_decl.hpp"
 #include "deviceops_fwd.hpp"
+#include "nanos-int.h"
 
 namespace nanos {
 
 class SMPTransfer {
    DeviceOps   *_ops;
+   memory_space_id_t _memSpaceId;
    char        *_dst;
    char        *_src;
    std::size_t  _len;
    std::size_t  _count;
    std::size_t  _ld;
    bool         _in;
+   bool         _streaming;
    public:
    SMPTransfer();
-   SMPTransfer( DeviceOps *ops, char *dst, char *src, std::size_t len, std::size_t count, std::size_t ld, bool in );
+   SMPTransfer( DeviceOps *ops, memory_space_id_t memSpaceId, char *dst, char *src, std::size_t len, std::size_t count, std::size_t ld, bool in, bool streaming );
    SMPTransfer( SMPTransfer const &s );
    SMPTransfer &operator=( SMPTransfer const &s );
    ~SMPTransfer();
@@ -29,7 +32,10 @@ class SMPTransferQueue {
    std::list< SMPTransfer > _transfers;
    public:
    SMPTransferQueue();
-   void addTransfer( DeviceOps *ops, char *dst, char *src, std::size_t len, std::size_t count, std::size_t ld, bool in );
+   /*! \brief Queues a copy of 'count' rows of 'len' bytes, split in pieces that can be executed in parallel
+    *  'memSpaceId' is the private memory space involved, to which the copy is accounted.
+    */
+   void addTransfer( DeviceOps *ops, memory_space_id_t memSpaceId, char *dst, char *src, std::size_t len, std::size_t count, std::size_t ld, bool in );
    void tryExecuteOne();
 };
 
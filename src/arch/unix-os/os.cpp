@@ -22,6 +22,12 @@
 #include <stdlib.h>
 #include <unistd.h>
 #include <string.h>
+#include <sched.h>
+
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif
 
 #ifdef IS_BGQ_MACHINE
 #include <spi/include/kernel/location.h>
@@ -167,3 +173,38 @@ int OS::nanosleep ( unsigned long long nanoseconds )
    req.tv_nsec = (long) ( nanoseconds % 1000000000ULL );
    return ::nanosleep( &req, &rem );
 }
+
+#ifdef __linux__
+static inline void futex ( volatile int *address, int op, int value, const struct timespec *timeout )
+{
+   syscall( SYS_futex, address, op, value, timeout, NULL, 0 );
+}
+#endif
+
+void OS::futexWait ( volatile int *address, int value )
+{
+#ifdef __linux__
+   futex( address, FUTEX_WAIT_PRIVATE, value, NULL );
+#else
+   if ( *address == value ) sched_yield();
+#endif
+}
+
+void OS::futexWait ( volatile int *address, int value, unsigned long long nanoseconds )
+{
+#ifdef __linux__
+   struct timespec timeout;
+   timeout.tv_sec = (time_t) ( nanoseconds / 1000000000ULL );
+   timeout.tv_nsec = (long) ( nanoseconds % 1000000000ULL );
+   futex( address, FUTEX_WAIT_PRIVATE, value, &timeout );
+#else
+   if ( *address == value ) nanosleep( nanoseconds );
+#endif
+}
+
+void OS::futexWake ( volatile int *address, int count )
+{
+#ifdef __linux__
+   futex( address, FUTEX_WAKE_PRIVATE, count, NULL );
+#endif
+}
@@ -111,6 +111,17 @@ namespace nanos {
          static double getMonotonicTimeResolution ();
 
          static int nanosleep ( unsigned long long nanoseconds );
+
+         /*! \brief Blocks the calling thread while *address == value
+          *  Spurious returns are possible. Falls back to sched_yield where futexes are not available.
+          */
+         static void futexWait ( volatile int *address, int value );
+         /*! \brief Blocks the calling thread while *address == value, for at most 'nanoseconds'
+          *  Spurious returns are possible. Falls back to nanosleep where futexes are not available.
+          */
+         static void futexWait ( volatile int *address, int value, unsigned long long nanoseconds );
+         //! \brief Wakes up to 'count' threads blocked in futexWait on 'address'
+         static void futexWake ( volatile int *address, int count );
          
          static const InitList & getInitializationFunctions ( ) { return *_initList;}
          static const InitList & getPostInitializationFunctions ( ) { return *_postInitList;}
@@ -211,6 +211,8 @@ namespace nanos {
          virtual bool inlineWorkDependent (WD &work) = 0;
          virtual void switchTo( WD *work, SchedulerHelper *helper ) = 0;
          virtual void exitTo( WD *work, SchedulerHelper *helper ) = 0;
+         //! \brief Called once work has its memory allocated, right before it starts in this thread (inlined or as a user-level thread)
+         virtual void preStartWorkDependent( WD &work ) {}
 
       private:
          //! \brief BaseThread default constructor (private)
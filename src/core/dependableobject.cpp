@@ -35,7 +35,8 @@ void DependableObject::finished ( )
       TargetVector const &outs = depObj.getWrittenTargets();
       DependenciesDomain *domain = depObj.getDependenciesDomain();
       if ( domain != 0 && outs.size() > 0 ) {
-         SyncRecursiveLockBlock lock1( domain->getInstanceLock() ); // This is needed here to avoid a dead-lock
+         // This is needed here to avoid a dead-lock (unless the domain does not need it)
+         CondSyncRecursiveLockBlock lock1( domain->getInstanceLock(), domain->finishNeedsInstanceLock() );
          SyncLockBlock lock2( depObj.getLock() );
          for ( unsigned int i = 0; i < outs.size(); i++ ) {
             BaseDependency const &target = *outs[i];
@@ -148,7 +149,9 @@ void DependableObject::releaseReadDependencies ()
 
    //Decrease predecessor for sucessor tasks
    //Only decrease if they are NOT writing or reading something that we write
-   for ( DependableObject::DependableObjectVector::iterator currSucessorIt = succ.begin(); currSucessorIt != succ.end(); ) {
+   //The successors that stay are moved down over the removed ones, which are dropped at once at the end
+   DependableObject::DependableObjectVector::iterator keptSucessorIt = succ.begin();
+   for ( DependableObject::DependableObjectVector::iterator currSucessorIt = succ.begin(); currSucessorIt != succ.end(); currSucessorIt++ ) {
       DependableObject::TargetVector const &sucessorWrites = currSucessorIt->second->getWrittenTargets();
       DependableObject::TargetVector const &sucessorReads = currSucessorIt->second->getReadTargets();
       bool canRemovePredecessor=true;
@@ -170,13 +173,13 @@ void DependableObject::releaseReadDependencies ()
          //DependenciesDomain::decreaseTasksInGraph();
          NANOS_INSTRUMENT ( instrument ( *currSucessorIt->second ); ) 
          currSucessorIt->second->decreasePredecessors( NULL, this, false, false );
-         succ.erase(currSucessorIt++);
       }
       else 
       {
-         currSucessorIt++;
+         *keptSucessorIt++ = *currSucessorIt;
       }
    }
+   succ.erase( keptSucessorIt, succ.end() );
 }
 
 
@@ -194,7 +197,7 @@ DependableObject * DependableObject::releaseImmediateSuccessor ( DependableObjec
 
    {
       SyncLockBlock lock( this->getLock() );
-      // NOTE: it gets incremented in the erase
+      // NOTE: erase returns the next successor
       for ( DependableObject::DependableObjectVector::iterator it = succ.begin(); it != succ.end(); ) {
          // Is this an immediate successor? 
          if ( it->second->numPredecessors() == 1 && condition(*it->second) && !(it->second->waits()) ) {
@@ -202,7 +205,7 @@ DependableObject * DependableObject::releaseImmediateSuccessor ( DependableObjec
                // remove it
                found = it->second;
                unsigned int wdId = it->first;
-               succ.erase(it++);
+               it = succ.erase(it);
                if ( found->numPredecessors() != 1 ) {
                   incorrectlyErased.insert( std::make_pair( wdId, found ) );
                   found = NULL;
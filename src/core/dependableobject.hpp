@@ -26,6 +26,7 @@
 
 #include "atomic.hpp"
 #include "lock.hpp"
+#include "smallvector.hpp"
 
 #include "dependableobject_decl.hpp"
 #include "basedependency_decl.hpp"
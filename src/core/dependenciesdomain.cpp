@@ -52,4 +52,13 @@ void DependenciesDomain::decreaseTasksInGraph( size_t num )
    NANOS_INSTRUMENT(sys.getInstrumentation()->raisePointEvents(1, &key, (nanos_event_value_t *) &tasks );)
    NANOS_INSTRUMENT(unlock();)
 }
+void DependenciesDomain::submitDependableObjects ( size_t numObjects, DependableObject **depObjs, size_t *numDataAccesses,
+                                                   DataAccess **dataAccesses, SchedulePolicySuccessorFunctor* callback )
+{
+   SyncRecursiveLockBlock lock( getInstanceLock() );
+   for ( size_t i = 0; i < numObjects; i++ ) {
+      submitDependableObject( *depObjs[i], numDataAccesses[i], dataAccesses[i], callback );
+   }
+}
+
 } // namespace nanos
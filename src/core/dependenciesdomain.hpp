@@ -77,6 +77,8 @@ inline void DependenciesDomain::finalizeAllReductions ( void )
 
 inline void DependenciesDomain::clearDependenciesDomain ( void ) { }
 
+inline bool DependenciesDomain::finishNeedsInstanceLock ( void ) const { return true; }
+
 } // namespace nanos
 
 #endif
@@ -160,6 +160,20 @@ using namespace dependencies_domain_internal;
          *  \sa DataAccess DependableObject TrackableObject
          */
          virtual void submitDependableObject ( DependableObject &depObj, size_t numDataAccesses, DataAccess* dataAccesses, SchedulePolicySuccessorFunctor* callback = NULL ) = 0;
+
+        /*! \brief Adds a batch of DependableObjects to the domain's dependency system.
+         *
+         *  All the accesses of the batch are resolved holding the instance lock once, instead of
+         *  taking it for every new address. Objects are submitted in order, so dependencies among
+         *  the members of the batch are honoured as if they had been submitted one by one.
+         *  \param numObjects Number of DependableObjects in the batch.
+         *  \param depObjs Array of DependableObjects to be added to the domain.
+         *  \param numDataAccesses Number of data accesses of each DependableObject.
+         *  \param dataAccesses Data accesses of each DependableObject.
+         *  \param callback A function to call when a WD has a successor [Optional].
+         *  \sa submitDependableObject
+         */
+         virtual void submitDependableObjects ( size_t numObjects, DependableObject **depObjs, size_t *numDataAccesses, DataAccess **dataAccesses, SchedulePolicySuccessorFunctor* callback = NULL );
          
          /*! \}
           */
@@ -171,6 +185,13 @@ using namespace dependencies_domain_internal;
         /*! \brief Returns a reference to the instance lock
          */
          RecursiveLock& getInstanceLock();
+
+        /*! \brief Returns whether finishing DependableObjects must hold the instance lock
+         *
+         *  Domains whose lookups take the instance lock need it to be acquired before the
+         *  DependableObject lock (to avoid dead-locks). Domains with lock-free lookups may skip it.
+         */
+         virtual bool finishNeedsInstanceLock ( void ) const;
          
         /*! \brief returns a reference to the static lock
          */
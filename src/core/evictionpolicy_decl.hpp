@@ -0,0 +1,75 @@
+/*************************************************************************************/
+/*      Copyright 2015 Barcelona Supercomputing Center                               */
+/*                                                                                   */
+/*      This file is part of the NANOS++ library.                                    */
+/*                                                                                   */
+/*      NANOS++ is free software: you can redistribute it and/or modify              */
+/*      it under the terms of the GNU Lesser General Public License as published by  */
+/*      the Free Software Foundation, either version 3 of the License, or            */
+/*      (at your option) any later version.                                          */
+/*                                                                                   */
+/*      NANOS++ is distributed in the hope that it will be useful,                   */
+/*      but WITHOUT ANY WARRANTY; without even the implied warranty of               */
+/*      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                */
+/*      GNU Lesser General Public License for more details.                          */
+/*                                                                                   */
+/*      You should have received a copy of the GNU Lesser General Public License     */
+/*      along with NANOS++.  If not, see <http://www.gnu.org/licenses/>.             */
+/*************************************************************************************/
+
+#ifndef __NANOS_EVICTION_POLICY_DECL_H
+#define __NANOS_EVICTION_POLICY_DECL_H
+
+#include <string>
+#include "regioncache_fwd.hpp"
+
+namespace nanos {
+
+   /*! \brief Victim selection of the region caches (loaded as an "evict-<name>" plugin)
+    *
+    *  When a cache runs out of memory, the chunks that are not referenced by any task are
+    *  ranked by their eviction cost: the cheapest chunk of the needed size is evicted or, if
+    *  there is none, the contiguous set of chunks with the least combined cost (see
+    *  getWindowCost).
+    *  Without a policy the cache keeps its built-in heuristic (clean chunks first).
+    */
+   class EvictionPolicy
+   {
+      private:
+         std::string _name;
+
+         /*! \brief EvictionPolicy copy constructor (private)
+          */
+         EvictionPolicy( const EvictionPolicy & );
+         /*! \brief EvictionPolicy copy assignment opeator (private)
+          */
+         const EvictionPolicy & operator=( const EvictionPolicy & );
+      public:
+         /*! \brief EvictionPolicy constructor
+          */
+         EvictionPolicy( const std::string &name ) : _name( name ) {}
+         /*! \brief EvictionPolicy destructor
+          */
+         virtual ~EvictionPolicy() {}
+
+         const std::string & getName() const { return _name; }
+
+         /*! \brief Cost (not negative) of evicting 'chunk'
+          *  'now' is the access clock of its cache (see AllocatedChunk::getLastUse).
+          */
+         virtual double getEvictionCost( AllocatedChunk const &chunk, unsigned int now ) const = 0;
+
+         /*! \brief Cost of a set of contiguous chunks costing 'windowCost' once 'chunkCost' is added
+          *  Costs add up by default.
+          */
+         virtual double getWindowCost( double windowCost, double chunkCost ) const { return windowCost + chunkCost; }
+
+         /*! \brief Use count to keep for a chunk accessed again after 'idle' accesses to its cache
+          *  Policies that age the use counts apply it here, so that the stored count stays current.
+          */
+         virtual unsigned int getAgedUseCount( unsigned int uses, unsigned int idle ) const { return uses; }
+   };
+
+} // namespace nanos
+
+#endif
@@ -435,6 +435,7 @@ namespace nanos {
             registerEventValue("api","get_num_nonready_tasks","nanos_get_num_nonready_tasks()");
             registerEventValue("api","get_num_blocked_tasks","nanos_get_num_blocked_tasks()");
             registerEventValue("api","get_num_running_tasks","nanos_get_num_running_tasks()");
+            registerEventValue("api","get_num_prefetched_tasks","nanos_get_num_prefetched_tasks()");
             registerEventValue("api","dependence_pendant_writes","nanos_dependence_pendant_writes()");
             registerEventValue("api","in_final","nanos_in_final()");
             registerEventValue("api","set_final","nanos_set_final()");
@@ -674,6 +675,11 @@ namespace nanos {
             /* 70 */ registerEventKey("network-transfer", "Network transfer to node ", false, EVENT_ADVANCED);
             /* 71 */ registerEventKey("cache-evict", "Cache eviction", false, EVENT_ADVANCED);
             /* 72 */ registerEventKey("copy-data-alloc","Cache allocation", false, EVENT_ADVANCED);
+            /* 73 */ registerEventKey("lock-wait","Time waiting on a contended user lock (in nsecs)", true, EVENT_DEVELOPER );
+            /* 74 */ registerEventKey("lock-hold","Time a user lock was held (in nsecs)", true, EVENT_DEVELOPER );
+            /* 75 */ registerEventKey("throttle-cutoff","Adaptive throttle: maximum number of live tasks", true, EVENT_ADVANCED );
+            /* 76 */ registerEventKey("throttle-granularity","Adaptive throttle: measured task granularity (in nsecs)", true, EVENT_ADVANCED );
+            /* 77 */ registerEventKey("throttle-pending-bytes","Adaptive throttle: memory used by live tasks (in bytes)", true, EVENT_ADVANCED );
 
             /* ** */ registerEventKey("debug","Debug Key", true, EVENT_ADVANCED ); /* Keep this key as the last one */
          }
@@ -1076,6 +1082,15 @@ namespace nanos {
           */
          virtual void wdCreate( WorkDescriptor* newWD );
 
+         /*! \brief Used when a work descriptor has just been created by the user (wdCreate is called later,
+          *         when the work descriptor is initialized to run)
+          */
+         virtual void wdCreated( WorkDescriptor* wd ) {}
+
+         /*! \brief Used when a work descriptor is submitted to the scheduler (it is ready to run)
+          */
+         virtual void wdReady( WorkDescriptor* wd ) {}
+
          /*! \brief Flush the deferred events (if any) of the given work descriptor
           *
           *  \param[in] wd, this work descriptor's deferred events will be flushed
@@ -53,6 +53,10 @@ namespace nanos {
          EventList                  _burstBackup;            /**< Backup list (non-active) of opened bursts */
          EventList                  _deferredEvents;         /**< List of deferred events */
          Lock                       _deferredEventsLock;     /**< Lock in deferred event list */
+         unsigned long long         _creationTime;           /**< Creation time (set by profiling plugins) */
+         unsigned long long         _readyTime;              /**< Ready time (set by profiling plugins) */
+         int                        _creator;                /**< Creator thread id (set by profiling plugins) */
+         unsigned long long         _startTime;              /**< Execution start time (set by profiling plugins) */
       private:
          /*! \brief InstrumentationContextData copy assignment operator (private)
           */
@@ -61,15 +65,18 @@ namespace nanos {
          /*! \brief InstrumentationContextData copy constructor
           */
          explicit InstrumentationContextData(const InstrumentationContextData &icd) : _startingWD(false), _stateStack(),
-                  _stateEventEnabled(icd._stateEventEnabled), _burstList(), _burstBackup(), _deferredEvents(), _deferredEventsLock() {}
+                  _stateEventEnabled(icd._stateEventEnabled), _burstList(), _burstBackup(), _deferredEvents(), _deferredEventsLock(),
+                  _creationTime(0), _readyTime(0), _creator(-1), _startTime(0) {}
          /*! \brief InstrumentationContextData copy constructor
           */
          explicit InstrumentationContextData(const InstrumentationContextData *icd) : _startingWD(false), _stateStack(),
-                  _stateEventEnabled(icd->_stateEventEnabled), _burstList(), _burstBackup(), _deferredEvents(), _deferredEventsLock() {}
+                  _stateEventEnabled(icd->_stateEventEnabled), _burstList(), _burstBackup(), _deferredEvents(), _deferredEventsLock(),
+                  _creationTime(0), _readyTime(0), _creator(-1), _startTime(0) {}
          /*! \brief InstrumentationContextData default constructor
           */
          InstrumentationContextData() : _startingWD(false), _stateStack(),
-                   _stateEventEnabled(true), _burstList(), _burstBackup(), _deferredEvents(), _deferredEventsLock() { }
+                   _stateEventEnabled(true), _burstList(), _burstBackup(), _deferredEvents(), _deferredEventsLock(),
+                   _creationTime(0), _readyTime(0), _creator(-1), _startTime(0) { }
          /*! \brief InstrumentationContextData destructor
           */
          ~InstrumentationContextData() {}
@@ -79,6 +86,19 @@ namespace nanos {
          /*! \brief Sets _startingWD attribute
           */
          bool getStartingWD ( void ) { return _startingWD; }
+         /*! \brief Records when and by which thread the WD was created
+          */
+         void setCreation ( unsigned long long time, int creator ) { _creationTime = time; _creator = creator; }
+         unsigned long long getCreationTime ( void ) const { return _creationTime; }
+         int getCreator ( void ) const { return _creator; }
+         /*! \brief Records when the WD became ready (0 if it never went through the scheduler)
+          */
+         void setReadyTime ( unsigned long long time ) { _readyTime = time; }
+         unsigned long long getReadyTime ( void ) const { return _readyTime; }
+         /*! \brief Records when the WD started its execution (0 if it is not running)
+          */
+         void setStartTime ( unsigned long long time ) { _startTime = time; }
+         unsigned long long getStartTime ( void ) const { return _startTime; }
 #else
       private:
          /*! \brief InstrumentationContextData copy constructor (private)
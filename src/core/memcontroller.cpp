@@ -570,6 +570,10 @@ bool MemController::isMemoryAllocated() const {
    return _memoryAllocated;
 }
 
+bool MemController::isInvalidating() const {
+   return _invalidating;
+}
+
 void MemController::setCacheMetaData() {
    for ( unsigned int index = 0; index < _wd->getNumCopies(); index++ ) {
       if ( _wd->getCopies()[index].isOutput() ) {
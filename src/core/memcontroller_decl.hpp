@@ -83,6 +83,7 @@ public:
    void synchronize();
    void synchronize( std::size_t numDataAccesses, DataAccess *data);
    bool isMemoryAllocated() const;
+   bool isInvalidating() const;
    void setCacheMetaData();
    bool ownsRegion( global_reg_t const &reg );
    bool hasObjectOfRegion( global_reg_t const &reg );
@@ -314,7 +314,7 @@ typedef struct {
 } nanos_event_t;
 
 /* Lock C interface */
-typedef enum { NANOS_LOCK_FREE = 0, NANOS_LOCK_BUSY = 1 } nanos_lock_state_t;
+typedef enum { NANOS_LOCK_FREE = 0, NANOS_LOCK_BUSY = 1, NANOS_LOCK_CONTENDED = 2 } nanos_lock_state_t;
 typedef struct nanos_lock_t {
 #ifdef HAVE_NEW_GCC_ATOMIC_OPS
    nanos_lock_state_t state_;
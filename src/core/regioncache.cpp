@@ -38,6 +38,7 @@
 #include "regiondict.hpp"
 #include "memoryops_decl.hpp"
 #include "globalregt.hpp"
+#include "evictionpolicy_decl.hpp"
 
 #define VERBOSE_DEV_OPS ( sys.getVerboseDevOps() )
 #define VERBOSE_INVAL 0
@@ -82,6 +83,8 @@ AllocatedChunk::AllocatedChunk( RegionCache &owner, uint64_t addr, uint64_t host
    _dirty( false ),
    _rooted( rooted ),
    _lruStamp( 0 ),
+   _lastUse( owner.getAccessClock() ),
+   _uses( 0 ),
    _refs( 0 ),
    _refWdId(),
    _refLoc(),
@@ -102,6 +105,16 @@ AllocatedChunk::~AllocatedChunk() {
    delete _newRegions;
 }
 
+void AllocatedChunk::recordUse() {
+   // Only the policies read the use data: without one the shared access clock is not touched
+   EvictionPolicy *policy = sys.getEvictionPolicy();
+   if ( policy == NULL ) return;
+   unsigned int now = _owner.nextAccessTime();
+   _uses = policy->getAgedUseCount( _uses, now - _lastUse );
+   _lastUse = now;
+   _uses += 1;
+}
+
 void AllocatedChunk::makeFlushable() {
    _flushable = true;
 }
@@ -761,6 +774,26 @@ AllocatedChunk **RegionCache::selectChunkToInvalidate( std::size_t allocSize ) {
    MemoryMap<AllocatedChunk>::iterator it;
    bool done = false;
    int count = 0;
+   EvictionPolicy *policy = sys.getEvictionPolicy();
+   if ( policy != NULL ) {
+      // The cheapest chunk of the same size
+      unsigned int now = getAccessClock();
+      double min_cost = 0.0;
+      for ( it = _chunks.begin(); it != _chunks.end(); it++ ) {
+         if ( it->second != NULL && (it->second != (AllocatedChunk *) -1)
+               && (it->second != (AllocatedChunk *) -2)
+               && it->second->getReferenceCount() == 0
+               && !(it->second->isRooted())
+               && it->second->getSize() == allocSize ) {
+            double cost = policy->getEvictionCost( *(it->second), now );
+            if ( allocChunkPtrPtr == NULL || cost < min_cost ) {
+               allocChunkPtrPtr = &(it->second);
+               min_cost = cost;
+            }
+         }
+      }
+      return allocChunkPtrPtr;
+   }
    //for ( it = _chunks.begin(); it != _chunks.end() && !done; it++ ) {
    //   *myThread->_file << "["<< count << "] this chunk: " << ((void *) it->second) << " refs: " << (int)( (it->second != NULL) ? it->second->getReferenceCount() : -1 ) << " dirty? " << (int)( (it->second != NULL) ? it->second->isDirty() : -1 )<< std::endl;
    //   count++;
@@ -863,6 +896,8 @@ void RegionCache::selectChunksToInvalidate( std::size_t allocSize, std::set< std
       MemoryMap<AllocatedChunk>::iterator it;
       bool done = false;
       MemoryMap< uint64_t > device_mem;
+      EvictionPolicy *policy = sys.getEvictionPolicy();
+      unsigned int now = getAccessClock();
 
       for ( it = _chunks.begin(); it != _chunks.end() && !done; it++ ) {
          // if ( it->second != NULL ) {
@@ -907,14 +942,17 @@ void RegionCache::selectChunksToInvalidate( std::size_t allocSize, std::set< std
             }
          }
       }
-      std::map< std::size_t, std::list< MemoryMap< uint64_t >::iterator > > candidates;
+      // Cost of every window of contiguous space: the bytes to write back, or the costs of the policy
+      std::map< double, std::list< MemoryMap< uint64_t >::iterator > > candidates;
 
       for ( devIt = device_mem.begin(); devIt != device_mem.end(); devIt++ ) {
          std::size_t len = devIt->first.getLength();
          uint64_t addr = devIt->first.getAddress();
-         std::size_t num_chunks = 0;
+         double num_chunks = 0;
          if ( devIt->second != 0 ) {
-            num_chunks += (*((AllocatedChunk **)(devIt->second)))->isDirty() ? devIt->first.getLength() : 0;
+            AllocatedChunk &c = **((AllocatedChunk **)(devIt->second));
+            if ( policy != NULL ) num_chunks = policy->getWindowCost( num_chunks, policy->getEvictionCost( c, now ) );
+            else num_chunks += c.isDirty() ? devIt->first.getLength() : 0;
          }
          devItAhead = devIt;
          devItAhead++;
@@ -923,7 +961,9 @@ void RegionCache::selectChunksToInvalidate( std::size_t allocSize, std::set< std
             if ( addr + len == devItAhead->first.getAddress() ) {
                len += devItAhead->first.getLength();
                if ( devItAhead->second != 0 ) {
-                  num_chunks += (*((AllocatedChunk **)(devItAhead->second)))->isDirty() ? devItAhead->first.getLength() : 0;
+                  AllocatedChunk &c = **((AllocatedChunk **)(devItAhead->second));
+                  if ( policy != NULL ) num_chunks = policy->getWindowCost( num_chunks, policy->getEvictionCost( c, now ) );
+                  else num_chunks += c.isDirty() ? devItAhead->first.getLength() : 0;
                }
                devItAhead++;
             } else {
@@ -1050,6 +1090,7 @@ AllocatedChunk *RegionCache::tryGetAddress( global_reg_t const &reg, WD const &w
    if ( allocChunkPtr != NULL ) {
       if ( allocChunkPtr->trylock() ) {
          allocChunkPtr->addReference( wd , 6); //tryGetAddress
+         allocChunkPtr->recordUse();
       } else {
          allocChunkPtr = NULL;
       }
@@ -1075,6 +1116,7 @@ AllocatedChunk *RegionCache::invalidate( LockedObjects &srcRegions, Invalidation
       invalControl._invalOps = NEW SeparateAddressSpaceOutOps( myThread->runningOn(), true, true );
       invalControl._chunksToInval.insert( std::make_pair( allocChunkPtrPtr, allocChunkPtr ) );
       allocChunkPtr->addReference( wd, 22 ); //invalidate, single chunk
+      increaseEvictions( *allocChunkPtr );
       bool hard_inval = allocChunkPtr->invalidate( this, srcRegions, wd, copyIdx, *invalControl._invalOps, invalControl._regions_to_remove_access );
       if ( hard_inval ) {
          invalControl._hardInvalidationCount++;
@@ -1120,6 +1162,7 @@ AllocatedChunk *RegionCache::invalidate( LockedObjects &srcRegions, Invalidation
          AllocatedChunk **chunkPtr = it->first;
          AllocatedChunk *chunk = *chunkPtr;
          chunk->addReference( wd, 23 ); //invalidate, multi chunk
+         increaseEvictions( *chunk );
          if ( chunk->invalidate( this, srcRegions, wd, copyIdx, *invalControl._invalOps, invalControl._regions_to_remove_access ) ) {
             invalControl._hardInvalidationCount++;
          } else {
@@ -1209,6 +1252,7 @@ AllocatedChunk *RegionCache::getOrCreateChunk( LockedObjects &srcRegions, global
             allocChunkPtr = *(results.front().second);
             this->addToAllocatedRegionMap( allocatedRegion );
             allocChunkPtr->addReference( wd, 4 ); //getOrCreateChunk, invalidated
+            allocChunkPtr->recordUse();
             allocChunkPtr->lock();
             //*(results.front().second) = allocChunkPtr;
          }
@@ -1219,6 +1263,7 @@ AllocatedChunk *RegionCache::getOrCreateChunk( LockedObjects &srcRegions, global
             if ( results.front().first->getLength() + results.front().first->getAddress() >= (targetHostAddr + allocSize) ) {
                allocChunkPtr = *(results.front().second);
                allocChunkPtr->addReference( wd, 5 ); //getOrCreateChunk, hit
+               allocChunkPtr->recordUse();
                allocChunkPtr->lock();
             } else {
                *myThread->_file << "I need a realloc of an allocated chunk!" << std::endl;
@@ -1361,6 +1406,9 @@ RegionCache::RegionCache( memory_space_id_t memSpaceId, Device &cacheArch, enum
    _lruTime( 0 ),
    _softInvalidationCount( 0 ),
    _hardInvalidationCount( 0 ),
+   _accessClock( 0 ),
+   _evictedChunks( 0 ),
+   _evictedBytes( 0 ),
    _inBytes( 0 ),
    _outBytes( 0 ),
    _outRepalcementBytes( 0 ),
@@ -84,6 +84,14 @@ inline void AllocatedChunk::increaseLruStamp() {
    _lruStamp += 1;
 }
 
+inline unsigned int AllocatedChunk::getLastUse() const {
+   return _lastUse;
+}
+
+inline unsigned int AllocatedChunk::getUseCount() const {
+   return _uses;
+}
+
 inline global_reg_t AllocatedChunk::getAllocatedRegion() const {
    return _allocatedRegion;
 }
@@ -108,6 +116,14 @@ inline void RegionCache::increaseLruTime() {
    _lruTime += 1;
 }
 
+inline unsigned int RegionCache::getAccessClock() const {
+   return _accessClock.value();
+}
+
+inline unsigned int RegionCache::nextAccessTime() {
+   return ++_accessClock;
+}
+
 inline unsigned int RegionCache::getSoftInvalidationCount() const {
    return _softInvalidationCount.value();
 }
@@ -124,6 +140,19 @@ inline void RegionCache::increaseHardInvalidationCount(unsigned int v) {
    _hardInvalidationCount += v;
 }
 
+inline unsigned int RegionCache::getEvictedChunks() const {
+   return _evictedChunks.value();
+}
+
+inline std::size_t RegionCache::getEvictedBytes() const {
+   return _evictedBytes.value();
+}
+
+inline void RegionCache::increaseEvictions( AllocatedChunk const &chunk ) {
+   _evictedChunks++;
+   _evictedBytes += chunk.getSize();
+}
+
 inline void RegionCache::increaseTransferredInData(size_t bytes) {
    _inBytes += bytes;
 
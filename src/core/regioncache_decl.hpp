@@ -61,6 +61,8 @@ namespace nanos {
          bool                              _dirty;
          bool                              _rooted;
          unsigned int                      _lruStamp;
+         unsigned int                      _lastUse;     //!< Access clock of the owner at the last task access
+         unsigned int                      _uses;        //!< Task accesses (approximate: updated without locking)
          Atomic<unsigned int>              _refs;
          std::map<WD const *, unsigned int>      _refWdId;
          std::map<int, std::set<int> >     _refLoc;
@@ -81,6 +83,10 @@ namespace nanos {
          bool isDirty() const;
          unsigned int getLruStamp() const;
          void increaseLruStamp();
+         unsigned int getLastUse() const;
+         unsigned int getUseCount() const;
+         //! \brief Records an access of a task, for the eviction policy
+         void recordUse();
          void setHostAddress( uint64_t addr );
 
          void clearRegions();
@@ -133,6 +139,9 @@ namespace nanos {
          unsigned int               _lruTime;
          Atomic<unsigned int>       _softInvalidationCount;
          Atomic<unsigned int>       _hardInvalidationCount;
+         Atomic<unsigned int>       _accessClock;         //!< Ticks on every task access to a chunk
+         Atomic<unsigned int>       _evictedChunks;
+         Atomic<std::size_t>        _evictedBytes;
          Atomic<std::size_t>        _inBytes;
          Atomic<std::size_t>        _outBytes;
          Atomic<std::size_t>        _outRepalcementBytes;
@@ -212,6 +221,8 @@ namespace nanos {
          unsigned int getNodeNumber() const;
          unsigned int getLruTime() const;
          void increaseLruTime();
+         unsigned int getAccessClock() const;
+         unsigned int nextAccessTime();
 
          unsigned int getVersion( global_reg_t const &hostMem, WD const &wd, unsigned int copyIdx );
          //void releaseRegion( global_reg_t const &hostMem, WD const &wd, unsigned int copyIdx, enum CachePolicy policy );
@@ -224,6 +235,9 @@ namespace nanos {
          void increaseSoftInvalidationCount(unsigned int v);
          unsigned int getHardInvalidationCount() const;
          void increaseHardInvalidationCount(unsigned int v);
+         unsigned int getEvictedChunks() const;
+         std::size_t getEvictedBytes() const;
+         void increaseEvictions( AllocatedChunk const &chunk );
          bool canAllocateMemory( MemCacheCopy *memCopies, unsigned int numCopies, bool considerInvalidations, WD const &wd );
          bool canInvalidateToFit( std::size_t *sizes, unsigned int numChunks ) const;
          std::size_t getAllocatableSize( global_reg_t const &reg ) const;
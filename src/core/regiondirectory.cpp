@@ -79,9 +79,57 @@ RegionDirectory::HashBucket::~HashBucket() { }
 
 #define HASH_BUCKETS 256
 
+namespace {
+   /*! \brief Per-thread cache of objectAddr -> GlobalRegionDictionary lookups
+    *
+    *  Direct mapped. An entry is only valid for the directory and epoch it was filled with:
+    *  unregistering objects (or destroying a directory) bumps the epoch, which discards the
+    *  entries of every thread at once.
+    */
+   struct DirectoryLookupCacheEntry {
+      RegionDirectory const   *directory;
+      uint64_t                 address;
+      std::size_t              size;
+      unsigned int             epoch;
+      GlobalRegionDictionary  *dict;
+   };
+
+   const unsigned int directoryLookupCacheSize = 256; //!< Must be a power of two
+   Atomic<unsigned int> directoryEpoch; //!< Zero initialized, as lookups may happen during static construction
+   __thread DirectoryLookupCacheEntry directoryLookupCache[directoryLookupCacheSize];
+
+   inline DirectoryLookupCacheEntry &getLookupCacheEntry( uint64_t objectAddr )
+   {
+      // Objects are usually aligned, so low bits are skipped and high bits folded in
+      return directoryLookupCache[ ( ( objectAddr >> 4 ) ^ ( objectAddr >> 16 ) ) & ( directoryLookupCacheSize - 1 ) ];
+   }
+}
+
 RegionDirectory::RegionDirectory() : _keys(), _keysSeed( 1 ),
    _keysLock(), _objects( HASH_BUCKETS, HashBucket() ) {}
 
+GlobalRegionDictionary *RegionDirectory::lookupCachedDictionary( uint64_t objectAddr, std::size_t objectSize ) const {
+   DirectoryLookupCacheEntry const &entry = getLookupCacheEntry( objectAddr );
+   if ( entry.directory == this && entry.address == objectAddr && entry.size == objectSize &&
+         entry.epoch == directoryEpoch.value() ) {
+      return entry.dict;
+   }
+   return NULL;
+}
+
+void RegionDirectory::cacheDictionary( uint64_t objectAddr, std::size_t objectSize, unsigned int epoch, GlobalRegionDictionary *dict ) const {
+   DirectoryLookupCacheEntry &entry = getLookupCacheEntry( objectAddr );
+   entry.directory = this;
+   entry.address = objectAddr;
+   entry.size = objectSize;
+   entry.epoch = epoch;
+   entry.dict = dict;
+}
+
+void RegionDirectory::invalidateLookupCaches() {
+   directoryEpoch++;
+}
+
 uint64_t RegionDirectory::_getKey( uint64_t addr, std::size_t len, WD const *wd ) {
    bool exact;
    while ( !_keysLock.tryAcquire() ) {
@@ -110,13 +158,19 @@ uint64_t RegionDirectory::_getKey( uint64_t addr ) const {
 GlobalRegionDictionary *RegionDirectory::getRegionDictionaryRegisterIfNeeded( CopyData const &cd, WD const *wd ) {
    uint64_t objectAddr = ( cd.getHostBaseAddress() == 0 ? ( uint64_t ) cd.getBaseAddress() : cd.getHostBaseAddress() );
    std::size_t objectSize = cd.getMaxSize();
+
+   // Repeated accesses to an object skip the keys map and the bucket lock
+   GlobalRegionDictionary *dict = lookupCachedDictionary( objectAddr, objectSize );
+   if ( dict != NULL ) return dict;
+   // Read before the lookup, so an entry filled while objects are unregistered is never valid
+   unsigned int epoch = directoryEpoch.value();
+
 #if 0
    unsigned int key = ( jen_hash( objectAddr ) & (HASH_BUCKETS-1) );
 #else
    uint64_t key = jen_hash( this->_getKey( objectAddr, objectSize, wd ) ) & (HASH_BUCKETS-1);
 #endif
    HashBucket &hb = _objects[ key ];
-   GlobalRegionDictionary *dict = NULL;
 
    while ( !hb._lock.tryAcquire() ) {
       myThread->processTransfers();
@@ -164,6 +218,7 @@ GlobalRegionDictionary *RegionDirectory::getRegionDictionaryRegisterIfNeeded( Co
       fatal("Unable to register prorgam object: " << cd );
    }
    hb._lock.release();
+   cacheDictionary( objectAddr, objectSize, epoch, dict );
    return dict;
 }
 
@@ -322,6 +377,8 @@ void RegionDirectory::_invalidateObjectsFromDevices( std::map< uint64_t, MemoryM
 }
 
 RegionDirectory::~RegionDirectory() {
+   // Another directory could be created at the same address
+   invalidateLookupCaches();
    for ( std::vector< HashBucket >::iterator bit = _objects.begin(); bit != _objects.end(); bit++ ) {
       HashBucket &hb = *bit;
       delete hb._bobjects;
@@ -329,6 +386,7 @@ RegionDirectory::~RegionDirectory() {
 }
 
 void RegionDirectory::_unregisterObjects( std::map< uint64_t, MemoryMap< Object > * > &objects ) {
+   if ( objects.empty() ) return;
    for ( std::map< uint64_t, MemoryMap< Object > * >::iterator it = objects.begin(); it != objects.end(); it++ ) {
       Object *o = it->second->getExactByAddress(it->first);
       sys.getNetwork()->deleteDirectoryObject( o->getGlobalRegionDictionary() );
@@ -357,6 +415,8 @@ void RegionDirectory::_unregisterObjects( std::map< uint64_t, MemoryMap< Object
          delete o;
       }
    }
+   // Lookups started before this point cached the dictionaries with the previous epoch
+   invalidateLookupCaches();
 }
 
 void RegionDirectory::synchronize( WD &wd, void *addr ) {
@@ -877,6 +937,7 @@ void RegionDirectory::unregisterObject(void *baseAddr) {
          printBt( *(myThread->_file) );
          fatal("can not continue");
       } else {
+         invalidateLookupCaches();
          delete o;
          hb._bobjects->eraseByAddress( (uint64_t) baseAddr );
          _keys.eraseByAddress( (uint64_t) baseAddr );
@@ -155,6 +155,9 @@ namespace nanos {
          GlobalRegionDictionary *getRegionDictionaryRegisterIfNeeded( CopyData const &cd, WD const *wd );
          GlobalRegionDictionary *getRegionDictionary( CopyData const &cd );
          GlobalRegionDictionary *getRegionDictionary( uint64_t addr, bool canFail );
+         GlobalRegionDictionary *lookupCachedDictionary( uint64_t objectAddr, std::size_t objectSize ) const;
+         void cacheDictionary( uint64_t objectAddr, std::size_t objectSize, unsigned int epoch, GlobalRegionDictionary *dict ) const;
+         static void invalidateLookupCaches();
          static void addSubRegion( GlobalRegionDictionary &dict, std::list< std::pair< reg_t, reg_t > > &partsList, reg_t regionToInsert );
          uint64_t _getKey( uint64_t addr, std::size_t len, WD const *wd );
          uint64_t _getKey( uint64_t addr ) const;
@@ -73,6 +73,7 @@ void Scheduler::_submit ( WD &wd, bool force_queue )
 
    wd.submitted();
    wd.setReady();
+   NANOS_INSTRUMENT ( sys.getInstrumentation()->wdReady( &wd ) );
 
    /* handle tied tasks */
    BaseThread *wd_tiedto = wd.isTiedTo();
@@ -81,6 +82,7 @@ void Scheduler::_submit ( WD &wd, bool force_queue )
          wd_tiedto->addNextWD( &wd );
       } else {
          wd_tiedto->getTeam()->getSchedulePolicy().queue( wd_tiedto, wd );
+         sys.getThreadManager()->wakeUpIdleThreads( 1 );
       }
       return;
    }
@@ -100,6 +102,7 @@ void Scheduler::_submit ( WD &wd, bool force_queue )
       * it in our scheduler system. Global ready task queue will take care about task/thread
       * architecture, while local ready task queue will wait until stealing. */
       mythread->getTeam()->getSchedulePolicy().queue( mythread, wd );
+      thread_manager->wakeUpIdleThreads( 1 );
 
       return;
    }
@@ -129,6 +132,9 @@ void Scheduler::_submit ( WD &wd, bool force_queue )
 
       }
       switchTo ( slice );
+   } else {
+      // The policy has queued the task
+      thread_manager->wakeUpIdleThreads( 1 );
    }
 
 }
@@ -157,6 +163,9 @@ void Scheduler::_submit ( WD ** wds, size_t numElems )
    {
       WD* wd = wds[i];
       wd->_mcontrol.preInit();
+      wd->submitted();
+      wd->setReady();
+      NANOS_INSTRUMENT ( sys.getInstrumentation()->wdReady( wd ) );
       
       // If the wd is tied to anyone
       BaseThread *wd_tiedto = wd->isTiedTo();
@@ -177,6 +186,7 @@ void Scheduler::_submit ( WD ** wds, size_t numElems )
    
    // Call the scheduling policy
    mythread->getTeam()->getSchedulePolicy().queue( threadList, wds, numElems );
+   sys.getThreadManager()->wakeUpIdleThreads( numElems );
    
    // Release
    delete[] threadList;
@@ -186,13 +196,17 @@ void Scheduler::updateCreateStats ( WD &wd )
 {
    sys.getSchedulerStats()._createdTasks++;
    sys.getSchedulerStats()._totalTasks++;
+   if ( sys.getSchedulerStats()._countBytes ) sys.getSchedulerStats()._pendingBytes += sizeof( WD ) + wd.getDataSize();
    wd.setConfigured(); 
 }
 
 void Scheduler::updateExitStats ( WD &wd )
 {
    sys.throttleTaskOut();
-   if ( wd.isConfigured() ) sys.getSchedulerStats()._totalTasks--;
+   if ( wd.isConfigured() ) {
+      sys.getSchedulerStats()._totalTasks--;
+      if ( sys.getSchedulerStats()._countBytes ) sys.getSchedulerStats()._pendingBytes -= sizeof( WD ) + wd.getDataSize();
+   }
 }
 
 struct TestInputs {
@@ -833,6 +847,7 @@ bool Scheduler::inlineWork ( WD *wd, bool schedule )
    // Instrumenting context switch: wd enters cpu (last = n/a)
    NANOS_INSTRUMENT( sys.getInstrumentation()->wdSwitch( oldwd, wd, false) );
 
+   thread->preStartWorkDependent(*wd);
    bool done = thread->inlineWorkDependent(*wd);
 
    // Reload current thread after running WD due wd may be not tied to thread if
@@ -924,6 +939,8 @@ void Scheduler::switchHelper (WD *oldWD, WD *newWD, void *arg)
       syncCond->unlock();
    } else if ( &(myThread->getThreadWD()) != oldWD ) {
       myThread->getTeam()->getSchedulePolicy().queue( myThread, *oldWD );
+      // Work-first policies leave the parent ready here, on submission
+      sys.getThreadManager()->wakeUpIdleThreads( 1 );
    }
    myThread->setCurrentWD( *newWD );
 }
@@ -948,6 +965,7 @@ void Scheduler::switchTo ( WD *to )
    NANOS_INSTRUMENT( sys.getInstrumentation()->raiseCloseBurstEvent( copy_data_in_key, 0 ); )
 
          to->init();
+         myThread->preStartWorkDependent( *to );
          to->start(WD::IsAUserLevelThread);
       }
 
@@ -1044,6 +1062,7 @@ void Scheduler::exitTo ( WD *to )
    NANOS_INSTRUMENT( sys.getInstrumentation()->raiseCloseBurstEvent( copy_data_in_key, 0 ); )
 
        to->init();
+       myThread->preStartWorkDependent( *to );
        //       to->start(true,current);
        to->start(WD::IsAUserLevelThread,NULL);
     }
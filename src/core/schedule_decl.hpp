@@ -137,6 +137,7 @@ namespace nanos {
    {
          friend class WDDeque;
          friend class WDLFQueue;
+         friend class WDChaseLevDeque;
          friend class WDPriorityQueue<WD::PriorityType>;
          friend class WDPriorityQueue<double>;
          friend class Scheduler;
@@ -152,6 +153,8 @@ namespace nanos {
          Atomic<int>          _readyTasks;
          Atomic<int>          _idleThreads;
          Atomic<int>          _totalTasks;
+         Atomic<size_t>       _pendingBytes;     /**< Memory used by the WDs not finished yet */
+         bool                 _countBytes;       /**< Whether _pendingBytes is kept (only a throttle policy needs it) */
       private:
          /*! \brief SchedulerStats copy constructor (private)
           */
@@ -162,7 +165,7 @@ namespace nanos {
       public:
          /*! \brief SchedulerStats default constructor
           */
-         SchedulerStats () : _createdTasks(0), _readyTasks(0), _idleThreads(0), _totalTasks(1) {}
+         SchedulerStats () : _createdTasks(0), _readyTasks(0), _idleThreads(0), _totalTasks(1), _pendingBytes(0), _countBytes(false) {}
          /*! \brief SchedulerStats destructor
           */
          ~SchedulerStats () {}
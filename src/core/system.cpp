@@ -45,6 +45,7 @@
 #include "router.hpp"
 #include "addressspace.hpp"
 #include "globalregt.hpp"
+#include "evictionpolicy_decl.hpp"
 
 #ifdef SPU_DEV
 #include "spuprocessor.hpp"
@@ -113,8 +114,8 @@ System::System () :
       /*jb _numPEs( INT_MAX ), _numThreads( 0 ),*/ _deviceStackSize( 0 ), _profile( false ),
       _instrument( false ), _verboseMode( false ), _summary( false ), _executionMode( DEDICATED ), _initialMode( POOL ),
       _untieMaster( true ), _delayedStart( false ), _synchronizedStart( true ), _alreadyFinished( false ),
-      _predecessorLists( false ), _throttlePolicy ( NULL ),
-      _schedStats(), _schedConf(), _defSchedule( "bf" ), _defThrottlePolicy( "hysteresis" ), 
+      _predecessorLists( false ), _throttlePolicy ( NULL ), _evictionPolicy( NULL ),
+      _schedStats(), _schedConf(), _defSchedule( "bf" ), _defThrottlePolicy( "hysteresis" ), _defEvictionPolicy( "" ),
       _defBarr( "centralized" ), _defInstr ( "empty_trace" ), _defDepsManager( "plain" ), _defArch( "smp" ),
       _initializedThreads ( 0 ), /*_targetThreads ( 0 ),*/ _pausedThreads( 0 ),
       _pausedThreadsCond(), _unpausedThreadsCond(),
@@ -129,7 +130,7 @@ System::System () :
 #ifdef NANOS_INSTRUMENTATION_ENABLED
       , _enableEvents(), _disableEvents(), _instrumentDefault("default"), _enableCpuidEvent( false )
 #endif
-      , _lockPoolSize(37), _lockPool( NULL ), _mainTeam (NULL), _simulator(false),  _task_max_retries(1), _affinityFailureCount( 0 )
+      , _lockPoolSize(64), _lockPoolGrow( false ), _lockPoolMaxLocks( 65536 ), _lockPool( NULL ), _mainTeam (NULL), _simulator(false),  _task_max_retries(1), _affinityFailureCount( 0 )
       , _createLocalTasks( false )
       , _verboseDevOps( false )
       , _verboseCopies( false )
@@ -143,6 +144,7 @@ System::System () :
       , _cgAlloc( true )
       , _inIdle( false )
 	   , _lazyPrivatizationEnabled (false)
+	   , _treeReductionEnabled (false)
 	   , _preSchedule (false)
       , _slots()
 	   , _watchAddr (NULL)
@@ -154,7 +156,7 @@ System::System () :
    OS::init();
    config();
 
-   _lockPool = NEW Lock[_lockPoolSize];
+   _lockPool = NEW LockPool( _lockPoolSize, _lockPoolGrow, _lockPoolMaxLocks );
 
    if ( !_delayedStart ) {
       //std::cerr << "NX_ARGS is:" << (char *)(OS::getEnvironmentVariable( "NX_ARGS" ) != NULL ? OS::getEnvironmentVariable( "NX_ARGS" ) : "NO NX_ARGS: GG!") << std::endl;
@@ -271,6 +273,15 @@ void System::loadModules ()
 
    ensure0( _throttlePolicy, "No default throttle policy" );
 
+   if ( !getDefaultEvictionPolicy().empty() ) {
+      verbose0( "loading " << getDefaultEvictionPolicy() << " region cache eviction policy" );
+
+      if ( !loadPlugin( "evict-"+getDefaultEvictionPolicy() ) )
+         fatal0( "Could not load region cache eviction policy" );
+
+      ensure0( _evictionPolicy, "No region cache eviction policy" );
+   }
+
    verbose0( "loading " << getDefaultBarrier() << " barrier algorithm" );
 
    if ( !loadPlugin( "barrier-"+getDefaultBarrier() ) )
@@ -286,6 +297,8 @@ void System::loadModules ()
 void System::unloadModules ()
 {   
    delete _throttlePolicy;
+
+   delete _evictionPolicy;
    
    delete _defSchedulePolicy;
    
@@ -436,6 +449,11 @@ void System::config ()
    cfg.registerArgOption ( "regioncache-policy", "cache-policy" );
    cfg.registerEnvOption ( "regioncache-policy", "NX_CACHE_POLICY" );
 
+   registerPluginOption( "regioncache-eviction", "evict", _defEvictionPolicy,
+                         "Region cache eviction policy: lru, lfu or writeback. Default is the built-in policy (clean chunks first).", cfg );
+   cfg.registerArgOption ( "regioncache-eviction", "cache-eviction" );
+   cfg.registerEnvOption ( "regioncache-eviction", "NX_CACHE_EVICTION" );
+
    cfg.registerConfigOption ( "regioncache-slab-size", NEW Config::SizeVar ( _regionCacheSlabSize ), "Region slab size." );
    cfg.registerArgOption ( "regioncache-slab-size", "cache-slab-size" );
    cfg.registerEnvOption ( "regioncache-slab-size", "NX_CACHE_SLAB_SIZE" );
@@ -459,10 +477,26 @@ void System::config ()
 		   "Enable lazy reduction privatization" );
    cfg.registerArgOption ( "enable-lazy-privatization", "enable-lazy-privatization" );
 
+   cfg.registerConfigOption ( "enable-tree-reduction", NEW Config::FlagOption ( _treeReductionEnabled ),
+		   "Use NUMA-local, cache-line padded reduction private copies combined as a parallel tree" );
+   cfg.registerArgOption ( "enable-tree-reduction", "enable-tree-reduction" );
+
    cfg.registerConfigOption( "preschedule", NEW Config::FlagOption( _preSchedule ),
                              "Enables pre scheduling" );
    cfg.registerArgOption( "preschedule", "preschedule" );
 
+   cfg.registerConfigOption( "lock-pool-size", NEW Config::PositiveVar( _lockPoolSize ),
+                             "Number of locks protecting addresses (nanos_get_lock_address), rounded up to a power of two (default: 64)" );
+   cfg.registerArgOption( "lock-pool-size", "lock-pool-size" );
+
+   cfg.registerConfigOption( "lock-pool-grow", NEW Config::FlagOption( _lockPoolGrow ),
+                             "Gives each address its own lock, growing the lock pool as needed" );
+   cfg.registerArgOption( "lock-pool-grow", "lock-pool-grow" );
+
+   cfg.registerConfigOption( "lock-pool-max-locks", NEW Config::PositiveVar( _lockPoolMaxLocks ),
+                             "Maximum number of addresses with a lock of their own when the lock pool grows, the rest share lock-pool-size locks (default: 65536)" );
+   cfg.registerArgOption( "lock-pool-max-locks", "lock-pool-max-locks" );
+
    _schedConf.config( cfg );
 
    _hwloc.config( cfg );
@@ -815,15 +849,25 @@ void System::finish ()
    NANOS_INSTRUMENT ( sys.getInstrumentation()->raiseCloseStateEvent() );
    NANOS_INSTRUMENT ( sys.getInstrumentation()->finalize() );
 
-   //! \note stopping and deleting the thread manager
+   //! \note printing thread manager statistics, stopping and deleting it
+   if ( _summary ) {
+      std::ostringstream output;
+      _threadManager->printStats( output );
+      if ( !output.str().empty() ) message0( output.str() );
+   }
    delete _threadManager;
 
    //! \note stopping and deleting the programming model interface
    _pmInterface->finish();
    delete _pmInterface;
 
-   //! \note deleting pool of locks
-   delete[] _lockPool;
+   //! \note printing lock pool statistics and deleting it
+   if ( _summary ) {
+      std::ostringstream output;
+      _lockPool->printStats( output );
+      message0( output.str() );
+   }
+   delete _lockPool;
 
    //! \note deleting main work descriptor
    delete ( WorkDescriptor * ) ( mythread->getCurrentWD() );
@@ -845,6 +889,11 @@ void System::finish ()
    ensure(team->size() == 0, "Trying to finish execution, but team is still not empty");
    delete team;
 
+#ifdef NANOS_ENABLE_ALLOCATOR
+   //! \note printing allocator statistics (before threads are deleted with their PEs)
+   if ( _summary ) allocatorSummary();
+#endif
+
    //! \note deleting processing elements (but main pe)
    for ( PEList::iterator it = _pes.begin(); it != _pes.end(); it++ ) {
       if ( it->first != (unsigned int)mythread->runningOn()->getId() ) {
@@ -1081,6 +1130,8 @@ void System::createWD ( WD **uwd, size_t num_devices, nanos_device_t *devices, s
 
    //Copy reduction data from parent
    if (uwg) wd->copyReductions((WorkDescriptor *)uwg);
+
+   NANOS_INSTRUMENT ( sys.getInstrumentation()->wdCreated( wd ) );
 }
 
 /*! \brief Duplicates the whole structure for a given WD
@@ -1299,6 +1350,19 @@ void System::submitWithDependencies (WD& work, size_t numDataAccesses, DataAcces
    current->submitWithDependencies( work, numDataAccesses , dataAccesses);
 }
 
+/*! \brief Submit a batch of WorkDescriptors to their parent's dependencies domain
+ */
+void System::submitBatchWithDependencies ( size_t numWorks, WD **works, size_t *numDataAccesses, DataAccess **dataAccesses )
+{
+   SchedulePolicy* policy = getDefaultSchedulePolicy();
+   for ( size_t i = 0; i < numWorks; i++ ) {
+      policy->onSystemSubmit( *works[i], numDataAccesses[i] != 0 ? SchedulePolicy::SYS_SUBMIT_WITH_DEPENDENCIES : SchedulePolicy::SYS_SUBMIT );
+   }
+
+   WD *current = myThread->getCurrentWD();
+   current->submitBatchWithDependencies( numWorks, works, numDataAccesses, dataAccesses );
+}
+
 /*! \brief Wait on the current WorkDescriptor's domain for some dependenices to be satisfied
  */
 void System::waitOn( size_t numDataAccesses, DataAccess* dataAccesses )
@@ -1583,6 +1647,24 @@ void System::executionSummary()
    message0( output.str() );
 }
 
+#ifdef NANOS_ENABLE_ALLOCATOR
+void System::allocatorSummary()
+{
+   Allocator::Stats stats;
+   for ( ThreadList::const_iterator it = _workers.begin(); it != _workers.end(); it++ ) {
+      stats += it->second->getAllocator().getStats();
+   }
+   if ( allocator != NULL ) stats += allocator->getStats();
+
+   std::ostringstream output;
+   output << "Nanos++ Allocator Summary" << std::endl;
+   output << "==========================================================" << std::endl;
+   Allocator::printStats( output, stats );
+   output << "==========================================================" << std::endl;
+   message0( output.str() );
+}
+#endif
+
 #ifdef NANOS_INSTRUMENTATION_ENABLED
 // XXX Temporary hack, do not commit
 namespace {
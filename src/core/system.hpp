@@ -32,6 +32,7 @@
 #include "instrumentation_decl.hpp"
 #include "synchronizedcondition.hpp"
 #include "regioncache.hpp"
+#include "lockpool.hpp"
 #include <cmath>
 #include <climits>
 
@@ -75,6 +76,10 @@ inline int System::getTaskNum() const { return _schedStats._totalTasks.value();
 
 inline int System::getReadyNum() const { return _schedStats._readyTasks.value(); }
 
+inline size_t System::getPendingBytes() const { return _schedStats._pendingBytes.value(); }
+
+inline void System::countPendingBytes() { _schedStats._countBytes = true; }
+
 inline int System::getIdleNum() const { return _schedStats._idleThreads.value(); }
 
 inline int System::getRunningTasks() const { return _workers.size() - _schedStats._idleThreads.value(); }
@@ -285,10 +290,16 @@ inline unsigned System::getNodeOfPE ( unsigned pe )
 
 inline void System::setThrottlePolicy( ThrottlePolicy * policy ) { _throttlePolicy = policy; }
 
+inline void System::setEvictionPolicy( EvictionPolicy * policy ) { _evictionPolicy = policy; }
+
+inline EvictionPolicy * System::getEvictionPolicy() const { return _evictionPolicy; }
+
 inline const std::string & System::getDefaultSchedule() const { return _defSchedule; }
 
 inline const std::string & System::getDefaultThrottlePolicy() const { return _defThrottlePolicy; }
 
+inline const std::string & System::getDefaultEvictionPolicy() const { return _defEvictionPolicy; }
+
 inline const std::string & System::getDefaultBarrier() const { return _defBarr; }
 
 inline const std::string & System::getDefaultInstrumentation() const { return _defInstr; }
@@ -505,7 +516,7 @@ inline int System::nextThreadId () { return _threadIdSeed++; }
 
 inline unsigned int System::nextPEId () { return _peIdSeed++; }
 
-inline Lock * System::getLockAddress ( void *addr ) const { return &_lockPool[((((uintptr_t)addr)>>8)%_lockPoolSize)];} ;
+inline Lock * System::getLockAddress ( void *addr ) const { return _lockPool->getLock( addr ); }
 
 inline bool System::haveDependencePendantWrites ( void *addr ) const
 {
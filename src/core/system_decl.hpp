@@ -22,6 +22,7 @@
 
 #include "processingelement_decl.hpp"
 #include "throttle_decl.hpp"
+#include "evictionpolicy_fwd.hpp"
 #include <vector>
 #include <string>
 #include "schedule_decl.hpp"
@@ -41,6 +42,7 @@
 #include "addressspace_decl.hpp"
 #include "smpbaseplugin_decl.hpp"
 #include "hwloc_decl.hpp"
+#include "lockpool_decl.hpp"
 #include "threadmanager_decl.hpp"
 #include "router_decl.hpp"
 
@@ -126,10 +128,12 @@ namespace nanos {
 
 
          ThrottlePolicy      *_throttlePolicy;
+         EvictionPolicy      *_evictionPolicy;
          SchedulerStats       _schedStats;
          SchedulerConf        _schedConf;
          std::string          _defSchedule;           //!< \brief Name of default scheduler
          std::string          _defThrottlePolicy;     //!< \brief Name of default throttole policy (cutoff)
+         std::string          _defEvictionPolicy;     //!< \brief Name of the region cache eviction policy (empty: built-in)
          std::string          _defBarr;               //!< \brief Name of default barrier
          std::string          _defInstr;              //!< \brief Name of default instrumentation
          std::string          _defDepsManager;        //!< \brief Name of default dependences manager
@@ -227,8 +231,10 @@ namespace nanos {
          bool                      _enableCpuidEvent;
 #endif
 
-         const int                 _lockPoolSize;
-         Lock *                    _lockPool;
+         int                       _lockPoolSize;
+         bool                      _lockPoolGrow;
+         int                       _lockPoolMaxLocks;
+         LockPool *                _lockPool;
          ThreadTeam               *_mainTeam;
          bool                      _simulator;
 
@@ -262,6 +268,7 @@ namespace nanos {
          bool _cgAlloc;
          bool _inIdle;
          bool _lazyPrivatizationEnabled;
+         bool _treeReductionEnabled;
          bool _preSchedule;
          std::map<int, std::set<WD *> > _slots;
          void *_watchAddr;
@@ -277,6 +284,12 @@ namespace nanos {
           */
          void executionSummary( void );
 
+#ifdef NANOS_ENABLE_ALLOCATOR
+         /*! \brief Prints the Allocator Summary (objects and Arenas of all threads)
+          */
+         void allocatorSummary( void );
+#endif
+
       public:
          /*! \brief System default constructor
           */
@@ -304,6 +317,7 @@ namespace nanos {
 
          void submit ( WD &work );
          void submitWithDependencies (WD& work, size_t numDataAccesses, DataAccess* dataAccesses);
+         void submitBatchWithDependencies ( size_t numWorks, WD **works, size_t *numDataAccesses, DataAccess **dataAccesses );
          void waitOn ( size_t numDataAccesses, DataAccess* dataAccesses);
          void inlineWork ( WD &work );
 
@@ -350,6 +364,11 @@ namespace nanos {
 
          int getReadyNum() const;
 
+         size_t getPendingBytes() const;
+
+         //! \brief Starts keeping the memory used by the pending WDs (must be called before any WD is created)
+         void countPendingBytes();
+
          int getRunningTasks() const;
 
          int getNumWorkers() const;
@@ -453,6 +472,10 @@ namespace nanos {
 
          void setThrottlePolicy( ThrottlePolicy * policy );
 
+         void setEvictionPolicy( EvictionPolicy * policy );
+         //! \brief Region cache eviction policy, NULL for the built-in one
+         EvictionPolicy * getEvictionPolicy() const;
+
          bool throttleTaskIn( void ) const;
          void throttleTaskOut( void ) const;
 
@@ -460,6 +483,8 @@ namespace nanos {
 
          const std::string & getDefaultThrottlePolicy() const;
 
+         const std::string & getDefaultEvictionPolicy() const;
+
          const std::string & getDefaultBarrier() const;
 
          const std::string & getDefaultInstrumentation() const;
@@ -0,0 +1,207 @@
+/*************************************************************************************/
+/*      Copyright 2015 Barcelona Supercomputing Center                               */
+/*                                                                                   */
+/*      This file is part of the NANOS++ library.                                    */
+/*                                                                                   */
+/*      NANOS++ is free software: you can redistribute it and/or modify              */
+/*      it under the terms of the GNU Lesser General Public License as published by  */
+/*      the Free Software Foundation, either version 3 of the License, or            */
+/*      (at your option) any later version.                                          */
+/*                                                                                   */
+/*      NANOS++ is distributed in the hope that it will be useful,                   */
+/*      but WITHOUT ANY WARRANTY; without even the implied warranty of               */
+/*      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                */
+/*      GNU Lesser General Public License for more details.                          */
+/*                                                                                   */
+/*      You should have received a copy of the GNU Lesser General Public License     */
+/*      along with NANOS++.  If not, see <http://www.gnu.org/licenses/>.             */
+/*************************************************************************************/
+
+#include "system.hpp"
+#include "basethread.hpp"
+#include "task_reduction.hpp"
+#include "atomic.hpp"
+#include "instrumentation.hpp"
+#include "smpdd.hpp"
+
+#include <algorithm>
+
+using namespace nanos;
+
+namespace nanos {
+
+//! \brief Bytes of the private copies combined by a single piece of work
+static const size_t TREE_REDUCTION_CHUNK = 64 * 1024;
+
+//! \brief Shared state of a parallel tree combine
+//!
+//! The work is a sequence of pieces: one per (pair of copies, chunk of elements) at each
+//! tree level, and one per chunk at the last level (first copy into the original). Pieces
+//! are claimed in order; a piece waits for the previous levels to be completed before
+//! running. The reducing thread claims pieces until none is left, so helper tasks that run
+//! late (or never) cannot block it.
+class TaskReductionCombine
+{
+   private:
+      TaskReduction        *_reduction;
+      std::vector<size_t>   _ids;         //!< Initialized copies, grouped by NUMA node
+      std::vector<size_t>   _levelStart;  //!< First piece of every level (plus total)
+      size_t                _chunks;      //!< Element chunks per pair
+      size_t                _chunkElems;  //!< Elements per chunk
+      Atomic<size_t>        _next;        //!< Next piece to claim
+      Atomic<size_t>        _done;        //!< Completed pieces
+      Atomic<int>           _references;  //!< Reducing thread plus helper tasks
+
+      TaskReductionCombine ( const TaskReductionCombine & );
+      const TaskReductionCombine & operator= ( const TaskReductionCombine & );
+
+      void runPiece ( size_t piece )
+      {
+         size_t level = std::upper_bound( _levelStart.begin(), _levelStart.end(), piece ) - _levelStart.begin() - 1;
+
+         while ( _done.value() < _levelStart[level] ) cpuRelax();
+
+         size_t offset = piece - _levelStart[level];
+         size_t chunk = offset % _chunks;
+         size_t first = chunk * _chunkElems;
+         size_t last = std::min( first + _chunkElems, _reduction->_num_elements );
+
+         if ( level == _levelStart.size() - 2 ) {
+            _reduction->combine( _reduction->_original, _reduction->_storage[_ids[0]].data, first, last, true );
+         } else {
+            size_t stride = (size_t) 1 << level;
+            size_t dst = ( offset / _chunks ) * 2 * stride;
+            _reduction->combine( _reduction->_storage[_ids[dst]].data, _reduction->_storage[_ids[dst + stride]].data, first, last, false );
+         }
+         _done++;
+      }
+
+   public:
+      TaskReductionCombine ( TaskReduction *tr, const std::vector<size_t> &ids, size_t chunks, int helpers )
+         : _reduction( tr ), _ids( ids ), _levelStart(), _chunks( chunks ),
+           _chunkElems( ( tr->_num_elements + chunks - 1 ) / chunks ), _next( 0 ), _done( 0 ), _references( helpers + 1 )
+      {
+         size_t start = 0;
+         for ( size_t stride = 1; stride < _ids.size(); stride *= 2 ) {
+            _levelStart.push_back( start );
+            start += ( ( _ids.size() - stride + 2 * stride - 1 ) / ( 2 * stride ) ) * _chunks;
+         }
+         _levelStart.push_back( start );
+         _levelStart.push_back( start + _chunks );
+      }
+
+      size_t getPieces ( void ) const { return _levelStart.back(); }
+
+      //! \brief Runs pieces until none is left to claim
+      void work ( void )
+      {
+         size_t total = getPieces();
+         for ( size_t piece = _next++; piece < total; piece = _next++ ) runPiece( piece );
+      }
+
+      //! \brief Waits until every claimed piece has been completed
+      void wait ( void )
+      {
+         size_t total = getPieces();
+         while ( _done.value() < total ) cpuRelax();
+      }
+
+      void release ( void )
+      {
+         if ( --_references == 0 ) delete this;
+      }
+
+      static void helper ( void *args )
+      {
+         TaskReductionCombine *combine = *(TaskReductionCombine **) args;
+         combine->work();
+         combine->release();
+      }
+};
+
+//! \brief Device factory of the helper tasks (the C API one lives in a library core does not link)
+static void * taskReductionSMPFactory ( void *args )
+{
+   nanos_smp_args_t *smp = ( nanos_smp_args_t * ) args;
+   return ( void * ) NEW ext::SMPDD( smp->outline );
+}
+
+struct TaskReductionCopyOrder
+{
+   const TaskReduction::storage_t &_storage;
+
+   TaskReductionCopyOrder ( const TaskReduction::storage_t &storage ) : _storage( storage ) {}
+
+   bool operator() ( size_t a, size_t b ) const
+   {
+      if ( _storage[a].numaNode != _storage[b].numaNode ) return _storage[a].numaNode < _storage[b].numaNode;
+      return a < b;
+   }
+};
+
+} // namespace nanos
+
+void TaskReduction::combine ( void *dst, void *src, size_t first, size_t last, bool toOriginal )
+{
+   reducer_t reducer = toOriginal ? _reducer_orig_var : _reducer;
+
+   if ( _isFortranArrayReduction ) {
+      reducer( dst, src );
+   } else if ( _bulk != NULL ) {
+      _bulk( &((char*)dst)[first*_size_element], &((char*)src)[first*_size_element], last - first );
+   } else {
+      for ( size_t j = first; j < last; j++ ) {
+         reducer( &((char*)dst)[j*_size_element], &((char*)src)[j*_size_element] );
+      }
+   }
+}
+
+void TaskReduction::reduceTree ( void )
+{
+   NANOS_INSTRUMENT( sys.getInstrumentation()->raiseOpenBurstEvent ( sys.getInstrumentation()->getInstrumentationDictionary()->getEventKey( "reduction" ), 2) );
+
+   std::vector<size_t> ids;
+   for ( size_t i = 0; i < _num_threads; i++ ) {
+      if ( _storage[i].isInitialized ) ids.push_back( i );
+   }
+
+   if ( !ids.empty() ) {
+      // Copies of the same NUMA node are neighbours, so they are combined first
+      std::sort( ids.begin(), ids.end(), TaskReductionCopyOrder( _storage ) );
+
+      size_t chunks = 1;
+      if ( !_isFortranArrayReduction ) {
+         chunks = ( _num_elements * _size_element + TREE_REDUCTION_CHUNK - 1 ) / TREE_REDUCTION_CHUNK;
+         if ( chunks == 0 ) chunks = 1;
+      }
+
+      // Helpers are only worth it when the widest level has more than one piece
+      size_t widest = std::max( ids.size() / 2, (size_t) 1 ) * chunks;
+      int helpers = (int) std::min( widest, (size_t) sys.getNumThreads() ) - 1;
+      if ( helpers < 0 ) helpers = 0;
+
+      TaskReductionCombine *combine = NEW TaskReductionCombine( this, ids, chunks, helpers );
+
+      for ( int i = 0; i < helpers; i++ ) {
+         nanos_smp_args_t smp_args = { TaskReductionCombine::helper };
+         nanos_device_t device = { taskReductionSMPFactory, &smp_args };
+         WD *wd = NULL;
+         void *data = NULL;
+         sys.createWD( &wd, 1, &device, sizeof( TaskReductionCombine * ), __alignof__( TaskReductionCombine * ), &data,
+                       NULL, NULL, NULL, 0, NULL, 0, NULL, NULL, "task-reduction-combine", NULL );
+         *(TaskReductionCombine **) data = combine;
+         sys.setupWD( *wd, myThread->getCurrentWD() );
+         sys.submit( *wd );
+      }
+
+      combine->work();
+      combine->wait();
+      combine->release();
+
+      for ( size_t i = 0; i < ids.size(); i++ ) {
+         _storage[ids[i]].isInitialized = false;
+      }
+   }
+
+   NANOS_INSTRUMENT( sys.getInstrumentation()->raiseCloseBurstEvent ( sys.getInstrumentation()->getInstrumentationDictionary()->getEventKey( "reduction" ), 0 ) );
+}
@@ -21,6 +21,9 @@
 #define _NANOS_TASK_REDUCTION_HPP
 
 #include "task_reduction_decl.hpp"
+#include "debug.hpp"
+#include <stdlib.h>
+#include <unistd.h>
 
 namespace nanos {
 
@@ -36,10 +39,41 @@ inline void * TaskReduction::get( size_t id )
 
 inline void * TaskReduction::allocate( size_t id )
 {
-   _storage[id].data = (void *) malloc (_size);
+   if ( _isTree ) {
+      // Own cache lines, first-touched by the thread initializing it
+      size_t size = _size;
+      NANOS_ARCHITECTURE_PADDING_SIZE(size);
+      fatal_cond0( posix_memalign( &_storage[id].data, 64, size ) != 0, "Could not allocate a task reduction private copy" );
+   } else {
+      _storage[id].data = (void *) malloc (_size);
+   }
    return _storage[id].data;
 }
 
+inline void TaskReduction::allocateStorage ( void )
+{
+   NANOS_ARCHITECTURE_PADDING_SIZE(_size);
+
+   char * storage;
+   if ( _isTree ) {
+      size_t page = (size_t) sysconf( _SC_PAGESIZE );
+      if ( _size >= page ) _size = ( ( _size + page - 1 ) / page ) * page;
+
+      void * block = NULL;
+      fatal_cond0( posix_memalign( &block, page, _size * _num_threads ) != 0, "Could not allocate task reduction private copies" );
+      storage = (char *) block;
+   } else {
+      storage = (char*) malloc (_size * _num_threads);
+   }
+
+   _min = & storage[0];
+   _max = & storage[_size * _num_threads];
+   for ( size_t i=0; i<_num_threads; i++) {
+      _storage[i].data = (void *) &storage[i * _size];
+      _storage[i].isInitialized = false;
+   }
+}
+
 inline bool TaskReduction::isInitialized( size_t id )
 {
 	return _storage[id].isInitialized;
@@ -52,6 +86,11 @@ inline unsigned TaskReduction::getDepth( void ) const
 
 inline void TaskReduction::reduce()
 {
+   if ( _isTree ) {
+      reduceTree();
+      return;
+   }
+
    NANOS_INSTRUMENT( sys.getInstrumentation()->raiseOpenBurstEvent ( sys.getInstrumentation()->getInstrumentationDictionary()->getEventKey( "reduction" ), 2) );
 
    //find first private copy that was allocated during execution
@@ -69,6 +108,8 @@ inline void TaskReduction::reduce()
 
          if( _isFortranArrayReduction ) {
             _reducer((char*)_storage[masterId].data ,(_storage[i].data));
+         } else if ( _bulk != NULL ) {
+            _bulk( _storage[masterId].data, _storage[i].data, _num_elements );
          } else {
             for( size_t j=0; j<_num_elements; j++ ) {
                _reducer( &((char*)_storage[masterId].data)[j*_size_element] ,& ((char*)(_storage[i].data))[j*_size_element]);
@@ -82,6 +123,8 @@ inline void TaskReduction::reduce()
    if( _storage[masterId].isInitialized ) {
       if( _isFortranArrayReduction ) {
          _reducer_orig_var(_original ,_storage[masterId].data);
+      } else if ( _bulk != NULL ) {
+         _bulk( _original, _storage[masterId].data, _num_elements );
       } else {
          for( size_t j=0; j<_num_elements; j++ ){
             _reducer_orig_var( &((char*)_original)[j*_size_element] ,& ((char*)(_storage[masterId].data))[j*_size_element]);
@@ -105,6 +148,7 @@ inline void TaskReduction::initialize( size_t id )
 	}
 
 	_storage[id].isInitialized = true;
+	if ( _isTree ) _storage[id].numaNode = myThread->runningOn()->getNumaNode();
 
 	NANOS_INSTRUMENT( sys.getInstrumentation()->raiseCloseBurstEvent ( sys.getInstrumentation()->getInstrumentationDictionary()->getEventKey( "reduction" ), 0 ); )
 }
@@ -21,6 +21,7 @@
 #define _NANOS_TASK_REDUCTION_DECL_H
 
 #include "nanos-int.h"
+#include "bulkreducer_decl.hpp"
 
 //! \brief This class represent a Task Reduction.
 //!
@@ -37,7 +38,7 @@ class TaskReduction {
 
       typedef void ( *initializer_t ) ( void *omp_priv,  void* omp_orig );
       typedef void ( *reducer_t ) ( void *obj1, void *obj2 );
-      typedef struct {void * data; bool isInitialized;} field_t;
+      typedef struct {void * data; bool isInitialized; unsigned numaNode;} field_t;
       typedef std::vector<field_t> storage_t;
 
 
@@ -57,6 +58,7 @@ class TaskReduction {
       // are only different when we are doing a Fortran Array Reduction
       reducer_t       _reducer;          //!< Reducer operator
       reducer_t       _reducer_orig_var; //!< Reducer on orignal variable
+      bulk_reducer_t  _bulk;             //!< Vectorized combine of whole copies (built-in reducers only)
 
       storage_t       _storage;          //!< Private copy vector
       size_t          _size;             //!< Size of array (size of element is scalar)
@@ -67,6 +69,26 @@ class TaskReduction {
       void           *_max;              //!< Pointer to last private copy
       bool            _isLazyPriv;       //!< Is lazy privatization enabled
       bool            _isFortranArrayReduction;//!< whether this is a Fortran array reudction
+      bool            _isTree;           //!< Are private copies NUMA-local and combined as a parallel tree
+
+      //! \brief Allocates the contiguous (non-lazy) private copies
+      //!
+      //! In tree mode every copy starts in its own cache line (in its own page when copies are
+      //! larger than a page) and the block is not touched here, so each copy is first-touched,
+      //! and thus placed, by the thread initializing it.
+      void allocateStorage ( void );
+
+      //! \brief Combines the private copies as a tree (copies of the same NUMA node first)
+      //!
+      //! Each tree level is split in pieces (pairs of copies x element chunks) which are run
+      //! by the reducing thread and by helper tasks.
+      void reduceTree ( void );
+
+      //! \brief Reduces elements [first,last) of 'src' into 'dst' ('toOriginal' uses the
+      //! reducer on the original variable)
+      void combine ( void *dst, void *src, size_t first, size_t last, bool toOriginal );
+
+      friend class TaskReductionCombine;
 
       //! \brief TaskReduction copy constructor (disabled)
       TaskReduction( const TaskReduction &tr ) {}
@@ -76,11 +98,13 @@ class TaskReduction {
       //! \brief TaskReduction constructor only used when we are performing a Reduction
       TaskReduction( void *orig, initializer_t f_init, reducer_t f_red,
     		  	  size_t size, size_t size_elem, size_t
-				  threads, unsigned depth, bool lazy )
+				  threads, unsigned depth, bool lazy, bool tree = false )
                	   : _original(orig), _dependence(orig), _depth(depth), _initializer(f_init),
-					 _reducer(f_red), _reducer_orig_var(f_red), _storage(threads),
+					 _reducer(f_red), _reducer_orig_var(f_red),
+					 _bulk( BulkReducer::find( ( const void * ) f_red ) ), _storage(threads),
 					 _size(size), _size_element(size_elem),_num_elements(size/size_elem),
-					 _num_threads(threads), _min(NULL), _max(NULL), _isLazyPriv (lazy), _isFortranArrayReduction(false)
+					 _num_threads(threads), _min(NULL), _max(NULL), _isLazyPriv (lazy), _isFortranArrayReduction(false),
+					 _isTree(tree)
    {
       if(_isLazyPriv) {
          //Note that renaming tracking for nested reductions is not supported
@@ -92,26 +116,19 @@ class TaskReduction {
          }
       }
       else {
-         NANOS_ARCHITECTURE_PADDING_SIZE(_size);
-
-         char * storage = (char*) malloc (_size*threads);
-         _min = & storage[0];
-         _max = & storage[_size * threads];
-         for ( size_t i=0; i<_num_threads; i++) {
-            _storage[i].data = (void *) &storage[i * _size];
-            _storage[i].isInitialized = false;
-         }
+         allocateStorage();
       }
    }
 
       //!brief TaskReduction constructor only used when we are performing a Fortran Array Reduction
    TaskReduction( void *orig, void *dep, initializer_t f_init, reducer_t f_red,
             reducer_t f_red_orig_var, size_t array_descriptor_size, size_t
-            threads, unsigned depth, bool lazy )
+            threads, unsigned depth, bool lazy, bool tree = false )
          : _original(orig), _dependence(dep), _depth(depth),
-         _initializer(f_init), _reducer(f_red), _reducer_orig_var(f_red_orig_var), _storage(threads),
+         _initializer(f_init), _reducer(f_red), _reducer_orig_var(f_red_orig_var), _bulk(NULL), _storage(threads),
          _size(array_descriptor_size), _size_element(0),_num_elements(0),
-         _num_threads(threads), _min(NULL), _max(NULL), _isLazyPriv(lazy), _isFortranArrayReduction(true)
+         _num_threads(threads), _min(NULL), _max(NULL), _isLazyPriv(lazy), _isFortranArrayReduction(true),
+         _isTree(tree)
    {
 
       if(_isLazyPriv) {
@@ -124,15 +141,7 @@ class TaskReduction {
          }
       }
       else {
-         NANOS_ARCHITECTURE_PADDING_SIZE(_size);
-         char * storage = (char*) malloc (_size * threads);
-
-         _min = & storage[0];
-         _max = & storage[_size * threads];
-         for ( size_t i=0; i<_num_threads; i++) {
-            _storage[i].data = (void *) &storage[i * _size];
-            _storage[i].isInitialized = false;
-         }
+         allocateStorage();
       }
    }
 
@@ -23,6 +23,10 @@
 #include "system.hpp"
 #include "config.hpp"
 #include "os.hpp"
+#include "atomic.hpp"
+
+#include <stdlib.h>
+#include <string.h>
 
 #ifdef DLB
 #include <DLB_interface.h>
@@ -63,6 +67,7 @@ using namespace nanos;
 
 const unsigned int ThreadManagerConf::DEFAULT_SLEEP_NS = 20000;
 const unsigned int ThreadManagerConf::DEFAULT_YIELDS = 10;
+const unsigned int ThreadManagerConf::DEFAULT_FUTEX_TIMEOUT_NS = 1000000;
 
 /**********************************/
 /****** Thread Manager Conf *******/
@@ -70,7 +75,7 @@ const unsigned int ThreadManagerConf::DEFAULT_YIELDS = 10;
 
 ThreadManagerConf::ThreadManagerConf()
    : _tm(TM_UNDEFINED), _numYields(DEFAULT_YIELDS), _sleepTime(DEFAULT_SLEEP_NS),
-   _useYield(false), _useBlock(false), _useDLB(false),
+   _futexTimeout(DEFAULT_FUTEX_TIMEOUT_NS), _useYield(false), _useBlock(false), _useFutex(false), _useDLB(false),
    _forceTieMaster(false), _warmupThreads(false)
 {
 }
@@ -94,6 +99,10 @@ void ThreadManagerConf::config( Config &cfg )
          "Thread sleep on idle and condition waits" );
    cfg.registerArgOption( "enable-sleep", "enable-sleep" );
 
+   cfg.registerConfigOption( "enable-futex", NEW Config::FlagOption( _useFutex, true ),
+         "Thread wait on a futex on idle until a task submission wakes it up" );
+   cfg.registerArgOption( "enable-futex", "enable-futex" );
+
    cfg.registerConfigOption( "enable-yield", NEW Config::FlagOption( _useYield, true ),
          "Thread yield on idle and condition waits" );
    cfg.registerArgOption( "enable-yield", "enable-yield" );
@@ -103,6 +112,11 @@ void ThreadManagerConf::config( Config &cfg )
    cfg.registerConfigOption ( "sleep-time", NEW Config::UintVar( _sleepTime ), sleep_sstream.str() );
    cfg.registerArgOption ( "sleep-time", "sleep-time" );
 
+   std::ostringstream futex_sstream;
+   futex_sstream << "Set the maximum amount of time (in nsec) of each futex wait (default = " << DEFAULT_FUTEX_TIMEOUT_NS << ")";
+   cfg.registerConfigOption ( "futex-timeout", NEW Config::UintVar( _futexTimeout ), futex_sstream.str() );
+   cfg.registerArgOption ( "futex-timeout", "futex-timeout" );
+
    std::ostringstream yield_sstream;
    yield_sstream << "Set number of yields on idle before blocking (default = " << DEFAULT_YIELDS << ")";
    cfg.registerConfigOption ( "num-yields", NEW Config::UintVar( _numYields ), yield_sstream.str() );
@@ -125,7 +139,7 @@ ThreadManager* ThreadManagerConf::create()
 {
    // Choose default if _tm not specified
    if ( _tm == TM_UNDEFINED ) {
-      if  ( _useYield || _useBlock || _useSleep || _useDLB) {
+      if  ( _useYield || _useBlock || _useSleep || _useFutex || _useDLB) {
          _tm = TM_NANOS;
       } else {
          _tm = TM_NONE;
@@ -137,8 +151,16 @@ ThreadManager* ThreadManagerConf::create()
       warning0( "Thread Manager: Flags --enable-block and --enable-sleep are mutually exclusive. Block takes precedence." );
       _useSleep = false;
    }
-   if ( _tm == TM_NONE && (_useYield || _useBlock || _useSleep || _useDLB) ) {
-      warning0( "Thread Manager: Block, sleep, yield or dlb options are ignored when you explicitly choose --thread-manager=none" );
+   if ( _useBlock && _useFutex ) {
+      warning0( "Thread Manager: Flags --enable-block and --enable-futex are mutually exclusive. Block takes precedence." );
+      _useFutex = false;
+   }
+   if ( _useSleep && _useFutex ) {
+      warning0( "Thread Manager: Flags --enable-sleep and --enable-futex are mutually exclusive. Futex takes precedence." );
+      _useSleep = false;
+   }
+   if ( _tm == TM_NONE && (_useYield || _useBlock || _useSleep || _useFutex || _useDLB) ) {
+      warning0( "Thread Manager: Block, sleep, futex, yield or dlb options are ignored when you explicitly choose --thread-manager=none" );
    }
 #ifndef DLB
    if ( _useDLB  || _tm == TM_DLB ) {
@@ -151,8 +173,9 @@ ThreadManager* ThreadManagerConf::create()
    if ( _tm == TM_NONE ) {
       return NEW ThreadManager( _warmupThreads );
    } else if ( _tm == TM_NANOS ) {
-      if ( _useSleep || (_useDLB && !_useBlock) ) {
-         return NEW BusyWaitThreadManager( _numYields, _sleepTime, _useSleep, _useDLB, _warmupThreads );
+      if ( _useSleep || _useFutex || (_useDLB && !_useBlock) ) {
+         return NEW BusyWaitThreadManager( _numYields, _sleepTime, _useSleep, _useDLB,
+                                           _useFutex, _futexTimeout, _warmupThreads );
       } else {
          return NEW BlockingThreadManager( _numYields, _useBlock, _useDLB, _warmupThreads );
       }
@@ -394,19 +417,38 @@ void BlockingThreadManager::processMaskChanged()
 /**********************************/
 
 BusyWaitThreadManager::BusyWaitThreadManager( unsigned int num_yields, unsigned int sleep_time,
-                                                bool use_sleep, bool use_dlb, bool warmup )
+                                                bool use_sleep, bool use_dlb, bool use_futex,
+                                                unsigned int futex_timeout, bool warmup )
    : ThreadManager(warmup), _isMalleable(false),
-   _numYields(num_yields), _sleepTime(sleep_time), _useSleep(use_sleep), _useDLB(use_dlb)
+   _numYields(num_yields), _sleepTime(sleep_time), _useSleep(use_sleep), _useDLB(use_dlb),
+   _useFutex(use_futex), _futexTimeout(futex_timeout), _idleSlots(NULL), _numIdleSlots(0),
+   _waitMask(NULL), _numWaitWords(0), _waiting(0), _wakeUps(0), _timeouts(0), _wakeUpLatency(0)
 {
 }
 
 BusyWaitThreadManager::~BusyWaitThreadManager()
 {
    if ( _useDLB ) DLB_Finalize();
+   free( _idleSlots );
+   delete[] _waitMask;
 }
 
 void BusyWaitThreadManager::init()
 {
+   if ( _useFutex ) {
+      // Room for every worker plus helper threads; threads with a larger id sleep instead
+      unsigned int num_slots = sys.getSMPPlugin()->getMaxWorkers() + OS::getMaxProcessors();
+      void *slots = NULL;
+      fatal_cond0( posix_memalign( &slots, NANOS_CACHELINE, num_slots * sizeof( IdleSlot ) ) != 0,
+                   "Thread Manager: cannot allocate the idle thread slots" );
+      memset( slots, 0, num_slots * sizeof( IdleSlot ) );
+      _idleSlots = ( IdleSlot * ) slots;
+      _numIdleSlots = num_slots;
+      _numWaitWords = ( num_slots + WAIT_MASK_BITS - 1 ) / WAIT_MASK_BITS;
+      _waitMask = NEW WaitMask[_numWaitWords];
+      for ( unsigned int i = 0; i < _numWaitWords; i++ ) _waitMask[i] = 0UL;
+   }
+
    ThreadManager::init();
    _isMalleable = sys.getPMInterface().isMalleable();
    _maxThreads = _useDLB ? OS::getMaxProcessors() : sys.getSMPPlugin()->getRequestedWorkers();
@@ -444,9 +486,20 @@ void BusyWaitThreadManager::idle( int& yields
       unsigned long long end_yield = (unsigned long long) ( OS::getMonotonicTime() * 1.0e9  );
       time_yields += ( end_yield - begin_yield );
 #endif
-      if ( _useSleep ) yields--;
+      if ( _useSleep || _useFutex ) yields--;
    } else {
-      if ( _useSleep ) {
+      if ( _useFutex ) {
+#ifdef NANOS_INSTRUMENTATION_ENABLED
+         total_blocks++;
+         unsigned long long begin_block = (unsigned long long) ( OS::getMonotonicTime() * 1.0e9  );
+#endif
+         waitForWork( thread );
+#ifdef NANOS_INSTRUMENTATION_ENABLED
+         unsigned long long end_block = (unsigned long long) ( OS::getMonotonicTime() * 1.0e9  );
+         time_blocks += ( end_block - begin_block );
+#endif
+         if ( _numYields != 0 ) yields = _numYields;
+      } else if ( _useSleep ) {
 #ifdef NANOS_INSTRUMENTATION_ENABLED
          total_blocks++;
          unsigned long begin_block = (unsigned long) ( OS::getMonotonicTime() * 1.0e9  );
@@ -463,6 +516,106 @@ void BusyWaitThreadManager::idle( int& yields
    blockThread(thread);
 }
 
+void BusyWaitThreadManager::waitForWork( BaseThread *thread )
+{
+   ThreadTeam *team = thread->getTeam();
+   unsigned int id = thread->getId();
+
+   // Submissions only wake up team members
+   if ( team == NULL || id >= _numIdleSlots ) {
+      OS::nanosleep( _sleepTime );
+      return;
+   }
+
+   IdleSlot &slot = _idleSlots[id];
+   slot._numaNode = thread->runningOn()->getNumaNode();
+   slot._state = WAITING;
+   setWaiting( id, true );
+   _waiting++;
+
+   // Tasks submitted before the slot was published did not see it. The global ready task
+   // counter is checked because testDequeue is not conclusive for every policy
+   memoryFence();
+   if ( sys.getReadyNum() == 0 ) {
+      OS::futexWait( &slot._state, WAITING, _futexTimeout );
+   }
+
+   if ( compareAndSwap( &slot._state, (int) WAITING, (int) RUNNING ) ) {
+      // Nobody claimed the slot (timeout, spurious wake-up or work already available)
+      setWaiting( id, false );
+      _waiting--;
+      _timeouts++;
+   } else {
+      // A waker claimed the slot, and already removed it from the waiting count
+      while ( slot._state == CLAIMED ) memoryFence();
+      _wakeUpLatency += (unsigned long long) ( ( OS::getMonotonicTime() - slot._wakeTime ) * 1.0e9 );
+      slot._state = RUNNING;
+   }
+}
+
+void BusyWaitThreadManager::setWaiting( unsigned int id, bool waiting )
+{
+   WaitMask &word = _waitMask[id / WAIT_MASK_BITS];
+   unsigned long bit = 1UL << ( id % WAIT_MASK_BITS );
+   unsigned long old_bits, new_bits;
+   do {
+      old_bits = word.value();
+      new_bits = waiting ? ( old_bits | bit ) : ( old_bits & ~bit );
+   } while ( !word.cswap( old_bits, new_bits ) );
+}
+
+void BusyWaitThreadManager::wakeUpIdleThreads( unsigned int num )
+{
+   if ( !_useFutex || !_initialized ) return;
+
+   // No fence on the submission path: the ready task counter was just updated with an atomic
+   // operation, and a thread starting to wait re-checks it after it is counted as waiting. A
+   // wait that is still missed ends at the futex timeout
+   if ( _waiting.value() == 0 ) return;
+
+   int node = getMyThreadSafe()->runningOn()->getNumaNode();
+   double now = OS::getMonotonicTime();
+
+   // First pass wakes up threads in the NUMA node of the submitting thread, second pass any other.
+   // Only the slots flagged in the waiting bitmap are visited
+   for ( int pass = 0; pass < 2 && num > 0; pass++ ) {
+      for ( unsigned int w = 0; w < _numWaitWords && num > 0; w++ ) {
+         unsigned long bits = _waitMask[w].value();
+         while ( bits != 0 && num > 0 ) {
+            unsigned int i = w * WAIT_MASK_BITS + __builtin_ctzl( bits );
+            bits &= bits - 1;
+
+            IdleSlot &slot = _idleSlots[i];
+            if ( ( slot._numaNode == node ) != ( pass == 0 ) ) continue;
+
+            // Only the waker that claims the slot writes its wake-up time
+            if ( compareAndSwap( &slot._state, (int) WAITING, (int) CLAIMED ) ) {
+               setWaiting( i, false );
+               slot._wakeTime = now;
+               memoryFence();
+               slot._state = WOKEN;
+               _waiting--;
+               _wakeUps++;
+               OS::futexWake( &slot._state, 1 );
+               num--;
+            }
+         }
+      }
+   }
+}
+
+void BusyWaitThreadManager::printStats( std::ostream &o )
+{
+   if ( !_useFutex ) return;
+
+   unsigned long long wake_ups = _wakeUps.value();
+   o << "=== Thread Manager: " << wake_ups << " targeted wake-ups, " << _timeouts.value() << " waits without wake-up";
+   if ( wake_ups > 0 ) {
+      o << ", average wake-up latency " << ( _wakeUpLatency.value() / wake_ups ) << " ns";
+   }
+   o << std::endl;
+}
+
 void BusyWaitThreadManager::acquireOne()
 {
    if ( !_initialized ) return;
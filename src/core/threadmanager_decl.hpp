@@ -24,6 +24,8 @@
 #include "atomic_decl.hpp"
 #include "cpuset.hpp"
 #include "basethread_decl.hpp"
+#include "allocator_decl.hpp"
+#include <ostream>
 
 namespace nanos {
 
@@ -71,6 +73,9 @@ namespace nanos {
          virtual void blockThread(BaseThread*) {}
          virtual void unblockThread(BaseThread*) {}
          virtual void processMaskChanged() {}
+         //! \brief Called when some tasks have been made ready, wakes up idle threads if needed
+         virtual void wakeUpIdleThreads( unsigned int ) {}
+         virtual void printStats( std::ostream & ) {}
    };
 
    //! BlockingThreadManager class
@@ -116,21 +121,54 @@ namespace nanos {
     * This derived class is used when either sleep is enabled or when DLB is running
     * with basic policies like LeWI or LeWI_mask
     *
-    * Used when --thread-manager=nanos and --enable-sleep,
+    * Used when --thread-manager=nanos and --enable-sleep or --enable-futex,
     *   or when --enable-dlb and block is not explicitly selected
+    *
+    * With futex enabled, idle threads wait on a per-thread futex instead of sleeping a
+    * fixed amount of time, and task submission wakes up as many of them as new ready tasks,
+    * those in the NUMA node of the submitting thread first. Waiting threads are also
+    * flagged in a bitmap, so a submission only visits the slots of threads that wait.
     */
    class BusyWaitThreadManager : public ThreadManager
    {
       private:
+         //! \brief Futex word and wake-up data of an idle thread, one per cache line
+         struct IdleSlot {
+            volatile int         _state;        //!< RUNNING, WAITING, CLAIMED or WOKEN
+            int                  _numaNode;     //!< NUMA node of the waiting thread
+            double               _wakeTime;     //!< When the waker claimed this slot
+            char                 _pad[NANOS_CACHELINE - 2 * sizeof(int) - sizeof(double)];
+         };
+
+         enum { RUNNING = 0, WAITING, CLAIMED, WOKEN };
+
+         typedef Atomic<unsigned long> WaitMask;
+         static const unsigned int  WAIT_MASK_BITS = 8 * sizeof( unsigned long );
+
          bool              _isMalleable;
          unsigned int      _numYields;
          unsigned int      _sleepTime;
          bool              _useSleep;
          bool              _useDLB;
+         bool              _useFutex;
+         unsigned int      _futexTimeout;
+         IdleSlot         *_idleSlots;      //!< Indexed by thread id
+         unsigned int      _numIdleSlots;
+         WaitMask         *_waitMask;       //!< One bit per slot, set while its thread is WAITING
+         unsigned int      _numWaitWords;
+         Atomic<unsigned int>       _waiting;         //!< Threads waiting on their futex
+         Atomic<unsigned long long> _wakeUps;         //!< Targeted wake-ups
+         Atomic<unsigned long long> _timeouts;        //!< Waits ended without a wake-up
+         Atomic<unsigned long long> _wakeUpLatency;   //!< Accumulated wake-up latency (ns)
+
+         void waitForWork( BaseThread *thread );
+         //! \brief Sets (or clears) the waiting bit of slot 'id'
+         void setWaiting( unsigned int id, bool waiting );
 
       public:
          BusyWaitThreadManager( unsigned int num_yields, unsigned int sleep_time,
-                                 bool use_sleep, bool use_dlb, bool warmup );
+                                 bool use_sleep, bool use_dlb, bool use_futex,
+                                 unsigned int futex_timeout, bool warmup );
          virtual ~BusyWaitThreadManager();
          virtual void init();
          virtual bool isGreedy();
@@ -148,6 +186,8 @@ namespace nanos {
          virtual void blockThread(BaseThread*);
          virtual void unblockThread(BaseThread*);
          virtual void processMaskChanged();
+         virtual void wakeUpIdleThreads( unsigned int num );
+         virtual void printStats( std::ostream &o );
    };
 
    //! DlbThreadManager class
@@ -201,9 +241,11 @@ namespace nanos {
          ThreadManagerOption  _tm;              //!< Thread Manager name option
          unsigned int         _numYields;       //!< Number of yields before block
          unsigned int         _sleepTime;       //!< Number of nanoseconds to sleep
+         unsigned int         _futexTimeout;    //!< Maximum number of nanoseconds to wait on the futex
          bool                 _useYield;        //!< Yield is enabled
          bool                 _useBlock;        //!< Block is enabled
          bool                 _useSleep;        //!< Sleep is enabled
+         bool                 _useFutex;        //!< Futex wait is enabled
          bool                 _useDLB;          //!< DLB library will be used
          bool                 _forceTieMaster;  //!< Force Master WD (user code) to run on Master Thread
          bool                 _warmupThreads;   //!< Force the initialization of as many threads as number of CPUs, then block them if needed
@@ -211,6 +253,7 @@ namespace nanos {
       public:
          static const unsigned int DEFAULT_SLEEP_NS;
          static const unsigned int DEFAULT_YIELDS;
+         static const unsigned int DEFAULT_FUTEX_TIMEOUT_NS;
 
          ThreadManagerConf();
 
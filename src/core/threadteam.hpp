@@ -25,6 +25,7 @@
 #include "debug.hpp"
 #include "system.hpp"
 #include "task_reduction.hpp"
+#include "bulkreducer_decl.hpp"
 
 namespace nanos {
 
@@ -251,9 +252,12 @@ inline void ThreadTeam::computeVectorReductions ( void )
       } else {
          unsigned i;
          char *privates = reinterpret_cast<char*>(red->privates);
+         // A built-in array reducer is replaced by its bulk loop (no call through the API)
+         bulk_reducer_t bulk = BulkReducer::find( ( const void * ) red->bop );
          for ( i = 0; i < this->size(); i++ ) {
              char* current = privates + i * red->element_size;
-             red->bop(red->original, current, red->num_scalars);
+             if ( bulk != NULL ) bulk( red->original, current, red->num_scalars );
+             else red->bop(red->original, current, red->num_scalars);
          }
       }
    }
@@ -34,3 +34,41 @@ void WDDeque::initDeviceList()
    }
 }
 
+
+WDChaseLevDeque::Buffer::Buffer ( long capacity, Buffer *previous ) : _mask( capacity - 1 ), _slots( NULL ), _previous( previous )
+{
+   ensure( capacity > 0 && ( capacity & ( capacity - 1 ) ) == 0, "Chase-Lev buffer capacity must be a power of two" );
+   _slots = NEW WorkDescriptor * volatile[capacity];
+}
+
+WDChaseLevDeque::Buffer::~Buffer ()
+{
+   delete[] _slots;
+}
+
+WDChaseLevDeque::Buffer * WDChaseLevDeque::Buffer::grow ( long top, long bottom )
+{
+   Buffer *buffer = NEW Buffer( capacity() * 2, this );
+   for ( long i = top; i < bottom; i++ ) {
+      buffer->put( i, get( i ) );
+   }
+   return buffer;
+}
+
+WDChaseLevDeque::WDChaseLevDeque( ScheduleThreadData *owner, bool enableDeviceCounter, long capacity )
+   : _top( 0 ), _bottom( 0 ), _buffer( NULL ), _spill( enableDeviceCounter ), _owner( owner )
+{
+   long size = 1;
+   while ( size < capacity ) size <<= 1;
+   _buffer = NEW Buffer( size, NULL );
+}
+
+WDChaseLevDeque::~WDChaseLevDeque()
+{
+   Buffer *buffer = _buffer.value();
+   while ( buffer != NULL ) {
+      Buffer *previous = buffer->getPrevious();
+      delete buffer;
+      buffer = previous;
+   }
+}
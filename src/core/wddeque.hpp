@@ -286,6 +286,90 @@ inline WorkDescriptor * WDDeque::popBackWithConstraints ( BaseThread const *thre
 }
 
 
+inline bool WDDeque::canMigrate ( WD &wd, BaseThread const &thread )
+{
+   return wd.getSlicer() == NULL && !wd.isTied() && !wd.isTiedLocation() && !wd.hasCommutativeAccesses() &&
+      wd.canRunIn( *thread.runningOn() ) && ( wd.getDepth() == 1 || thread.runningOn()->getMemorySpaceId() == 0 );
+}
+
+inline WorkDescriptor * WDDeque::stealHalf ( BaseThread *thread, WDPool &dst )
+{
+   return stealHalfWithConstraints<NoConstraints>( thread, dst );
+}
+
+template <typename Constraints>
+inline WorkDescriptor * WDDeque::stealHalfWithConstraints ( BaseThread *thread, WDPool &dst )
+{
+   WorkDescriptor *found = NULL;
+   WD *moved[MaxStealBatch];
+   size_t numMoved = 0;
+
+   if ( _dq.empty() )
+      return NULL;
+
+   if ( _deviceCounter ) {
+      std::vector<const Device *> const &pe_devices = thread->runningOn()->getDeviceTypes();
+      bool has_tasks = false;
+      for ( std::vector<const Device *>::const_iterator it = pe_devices.begin();
+            it != pe_devices.end() && !has_tasks; it++ ) {
+         has_tasks = (_ndevs[ *it ].value() > 0); 
+      }
+      if ( !has_tasks ) {
+         return NULL;
+      }
+   }
+
+   {
+      LockBlock lock( _lock );
+
+      memoryFence();
+
+      size_t limit = std::min( ( _nelems + 1 ) / 2, (size_t) MaxStealBatch + 1 );
+      int removed = 0;
+
+      WDDeque::BaseContainer::iterator it = _dq.end();
+      while ( it != _dq.begin() && ( found == NULL || numMoved + 1 < limit ) ) {
+         --it;
+         WD &wd = *(WD *)*it;
+         if ( found == NULL ) {
+            // First the WD to run, exactly as pop_back would take it
+            if ( !Scheduler::checkBasicConstraints( wd, *thread ) || !Constraints::check( wd, *thread ) ) continue;
+            if ( !wd.dequeue( &found ) ) break; // Only a slice was taken, the WD stays in the queue
+         } else if ( canMigrate( wd, *thread ) && Constraints::check( wd, *thread ) ) {
+            moved[numMoved++] = &wd;
+         } else {
+            continue;
+         }
+
+         it = _dq.erase( it );
+         removed++;
+         if ( _deviceCounter ) {
+            for ( unsigned int i = 0; i < wd.getNumDevices(); i++ ) {
+               _ndevs[( wd.getDevices()[i]->getDevice() )]--;
+            }
+         }
+      }
+
+      if ( removed > 0 ) {
+         int tasks = sys.getSchedulerStats()._readyTasks -= removed;
+         decreaseTasksInQueues( tasks, removed );
+      }
+
+      if ( found != NULL ) found->setMyQueue( NULL );
+      for ( size_t i = 0; i < numMoved; i++ ) moved[i]->setMyQueue( NULL );
+   }
+
+   // Outside of the critical section: two threads may be stealing from each other
+   if ( numMoved > 0 ) {
+      // moved[0] was the oldest one: it ends at the back of 'dst', where it will be stolen first
+      dst.push_front( moved, numMoved );
+   }
+
+   ensure( !found || !found->isTied() || found->isTiedTo() == thread, "" );
+
+   return found;
+}
+
 template <typename Constraints>
 inline bool WDDeque::removeWDWithConstraints( BaseThread *thread, WorkDescriptor *toRem, WorkDescriptor **next )
 {
@@ -528,10 +612,220 @@ inline bool WDLFQueue::removeWD( BaseThread *thread, WorkDescriptor *toRem, Work
    return false;
 }
 
+/*******************
+ * WDChaseLevDeque *
+ *******************/
+
+inline void WDChaseLevDeque::fullFence ()
+{
+   // memoryFence() may be an acquire-release fence, which does not order a
+   // store with a later load. Chase-Lev needs a sequentially consistent one.
+#ifdef HAVE_NEW_GCC_ATOMIC_OPS
+   __atomic_thread_fence(__ATOMIC_SEQ_CST);
+#else
+   __sync_synchronize();
+#endif
+}
+
+inline bool WDChaseLevDeque::isOwner ( BaseThread const *thread ) const
+{
+   return thread != NULL && thread->getTeamData() != NULL && thread->getTeamData()->getScheduleData() == _owner;
+}
+
+inline bool WDChaseLevDeque::empty ( void ) const
+{
+   return _bottom.value() <= _top.value() && _spill.empty();
+}
+
+inline size_t WDChaseLevDeque::size() const
+{
+   long n = _bottom.value() - _top.value();
+   return ( n > 0 ? (size_t) n : 0 ) + _spill.size();
+}
+
+inline void WDChaseLevDeque::pushBottom ( WorkDescriptor *wd )
+{
+   wd->setMyQueue( this );
+
+   long b = _bottom.value();
+   long t = _top.value();
+   Buffer *buffer = _buffer.value();
+   if ( b - t >= buffer->capacity() ) {
+      buffer = buffer->grow( t, b );
+      _buffer = buffer;
+   }
+   buffer->put( b, wd );
+   memoryFence();
+   _bottom = b + 1;
+
+   int tasks = ++( sys.getSchedulerStats()._readyTasks );
+   increaseTasksInQueues(tasks);
+}
+
+inline WorkDescriptor * WDChaseLevDeque::takeBottom ()
+{
+   long b = _bottom.value() - 1;
+   Buffer *buffer = _buffer.value();
+   _bottom = b;
+   fullFence();
+   long t = _top.value();
+
+   if ( t > b ) {
+      // Empty deque: restore bottom
+      _bottom = b + 1;
+      return NULL;
+   }
+
+   WorkDescriptor *wd = buffer->get( b );
+   if ( t == b ) {
+      // Last element: race against thieves for it
+      if ( !_top.cswap( t, t + 1 ) ) wd = NULL;
+      _bottom = b + 1;
+   }
+   return wd;
+}
+
+inline WorkDescriptor * WDChaseLevDeque::stealTop ()
+{
+   while ( true ) {
+      long t = _top.value();
+      fullFence();
+      long b = _bottom.value();
+
+      if ( t >= b ) return NULL;
+
+      WorkDescriptor *wd = _buffer.value()->get( t );
+      if ( _top.cswap( t, t + 1 ) ) return wd;
+      // Lost the race against the owner or another thief, try again
+   }
+}
+
+template <typename Constraints>
+inline WorkDescriptor * WDChaseLevDeque::claim ( WorkDescriptor *wd, BaseThread const *thread )
+{
+   int tasks = --( sys.getSchedulerStats()._readyTasks );
+   decreaseTasksInQueues(tasks);
+
+   WorkDescriptor *found = NULL;
+   if ( Scheduler::checkBasicConstraints( *wd, *thread ) && Constraints::check( *wd, *thread ) ) {
+      if ( wd->dequeue( &found ) ) {
+         found->setMyQueue( NULL );
+      } else {
+         // Only a slice was taken, the rest of the WD stays queued
+         _spill.push_front( wd );
+      }
+   } else {
+      _spill.push_back( wd );
+   }
+
+   ensure( !found || !found->isTied() || found->isTiedTo() == thread, "" );
+
+   return found;
+}
+
+inline void WDChaseLevDeque::push_front ( WorkDescriptor *wd )
+{
+   if ( isOwner( myThread ) ) pushBottom( wd );
+   else _spill.push_front( wd );
+}
+
+inline void WDChaseLevDeque::push_back ( WorkDescriptor *wd )
+{
+   _spill.push_back( wd );
+}
+
+inline Lock& WDChaseLevDeque::getLock()
+{
+   return _spill.getLock();
+}
+
+inline void WDChaseLevDeque::push_front( WD** wds, size_t numElems )
+{
+   _spill.push_front( wds, numElems );
+}
+
+inline void WDChaseLevDeque::push_back( WD** wds, size_t numElems )
+{
+   _spill.push_back( wds, numElems );
+}
+
+template <typename Constraints>
+inline WorkDescriptor * WDChaseLevDeque::popFrontWithConstraints ( BaseThread const *thread )
+{
+   WorkDescriptor *found = NULL;
+   WorkDescriptor *wd;
+   bool owner = isOwner( thread );
+
+   while ( found == NULL && ( wd = ( owner ? takeBottom() : stealTop() ) ) != NULL ) {
+      found = claim<Constraints>( wd, thread );
+   }
+   if ( found == NULL && !_spill.empty() ) {
+      found = _spill.popFrontWithConstraints<Constraints>( thread );
+   }
+
+   return found;
+}
+
+template <typename Constraints>
+inline WorkDescriptor * WDChaseLevDeque::popBackWithConstraints ( BaseThread const *thread )
+{
+   WorkDescriptor *found = NULL;
+   WorkDescriptor *wd;
+
+   while ( found == NULL && ( wd = stealTop() ) != NULL ) {
+      found = claim<Constraints>( wd, thread );
+   }
+   if ( found == NULL && !_spill.empty() ) {
+      found = _spill.popBackWithConstraints<Constraints>( thread );
+   }
+
+   return found;
+}
+
+template <typename Constraints>
+inline bool WDChaseLevDeque::removeWDWithConstraints( BaseThread *thread, WorkDescriptor *toRem, WorkDescriptor **next )
+{
+   return _spill.removeWDWithConstraints<Constraints>( thread, toRem, next );
+}
+
+inline WorkDescriptor * WDChaseLevDeque::pop_front ( BaseThread *thread )
+{
+   return popFrontWithConstraints<NoConstraints>(thread);
+}
+
+inline WorkDescriptor * WDChaseLevDeque::pop_back ( BaseThread *thread )
+{
+   return popBackWithConstraints<NoConstraints>(thread);
+}
+
+inline bool WDChaseLevDeque::removeWD( BaseThread *thread, WorkDescriptor *toRem, WorkDescriptor **next )
+{
+   return removeWDWithConstraints<NoConstraints>(thread,toRem,next);
+}
+
+inline void WDChaseLevDeque::increaseTasksInQueues( int tasks, int increment )
+{
+   NANOS_INSTRUMENT(static nanos_event_key_t key = sys.getInstrumentation()->getInstrumentationDictionary()->getEventKey("num-ready");)
+   NANOS_INSTRUMENT( nanos_event_value_t nb =  (nanos_event_value_t ) tasks );
+   NANOS_INSTRUMENT(sys.getInstrumentation()->raisePointEvents(1, &key, &nb );)
+}
+
+inline void WDChaseLevDeque::decreaseTasksInQueues( int tasks, int decrement )
+{
+   NANOS_INSTRUMENT(static nanos_event_key_t key = sys.getInstrumentation()->getInstrumentationDictionary()->getEventKey("num-ready");)
+   NANOS_INSTRUMENT( nanos_event_value_t nb =  (nanos_event_value_t ) tasks );
+   NANOS_INSTRUMENT(sys.getInstrumentation()->raisePointEvents(1, &key, &nb );)
+}
+
+inline bool WDChaseLevDeque::testDequeue()
+{
+   return _bottom.value() > _top.value() || _spill.testDequeue();
+}
+
 template <typename T>
-inline WDPriorityQueue<T>::WDPriorityQueue( bool enableDeviceCounter, bool optimise, bool reverse, PriorityValueFun getter )
-   : _dq(), _lock(), _nelems(0), _optimise( optimise ), _reverse( reverse ), _ndevs(), _deviceCounter( enableDeviceCounter ),
-     _getter( getter ), _maxPriority( 0 ), _minPriority( 0 )
+inline WDPriorityQueue<T>::WDPriorityQueue( bool enableDeviceCounter, bool reverse, PriorityValueFun getter )
+   : _dq(), _lock(), _nelems(0), _reverse( reverse ), _backSeq( 0 ), _frontSeq( 0 ),
+     _ndevs(), _deviceCounter( enableDeviceCounter ), _getter( getter ), _maxPriority( 0 ), _minPriority( 0 )
 {
    if ( _deviceCounter ) {
 
@@ -558,88 +852,103 @@ inline size_t WDPriorityQueue<T>::size() const
 }
 
 template<typename T>
-inline void WDPriorityQueue<T>::insertOrdered( WorkDescriptor *wd, bool fifo )
+inline bool WDPriorityQueue<T>::before ( const Entry &a, const Entry &b ) const
 {
-   // Find where to insert the wd
-   WDPQ::BaseContainer::iterator it;
-   T priority = wd->getPriority();
-   
-   if ( fifo ) {
-      // #637: Insert at the back if possible
-      if ( ( _optimise ) && ( ( _dq.empty() ) || ( _dq.back()->getPriority() >= wd->getPriority() ) ) ){
-         it = _dq.end();
-      }
-      else
-         it = upper_bound ( wd );
-   }
-   else {
-      // #637: Insert at the front if possible
-      if ( ( _optimise ) && ( ( _dq.empty() ) || ( _dq.front()->getPriority() < wd->getPriority() ) ) )
-         it = _dq.begin();
-      else {
-         it = lower_bound( wd );
-      }
+   if ( _reverse )
+      return a._priority < b._priority || ( a._priority == b._priority && a._seq > b._seq );
+   return a._priority > b._priority || ( a._priority == b._priority && a._seq < b._seq );
+}
+
+template<typename T>
+inline void WDPriorityQueue<T>::siftUp ( size_t pos )
+{
+   Entry e = _dq[pos];
+   while ( pos > 0 ) {
+      size_t parent = ( pos - 1 ) / Arity;
+      if ( !before( e, _dq[parent] ) ) break;
+      _dq[pos] = _dq[parent];
+      pos = parent;
    }
-   
-   _dq.insert( it, wd );
-   // If the wd was inserted at the end, it has lower priority than any other
-   if( wd == _dq.back() )
-      _minPriority = priority;
-   // If it was inserted at the start, it has more than the rest
-   if ( wd == _dq.front() )
-      _maxPriority = priority;
+   _dq[pos] = e;
 }
 
 template<typename T>
-inline void WDPriorityQueue<T>::insertOrdered( WorkDescriptor ** wds, size_t numElems, bool fifo )
+inline void WDPriorityQueue<T>::siftDown ( size_t pos )
 {
-   // Find where to insert the wd
-   WDPQ::BaseContainer::iterator it;
-   WD* first = wds[0];
-   T priority = first->getPriority();
-   
-   if ( fifo ) {
-      // #637: Insert at the back if possible
-      if ( ( _optimise ) && ( ( _dq.empty() ) || ( _dq.back()->getPriority() >= priority ) ) ){
-         it = _dq.end();
-      }
-      else
-         it = upper_bound ( first );
-   }
-   else {
-      // #637: Insert at the front if possible
-      if ( ( _optimise ) && ( ( _dq.empty() ) || ( _dq.front()->getPriority() < priority ) ) )
-         it = _dq.begin();
-      else {
-         it = lower_bound( first );
+   const size_t n = _dq.size();
+   Entry e = _dq[pos];
+   while ( true ) {
+      size_t first = pos * Arity + 1;
+      if ( first >= n ) break;
+      size_t last = std::min( first + Arity, n );
+      size_t best = first;
+      for ( size_t child = first + 1; child < last; child++ ) {
+         if ( before( _dq[child], _dq[best] ) ) best = child;
       }
+      if ( !before( _dq[best], e ) ) break;
+      _dq[pos] = _dq[best];
+      pos = best;
    }
-   
-   _dq.insert( it, wds, wds + numElems );
-   // If the wd was inserted at the end, it has lower priority than any other
-   if( first == _dq.back() )
-      _minPriority = priority;
-   // If it was inserted at the start, it has more than the rest
-   if ( first == _dq.front() )
-      _maxPriority = priority;
+   _dq[pos] = e;
 }
 
 template<typename T>
-inline WDPQ::BaseContainer::iterator
-WDPriorityQueue<T>::upper_bound( const WD *wd )
+inline void WDPriorityQueue<T>::insertEntry ( const Entry &e )
 {
-   if ( _reverse )
-      return std::upper_bound( _dq.begin(), _dq.end(), wd, WDPriorityComparisonReverse<T>( _getter ) );
-   return std::upper_bound( _dq.begin(), _dq.end(), wd, WDPriorityComparison<T>( _getter ) );
+   _dq.push_back( e );
+   siftUp( _dq.size() - 1 );
 }
 
 template<typename T>
-inline WDPQ::BaseContainer::iterator
-WDPriorityQueue<T>::lower_bound( const WD *wd )
+inline void WDPriorityQueue<T>::removeAt ( size_t pos )
 {
-   if ( _reverse )
-      return std::lower_bound( _dq.begin(), _dq.end(), wd, WDPriorityComparisonReverse<T>( _getter ) );
-   return std::lower_bound( _dq.begin(), _dq.end(), wd, WDPriorityComparison<T>( _getter ) );
+   Entry last = _dq.back();
+   _dq.pop_back();
+   if ( pos == _dq.size() ) return;
+
+   _dq[pos] = last;
+   if ( pos > 0 && before( last, _dq[( pos - 1 ) / Arity] ) ) siftUp( pos );
+   else siftDown( pos );
+}
+
+template<typename T>
+inline size_t WDPriorityQueue<T>::find ( const WorkDescriptor *wd ) const
+{
+   size_t pos;
+   for ( pos = 0; pos < _dq.size(); pos++ ) {
+      if ( _dq[pos]._wd == wd ) break;
+   }
+   return pos;
+}
+
+template<typename T>
+inline void WDPriorityQueue<T>::insertOrdered( WorkDescriptor *wd, bool fifo )
+{
+   T priority = _getter( wd );
+
+   insertEntry( Entry( wd, priority, fifo ? ++_backSeq : --_frontSeq ) );
+
+   // The WD at the top has the highest priority
+   _maxPriority = _dq.front()._priority;
+   if ( _dq.size() == 1 || ( _reverse ? priority > _minPriority : priority < _minPriority ) )
+      _minPriority = priority;
+}
+
+template<typename T>
+inline void WDPriorityQueue<T>::removed( WorkDescriptor *wd )
+{
+   if ( _deviceCounter ) {
+      for ( unsigned int i = 0; i < wd->getNumDevices(); i++ ) {
+         _ndevs[( wd->getDevices()[i]->getDevice() )]--;
+      }
+   }
+   // Update max and min
+   if ( _dq.empty() ) {
+      _maxPriority = 0;
+      _minPriority = 0;
+   } else {
+      _maxPriority = _dq.front()._priority;
+   }
 }
 
 /*!
@@ -717,6 +1026,7 @@ template<typename T>
 inline void WDPriorityQueue<T>::push_front( WD** wds, size_t numElems )
 {
    LockBlock lock( _lock );
+   _dq.reserve( _dq.size() + numElems );
    for( size_t i = 0; i < numElems; ++i )
    {
       WD* wd = wds[i];
@@ -730,7 +1040,7 @@ inline void WDPriorityQueue<T>::push_front( WD** wds, size_t numElems )
    }
    int tasks = sys.getSchedulerStats()._readyTasks += numElems;
    increaseTasksInQueues(tasks,numElems);
-   fatal_cond( _dq.size() != _nelems, "List size does not match queue size" );
+   fatal_cond( _dq.size() != _nelems, "Heap size does not match queue size" );
 }
 
 template<typename T>
@@ -738,48 +1048,21 @@ inline void WDPriorityQueue<T>::push_back( WD** wds, size_t numElems )
 {
    LockBlock lock( _lock );
    fatal_cond( numElems == 0, "No reason to call push_back for 0 elements" );
-   // Get the priority of the first one
-  /* T firstPrio = (*wds)->getPriority();
-   bool samePrio = true;
-   // Check if all of them have the same priority
-   for( size_t i = 1; i < numElems && samePrio; ++i )
-   {
-      samePrio = wds[i]->getPriority() != firstPrio;
-   }
-   // If the have different priorities
-   if ( !samePrio )
-   {*/
-      for( size_t i = 0; i < numElems; ++i )
-      {
-         WD* wd = wds[i];
-         wd->setMyQueue( this );
-         insertOrdered( wd, true );
-         if ( _deviceCounter ) {
-            for ( unsigned int j = 0; j < wd->getNumDevices(); j++ ) {
-               _ndevs[( wd->getDevices()[j]->getDevice() )]++;
-            }
-         }
-      }
-   /*}
-   // Otherwise, insert in the same position
-   else
+   _dq.reserve( _dq.size() + numElems );
+   for( size_t i = 0; i < numElems; ++i )
    {
-      for( size_t i = 0; i < numElems; ++i )
-      {
-         WD* wd = wds[i];
-         wd->setMyQueue( this );
-      }
-      insertOrdered( wds, numElems, true );
+      WD* wd = wds[i];
+      wd->setMyQueue( this );
+      insertOrdered( wd, true );
       if ( _deviceCounter ) {
          for ( unsigned int j = 0; j < wd->getNumDevices(); j++ ) {
             _ndevs[( wd->getDevices()[j]->getDevice() )]++;
          }
       }
-
-   }*/
+   }
    int tasks = sys.getSchedulerStats()._readyTasks += numElems;
    increaseTasksInQueues(tasks,numElems);
-   fatal_cond( _dq.size() != _nelems, "List size does not match queue size" );
+   fatal_cond( _dq.size() != _nelems, "Heap size does not match queue size" );
 }
 
 /*!
@@ -805,34 +1088,26 @@ inline WorkDescriptor * WDPriorityQueue<T>::popFrontWithConstraints ( BaseThread
 
       memoryFence();
 
-      if ( !_dq.empty() ) {
-         WDPQ::BaseContainer::iterator it;
-         for ( it = _dq.begin(); it != _dq.end() ; ++it ) {
-            WD &wd = *(WD *)*it;
-            if ( Scheduler::checkBasicConstraints( wd, *thread) && Constraints::check(wd,*thread)) {
-               if ( wd.dequeue( &found ) ) {
-                  _dq.erase( it );
-                  if ( _deviceCounter ) {
-                     for ( unsigned int i = 0; i < wd.getNumDevices(); i++ ) {
-                        _ndevs[( wd.getDevices()[i]->getDevice() )]--;
-                     }
-                  }
-                  // Update max and min
-                  if ( _dq.empty() ){
-                     _maxPriority = 0;
-                     _minPriority = 0;
-                  }
-                  // Note that, due to constraints, we might not have extracted
-                  // the first element of the queue, but the last one.
-                  else{
-                     _maxPriority = _dq.front()->getPriority();
-                     _minPriority = _dq.back()->getPriority();
-                  }
-                  int tasks = --(sys.getSchedulerStats()._readyTasks);
-                  decreaseTasksInQueues(tasks);
-               }
-               break;
-            }
+      // The top of the heap is usually eligible; otherwise look for the best eligible
+      // entry with a read-only scan of the heap array, so the heap is only modified once
+      const size_t n = _dq.size();
+      size_t best = n;
+      for ( size_t pos = 0; pos < n; pos++ ) {
+         if ( best != n && !before( _dq[pos], _dq[best] ) ) continue;
+         WD &wd = *_dq[pos]._wd;
+         if ( Scheduler::checkBasicConstraints( wd, *thread) && Constraints::check(wd,*thread)) {
+            best = pos;
+            if ( pos == 0 ) break;
+         }
+      }
+
+      if ( best != n ) {
+         WD &wd = *_dq[best]._wd;
+         if ( wd.dequeue( &found ) ) {
+            removeAt( best );
+            removed( &wd );
+            int tasks = --(sys.getSchedulerStats()._readyTasks);
+            decreaseTasksInQueues(tasks);
          }
       }
 
@@ -850,54 +1125,7 @@ template <typename Constraints>
 inline WorkDescriptor * WDPriorityQueue<T>::popBackWithConstraints ( BaseThread *thread )
 {
    // FIXME: at the moment this method is implemented as pop_front, change behaviour!!!
-   WorkDescriptor *found = NULL;
-
-   if ( _dq.empty() )
-      return NULL;
-   {
-      LockBlock lock( _lock );
-
-      memoryFence();
-
-      if ( !_dq.empty() ) {
-         WDPQ::BaseContainer::iterator it;
-
-         for ( it = _dq.begin(); it != _dq.end() ; ++it ) {
-            WD &wd = *(WD *)*it;
-            if ( Scheduler::checkBasicConstraints( wd, *thread) && Constraints::check(wd,*thread)) {
-               if ( wd.dequeue( &found ) ) {
-                  _dq.erase( it );
-                  if ( _deviceCounter ) {
-                     for ( unsigned int i = 0; i < wd.getNumDevices(); i++ ) {
-                        _ndevs[( wd.getDevices()[i]->getDevice() )]--;
-                     }
-                  }
-                  // Update max and min
-                  if ( _dq.empty() ){
-                     _maxPriority = 0;
-                     _minPriority = 0;
-                  }
-                  // Note that, due to constraints, we might not have extracted
-                  // the last element of the queue, but the first one.
-                  else{
-                     _maxPriority = _dq.front()->getPriority();
-                     _minPriority = _dq.back()->getPriority();
-                  }
-                  int tasks = --(sys.getSchedulerStats()._readyTasks);
-                  decreaseTasksInQueues(tasks);
-               }
-               break;
-            }
-         }
-      }
-
-      if ( found != NULL ) found->setMyQueue( NULL );
-
-   }
-
-   ensure( !found || !found->isTied() || found->isTiedTo() == thread, "" );
-
-   return found;
+   return popFrontWithConstraints<Constraints>( thread );
 }
 
 template <typename T>
@@ -909,7 +1137,6 @@ inline bool WDPriorityQueue<T>::removeWDWithConstraints( BaseThread *thread, Wor
    if ( !Scheduler::checkBasicConstraints( *toRem, *thread) || !Constraints::check(*toRem, *thread) ) return false;
 
    *next = NULL;
-   WDPQ::BaseContainer::iterator it;
 
    {
       LockBlock lock( _lock );
@@ -917,21 +1144,16 @@ inline bool WDPriorityQueue<T>::removeWDWithConstraints( BaseThread *thread, Wor
       memoryFence();
 
       if ( !_dq.empty() && toRem->getMyQueue() == this ) {
-         for ( it = _dq.begin(); it != _dq.end(); it++ ) {
-            if ( *it == toRem ) {
-               if ( ( *it )->dequeue( next ) ) {
-                  _dq.erase( it );
-                  if ( _deviceCounter ) {
-                     for ( unsigned int i = 0; i < ( *it )->getNumDevices(); i++ ) {
-                        _ndevs[( ( *it )->getDevices()[i]->getDevice() )]--;
-                     }
-                  }
-                  int tasks = --(sys.getSchedulerStats()._readyTasks);
-                  decreaseTasksInQueues(tasks);
-               }
-               (*next)->setMyQueue( NULL );
-               return true;
+         size_t pos = find( toRem );
+         if ( pos != _dq.size() ) {
+            if ( toRem->dequeue( next ) ) {
+               removeAt( pos );
+               removed( toRem );
+               int tasks = --(sys.getSchedulerStats()._readyTasks);
+               decreaseTasksInQueues(tasks);
             }
+            (*next)->setMyQueue( NULL );
+            return true;
          }
       }
    }
@@ -945,16 +1167,15 @@ inline bool WDPriorityQueue<T>::reorderWD( WorkDescriptor *wd )
    LockBlock l( _lock );
    
    // Find the WD
-   WDPQ::BaseContainer::iterator it =
-      std::find( _dq.begin(), _dq.end(), wd );
+   size_t pos = find( wd );
 
    // If the WD was not found, return false
-   if( it == _dq.end() ){
+   if( pos == _dq.size() ){
       return false;
    }
 
    // Otherwise, reorder it
-   _dq.erase( it );
+   removeAt( pos );
    insertOrdered( wd );
 
    return true;
@@ -979,7 +1200,7 @@ inline void WDPriorityQueue<T>::increaseTasksInQueues( int tasks, int increment
    NANOS_INSTRUMENT( nanos_event_value_t nb =  (nanos_event_value_t ) tasks );
    NANOS_INSTRUMENT(sys.getInstrumentation()->raisePointEvents(1, &key, &nb );)
    _nelems += increment;
-   fatal_cond( _dq.size() != _nelems, "List size does not match queue size (increase)" );
+   fatal_cond( _dq.size() != _nelems, "Heap size does not match queue size (increase)" );
 }
 
 template<typename T>
@@ -989,7 +1210,7 @@ inline void WDPriorityQueue<T>::decreaseTasksInQueues( int tasks, int decrement
    NANOS_INSTRUMENT( nanos_event_value_t nb =  (nanos_event_value_t ) tasks );
    NANOS_INSTRUMENT(sys.getInstrumentation()->raisePointEvents(1, &key, &nb );)
    _nelems -= decrement;
-   fatal_cond( _dq.size() != _nelems, "List size does not match queue size (decrease)" );
+   fatal_cond( _dq.size() != _nelems, "Heap size does not match queue size (decrease)" );
 }
 
 template<typename T>
@@ -1001,10 +1222,10 @@ inline bool WDPriorityQueue<T>::testDequeue()
    // Auxiliary map to count successful commutative accesses
    std::map<WD**, WD*> comm_accesses;
    // ReadyQueue iterator
-   WDPQ::BaseContainer::const_iterator it;
+   typename BaseContainer::const_iterator it;
    LockBlock lock( _lock );
    for ( it = _dq.begin(); it != _dq.end(); ++it ) {
-      const WD &wd = *(WD *)*it;
+      const WD &wd = *it->_wd;
       if ( wd.getConcurrencyLevel( comm_accesses ) > 0 )
          return true;
    }
@@ -1015,4 +1236,3 @@ inline bool WDPriorityQueue<T>::testDequeue()
 } // namespace nanos
 
 #endif
-
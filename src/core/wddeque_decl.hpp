@@ -23,12 +23,14 @@
 #include <list>
 #include <functional>
 #include <map>
+#include <vector>
 
 #include "debug.hpp"
 #include "atomic_decl.hpp"
 #include "lock_decl.hpp"
 
 #include "basethread_fwd.hpp"
+#include "schedule_fwd.hpp"
 
 #include "workdescriptor_decl.hpp"
 
@@ -86,6 +88,14 @@ namespace nanos {
          WorkDescriptor * popBackWithConstraints ( BaseThread const *thread );
          template <typename Constraints>
          bool removeWDWithConstraints( BaseThread *thread, WorkDescriptor *toRem, WorkDescriptor **next );
+
+         /*! \brief Steals up to half of the WDs of this pool that 'thread' can run
+          *
+          *  One of them is returned to be run by 'thread' and the rest are pushed, in a single batch,
+          *  to the front of 'dst' (usually the queue of the thief). The default implementation only
+          *  steals one WD with pop_back.
+          */
+         virtual WorkDescriptor * stealHalf ( BaseThread *thread, WDPool &dst ) { return pop_back( thread ); }
          
          /*! \brief Returns the lock object, for batch operations. */
          virtual Lock& getLock() = 0;
@@ -115,6 +125,9 @@ namespace nanos {
          typedef std::list<WorkDescriptor *> BaseContainer;
          typedef std::map< const Device *, Atomic<unsigned int> > WDDeviceCounter;
 
+         /*! \brief Maximum number of WDs moved by a single stealHalf (they are kept on the stack) */
+         static const size_t MaxStealBatch = 64;
+
          BaseContainer     _dq;
          Lock              _lock;
          size_t            _nelems;
@@ -134,6 +147,12 @@ namespace nanos {
           */
          void initDeviceList();
 
+         /*! \brief Whether a WD can be moved to the queue of 'thread' without being run by it
+          *  \note Tied, sliced and commutative WDs are never moved: their constraints can only be
+          *  checked (or their accesses acquired) right before they are run.
+          */
+         static bool canMigrate ( WD &wd, BaseThread const &thread );
+
       public:
          /*! \brief WDDeque default constructor
           */
@@ -164,6 +183,14 @@ namespace nanos {
 
          bool removeWD( BaseThread *thread, WorkDescriptor *toRem, WorkDescriptor **next );
 
+         /*! \brief Takes the last WD 'thread' can run, like pop_back, and moves up to half of the
+          *  queue (counting it, and at most MaxStealBatch WDs) from the back to 'dst', all in a single
+          *  critical section of this queue
+          */
+         template <typename Constraints>
+         WorkDescriptor * stealHalfWithConstraints ( BaseThread *thread, WDPool &dst );
+         WorkDescriptor * stealHalf ( BaseThread *thread, WDPool &dst );
+
          void increaseTasksInQueues( int tasks, int increment = 1 );
          void decreaseTasksInQueues( int tasks, int decrement = 1 );
 
@@ -247,59 +274,158 @@ namespace nanos {
          bool removeWD( BaseThread *thread, WorkDescriptor *toRem, WorkDescriptor **next );
 
    };
-   
-   /*! \brief Class used to compare WDs by priority.
-    *  \see WDPriorityQueue::push
-    */
-   template <typename T>
-   struct WDPriorityComparisonBase : public std::binary_function< WD*, WD*, bool>
-   {
-      /*! \brief Type of the functor */
-      typedef std::const_mem_fun_t<T, WD> PriorityValueFun;
-      
-      PriorityValueFun _getter;
-      
-      WDPriorityComparisonBase( PriorityValueFun functor ) : _getter( functor ) {}
-   };
-   
-   /*! \brief Class used to compare WDs by priority.
-    */
-   template <typename T>
-   struct WDPriorityComparison : public WDPriorityComparisonBase<T>
-   {
-      typedef WDPriorityComparisonBase<T> Base;
-      
-      WDPriorityComparison( typename Base::PriorityValueFun functor ) 
-         : Base( functor ) {}
-      
-      bool operator() ( const WD *wd1, const WD *wd2 ) const
-      {
-         return this->_getter( wd1 ) > this->_getter( wd2 );
-      }
-   };
-   
-   /*! \brief Class used to compare WDs by priority reversely.
+
+   /*! \brief Chase-Lev work-stealing deque.
+    *
+    *  The thread owning the queue pushes and pops at the front (bottom of the
+    *  deque) without any atomic read-modify-write operation, while the other
+    *  threads steal from the back (top) with a compare-and-swap. WDs pushed by
+    *  threads other than the owner, WDs rejected by the constraints of the
+    *  thread that extracted them and WDs that are only partially dequeued
+    *  (slicers) are kept in a locked WDDeque, so popFrontWithConstraints and
+    *  removeWD keep their semantics for them.
     */
-   template <typename T>
-   struct WDPriorityComparisonReverse : public WDPriorityComparisonBase<T>
+   class WDChaseLevDeque : public WDPool
    {
-      typedef WDPriorityComparisonBase<T> Base;
-      
-      WDPriorityComparisonReverse( typename Base::PriorityValueFun functor ) 
-         : Base( functor ) {}
-      bool operator() ( const WD *wd1, const WD *wd2 ) const
-      {
-         return this->_getter( wd1 ) <= this->_getter( wd2 );
-      }
+      private:
+         class Buffer
+         {
+            private:
+               long                       _mask;      /**< Capacity - 1, capacity is a power of two */
+               WorkDescriptor * volatile *_slots;     /**< Circular array of WDs */
+               Buffer                    *_previous;  /**< Smaller buffer replaced by this one */
+            private:
+               /*! \brief Buffer copy constructor (private)
+                */
+               Buffer ( const Buffer & );
+               /*! \brief Buffer copy assignment operator (private)
+                */
+               const Buffer & operator= ( const Buffer & );
+            public:
+               /*! \brief Buffer constructor
+                */
+               Buffer ( long capacity, Buffer *previous );
+               /*! \brief Buffer destructor
+                */
+               ~Buffer ();
+
+               long capacity () const { return _mask + 1; }
+               Buffer * getPrevious () const { return _previous; }
+
+               WorkDescriptor * get ( long i ) const { return _slots[ i & _mask ]; }
+               void put ( long i, WorkDescriptor *wd ) { _slots[ i & _mask ] = wd; }
+
+               /*! \brief Returns a buffer twice as big holding the elements in [top,bottom)
+                *  \note This buffer is not freed, as thieves may still be reading from it
+                */
+               Buffer * grow ( long top, long bottom );
+         };
+
+         Atomic<long>          _top;        /**< Steal end, only modified through compare-and-swap */
+         char                  _pad[64];    /**< Keeps thieves off the owner's cache line */
+         Atomic<long>          _bottom;     /**< Owner end, only written by the owner */
+         Atomic<Buffer *>      _buffer;     /**< Current circular array */
+         WDDeque               _spill;      /**< Locked queue for WDs that cannot use the lock-free path */
+         ScheduleThreadData   *_owner;      /**< Schedule data of the thread owning this queue */
+
+      private:
+         /*! \brief WDChaseLevDeque copy constructor (private)
+          */
+         WDChaseLevDeque ( const WDChaseLevDeque & );
+         /*! \brief WDChaseLevDeque copy assignment operator (private)
+          */
+         const WDChaseLevDeque & operator= ( const WDChaseLevDeque & );
+
+         /*! \brief Full (store-load) barrier required by the Chase-Lev protocol
+          */
+         static void fullFence ();
+
+         /*! \brief Returns whether the given thread is the owner of this queue
+          */
+         bool isOwner ( BaseThread const *thread ) const;
+
+         /*! \brief Owner push at the bottom of the deque */
+         void pushBottom ( WorkDescriptor *wd );
+         /*! \brief Owner pop at the bottom of the deque */
+         WorkDescriptor * takeBottom ();
+         /*! \brief Steal from the top of the deque (any thread) */
+         WorkDescriptor * stealTop ();
+
+         /*! \brief Checks the constraints of a WD already extracted from the deque
+          *  \return the WD (or slice) to run, or NULL if it had to be moved to the spill queue
+          */
+         template <typename Constraints>
+         WorkDescriptor * claim ( WorkDescriptor *wd, BaseThread const *thread );
+
+      public:
+         /*! \brief WDChaseLevDeque constructor
+          *  \param owner Schedule data of the thread that will own the queue
+          *  \param enableDeviceCounter Enables device counters in the locked spill queue
+          *  \param capacity Initial capacity (rounded up to a power of two), the deque grows on demand
+          */
+         WDChaseLevDeque( ScheduleThreadData *owner, bool enableDeviceCounter = true, long capacity = 1024 );
+         /*! \brief WDChaseLevDeque destructor
+          */
+         ~WDChaseLevDeque();
+
+         bool empty ( void ) const;
+         size_t size() const;
+
+         void push_front ( WorkDescriptor *wd );
+         void push_back( WorkDescriptor *wd );
+
+         /*! \brief Returns the lock of the spill queue, for batch operations. */
+         Lock& getLock();
+         void push_front( WD** wds, size_t numElems );
+         void push_back( WD** wds, size_t numElems );
+
+         template <typename Constraints>
+         WorkDescriptor * popFrontWithConstraints ( BaseThread const *thread );
+         template <typename Constraints>
+         WorkDescriptor * popBackWithConstraints ( BaseThread const *thread );
+         template <typename Constraints>
+         bool removeWDWithConstraints( BaseThread *thread, WorkDescriptor *toRem, WorkDescriptor **next );
+
+         WorkDescriptor * pop_front ( BaseThread *thread );
+         WorkDescriptor * pop_back ( BaseThread *thread );
+
+         /*! \brief Removes a WD from the spill queue
+          *  \note WDs in the lock-free part cannot be removed from the middle of the deque, so
+          *  this returns false for them and they will be found by a regular pop or steal.
+          */
+         bool removeWD( BaseThread *thread, WorkDescriptor *toRem, WorkDescriptor **next );
+
+         void increaseTasksInQueues( int tasks, int increment = 1 );
+         void decreaseTasksInQueues( int tasks, int decrement = 1 );
+
+         bool testDequeue();
    };
 
    /*! \brief Namespace used to refer WDPriorityQueue BaseContainer.
     */
    namespace WDPQ
    {
-       typedef std::list<WorkDescriptor *> BaseContainer;
+      /*! \brief Heap element: the WD, its priority when it was queued and
+       *  an insertion sequence number used to break ties.
+       */
+      template <typename T>
+      struct Entry
+      {
+         WorkDescriptor *_wd;
+         T               _priority;
+         long            _seq;
+
+         Entry () : _wd( NULL ), _priority(), _seq( 0 ) {}
+         Entry ( WorkDescriptor *wd, T priority, long seq ) : _wd( wd ), _priority( priority ), _seq( seq ) {}
+      };
    }
 
+   /*! \brief Priority queue of WDs implemented as an array-based d-ary heap.
+    *
+    *  WDs with higher priority are dequeued first (lower first if reverse is
+    *  set). Ties are broken by insertion order: push_back behaves as FIFO and
+    *  push_front as LIFO among the WDs with the same priority.
+    */
    template<typename T = WD::PriorityType>
    class WDPriorityQueue : public WDPool
    {
@@ -307,22 +433,23 @@ namespace nanos {
          typedef T         type;
          typedef std::const_mem_fun_t<T, WD> PriorityValueFun;
          typedef std::map< const Device *, Atomic<unsigned int> > WDDeviceCounter;
+         typedef WDPQ::Entry<T> Entry;
+         typedef std::vector<Entry> BaseContainer;
+
+         /*! \brief Arity of the heap */
+         static const size_t Arity = 4;
 
       private:
-         // TODO (gmiranda): Measure if vector is better as a container
-         WDPQ::BaseContainer _dq;
+         BaseContainer       _dq;
          Lock                _lock;
          size_t              _nelems;
-         /*! \brief When this is enabled, elements with the same priority
-          * as the one in the back will be inserted at the back.
-          * \note When this is enabled, it will override the LIFO behaviour
-          * in the above case.
-          */
-         bool              _optimise;
          
          /*! \brief Revert insertion */
          bool              _reverse;
 
+         /*! \brief Sequence numbers for push_back (growing) and push_front (decreasing) */
+         long              _backSeq, _frontSeq;
+
          /*! \brief Counts the number of WDs in the queue for each architecture */
          WDDeviceCounter   _ndevs;
          bool              _deviceCounter;
@@ -347,19 +474,26 @@ namespace nanos {
           *  \param fifo Insert WDs with the same after the current ones?
           */
          void insertOrdered ( WorkDescriptor *wd, bool fifo = true );
-         void insertOrdered ( WorkDescriptor ** wds, size_t numElems, bool fifo = true );
-         
-         /*! \brief Performs upper bound reversely or not depending on the settings */
-         WDPQ::BaseContainer::iterator upper_bound( const WD *wd );
-        
-         /*! \brief Performs lower bound reversely or not depending on the settings */
-         WDPQ::BaseContainer::iterator lower_bound( const WD *wd );
 
+         /*! \brief Returns true if a has to be dequeued before b */
+         bool before ( const Entry &a, const Entry &b ) const;
+
+         /*! \brief Heap maintenance */
+         void siftUp ( size_t pos );
+         void siftDown ( size_t pos );
+         void insertEntry ( const Entry &e );
+         void removeAt ( size_t pos );
+
+         /*! \brief Returns the position of wd in the heap or _dq.size() if not found */
+         size_t find ( const WorkDescriptor *wd ) const;
+
+         /*! \brief Updates the device counters and the max and min priorities after a removal */
+         void removed ( WorkDescriptor *wd );
 
       public:
          /*! \brief WDPriorityQueue default constructor
           */
-         WDPriorityQueue( bool enableDeviceCounter = true, bool optimise = true, bool reverse = false,
+         WDPriorityQueue( bool enableDeviceCounter = true, bool reverse = false,
                PriorityValueFun getter = std::mem_fun( &WD::getPriority ) );
          
          /*! \brief WDPriorityQueue destructor
@@ -389,9 +523,9 @@ namespace nanos {
 
          bool removeWD( BaseThread *thread, WorkDescriptor *toRem, WorkDescriptor **next );
 
-         /*! \brief Reorders the list a WD in the current queue.
+         /*! \brief Reorders a WD in the current queue.
           * It is needed when the priority of a WD is changed.
-          * \note This just removes and pushes the WD into the list.
+          * \note The WD gets the position of a WD pushed back with its new priority.
           * \return If the WD was found or not.
           * \note This method sets the lock upon entry (using LockBlock).
           */
@@ -402,6 +536,7 @@ namespace nanos {
          WD::PriorityType maxPriority() const;
          
          /*! \brief Returns the lowest priority, without blocking.
+          *  \note It is a lower bound: it is only refreshed on insertion and when the queue gets empty.
           */
          WD::PriorityType minPriority() const;
 
@@ -435,6 +435,76 @@ void WorkDescriptor::printCopies()
 void WorkDescriptor::setNotifyCopyFunc( void (*func)(WD &, BaseThread const&) ) {
    _notifyCopy = func;
 }
+void WorkDescriptor::submitBatchWithDependencies( size_t numWDs, WorkDescriptor **wds, size_t *numDeps, DataAccess **deps )
+{
+   WD **ready = NEW WD*[numWDs];
+   size_t numReady = 0;
+
+   DependableObject **depObjs = NEW DependableObject*[numWDs];
+   size_t *depObjNumDeps = NEW size_t[numWDs];
+   DataAccess **depObjDeps = NEW DataAccess*[numWDs];
+   size_t numDepObjs = 0;
+
+   for ( size_t i = 0; i < numWDs; i++ ) {
+      WD &wd = *wds[i];
+      if ( numDeps[i] == 0 ) {
+         ready[numReady++] = &wd;
+         continue;
+      }
+
+      wd._doSubmit = NEW DOSubmit();
+      wd._doSubmit->setWD(&wd);
+      // Hold the object until the whole batch is in the domain, so that the ones
+      // found ready are queued together below instead of one at a time
+      wd._doSubmit->increasePredecessors();
+
+      initCommutativeAccesses( wd, numDeps[i], deps[i] );
+
+      depObjs[numDepObjs] = wd._doSubmit;
+      depObjNumDeps[numDepObjs] = numDeps[i];
+      depObjDeps[numDepObjs] = deps[i];
+      numDepObjs++;
+   }
+
+   if ( numDepObjs > 0 ) {
+      // Defining call back (cb)
+      SchedulePolicySuccessorFunctor cb( *sys.getDefaultSchedulePolicy() );
+
+      _depsDomain->submitDependableObjects( numDepObjs, depObjs, depObjNumDeps, depObjDeps, &cb );
+
+      size_t numSatisfied = 0;
+      for ( size_t i = 0; i < numDepObjs; i++ ) {
+         DependableObject &depObj = *depObjs[i];
+         WD &wd = *depObj.getWD();
+         if ( sys._preSchedule ) {
+            sys._slots[depObj.getNum()].insert(&wd);
+         }
+         // Release the hold without triggering the submission
+         if ( depObj.decreasePredecessors( NULL, NULL, true, false ) == 0 && depObj.needsSubmission() ) {
+            depObj.dependenciesSatisfiedNoSubmit();
+            ready[numReady++] = &wd;
+            numSatisfied++;
+         }
+      }
+      if ( numSatisfied > 0 ) DependenciesDomain::decreaseTasksInGraph( numSatisfied );
+   }
+
+   // WDs the policy cannot queue in batch are submitted individually
+   SchedulePolicy *policy = sys.getDefaultSchedulePolicy();
+   size_t numBatch = 0;
+   for ( size_t i = 0; i < numReady; i++ ) {
+      WD *wd = ready[i];
+      if ( wd->getSlicer() == NULL && policy->isValidForBatch( wd ) ) ready[numBatch++] = wd;
+      else wd->submit( true );
+   }
+   if ( numBatch > 0 ) Scheduler::submit( ready, numBatch );
+
+   delete[] depObjDeps;
+   delete[] depObjNumDeps;
+   delete[] depObjs;
+   delete[] ready;
+}
+
 void WorkDescriptor::initCommutativeAccesses( WorkDescriptor &wd, size_t numDeps, DataAccess* deps )
 {
    size_t numCommutative = 0;
@@ -582,7 +652,8 @@ void WorkDescriptor::registerTaskReduction( void *p_orig, size_t p_size, size_t
 					   p_el_size,
 					   sys.getThreadManager()->getMaxThreads(),
 					   myThread->getCurrentWD()->getDepth(),
-					   sys._lazyPrivatizationEnabled
+					   sys._lazyPrivatizationEnabled,
+					   sys._treeReductionEnabled
 					   )
        );
    }
@@ -609,7 +680,8 @@ void WorkDescriptor::registerFortranArrayTaskReduction( void *p_orig, void *p_de
 					array_descriptor_size,
 					sys.getThreadManager()->getMaxThreads(),
 					myThread->getCurrentWD()->getDepth(),
-					sys._lazyPrivatizationEnabled
+					sys._lazyPrivatizationEnabled,
+					sys._treeReductionEnabled
 					)
      );
    }
@@ -220,6 +220,8 @@ inline bool WorkDescriptor::isTied() const { return _tiedTo != NULL; }
 
 inline bool WorkDescriptor::isTiedLocation() const { return _tiedToLocation != ( (memory_space_id_t) -1); }
 
+inline bool WorkDescriptor::hasCommutativeAccesses() const { return _commutativeOwners != NULL; }
+
 inline BaseThread* WorkDescriptor::isTiedTo() const { return _tiedTo; }
 
 inline memory_space_id_t WorkDescriptor::isTiedToLocation() const { return _tiedToLocation; }
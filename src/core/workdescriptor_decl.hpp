@@ -604,6 +604,17 @@ typedef std::set<const Device *>  DeviceList;
           */
          void submitWithDependencies( WorkDescriptor &wd, size_t numDeps, DataAccess* deps );
 
+         /*! \brief Add a batch of new WDs to the domain of this WD.
+          *
+          *  The whole batch is registered in the dependencies domain at once and the WDs
+          *  that are ready afterwards are handed to the scheduler in a single submission.
+          *  \param numWDs Number of WDs in the batch, all of them created by "this".
+          *  \param wds Array of WDs, in the order they would have been submitted.
+          *  \param numDeps Number of dependencies of each wd.
+          *  \param deps Arrays with the dependencies associated to each wd.
+          */
+         void submitBatchWithDependencies( size_t numWDs, WorkDescriptor **wds, size_t *numDeps, DataAccess **deps );
+
          /*! \brief Waits untill all (input) dependencies passed are satisfied for the _doWait object.
           *  \param numDeps Number of de dependencies.
           *  \param deps dependencies to wait on, should be input dependencies.
@@ -671,6 +682,9 @@ typedef std::set<const Device *>  DeviceList;
           *  Called when a task is finished.
           */
          void releaseCommutativeAccesses(); 
+         /*! \brief Whether the WD has commutative accesses (see tryAcquireCommutativeAccesses)
+          */
+         bool hasCommutativeAccesses() const;
 
          void setImplicit( bool b = true );
          bool isImplicit( void );
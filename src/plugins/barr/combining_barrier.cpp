@@ -0,0 +1,250 @@
+/*************************************************************************************/
+/*      Copyright 2015 Barcelona Supercomputing Center                               */
+/*                                                                                   */
+/*      This file is part of the NANOS++ library.                                    */
+/*                                                                                   */
+/*      NANOS++ is free software: you can redistribute it and/or modify              */
+/*      it under the terms of the GNU Lesser General Public License as published by  */
+/*      the Free Software Foundation, either version 3 of the License, or            */
+/*      (at your option) any later version.                                          */
+/*                                                                                   */
+/*      NANOS++ is distributed in the hope that it will be useful,                   */
+/*      but WITHOUT ANY WARRANTY; without even the implied warranty of               */
+/*      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                */
+/*      GNU Lesser General Public License for more details.                          */
+/*                                                                                   */
+/*      You should have received a copy of the GNU Lesser General Public License     */
+/*      along with NANOS++.  If not, see <http://www.gnu.org/licenses/>.             */
+/*************************************************************************************/
+
+#include "barrier.hpp"
+#include "system.hpp"
+#include "atomic.hpp"
+#include "schedule.hpp"
+#include "plugin.hpp"
+#include "synchronizedcondition.hpp"
+#include "allocator_decl.hpp"
+#include <vector>
+#include <algorithm>
+
+namespace nanos {
+   namespace ext {
+
+      /*! \class CombiningBarrier
+       *  \brief implements a topology-aware combining tree barrier
+       *
+       *  Participants are grouped following the machine topology (hardware
+       *  threads of a core or cache siblings first, then sockets), assuming
+       *  consecutive team ids are bound to consecutive cpus. Each tree node
+       *  has its own arrival counter and release flag, each one in its own
+       *  cache line. The last participant arriving to a node climbs to its
+       *  parent; the one completing the root computes the team reductions
+       *  and releases the tree top-down, so reductions need no extra pass.
+       */
+      class CombiningBarrier: public Barrier
+      {
+         private:
+            typedef MultipleSyncCond<EqualConditionChecker<bool> > ReleaseCond;
+
+            /*! \brief Combining tree node
+             *  \warning padding keeps arrivals and releases in different cache lines
+             */
+            struct Node {
+               char              _padHead[NANOS_CACHELINE];
+               Atomic<int>       _arrived;     /**< Participants already arrived in this episode */
+               char              _padArrived[NANOS_CACHELINE];
+#ifdef HAVE_NEW_GCC_ATOMIC_OPS
+               bool              _release;     /**< Flipped when the episode is completed */
+#else
+               volatile bool     _release;     /**< Flipped when the episode is completed */
+#endif
+               char              _padRelease[NANOS_CACHELINE];
+               int               _expected;    /**< Number of children of this node */
+               int               _parent;      /**< Parent node index, -1 for the root */
+               ReleaseCond       _releaseTrue;
+               ReleaseCond       _releaseFalse;
+
+               Node ( int expected, int parent ) : _arrived( 0 ), _release( false ), _expected( expected ), _parent( parent ),
+                  _releaseTrue( EqualConditionChecker<bool>( &_release, true ), expected ),
+                  _releaseFalse( EqualConditionChecker<bool>( &_release, false ), expected ) {}
+            };
+
+            typedef std::vector<Node *> NodeList;
+
+            /*! Maximum tree depth, bounds the per-participant release stack */
+            enum { MAX_DEPTH = 32 };
+
+            NodeList          _nodes;          /**< Tree nodes, leaves first and root last */
+            std::vector<int>  _leaves;         /**< Leaf node of each participant */
+            int               _numParticipants;
+
+            void clear ();
+            void build ( int numParticipants );
+
+         public:
+            static int                       _fanIn;          /**< Fan-in used above the known topology levels */
+            static std::vector<unsigned int> _topologyFanIns; /**< Fan-in of each hwloc topology level, bottom-up */
+
+            CombiningBarrier () : Barrier(), _nodes(), _leaves(), _numParticipants( 0 ) {}
+            CombiningBarrier ( const CombiningBarrier& orig ) : Barrier( orig ), _nodes(), _leaves(), _numParticipants( 0 )
+               { init( orig._numParticipants ); }
+
+            const CombiningBarrier & operator= ( const CombiningBarrier & barrier );
+
+            virtual ~CombiningBarrier() { clear(); }
+
+            void init ( int numParticipants );
+            void resize ( int numThreads );
+
+            void barrier ( int participant );
+      };
+
+      int CombiningBarrier::_fanIn = 4;
+      std::vector<unsigned int> CombiningBarrier::_topologyFanIns;
+
+      const CombiningBarrier & CombiningBarrier::operator= ( const CombiningBarrier & orig )
+      {
+         // self-assignment
+         if ( &orig == this ) return *this;
+
+         Barrier::operator=(orig);
+
+         build( orig._numParticipants );
+
+         return *this;
+      }
+
+      void CombiningBarrier::clear ()
+      {
+         for ( NodeList::iterator it = _nodes.begin(); it != _nodes.end(); it++ ) delete *it;
+         _nodes.clear();
+         _leaves.clear();
+      }
+
+      void CombiningBarrier::build ( int numParticipants )
+      {
+         clear();
+
+         _numParticipants = numParticipants;
+         if ( numParticipants <= 0 ) return;
+
+         _leaves.resize( numParticipants );
+
+         // Each iteration groups the members of the previous level (participants first)
+         int width = numParticipants;
+         int firstChild = -1;
+         unsigned level = 0;
+         do {
+            int fanIn = level < _topologyFanIns.size() ? (int) _topologyFanIns[level] : _fanIn;
+            if ( fanIn < 2 ) fanIn = 2;
+
+            int levelNodes = ( width + fanIn - 1 ) / fanIn;
+            int first = _nodes.size();
+
+            for ( int i = 0; i < levelNodes; i++ ) {
+               int expected = std::min( fanIn, width - i * fanIn );
+               _nodes.push_back( NEW Node( expected, -1 ) );
+            }
+
+            for ( int i = 0; i < width; i++ ) {
+               if ( firstChild < 0 ) _leaves[i] = first + i / fanIn;
+               else _nodes[firstChild + i]->_parent = first + i / fanIn;
+            }
+
+            firstChild = first;
+            width = levelNodes;
+            level++;
+         } while ( width > 1 );
+
+         ensure( level <= MAX_DEPTH, "Combining barrier tree is too deep" );
+      }
+
+      void CombiningBarrier::init( int numParticipants )
+      {
+         build( numParticipants );
+      }
+
+      void CombiningBarrier::resize( int numParticipants )
+      {
+         build( numParticipants );
+      }
+
+      void CombiningBarrier::barrier( int participant )
+      {
+         Node *won[MAX_DEPTH];
+         int numWon = 0;
+
+         Node *node = _nodes[_leaves[participant]];
+         bool sense;
+
+         // Climb while being the last one arriving to each node. A node
+         // cannot be released before we arrive, so the sense read here is safe
+         while ( true ) {
+            sense = !node->_release;
+
+            if ( ++node->_arrived != node->_expected ) {
+               // Somebody else will carry our arrival up the tree
+               if ( sense ) node->_releaseTrue.wait();
+               else node->_releaseFalse.wait();
+               break;
+            }
+
+            won[numWon++] = node;
+            if ( node->_parent < 0 ) {
+               // Fused reduction slot: the whole team has arrived
+               computeVectorReductions();
+               break;
+            }
+            node = _nodes[node->_parent];
+         }
+
+         // Release the nodes we completed, top-down
+         while ( numWon > 0 ) {
+            node = won[--numWon];
+            sense = !node->_release;
+
+            node->_arrived = 0;
+            memoryFence();
+
+            node->_release = sense;
+            if ( sense ) node->_releaseTrue.signal();
+            else node->_releaseFalse.signal();
+         }
+      }
+
+
+      static Barrier * createCombiningBarrier()
+      {
+          return NEW CombiningBarrier();
+      }
+
+
+      /*! \class CombiningBarrierPlugin
+       *  \brief plugin of the related CombiningBarrier class
+       *  \see CombiningBarrier
+       */
+      class CombiningBarrierPlugin : public Plugin
+      {
+
+         public:
+            CombiningBarrierPlugin() : Plugin( "Combining Tree Barrier Plugin",1 ) {}
+
+            virtual void config( Config &cfg )
+            {
+               cfg.setOptionsSection( "Combining barrier", "Combining tree barrier specific options" );
+               cfg.registerConfigOption( "barrier-fan-in", NEW Config::PositiveVar( CombiningBarrier::_fanIn ),
+                                         "Fan-in of the combining barrier levels not described by the topology (default: 4)" );
+               cfg.registerArgOption( "barrier-fan-in", "barrier-fan-in" );
+               cfg.registerEnvOption( "barrier-fan-in", "NX_BARRIER_FAN_IN" );
+            }
+
+            virtual void init() {
+               sys._hwloc.getTopologyFanIns( CombiningBarrier::_topologyFanIns );
+               sys.setDefaultBarrFactory( createCombiningBarrier );
+            }
+      };
+
+   }
+}
+
+DECLARE_PLUGIN("barr-combining",nanos::ext::CombiningBarrierPlugin);
@@ -0,0 +1,478 @@
+/*************************************************************************************/
+/*      Copyright 2015 Barcelona Supercomputing Center                               */
+/*                                                                                   */
+/*      This file is part of the NANOS++ library.                                    */
+/*                                                                                   */
+/*      NANOS++ is free software: you can redistribute it and/or modify              */
+/*      it under the terms of the GNU Lesser General Public License as published by  */
+/*      the Free Software Foundation, either version 3 of the License, or            */
+/*      (at your option) any later version.                                          */
+/*                                                                                   */
+/*      NANOS++ is distributed in the hope that it will be useful,                   */
+/*      but WITHOUT ANY WARRANTY; without even the implied warranty of               */
+/*      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                */
+/*      GNU Lesser General Public License for more details.                          */
+/*                                                                                   */
+/*      You should have received a copy of the GNU Lesser General Public License     */
+/*      along with NANOS++.  If not, see <http://www.gnu.org/licenses/>.             */
+/*************************************************************************************/
+
+#include "basedependenciesdomain.hpp"
+#include "plugin.hpp"
+#include "system.hpp"
+#include "config.hpp"
+#include "address.hpp"
+#include "compatibility.hpp"
+#include "atomic.hpp"
+#include <stdint.h>
+
+namespace nanos {
+   namespace ext {
+
+      /*! \brief Maps addresses to TrackableObjects in independently locked shards
+       *
+       *  Lookups do not lock: each shard publishes an open addressing table through an atomic
+       *  pointer, and entries are only added (the key is stored after its TrackableObject), so
+       *  readers either see a complete entry or an empty slot. Inserts (and table growth) only
+       *  lock their shard. Replaced tables are kept until the map is cleared, as readers may still
+       *  be probing them. TrackableObjects are allocated in chunks owned by each shard.
+       */
+      class ShardedDepsMap
+      {
+         public:
+            typedef Address::TargetType Key;
+            typedef std::vector< std::pair<Key, TrackableObject *> > EntryList;
+
+         private:
+            static const size_t _numShards = 16;       /**< Number of shards (power of 2) */
+            static const size_t _initialCapacity = 16; /**< Slots of the first table of a shard (power of 2) */
+            static const size_t _chunkObjects = 32;    /**< TrackableObjects allocated at once */
+
+            struct Entry {
+               Atomic<Key>        _key;                /**< Address, NULL if the slot is empty */
+               TrackableObject   *_object;             /**< Published before _key */
+            };
+
+            struct Table {
+               size_t             _mask;               /**< Number of slots - 1 */
+               Entry             *_entries;
+               Table             *_previous;           /**< Table replaced by this one */
+            };
+
+            struct Shard {
+               Lock               _lock;               /**< Serializes inserts */
+               Atomic<Table *>    _table;              /**< Current table (NULL until first insert) */
+               size_t             _size;               /**< Entries in current table */
+               std::vector<char *> _chunks;            /**< TrackableObject storage */
+               size_t             _chunkUsed;          /**< Objects used in the last chunk */
+
+               Shard () : _lock(), _table( (Table *) NULL ), _size( 0 ), _chunks(), _chunkUsed( _chunkObjects ) {}
+            };
+
+            Shard                 _shards[_numShards];
+
+            ShardedDepsMap ( const ShardedDepsMap & );
+            const ShardedDepsMap & operator= ( const ShardedDepsMap & );
+
+            static size_t hash ( Key key )
+            {
+               uintptr_t h = ( (uintptr_t) key ) >> 3;
+               h ^= h >> 16;
+               h *= 0x45d9f3b;
+               h ^= h >> 16;
+               return (size_t) h;
+            }
+
+            static Table * newTable ( size_t capacity, Table *previous )
+            {
+               Table *table = NEW Table;
+               table->_mask = capacity - 1;
+               table->_entries = NEW Entry[capacity];
+               table->_previous = previous;
+               for ( size_t i = 0; i < capacity; i++ ) {
+                  table->_entries[i]._key = (Key) NULL;
+                  table->_entries[i]._object = NULL;
+               }
+               return table;
+            }
+
+            static TrackableObject * find ( Table *table, Key key, size_t h )
+            {
+               if ( table == NULL ) return NULL;
+               for ( size_t i = h & table->_mask, n = 0; n <= table->_mask; i = ( i + 1 ) & table->_mask, n++ ) {
+                  Key current = table->_entries[i]._key.value();
+                  if ( current == key ) return table->_entries[i]._object;
+                  if ( current == NULL ) return NULL;
+               }
+               return NULL;
+            }
+
+            //! \brief Stores a new entry (shard lock held, table has free slots)
+            static void insert ( Table *table, Key key, TrackableObject *object, size_t h )
+            {
+               size_t i = h & table->_mask;
+               while ( table->_entries[i]._key.value() != NULL ) i = ( i + 1 ) & table->_mask;
+               table->_entries[i]._object = object;
+               table->_entries[i]._key = key;
+            }
+
+            //! \brief Returns a new TrackableObject from the shard chunks (shard lock held)
+            static TrackableObject * allocate ( Shard &shard )
+            {
+               if ( shard._chunkUsed == _chunkObjects ) {
+                  shard._chunks.push_back( NEW char[ sizeof( TrackableObject ) * _chunkObjects ] );
+                  shard._chunkUsed = 0;
+               }
+               void *addr = shard._chunks.back() + sizeof( TrackableObject ) * shard._chunkUsed++;
+               return new ( addr ) TrackableObject();
+            }
+
+            //! \brief Empties a shard, not thread safe
+            static void clear ( Shard &shard )
+            {
+               Table *table = shard._table.value();
+               if ( table != NULL ) {
+                  for ( size_t i = 0; i <= table->_mask; i++ ) {
+                     if ( table->_entries[i]._key.value() != NULL ) table->_entries[i]._object->~TrackableObject();
+                  }
+               }
+               while ( table != NULL ) {
+                  Table *previous = table->_previous;
+                  delete[] table->_entries;
+                  delete table;
+                  table = previous;
+               }
+               for ( std::vector<char *>::iterator it = shard._chunks.begin(); it != shard._chunks.end(); it++ ) {
+                  delete[] *it;
+               }
+               shard._chunks.clear();
+               shard._chunkUsed = _chunkObjects;
+               shard._size = 0;
+               shard._table = (Table *) NULL;
+            }
+
+         public:
+            ShardedDepsMap () {}
+
+            ~ShardedDepsMap ()
+            {
+               clear();
+            }
+
+            //! \brief Returns the TrackableObject of 'key' or NULL, without locking
+            TrackableObject * find ( Key key )
+            {
+               size_t h = hash( key );
+               return find( _shards[h & ( _numShards - 1 )]._table.value(), key, h / _numShards );
+            }
+
+            //! \brief Returns the TrackableObject of 'key', creating it if needed
+            TrackableObject * findOrInsert ( Key key )
+            {
+               size_t h = hash( key );
+               Shard &shard = _shards[h & ( _numShards - 1 )];
+               h /= _numShards;
+
+               TrackableObject *object = find( shard._table.value(), key, h );
+               if ( object != NULL ) return object;
+
+               SyncLockBlock lock( shard._lock );
+
+               Table *table = shard._table.value();
+               object = find( table, key, h );
+               if ( object != NULL ) return object;
+
+               // Keep the load factor under 1/2, the new table is filled before being published
+               if ( table == NULL || ( shard._size + 1 ) * 2 > table->_mask + 1 ) {
+                  Table *bigger = newTable( table == NULL ? _initialCapacity : ( table->_mask + 1 ) * 2, table );
+                  if ( table != NULL ) {
+                     for ( size_t i = 0; i <= table->_mask; i++ ) {
+                        Key current = table->_entries[i]._key.value();
+                        if ( current != NULL ) insert( bigger, current, table->_entries[i]._object, hash( current ) / _numShards );
+                     }
+                  }
+                  shard._table = bigger;
+                  table = bigger;
+               }
+
+               object = allocate( shard );
+               insert( table, key, object, h );
+               shard._size++;
+
+               return object;
+            }
+
+            //! \brief Appends all the entries to 'entries'
+            void getEntries ( EntryList &entries )
+            {
+               for ( size_t s = 0; s < _numShards; s++ ) {
+                  Table *table = _shards[s]._table.value();
+                  if ( table == NULL ) continue;
+                  for ( size_t i = 0; i <= table->_mask; i++ ) {
+                     Key current = table->_entries[i]._key.value();
+                     if ( current != NULL ) entries.push_back( std::make_pair( current, table->_entries[i]._object ) );
+                  }
+               }
+            }
+
+            //! \brief Removes all the entries, not thread safe
+            void clear ()
+            {
+               for ( size_t s = 0; s < _numShards; s++ ) clear( _shards[s] );
+            }
+      };
+
+      class ShardedDependenciesDomain : public BaseDependenciesDomain
+      {
+         private:
+            ShardedDepsMap _addressDependencyMap; /**< Used to track dependencies between DependableObject */
+
+         private:
+            ShardedDependenciesDomain ( const ShardedDependenciesDomain &depDomain );
+
+            //! \brief Clear current dependencies domain
+            //!
+            //! This function should be called withing a thread safe area. It is, when other
+            //! tasks can not update the domain: after a taskwait and before any task submission.
+            void clearDependenciesDomain ( void )
+            {
+               _addressDependencyMap.clear();
+            }
+
+            //! \brief Looks for the dependency's address, returns the trackableObject associated
+            //! \param dep Dependency to be checked.
+            //! \sa Dependency TrackableObject
+            TrackableObject* lookupDependency ( const Address& target )
+            {
+               return _addressDependencyMap.findOrInsert( target() );
+            }
+         protected:
+            //! \brief Assigns the DependableObject depObj an id in this domain and adds it to the domains dependency system.
+            //! \param depObj DependableObject to be added to the domain.
+            //! \param begin Iterator to the start of the list of dependencies to be associated to the Dependable Object.
+            //! \param end Iterator to the end of the mentioned list.
+            //! \param callback A function to call when a WD has a successor [Optional].
+            //! \sa Dependency DependableObject TrackableObject
+            template<typename iterator>
+            void submitDependableObjectInternal ( DependableObject &depObj, iterator begin, iterator end,
+                                                  SchedulePolicySuccessorFunctor* callback )
+            {
+               // Initializing several properties of the depObject
+               depObj.setId ( _lastDepObjId++ );
+               depObj.init();
+               depObj.setDependenciesDomain( this );
+            
+               // Object is not ready to get its dependencies satisfied, so we increase the
+               // number of predecessors to permit other dependableObjects to free some of
+               // its dependencies without triggering the "dependenciesSatisfied" method.
+               depObj.increasePredecessors();
+            
+               // flushDeps will be needed for waiting (see decreasePredecessors)
+               std::list<uint64_t> flushDeps;
+
+               // Iterate from begin to end, just to handle each data access
+               for ( iterator it = begin; it != end; it++ ) {
+                  DataAccess &dep = (*it);
+                  Address target = dep.getDepAddress();
+
+                  // if address == NULL, just ignore it
+                  if ( target() == NULL ) continue;
+                  AccessType const &accessType = dep.flags;
+
+                  submitDependableObjectDataAccess( depObj, target, accessType, callback );
+                  flushDeps.push_back( (uint64_t) target() );
+               }
+               
+               // Calling scheduler policy "atCreate"
+               sys.getDefaultSchedulePolicy()->atCreate( depObj );
+               
+               // To Task In Graph count consistent before releasing the fake dependency
+               increaseTasksInGraph();
+            
+               depObj.submitted();
+            
+               // Now everything is ready, release fake dependency
+               depObj.decreasePredecessors( &flushDeps, NULL, false, true );
+            }
+
+            //! \brief Adds a region access of a DependableObject to the domains dependency system.
+            //! \param depObj target DependableObject
+            //! \param target accessed memory address
+            //! \param accessType kind of region access
+            //! \param callback Function to call if an immediate predecessor is found.
+            void submitDependableObjectDataAccess( DependableObject &depObj, Address const &target,
+                                                   AccessType const &accessType, SchedulePolicySuccessorFunctor* callback )
+            {
+
+               ensure(!(accessType.concurrent && accessType.commutative),"Task cannot be concurrent AND commutative");
+
+               TrackableObject &status = *lookupDependency( target );
+
+               if ( status.getLastWriter() == &depObj ) return;
+
+               if ( accessType.concurrent || accessType.commutative ) {
+                  ensure(accessType.input && accessType.output,"Commutative & concurrent must be inout");
+                  ensure(!depObj.waits(), "Commutative & concurrent should not wait" );
+                  submitDependableObjectCommutativeDataAccess( depObj, target, accessType, status, callback );
+               } else if ( accessType.output && accessType.input ) {
+                  submitDependableObjectInoutDataAccess( depObj, target, accessType, status, callback );
+                  // We don't add as write target depObj.addWriteTarget(), due this op is done internally
+                  // in basedependencyregion as part of finding a writer. This same mechanism will be
+                  // used by commutative and concurrent access to summarize dependences
+                  if ( !depObj.waits() ) depObj.addReadTarget( target );
+               } else if ( accessType.output ) {
+                  // We don't add as write target depObj.addWriteTarget(), see comment above
+                  submitDependableObjectOutputDataAccess( depObj, target, accessType, status, callback );
+               } else if ( accessType.input  ) {
+                  submitDependableObjectInputDataAccess( depObj, target, accessType, status, callback );
+                  if ( !depObj.waits() ) depObj.addReadTarget( target );
+               } else {
+                  fatal( "Invalid data access" );
+               }
+
+            }
+            
+            inline void deleteLastWriter ( DependableObject &depObj, BaseDependency const &target )
+            {
+               const Address& address( static_cast<const Address&>( target ) );
+               TrackableObject *status = _addressDependencyMap.find( address() );
+
+               if ( status != NULL ) {
+                  status->deleteLastWriter(depObj);
+               }
+            }
+
+
+            inline void deleteReader ( DependableObject &depObj, BaseDependency const &target )
+            {
+               const Address& address( static_cast<const Address&>( target ) );
+               TrackableObject *status = _addressDependencyMap.find( address() );
+
+               if ( status != NULL ) {
+                  SyncLockBlock lock2( status->getReadersLock() );
+                  status->deleteReader(depObj);
+               }
+            }
+
+            inline void removeCommDO ( CommutationDO *commDO, BaseDependency const &target )
+            {
+               const Address& address( static_cast<const Address&>( target ) );
+               TrackableObject *status = _addressDependencyMap.find( address() );
+
+               if ( status != NULL && status->getCommDO ( ) == commDO ) {
+                  status->setCommDO ( 0 );
+               }
+            }
+
+         public:
+            ShardedDependenciesDomain() : BaseDependenciesDomain(), _addressDependencyMap() {}
+
+            ~ShardedDependenciesDomain() {}
+
+            //! \brief Lookups do not take the instance lock, so finishing objects do not need it either
+            bool finishNeedsInstanceLock ( void ) const { return false; }
+
+            /*!
+             *  \note This function cannot be implemented in
+             *  BaseDependenciesDomain since it calls a template function,
+             *  and they cannot be virtual.
+             */
+            inline void submitDependableObject ( DependableObject &depObj, std::vector<DataAccess> &deps, SchedulePolicySuccessorFunctor* callback )
+            {
+               submitDependableObjectInternal ( depObj, deps.begin(), deps.end(), callback );
+            }
+
+            /*!
+             *  \note This function cannot be implemented in
+             *  BaseDependenciesDomain since it calls a template function,
+             *  and they cannot be virtual.
+             */
+            inline void submitDependableObject ( DependableObject &depObj, size_t numDeps, DataAccess* deps, SchedulePolicySuccessorFunctor* callback )
+            {
+               submitDependableObjectInternal ( depObj, deps, deps+numDeps, callback );
+            }
+
+            //! \note Lookups only take shard locks, so there is no point in holding the instance lock
+            void submitDependableObjects ( size_t numObjects, DependableObject **depObjs, size_t *numDeps, DataAccess **deps,
+                                           SchedulePolicySuccessorFunctor* callback )
+            {
+               for ( size_t i = 0; i < numObjects; i++ ) {
+                  submitDependableObjectInternal ( *depObjs[i], deps[i], deps[i]+numDeps[i], callback );
+               }
+            }
+
+            bool haveDependencePendantWrites ( void *addr )
+            {
+               TrackableObject *status = _addressDependencyMap.find( addr );
+               return status != NULL && status->getLastWriter() != NULL;
+            }
+
+            void finalizeAllReductions ( void )
+            {
+               ShardedDepsMap::EntryList entries;
+               _addressDependencyMap.getEntries( entries );
+               for ( ShardedDepsMap::EntryList::iterator it = entries.begin(); it != entries.end(); it++ ) {
+                  TrackableObject& status = *( it->second );
+                  Address::TargetType target = it->first;
+                  CommutationDO *commDO = status.getCommDO();
+                  if ( commDO != NULL ) {
+                     status.setCommDO( NULL );
+                     status.setLastWriter( *commDO );
+
+                     TaskReduction *tr = myThread->getCurrentWD()->getTaskReduction( (const void *) target );
+                     if ( tr != NULL ) {
+                        if ( myThread->getCurrentWD()->getDepth() == tr->getDepth() )
+                           commDO->setTaskReduction( tr );
+                     }
+
+                     commDO->resetReferences();
+
+                     //! Finally decrease dummy dependence added in createCommutationDO
+                     std::list<uint64_t> flushDeps;
+                     commDO->decreasePredecessors( &flushDeps, NULL, false, false );
+                  }
+               }
+            }
+      };
+
+      template void ShardedDependenciesDomain::submitDependableObjectInternal ( DependableObject &depObj, DataAccess* begin, DataAccess* end, SchedulePolicySuccessorFunctor* callback );
+      template void ShardedDependenciesDomain::submitDependableObjectInternal ( DependableObject &depObj, std::vector<DataAccess>::iterator begin, std::vector<DataAccess>::iterator end, SchedulePolicySuccessorFunctor* callback );
+
+      /*! \brief Plain (address based) dependencies with a sharded, lock-free lookup map.
+       */
+      class ShardedDependenciesManager : public DependenciesManager
+      {
+         public:
+            ShardedDependenciesManager() : DependenciesManager("Nanos sharded plain dependencies domain") {}
+            virtual ~ShardedDependenciesManager () {}
+
+            /*! \brief Creates a sharded dependencies domain.
+             */
+            DependenciesDomain* createDependenciesDomain () const
+            {
+               return NEW ShardedDependenciesDomain();
+            }
+      };
+
+      class NanosShardedDepsPlugin : public Plugin
+      {
+
+         public:
+            NanosShardedDepsPlugin() : Plugin( "Nanos++ sharded plain dependencies management plugin",1 )
+            {
+            }
+
+            virtual void config ( Config &cfg )
+            {
+            }
+
+            virtual void init()
+            {
+               sys.setDependenciesManager(NEW ShardedDependenciesManager());
+            }
+      };
+
+   }
+}
+
+DECLARE_PLUGIN("deps-sharded",nanos::ext::NanosShardedDepsPlugin);
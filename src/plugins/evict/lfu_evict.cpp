@@ -0,0 +1,87 @@
+/*************************************************************************************/
+/*      Copyright 2015 Barcelona Supercomputing Center                               */
+/*                                                                                   */
+/*      This file is part of the NANOS++ library.                                    */
+/*                                                                                   */
+/*      NANOS++ is free software: you can redistribute it and/or modify              */
+/*      it under the terms of the GNU Lesser General Public License as published by  */
+/*      the Free Software Foundation, either version 3 of the License, or            */
+/*      (at your option) any later version.                                          */
+/*                                                                                   */
+/*      NANOS++ is distributed in the hope that it will be useful,                   */
+/*      but WITHOUT ANY WARRANTY; without even the implied warranty of               */
+/*      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                */
+/*      GNU Lesser General Public License for more details.                          */
+/*                                                                                   */
+/*      You should have received a copy of the GNU Lesser General Public License     */
+/*      along with NANOS++.  If not, see <http://www.gnu.org/licenses/>.             */
+/*************************************************************************************/
+
+#include "evictionpolicy_decl.hpp"
+#include "regioncache.hpp"
+#include "plugin.hpp"
+#include "system.hpp"
+#include "config.hpp"
+#include <math.h>
+#include <algorithm>
+
+namespace nanos {
+   namespace ext {
+
+      /*! \brief Least frequently used, with aging
+       *
+       *  The number of task accesses of a chunk is halved for every aging period (measured in
+       *  accesses to its cache) that it has gone unused, so chunks that were hot some time ago
+       *  do not stay in the cache forever. The stored count is aged when the chunk is accessed
+       *  again, and the cost ages it for the time since then.
+       */
+      class LFUEviction : public EvictionPolicy
+      {
+         public:
+            static unsigned int _agingPeriod;
+
+            LFUEviction() : EvictionPolicy( "lfu" ) {}
+            virtual ~LFUEviction() {}
+
+            static unsigned int getAgingPeriods( unsigned int idle )
+            {
+               return _agingPeriod > 0 ? idle / _agingPeriod : 0;
+            }
+
+            virtual double getEvictionCost( AllocatedChunk const &chunk, unsigned int now ) const
+            {
+               unsigned int periods = getAgingPeriods( now - chunk.getLastUse() );
+               return ldexp( (double) chunk.getUseCount(), - (int) std::min( periods, 1024U ) );
+            }
+
+            virtual unsigned int getAgedUseCount( unsigned int uses, unsigned int idle ) const
+            {
+               unsigned int periods = getAgingPeriods( idle );
+               return periods < 32 ? uses >> periods : 0;
+            }
+      };
+
+      unsigned int LFUEviction::_agingPeriod = 64;
+
+      class LFUEvictionPlugin : public Plugin
+      {
+         public:
+            LFUEvictionPlugin() : Plugin( "LFU region cache eviction Plugin",1 ) {}
+
+            virtual void config ( Config &cfg )
+            {
+               cfg.setOptionsSection( "LFU eviction", "Least frequently used region cache eviction" );
+               cfg.registerConfigOption ( "evict-lfu-aging-period", NEW Config::UintVar( LFUEviction::_agingPeriod ),
+                                          "Cache accesses after which the access count of an unused chunk is halved (default = 64, 0 disables aging)" );
+               cfg.registerArgOption( "evict-lfu-aging-period", "evict-lfu-aging-period" );
+            }
+
+            virtual void init() {
+               sys.setEvictionPolicy( NEW LFUEviction() );
+            }
+      };
+
+   }
+}
+
+DECLARE_PLUGIN("evict-lfu",nanos::ext::LFUEvictionPlugin);
@@ -0,0 +1,65 @@
+/*************************************************************************************/
+/*      Copyright 2015 Barcelona Supercomputing Center                               */
+/*                                                                                   */
+/*      This file is part of the NANOS++ library.                                    */
+/*                                                                                   */
+/*      NANOS++ is free software: you can redistribute it and/or modify              */
+/*      it under the terms of the GNU Lesser General Public License as published by  */
+/*      the Free Software Foundation, either version 3 of the License, or            */
+/*      (at your option) any later version.                                          */
+/*                                                                                   */
+/*      NANOS++ is distributed in the hope that it will be useful,                   */
+/*      but WITHOUT ANY WARRANTY; without even the implied warranty of               */
+/*      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                */
+/*      GNU Lesser General Public License for more details.                          */
+/*                                                                                   */
+/*      You should have received a copy of the GNU Lesser General Public License     */
+/*      along with NANOS++.  If not, see <http://www.gnu.org/licenses/>.             */
+/*************************************************************************************/
+
+#include "evictionpolicy_decl.hpp"
+#include "regioncache.hpp"
+#include "plugin.hpp"
+#include "system.hpp"
+#include <algorithm>
+
+namespace nanos {
+   namespace ext {
+
+      /*! \brief Least recently used: evicts the chunk that has gone the longest without a task access
+       */
+      class LRUEviction : public EvictionPolicy
+      {
+         public:
+            LRUEviction() : EvictionPolicy( "lru" ) {}
+            virtual ~LRUEviction() {}
+
+            virtual double getEvictionCost( AllocatedChunk const &chunk, unsigned int now ) const
+            {
+               // In (0,1], decreasing with the age
+               return 1.0 / ( 1.0 + (double) ( now - chunk.getLastUse() ) );
+            }
+
+            virtual double getWindowCost( double windowCost, double chunkCost ) const
+            {
+               // A set of chunks is as recent as its most recently used one
+               return std::max( windowCost, chunkCost );
+            }
+      };
+
+      class LRUEvictionPlugin : public Plugin
+      {
+         public:
+            LRUEvictionPlugin() : Plugin( "LRU region cache eviction Plugin",1 ) {}
+
+            virtual void config ( Config &cfg ) {}
+
+            virtual void init() {
+               sys.setEvictionPolicy( NEW LRUEviction() );
+            }
+      };
+
+   }
+}
+
+DECLARE_PLUGIN("evict-lru",nanos::ext::LRUEvictionPlugin);
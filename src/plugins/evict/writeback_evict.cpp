@@ -0,0 +1,60 @@
+/*************************************************************************************/
+/*      Copyright 2015 Barcelona Supercomputing Center                               */
+/*                                                                                   */
+/*      This file is part of the NANOS++ library.                                    */
+/*                                                                                   */
+/*      NANOS++ is free software: you can redistribute it and/or modify              */
+/*      it under the terms of the GNU Lesser General Public License as published by  */
+/*      the Free Software Foundation, either version 3 of the License, or            */
+/*      (at your option) any later version.                                          */
+/*                                                                                   */
+/*      NANOS++ is distributed in the hope that it will be useful,                   */
+/*      but WITHOUT ANY WARRANTY; without even the implied warranty of               */
+/*      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                */
+/*      GNU Lesser General Public License for more details.                          */
+/*                                                                                   */
+/*      You should have received a copy of the GNU Lesser General Public License     */
+/*      along with NANOS++.  If not, see <http://www.gnu.org/licenses/>.             */
+/*************************************************************************************/
+
+#include "evictionpolicy_decl.hpp"
+#include "regioncache.hpp"
+#include "plugin.hpp"
+#include "system.hpp"
+
+namespace nanos {
+   namespace ext {
+
+      /*! \brief Cheapest write-back first: evicts clean chunks before dirty ones, and small dirty
+       *  chunks before big ones. Chunks with the same bytes to write back go in LRU order.
+       */
+      class WritebackEviction : public EvictionPolicy
+      {
+         public:
+            WritebackEviction() : EvictionPolicy( "writeback" ) {}
+            virtual ~WritebackEviction() {}
+
+            virtual double getEvictionCost( AllocatedChunk const &chunk, unsigned int now ) const
+            {
+               // The recency term is below one byte, so it only breaks ties
+               double recency = 0.5 / ( 1.0 + (double) ( now - chunk.getLastUse() ) );
+               return ( chunk.isDirty() ? (double) chunk.getSize() : 0.0 ) + recency;
+            }
+      };
+
+      class WritebackEvictionPlugin : public Plugin
+      {
+         public:
+            WritebackEvictionPlugin() : Plugin( "Write-back cost region cache eviction Plugin",1 ) {}
+
+            virtual void config ( Config &cfg ) {}
+
+            virtual void init() {
+               sys.setEvictionPolicy( NEW WritebackEviction() );
+            }
+      };
+
+   }
+}
+
+DECLARE_PLUGIN("evict-writeback",nanos::ext::WritebackEvictionPlugin);
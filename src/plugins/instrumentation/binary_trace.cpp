@@ -0,0 +1,446 @@
+/*************************************************************************************/
+/*      Copyright 2015 Barcelona Supercomputing Center                               */
+/*                                                                                   */
+/*      This file is part of the NANOS++ library.                                    */
+/*                                                                                   */
+/*      NANOS++ is free software: you can redistribute it and/or modify              */
+/*      it under the terms of the GNU Lesser General Public License as published by  */
+/*      the Free Software Foundation, either version 3 of the License, or            */
+/*      (at your option) any later version.                                          */
+/*                                                                                   */
+/*      NANOS++ is distributed in the hope that it will be useful,                   */
+/*      but WITHOUT ANY WARRANTY; without even the implied warranty of               */
+/*      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                */
+/*      GNU Lesser General Public License for more details.                          */
+/*                                                                                   */
+/*      You should have received a copy of the GNU Lesser General Public License     */
+/*      along with NANOS++.  If not, see <http://www.gnu.org/licenses/>.             */
+/*************************************************************************************/
+
+#include "plugin.hpp"
+#include "system.hpp"
+#include "instrumentation.hpp"
+#include "instrumentationcontext_decl.hpp"
+#include "allocator_decl.hpp"
+#include "atomic.hpp"
+#include "lock.hpp"
+#include "binary_trace_format.hpp"
+
+#include <fstream>
+#include <algorithm>
+#include <sstream>
+#include <string.h>
+#include <stdlib.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+
+namespace nanos {
+
+#ifdef NANOS_INSTRUMENTATION_ENABLED
+/*! \class BinaryTraceStream
+ *  \brief Per-thread ring buffer of binary records and its memory-mapped output file
+ *
+ *  The owner thread is the only one appending records (moving _head) and the
+ *  flusher thread the only one draining them (moving _tail), so no locks are needed.
+ *  When the buffer is full, new records are dropped and counted instead of blocking.
+ */
+class BinaryTraceStream
+{
+   private:
+      char                  _padHead[NANOS_CACHELINE];
+      volatile uint64_t     _head;       /**< Next record to write (owner) */
+      char                  _padProducer[NANOS_CACHELINE - sizeof(uint64_t)];
+      volatile uint64_t     _tail;       /**< Next record to flush (flusher) */
+      char                  _padConsumer[NANOS_CACHELINE - sizeof(uint64_t)];
+      uint64_t              _dropped;    /**< Records lost because the buffer was full (owner) */
+      uint64_t              _mask;       /**< Buffer capacity - 1 */
+      BinaryTraceRecord    *_records;    /**< Ring buffer */
+
+      int                   _fd;         /**< Output file */
+      char                 *_window;     /**< Currently mapped window of the output file */
+      uint64_t              _windowOffset;
+      size_t                _windowPos;
+
+      enum { WINDOW_SIZE = 4 * 1024 * 1024 }; /**< Bytes mapped at once */
+
+      BinaryTraceStream ( const BinaryTraceStream & );
+      const BinaryTraceStream & operator= ( const BinaryTraceStream & );
+
+      void mapWindow ( uint64_t offset )
+      {
+         fatal_cond( ftruncate( _fd, offset + (size_t) WINDOW_SIZE ) != 0, "binary_trace: cannot grow trace file" );
+         void *map = mmap( NULL, (size_t) WINDOW_SIZE, PROT_WRITE, MAP_SHARED, _fd, offset );
+         fatal_cond( map == MAP_FAILED, "binary_trace: cannot map trace file" );
+         _window = (char *) map;
+         _windowOffset = offset;
+         _windowPos = 0;
+      }
+
+      void write ( const void *data, size_t size )
+      {
+         const char *src = (const char *) data;
+         while ( size > 0 ) {
+            if ( _windowPos == (size_t) WINDOW_SIZE ) {
+               munmap( _window, (size_t) WINDOW_SIZE );
+               mapWindow( _windowOffset + (size_t) WINDOW_SIZE );
+            }
+            size_t n = std::min( size, (size_t) WINDOW_SIZE - _windowPos );
+            memcpy( _window + _windowPos, src, n );
+            _windowPos += n;
+            src += n;
+            size -= n;
+         }
+      }
+
+   public:
+      BinaryTraceStream ( const std::string &fileName, size_t capacity, int threadId, unsigned stream, uint64_t startTime )
+         : _head( 0 ), _tail( 0 ), _dropped( 0 ), _mask( capacity - 1 ), _records( NULL ),
+           _fd( -1 ), _window( NULL ), _windowOffset( 0 ), _windowPos( 0 )
+      {
+         void *mem;
+         fatal_cond( posix_memalign( &mem, NANOS_CACHELINE, capacity * sizeof( BinaryTraceRecord ) ) != 0,
+                     "binary_trace: cannot allocate trace buffer" );
+         _records = (BinaryTraceRecord *) mem;
+
+         _fd = open( fileName.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644 );
+         fatal_cond( _fd < 0, "binary_trace: cannot create " + fileName );
+         mapWindow( 0 );
+
+         BinaryTraceHeader header;
+         memset( &header, 0, sizeof( header ) );
+         memcpy( header.magic, NANOS_BINARY_TRACE_MAGIC, sizeof( header.magic ) );
+         header.version = NANOS_BINARY_TRACE_VERSION;
+         header.recordSize = sizeof( BinaryTraceRecord );
+         header.threadId = threadId;
+         header.stream = stream;
+         header.startTime = startTime;
+         write( &header, sizeof( header ) );
+      }
+
+      ~BinaryTraceStream ()
+      {
+         if ( _window != NULL ) munmap( _window, (size_t) WINDOW_SIZE );
+         if ( _fd >= 0 ) {
+            // Trim the unused part of the last window
+            if ( ftruncate( _fd, _windowOffset + _windowPos ) != 0 ) warning( "binary_trace: cannot trim trace file" );
+            close( _fd );
+         }
+         free( _records );
+      }
+
+      uint64_t getDropped ( void ) const { return _dropped; }
+
+      //! \brief Append a list of events (owner thread only)
+      void append ( uint64_t time, unsigned int count, Instrumentation::Event *events )
+      {
+         uint64_t head = _head;
+         if ( head + count - _tail > _mask + 1 ) {
+            _dropped += count;
+            return;
+         }
+
+         for ( unsigned int i = 0; i < count; i++ ) {
+            Instrumentation::Event &e = events[i];
+            BinaryTraceRecord &r = _records[( head + i ) & _mask];
+            r.time = time;
+            r.value = e.getValue();
+            r.id = e.getId();
+            r.key = e.getKey();
+            r.type = (uint16_t) e.getType();
+            r.domain = (uint16_t) e.getDomain();
+         }
+
+         memoryFence();     // Records must be visible before moving the head
+         _head = head + count;
+      }
+
+      //! \brief Copy the pending records to the output file (flusher thread only)
+      void flush ( void )
+      {
+         uint64_t head = _head;
+         uint64_t tail = _tail;
+         memoryFence();     // Do not read records before reading the head
+
+         while ( tail < head ) {
+            uint64_t first = tail & _mask;
+            uint64_t n = std::min( head - tail, _mask + 1 - first );
+            write( &_records[first], n * sizeof( BinaryTraceRecord ) );
+            tail += n;
+         }
+
+         memoryFence();     // Records must be copied before releasing their slots
+         _tail = tail;
+      }
+};
+#endif
+
+class InstrumentationBinaryTrace: public Instrumentation
+{
+#ifndef NANOS_INSTRUMENTATION_ENABLED
+   public:
+      // constructor
+      InstrumentationBinaryTrace() : Instrumentation() {}
+      // destructor
+      ~InstrumentationBinaryTrace() {}
+
+      // low-level instrumentation interface (mandatory functions)
+      void initialize( void ) {}
+      void finalize( void ) {}
+      void disable( void ) {}
+      void enable( void ) {}
+      void addResumeTask( WorkDescriptor &w ) {}
+      void addSuspendTask( WorkDescriptor &w, bool last ) {}
+      void addEventList ( unsigned int count, Event *events ) {}
+      void threadStart( BaseThread &thread ) {}
+      void threadFinish ( BaseThread &thread ) {}
+#else
+   public:
+      static std::string   _prefix;        /**< Trace files prefix */
+      static int           _bufferSize;    /**< Records per thread buffer */
+      static int           _flushPeriod;   /**< Flusher period (us) */
+
+   private:
+      enum { MAX_STREAMS = 1024 };
+
+      //! \brief Set by the owner of a stream while it appends, so that finalize can wait for it
+      struct AppendFlag {
+         volatile bool     _busy;
+         char              _pad[NANOS_CACHELINE - sizeof(bool)];
+      };
+
+      static __thread BinaryTraceStream *_myStream;
+      static __thread unsigned           _myIndex;      /**< Slot of _myStream */
+      static __thread unsigned           _myGeneration; /**< Trace generation _myStream belongs to */
+
+      BinaryTraceStream   *_streams[MAX_STREAMS];
+      AppendFlag           _appending[MAX_STREAMS];   /**< Not freed with the streams: checked by stale appenders */
+      Atomic<unsigned>     _numStreams;
+      unsigned             _generation;   /**< Increased at every finalize, which deletes the streams */
+      Lock                 _streamsLock;
+      size_t               _capacity;
+      uint64_t             _startTime;
+#ifdef HAVE_NEW_GCC_ATOMIC_OPS
+      bool                 _enabled;
+      bool                 _stop;
+#else
+      volatile bool        _enabled;
+      volatile bool        _stop;
+#endif
+      bool                 _initialized;
+      pthread_t            _flusher;
+
+      static uint64_t getTime ( void )
+      {
+         struct timespec ts;
+         clock_gettime( CLOCK_MONOTONIC, &ts );
+         return (uint64_t) ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+      }
+
+      //! \brief Registers the calling thread stream (once per thread)
+      BinaryTraceStream * createStream ( void )
+      {
+         LockBlock lock( _streamsLock );
+
+         // Checked with the lock held: finalize deletes the streams with it
+         unsigned stream = _numStreams.value();
+         if ( stream == MAX_STREAMS || !_enabled ) return NULL;
+
+         std::ostringstream fileName;
+         fileName << _prefix << "." << stream << ".bin";
+
+         _streams[stream] = NEW BinaryTraceStream( fileName.str(), _capacity, myThread ? myThread->getId() : -1,
+                                                   stream, _startTime );
+         memoryFence();
+         _numStreams++;
+
+         _myIndex = stream;
+         return _streams[stream];
+      }
+
+      void flushAll ( void )
+      {
+         unsigned num = _numStreams.value();
+         memoryFence();
+         for ( unsigned i = 0; i < num; i++ ) _streams[i]->flush();
+      }
+
+      static void * flusherLoop ( void *arg )
+      {
+         InstrumentationBinaryTrace *trace = (InstrumentationBinaryTrace *) arg;
+         while ( !trace->_stop ) {
+            trace->flushAll();
+            usleep( _flushPeriod );
+         }
+         return NULL;
+      }
+
+      static std::string sanitize ( std::string s )
+      {
+         for ( size_t i = 0; i < s.size(); i++ ) if ( s[i] == '\n' ) s[i] = ' ';
+         return s;
+      }
+
+      void writeDictionary ( void )
+      {
+         std::string fileName = _prefix + ".dict";
+         std::ofstream dict( fileName.c_str() );
+         if ( !dict.good() ) {
+            warning0( "binary_trace: cannot write " << fileName );
+            return;
+         }
+
+         dict << "streams " << _numStreams.value() << std::endl;
+
+         InstrumentationDictionary *iD = getInstrumentationDictionary();
+         InstrumentationDictionary::ConstKeyMapIterator itK;
+         InstrumentationKeyDescriptor::ConstValueMapIterator itV;
+         for ( itK = iD->beginKeyMap(); itK != iD->endKeyMap(); itK++ ) {
+            InstrumentationKeyDescriptor *kD = itK->second;
+            if ( kD->getId() == 0 ) continue;
+            dict << "key " << kD->getId() << " " << ( kD->isStacked() ? 1 : 0 ) << " " << itK->first << " " << sanitize( kD->getDescription() ) << std::endl;
+            for ( itV = kD->beginValueMap(); itV != kD->endValueMap(); itV++ ) {
+               dict << "value " << kD->getId() << " " << (itV->second)->getId() << " "
+                    << sanitize( (itV->second)->getDescription() ) << std::endl;
+            }
+         }
+      }
+
+   public:
+      // constructor
+      InstrumentationBinaryTrace() : Instrumentation( *NEW InstrumentationContextDisabled() ),
+         _appending(), _numStreams( 0 ), _generation( 1 ), _streamsLock(), _capacity( 0 ), _startTime( 0 ), _enabled( false ), _stop( false ),
+         _initialized( false ), _flusher() {}
+      // destructor
+      ~InstrumentationBinaryTrace() {}
+
+      // low-level instrumentation interface (mandatory functions)
+      void initialize( void )
+      {
+         _capacity = 1;
+         while ( _capacity < (size_t) _bufferSize ) _capacity <<= 1;
+
+         _startTime = getTime();
+
+         fatal_cond( pthread_create( &_flusher, NULL, flusherLoop, this ) != 0, "binary_trace: cannot create flusher thread" );
+
+         _initialized = true;
+         _enabled = true;
+      }
+
+      void finalize( void )
+      {
+         if ( !_initialized ) return;
+         _initialized = false;   // enable() must not turn the trace on again while it is finalized
+         _enabled = false;
+         _stop = true;
+         pthread_join( _flusher, NULL );
+
+         // Threads still appending (they saw the trace enabled) must be done before the streams go
+         memoryFence();
+         for ( unsigned i = 0; i < MAX_STREAMS; i++ ) {
+            while ( _appending[i]._busy ) sched_yield();
+         }
+
+         // Last flush and close
+         flushAll();
+
+         LockBlock lock( _streamsLock );
+         uint64_t dropped = 0;
+         for ( unsigned i = 0; i < _numStreams.value(); i++ ) {
+            dropped += _streams[i]->getDropped();
+            delete _streams[i];
+         }
+
+         writeDictionary();
+
+         message0( "Binary trace written to " << _prefix << ".*.bin (" << _numStreams.value() << " streams), use nanox-bintrace to convert it" );
+         if ( dropped > 0 ) {
+            warning0( "binary_trace: " << dropped << " events were dropped, consider increasing --bintrace-buffer-size" );
+         }
+         _numStreams = 0;
+         _generation++;
+         _myStream = NULL;
+      }
+
+      void disable( void ) { _enabled = false; }
+      void enable( void ) { _enabled = _initialized; }
+      void addResumeTask( WorkDescriptor &w ) {}
+      void addSuspendTask( WorkDescriptor &w, bool last ) {}
+
+      void addEventList ( unsigned int count, Event *events )
+      {
+         if ( !_enabled ) return;
+
+         // The stream of a thread is gone once the trace it was created for is finalized
+         BinaryTraceStream *stream = _myStream;
+         unsigned generation = _generation;
+         if ( stream == NULL || _myGeneration != generation ) {
+            stream = _myStream = createStream();
+            if ( stream == NULL ) return;
+            _myGeneration = generation;
+         }
+
+         // Checked again once flagged: finalize may have started (and deleted the stream) meanwhile
+         AppendFlag &flag = _appending[_myIndex];
+         flag._busy = true;
+         memoryFence();
+         if ( _enabled && _generation == generation ) stream->append( getTime(), count, events );
+         memoryFence();
+         flag._busy = false;
+      }
+
+      void threadStart( BaseThread &thread ) {}
+      void threadFinish ( BaseThread &thread ) {}
+#endif
+};
+
+#ifdef NANOS_INSTRUMENTATION_ENABLED
+__thread BinaryTraceStream *InstrumentationBinaryTrace::_myStream = NULL;
+__thread unsigned InstrumentationBinaryTrace::_myIndex = 0;
+__thread unsigned InstrumentationBinaryTrace::_myGeneration = 0;
+std::string InstrumentationBinaryTrace::_prefix = "nanox-trace";
+int InstrumentationBinaryTrace::_bufferSize = 65536;
+int InstrumentationBinaryTrace::_flushPeriod = 10000;
+#endif
+
+namespace ext {
+
+class InstrumentationBinaryTracePlugin : public Plugin {
+   public:
+      InstrumentationBinaryTracePlugin () : Plugin("Instrumentation which writes a per-thread binary trace.",1) {}
+      ~InstrumentationBinaryTracePlugin () {}
+
+      void config( Config &cfg )
+      {
+#ifdef NANOS_INSTRUMENTATION_ENABLED
+         cfg.setOptionsSection( "Binary trace plugin", "Binary trace instrumentation specific options" );
+         cfg.registerConfigOption( "bintrace-prefix", NEW Config::StringVar( InstrumentationBinaryTrace::_prefix ),
+                                   "Prefix of the trace files (default: nanox-trace)" );
+         cfg.registerArgOption( "bintrace-prefix", "bintrace-prefix" );
+         cfg.registerEnvOption( "bintrace-prefix", "NX_BINTRACE_PREFIX" );
+
+         cfg.registerConfigOption( "bintrace-buffer-size", NEW Config::PositiveVar( InstrumentationBinaryTrace::_bufferSize ),
+                                   "Events buffered per thread before being dropped (default: 65536)" );
+         cfg.registerArgOption( "bintrace-buffer-size", "bintrace-buffer-size" );
+
+         cfg.registerConfigOption( "bintrace-flush-period", NEW Config::PositiveVar( InstrumentationBinaryTrace::_flushPeriod ),
+                                   "Microseconds between flushes of the thread buffers (default: 10000)" );
+         cfg.registerArgOption( "bintrace-flush-period", "bintrace-flush-period" );
+#endif
+      }
+
+      void init ()
+      {
+         sys.setInstrumentation( NEW InstrumentationBinaryTrace() );
+      }
+};
+
+} // namespace ext
+
+} // namespace nanos
+
+DECLARE_PLUGIN("instrumentation-binary_trace",nanos::ext::InstrumentationBinaryTracePlugin);
@@ -0,0 +1,63 @@
+/*************************************************************************************/
+/*      Copyright 2015 Barcelona Supercomputing Center                               */
+/*                                                                                   */
+/*      This file is part of the NANOS++ library.                                    */
+/*                                                                                   */
+/*      NANOS++ is free software: you can redistribute it and/or modify              */
+/*      it under the terms of the GNU Lesser General Public License as published by  */
+/*      the Free Software Foundation, either version 3 of the License, or            */
+/*      (at your option) any later version.                                          */
+/*                                                                                   */
+/*      NANOS++ is distributed in the hope that it will be useful,                   */
+/*      but WITHOUT ANY WARRANTY; without even the implied warranty of               */
+/*      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                */
+/*      GNU Lesser General Public License for more details.                          */
+/*                                                                                   */
+/*      You should have received a copy of the GNU Lesser General Public License     */
+/*      along with NANOS++.  If not, see <http://www.gnu.org/licenses/>.             */
+/*************************************************************************************/
+
+#ifndef _NANOS_BINARY_TRACE_FORMAT
+#define _NANOS_BINARY_TRACE_FORMAT
+
+#include <stdint.h>
+
+/*! \file binary_trace_format.hpp
+ *  \brief On-disk format shared by the binary_trace plugin and nanox-bintrace
+ *
+ *  A trace named <prefix> is made of one <prefix>.<n>.bin stream per thread
+ *  (a BinaryTraceHeader followed by BinaryTraceRecords in time order) and a
+ *  <prefix>.dict text file describing the instrumentation keys and values:
+ *
+ *     streams <n>
+ *     key <key id> <stacked> <key name> <description>
+ *     value <key id> <value> <description>
+ */
+
+namespace nanos {
+
+#define NANOS_BINARY_TRACE_MAGIC   "NXBTRACE"
+#define NANOS_BINARY_TRACE_VERSION 1
+
+   typedef struct {
+      char      magic[8];      /**< NANOS_BINARY_TRACE_MAGIC */
+      uint32_t  version;       /**< NANOS_BINARY_TRACE_VERSION */
+      uint32_t  recordSize;    /**< sizeof(BinaryTraceRecord) */
+      int32_t   threadId;      /**< Nanos++ thread id, -1 if unknown */
+      uint32_t  stream;        /**< Stream (file) index */
+      uint64_t  startTime;     /**< Monotonic time (ns) when the trace started */
+      char      reserved[32];
+   } BinaryTraceHeader;
+
+   typedef struct {
+      uint64_t  time;          /**< Monotonic time (ns) */
+      uint64_t  value;         /**< Event value (state for state events) */
+      int64_t   id;            /**< PtP id */
+      uint32_t  key;           /**< Event key */
+      uint16_t  type;          /**< nanos_event_type_t */
+      uint16_t  domain;        /**< PtP domain */
+   } BinaryTraceRecord;
+
+} // namespace nanos
+
+#endif
@@ -0,0 +1,418 @@
+/*************************************************************************************/
+/*      Copyright 2015 Barcelona Supercomputing Center                               */
+/*                                                                                   */
+/*      This file is part of the NANOS++ library.                                    */
+/*                                                                                   */
+/*      NANOS++ is free software: you can redistribute it and/or modify              */
+/*      it under the terms of the GNU Lesser General Public License as published by  */
+/*      the Free Software Foundation, either version 3 of the License, or            */
+/*      (at your option) any later version.                                          */
+/*                                                                                   */
+/*      NANOS++ is distributed in the hope that it will be useful,                   */
+/*      but WITHOUT ANY WARRANTY; without even the implied warranty of               */
+/*      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                */
+/*      GNU Lesser General Public License for more details.                          */
+/*                                                                                   */
+/*      You should have received a copy of the GNU Lesser General Public License     */
+/*      along with NANOS++.  If not, see <http://www.gnu.org/licenses/>.             */
+/*************************************************************************************/
+
+#include "plugin.hpp"
+#include "system.hpp"
+#include "instrumentation.hpp"
+#include "instrumentationcontext_decl.hpp"
+#include "workdescriptor_decl.hpp"
+#include "basethread.hpp"
+#include "lock.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <map>
+#include <string.h>
+#include <time.h>
+
+namespace nanos {
+
+#ifdef NANOS_INSTRUMENTATION_ENABLED
+/*! \class TaskProfileHistogram
+ *  \brief Log-linear (HDR-style) latency histogram in nanoseconds
+ *
+ *  Values below SUB_BUCKETS are counted exactly; above that, each power of two is
+ *  split in SUB_BUCKETS linear buckets, which bounds the relative error to 1/SUB_BUCKETS.
+ */
+class TaskProfileHistogram
+{
+   private:
+      enum { SUB_BITS = 4, SUB_BUCKETS = 1 << SUB_BITS, BUCKETS = ( 64 - SUB_BITS + 1 ) * SUB_BUCKETS };
+
+      uint64_t    _counts[BUCKETS];
+      uint64_t    _count;
+      uint64_t    _sum;
+      uint64_t    _min;
+      uint64_t    _max;
+
+      static unsigned bucketOf ( uint64_t value )
+      {
+         if ( value < (uint64_t) SUB_BUCKETS ) return (unsigned) value;
+         unsigned shift = 63 - __builtin_clzll( value ) - SUB_BITS;
+         return ( shift + 1 ) * SUB_BUCKETS + (unsigned) ( ( value >> shift ) & ( SUB_BUCKETS - 1 ) );
+      }
+
+      static uint64_t lowerBound ( unsigned bucket )
+      {
+         if ( bucket < (unsigned) SUB_BUCKETS ) return bucket;
+         unsigned shift = bucket / SUB_BUCKETS - 1;
+         return (uint64_t) ( SUB_BUCKETS + bucket % SUB_BUCKETS ) << shift;
+      }
+
+   public:
+      TaskProfileHistogram () : _count( 0 ), _sum( 0 ), _min( 0 ), _max( 0 )
+      {
+         memset( _counts, 0, sizeof( _counts ) );
+      }
+
+      void add ( uint64_t value )
+      {
+         _counts[bucketOf( value )]++;
+         if ( _count == 0 || value < _min ) _min = value;
+         if ( value > _max ) _max = value;
+         _count++;
+         _sum += value;
+      }
+
+      uint64_t getCount ( void ) const { return _count; }
+
+      void merge ( const TaskProfileHistogram &other )
+      {
+         if ( other._count == 0 ) return;
+         for ( unsigned i = 0; i < (unsigned) BUCKETS; i++ ) _counts[i] += other._counts[i];
+         if ( _count == 0 || other._min < _min ) _min = other._min;
+         if ( other._max > _max ) _max = other._max;
+         _count += other._count;
+         _sum += other._sum;
+      }
+
+      //! \brief Value below which the given fraction of the samples fall
+      uint64_t percentile ( double fraction ) const
+      {
+         if ( _count == 0 ) return 0;
+         uint64_t rank = (uint64_t) ( fraction * _count );
+         if ( rank >= _count ) rank = _count - 1;
+         uint64_t seen = 0;
+         for ( unsigned i = 0; i < (unsigned) BUCKETS; i++ ) {
+            seen += _counts[i];
+            if ( seen > rank ) return std::max( _min, std::min( _max, lowerBound( i ) ) );
+         }
+         return _max;
+      }
+
+      void toJson ( std::ostream &o ) const
+      {
+         o << "{ \"count\": " << _count << ", \"min\": " << _min << ", \"mean\": " << ( _count ? _sum / _count : 0 )
+           << ", \"p50\": " << percentile( 0.50 ) << ", \"p90\": " << percentile( 0.90 ) << ", \"p99\": " << percentile( 0.99 )
+           << ", \"max\": " << _max << ", \"buckets\": [";
+         bool first = true;
+         for ( unsigned i = 0; i < (unsigned) BUCKETS; i++ ) {
+            if ( _counts[i] == 0 ) continue;
+            o << ( first ? "" : ", " ) << "[" << lowerBound( i ) << ", " << _counts[i] << "]";
+            first = false;
+         }
+         o << "] }";
+      }
+};
+
+//! \brief Aggregated data of one task type (function)
+typedef struct {
+   TaskProfileHistogram   creationToReady;   /**< From creation to submission to the scheduler */
+   TaskProfileHistogram   readyToStart;      /**< From submission to the scheduler to execution start */
+   TaskProfileHistogram   execution;         /**< From execution start to end, suspensions included */
+   uint64_t               migrated;          /**< Executed by a thread other than its creator */
+   uint64_t               inlined;           /**< Executed without going through the scheduler */
+} TaskTypeProfile;
+
+/*! \class TaskProfileThread
+ *  \brief Profile data owned (and only written) by one thread
+ */
+class TaskProfileThread
+{
+   public:
+      typedef std::map<const char *, TaskTypeProfile *> TypeMap;
+
+      TypeMap                _types;     /**< Task types, keyed by their description pointer */
+
+      TaskProfileThread () : _types() {}
+      ~TaskProfileThread ()
+      {
+         for ( TypeMap::iterator it = _types.begin(); it != _types.end(); it++ ) delete it->second;
+      }
+
+      TaskTypeProfile & getType ( const char *description )
+      {
+         TypeMap::iterator it = _types.find( description );
+         if ( it != _types.end() ) return *it->second;
+         TaskTypeProfile *type = NEW TaskTypeProfile();   // value-initialized: counters start at zero
+         _types[description] = type;
+         return *type;
+      }
+};
+#endif
+
+class InstrumentationTaskProfile: public Instrumentation
+{
+#ifndef NANOS_INSTRUMENTATION_ENABLED
+   public:
+      // constructor
+      InstrumentationTaskProfile() : Instrumentation() {}
+      // destructor
+      ~InstrumentationTaskProfile() {}
+
+      // low-level instrumentation interface (mandatory functions)
+      void initialize( void ) {}
+      void finalize( void ) {}
+      void disable( void ) {}
+      void enable( void ) {}
+      void addResumeTask( WorkDescriptor &w ) {}
+      void addSuspendTask( WorkDescriptor &w, bool last ) {}
+      void addEventList ( unsigned int count, Event *events ) {}
+      void threadStart( BaseThread &thread ) {}
+      void threadFinish ( BaseThread &thread ) {}
+#else
+   public:
+      static std::string   _fileName;      /**< JSON output file */
+
+   private:
+      static __thread TaskProfileThread *_myProfile;
+      static __thread unsigned           _myGeneration; /**< Profile generation _myProfile belongs to */
+
+      std::vector<TaskProfileThread *>   _threads;
+      std::vector<TaskProfileThread *>   _retired;      /**< Profiles of finalized runs, freed with the plugin */
+      unsigned                           _generation;   /**< Increased at every finalize */
+      Lock                               _threadsLock;
+      nanos_event_key_t                  _userCodeKey;
+      bool                               _enabled;
+
+      static uint64_t getTime ( void )
+      {
+         struct timespec ts;
+         clock_gettime( CLOCK_MONOTONIC, &ts );
+         return (uint64_t) ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+      }
+
+      //! \brief Calling thread profile, registered the first time the thread runs a task
+      TaskProfileThread & getMyProfile ( void )
+      {
+         // The profile of a thread belongs to the run it was created in: a finalize starts a new one
+         if ( _myProfile == NULL || _myGeneration != _generation ) {
+            TaskProfileThread *profile = NEW TaskProfileThread();
+            LockBlock lock( _threadsLock );
+            _threads.push_back( profile );
+            _myProfile = profile;
+            _myGeneration = _generation;
+         }
+         return *_myProfile;
+      }
+
+      //! \brief Running WD the user-code burst belongs to, NULL if it is not the current one of the thread
+      static WD * getBurstWD ( nanos_event_value_t wdId )
+      {
+         WD *wd = myThread->getCurrentWD();
+         if ( wd == NULL || (nanos_event_value_t) wd->getId() != wdId ) return NULL;
+         return wd;
+      }
+
+      void taskStart ( nanos_event_value_t wdId )
+      {
+         uint64_t now = getTime();
+         WD *wd = getBurstWD( wdId );
+         if ( wd == NULL ) return;
+
+         TaskTypeProfile &type = getMyProfile().getType( wd->getDescription() );
+         InstrumentationContextData *icd = wd->getInstrumentationContextData();
+         uint64_t created = icd->getCreationTime();
+         uint64_t ready = icd->getReadyTime();
+
+         if ( ready == 0 ) {
+            type.inlined++;
+         } else {
+            if ( created != 0 && ready >= created ) type.creationToReady.add( ready - created );
+            if ( now >= ready ) type.readyToStart.add( now - ready );
+         }
+         if ( icd->getCreator() >= 0 && icd->getCreator() != myThread->getId() ) type.migrated++;
+
+         // Kept in the WD: an untied task may end in a different thread than the one it started in
+         icd->setStartTime( now );
+      }
+
+      void taskEnd ( nanos_event_value_t wdId )
+      {
+         uint64_t now = getTime();
+         WD *wd = getBurstWD( wdId );
+         if ( wd == NULL ) return;
+
+         InstrumentationContextData *icd = wd->getInstrumentationContextData();
+         uint64_t start = icd->getStartTime();
+         if ( start == 0 ) return;
+
+         getMyProfile().getType( wd->getDescription() ).execution.add( now - start );
+         icd->setStartTime( 0 );
+      }
+
+      static void writeString ( std::ostream &o, const std::string &s )
+      {
+         o << "\"";
+         for ( size_t i = 0; i < s.size(); i++ ) {
+            if ( s[i] == '"' || s[i] == '\\' ) o << '\\' << s[i];
+            else if ( (unsigned char) s[i] < 0x20 ) o << ' ';
+            else o << s[i];
+         }
+         o << "\"";
+      }
+
+      //! \brief Merges the thread profiles by task type name and writes them as JSON
+      void writeSummary ( void )
+      {
+         typedef std::map<std::string, TaskTypeProfile> Summary;
+         Summary summary;
+
+         for ( size_t t = 0; t < _threads.size(); t++ ) {
+            TaskProfileThread::TypeMap &types = _threads[t]->_types;
+            for ( TaskProfileThread::TypeMap::iterator it = types.begin(); it != types.end(); it++ ) {
+               std::string name = it->first != NULL ? it->first : "unknown";
+               TaskTypeProfile &merged = summary[name];   // value-initialized: counters start at zero
+               merged.creationToReady.merge( it->second->creationToReady );
+               merged.readyToStart.merge( it->second->readyToStart );
+               merged.execution.merge( it->second->execution );
+               merged.migrated += it->second->migrated;
+               merged.inlined += it->second->inlined;
+            }
+         }
+
+         std::ofstream o( _fileName.c_str() );
+         if ( !o.good() ) {
+            warning0( "task_profile: cannot write " << _fileName );
+            return;
+         }
+
+         o << "{" << std::endl << "  \"threads\": " << _threads.size() << "," << std::endl;
+         o << "  \"units\": \"ns\"," << std::endl << "  \"tasks\": [";
+         for ( Summary::iterator it = summary.begin(); it != summary.end(); it++ ) {
+            TaskTypeProfile &type = it->second;
+            o << ( it == summary.begin() ? "" : "," ) << std::endl << "    { \"name\": ";
+            writeString( o, it->first );
+            o << ", \"count\": " << type.execution.getCount() << "," << std::endl << "      \"migrated\": " << type.migrated << ", \"inlined\": " << type.inlined << "," << std::endl;
+            o << "      \"creation_to_ready\": ";
+            type.creationToReady.toJson( o );
+            o << "," << std::endl << "      \"ready_to_start\": ";
+            type.readyToStart.toJson( o );
+            o << "," << std::endl << "      \"execution\": ";
+            type.execution.toJson( o );
+            o << " }";
+         }
+         o << std::endl << "  ]" << std::endl << "}" << std::endl;
+
+         message0( "Task profile summary (" << summary.size() << " task types) written to " << _fileName );
+      }
+
+   public:
+      // constructor
+      InstrumentationTaskProfile() : Instrumentation( *NEW InstrumentationContextDisabled() ),
+         _threads(), _retired(), _generation( 1 ), _threadsLock(), _userCodeKey( 0 ), _enabled( false ) {}
+      // destructor
+      ~InstrumentationTaskProfile()
+      {
+         for ( size_t t = 0; t < _threads.size(); t++ ) delete _threads[t];
+         for ( size_t t = 0; t < _retired.size(); t++ ) delete _retired[t];
+      }
+
+      // low-level instrumentation interface (mandatory functions)
+      void initialize( void )
+      {
+         // Task start and end are detected through the user-code bursts
+         InstrumentationDictionary *iD = getInstrumentationDictionary();
+         iD->switchEventPrefix( "user-code", EVENT_ENABLED );
+         iD->normalizeLevels();
+         _userCodeKey = iD->getEventKey( "user-code" );
+         _enabled = true;
+      }
+
+      void finalize( void )
+      {
+         _enabled = false;
+
+         // Profiles are kept until the plugin goes away: threads may still be in taskEnd
+         LockBlock lock( _threadsLock );
+         writeSummary();
+         _retired.insert( _retired.end(), _threads.begin(), _threads.end() );
+         _threads.clear();
+         _generation++;
+      }
+
+      void disable( void ) { _enabled = false; }
+      void enable( void ) { _enabled = true; }
+      void addResumeTask( WorkDescriptor &w ) {}
+      void addSuspendTask( WorkDescriptor &w, bool last ) {}
+
+      void wdCreated( WorkDescriptor* wd )
+      {
+         wd->getInstrumentationContextData()->setCreation( getTime(), myThread ? myThread->getId() : -1 );
+      }
+
+      void wdReady( WorkDescriptor* wd )
+      {
+         wd->getInstrumentationContextData()->setReadyTime( getTime() );
+      }
+
+      void addEventList ( unsigned int count, Event *events )
+      {
+         if ( !_enabled || _userCodeKey == 0 ) return;
+
+         for ( unsigned int i = 0; i < count; i++ ) {
+            Event &e = events[i];
+            if ( e.getKey() != _userCodeKey ) continue;
+            if ( e.getType() == NANOS_BURST_START ) taskStart( e.getValue() );
+            else if ( e.getType() == NANOS_BURST_END ) taskEnd( e.getValue() );
+         }
+      }
+
+      void threadStart( BaseThread &thread ) {}
+      void threadFinish ( BaseThread &thread ) {}
+#endif
+};
+
+#ifdef NANOS_INSTRUMENTATION_ENABLED
+__thread TaskProfileThread *InstrumentationTaskProfile::_myProfile = NULL;
+__thread unsigned InstrumentationTaskProfile::_myGeneration = 0;
+std::string InstrumentationTaskProfile::_fileName = "nanox-task-profile.json";
+#endif
+
+namespace ext {
+
+class InstrumentationTaskProfilePlugin : public Plugin {
+   public:
+      InstrumentationTaskProfilePlugin () : Plugin("Instrumentation which aggregates per task type latency histograms.",1) {}
+      ~InstrumentationTaskProfilePlugin () {}
+
+      void config( Config &cfg )
+      {
+#ifdef NANOS_INSTRUMENTATION_ENABLED
+         cfg.setOptionsSection( "Task profile plugin", "Task profile instrumentation specific options" );
+         cfg.registerConfigOption( "task-profile-file", NEW Config::StringVar( InstrumentationTaskProfile::_fileName ),
+                                   "JSON file where the task profile summary is written (default: nanox-task-profile.json)" );
+         cfg.registerArgOption( "task-profile-file", "task-profile-file" );
+         cfg.registerEnvOption( "task-profile-file", "NX_TASK_PROFILE_FILE" );
+#endif
+      }
+
+      void init ()
+      {
+         sys.setInstrumentation( NEW InstrumentationTaskProfile() );
+      }
+};
+
+} // namespace ext
+
+} // namespace nanos
+
+DECLARE_PLUGIN("instrumentation-task_profile",nanos::ext::InstrumentationTaskProfilePlugin);
@@ -180,7 +180,7 @@ namespace nanos {
 #endif
 
                public:
-                  SchedQueuesWDPQ( int memSpaces ) : SchedQueues(), _globalReadyQueue( /* optimise option */ true )
+                  SchedQueuesWDPQ( int memSpaces ) : SchedQueues(), _globalReadyQueue( /* enableDeviceCounter */ true )
                   {
                      _readyQueues = NEW WDPriorityQueue<>[memSpaces];
 
@@ -114,7 +114,7 @@ namespace nanos {
       {
          public:
             typedef std::stack<BotLevDOData *>   bot_lev_dos_t;
-            typedef std::set<std::pair< unsigned int, DependableObject * > > DepObjVector; /**< Type vector of successors  */
+            typedef DependableObject::DependableObjectVector DepObjVector; /**< Type vector of successors  */
 
          private:
             bot_lev_dos_t     _blStack;       //! tasks added, pending having their bottom level updated
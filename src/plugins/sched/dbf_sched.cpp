@@ -30,6 +30,8 @@ namespace nanos {
          public:
             static bool       _usePriority;
             static bool       _useSmartPriority;
+            static bool       _useLockFreeQueue;
+            static bool       _stealHalf;
          private:
             /** \brief DistributedBF Scheduler data associated to each thread
               *
@@ -41,7 +43,8 @@ namespace nanos {
 
                ThreadData () : ScheduleThreadData(), _readyQueue( NULL )
                {
-                 if ( _usePriority || _useSmartPriority ) _readyQueue = NEW WDPriorityQueue<>( true /* enableDeviceCounter */, true /* optimise option */ );
+                 if ( _usePriority || _useSmartPriority ) _readyQueue = NEW WDPriorityQueue<>( true /* enableDeviceCounter */ );
+                 else if ( _useLockFreeQueue ) _readyQueue = NEW WDChaseLevDeque( this, true /* enableDeviceCounter */ );
                  else _readyQueue = NEW WDDeque( true /* enableDeviceCounter */ );
                }
                virtual ~ThreadData () { delete _readyQueue; }
@@ -227,7 +230,9 @@ namespace nanos {
 
                if ( victim.getTeam() != NULL ) {
                  ThreadData &tdata = ( ThreadData & ) *victim.getTeamData()->getScheduleData();
-                 wd = tdata._readyQueue->pop_back ( thread );
+                 //! Take up to half of the victim queue: the rest of the WDs are moved to ours
+                 if ( _stealHalf ) wd = tdata._readyQueue->stealHalf ( thread, *data._readyQueue );
+                 else wd = tdata._readyQueue->pop_back ( thread );
                }
 
                count++;
@@ -240,6 +245,8 @@ namespace nanos {
 
       bool DistributedBFPolicy::_usePriority = true;
       bool DistributedBFPolicy::_useSmartPriority = false;
+      bool DistributedBFPolicy::_useLockFreeQueue = false;
+      bool DistributedBFPolicy::_stealHalf = false;
 
       class DistributedBFSchedPlugin : public Plugin
       {
@@ -257,6 +264,12 @@ namespace nanos {
                cfg.registerConfigOption ( "schedule-smart-priority", NEW Config::FlagOption( DistributedBFPolicy::_useSmartPriority ), "Smart priority queue propagates high priorities to predecessors");
                cfg.registerArgOption( "schedule-smart-priority", "schedule-smart-priority" );
 
+               cfg.registerConfigOption ( "schedule-lock-free-queue", NEW Config::FlagOption( DistributedBFPolicy::_useLockFreeQueue ), "Lock-free Chase-Lev deque used as ready task queue (ignored when priorities are used)");
+               cfg.registerArgOption( "schedule-lock-free-queue", "schedule-lock-free-queue" );
+
+               cfg.registerConfigOption ( "schedule-steal-half", NEW Config::FlagOption( DistributedBFPolicy::_stealHalf ), "Steals move up to half of the victim queue to the thief queue (default = no)");
+               cfg.registerArgOption( "schedule-steal-half", "schedule-steal-half" );
+
                
             }
 
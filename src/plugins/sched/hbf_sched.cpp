@@ -0,0 +1,335 @@
+/*************************************************************************************/
+/*      Copyright 2015 Barcelona Supercomputing Center                               */
+/*                                                                                   */
+/*      This file is part of the NANOS++ library.                                    */
+/*                                                                                   */
+/*      NANOS++ is free software: you can redistribute it and/or modify              */
+/*      it under the terms of the GNU Lesser General Public License as published by  */
+/*      the Free Software Foundation, either version 3 of the License, or            */
+/*      (at your option) any later version.                                          */
+/*                                                                                   */
+/*      NANOS++ is distributed in the hope that it will be useful,                   */
+/*      but WITHOUT ANY WARRANTY; without even the implied warranty of               */
+/*      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                */
+/*      GNU Lesser General Public License for more details.                          */
+/*                                                                                   */
+/*      You should have received a copy of the GNU Lesser General Public License     */
+/*      along with NANOS++.  If not, see <http://www.gnu.org/licenses/>.             */
+/*************************************************************************************/
+
+#include "schedule.hpp"
+#include "wddeque.hpp"
+#include "plugin.hpp"
+#include "system.hpp"
+#include "config.hpp"
+#include "os.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <iterator>
+
+namespace nanos {
+   namespace ext {
+
+      /*! \brief Breadth-first policy with a hierarchy of ready queues
+       *
+       *  There is a ready queue per core, per last level cache and per socket. Tasks are queued
+       *  in the cache queue of the submitting thread, which all the cores below that cache share,
+       *  and batches (e.g. the successors released by a task) in its socket queue. Tasks tied to a
+       *  thread go to the queue of the core the thread runs on. Idle threads visit the queues in
+       *  distance order: their core, cache and socket queues, the other caches of the socket and
+       *  finally the other sockets (their socket queue and then their caches), nearest first
+       *  according to the NUMA distances of their nodes.
+       *
+       *  Ordering guarantee: every queue is FIFO and every thread, local or remote, dequeues one
+       *  task at a time from its front. So the tasks queued at the same level run in submission
+       *  order, and a thread always takes the oldest task of the nearest queue with work.
+       */
+      class HierarchicalBreadthFirst : public SchedulePolicy
+      {
+         private:
+            enum Level { CORE = 0, CACHE, SOCKET, NUM_LEVELS };
+
+            struct QueueId
+            {
+               Level          _level;
+               unsigned int   _index;
+
+               QueueId ( Level level, unsigned int index ) : _level( level ), _index( index ) {}
+            };
+
+            //! \brief Queues visited by the threads of a CPU, nearest first
+            struct QueueOrder
+            {
+               std::vector<QueueId>   _queues;
+            };
+
+            struct TeamData : public ScheduleTeamData
+            {
+               std::vector<WDPool *> _queues[NUM_LEVELS];
+
+               TeamData ( const unsigned int *numQueues ) : ScheduleTeamData()
+               {
+                  for ( int level = 0; level < NUM_LEVELS; level++ ) {
+                     for ( unsigned int i = 0; i < numQueues[level]; i++ ) {
+                        _queues[level].push_back( NEW WDDeque( true /* enableDeviceCounter */ ) );
+                     }
+                  }
+               }
+
+               ~TeamData ()
+               {
+                  for ( int level = 0; level < NUM_LEVELS; level++ ) {
+                     for ( size_t i = 0; i < _queues[level].size(); i++ ) delete _queues[level][i];
+                  }
+               }
+
+               WDPool * getQueue ( const QueueId &id ) { return _queues[id._level][id._index]; }
+            };
+
+            std::vector<unsigned int>  _location[NUM_LEVELS];   //!< Queue index of every level, by OS CPU id
+            std::vector<QueueOrder>    _orders;                 //!< By OS CPU id
+            unsigned int               _numQueues[NUM_LEVELS];
+
+            /* disable copy and assigment */
+            explicit HierarchicalBreadthFirst ( const HierarchicalBreadthFirst & );
+            const HierarchicalBreadthFirst & operator= ( const HierarchicalBreadthFirst & );
+
+            static void addUnique ( std::vector<unsigned int> &v, unsigned int value )
+            {
+               if ( std::find( v.begin(), v.end(), value ) == v.end() ) v.push_back( value );
+            }
+
+            //! \brief Comparison functor used to sort sockets by their distance to a given one
+            struct DistanceCmp {
+               const std::vector<unsigned int> &_distances;
+
+               DistanceCmp( const std::vector<unsigned int> &distances ) : _distances( distances ) {}
+
+               bool operator()( unsigned int socket1, unsigned int socket2 ) const
+               {
+                  return _distances[socket1] < _distances[socket2];
+               }
+            };
+
+            /*! \brief Remote sockets of every socket, nearest first
+             *
+             *  Distances are those of the NUMA nodes of the sockets, as reported by the kernel.
+             *  Sockets at the same distance (or all of them, if the distances are not available)
+             *  keep a ring order starting by the next socket, so that thieves spread over them.
+             */
+            static void computeVictims ( const std::vector<int> &socketNode, std::vector< std::vector<unsigned int> > &victims )
+            {
+               unsigned int num_sockets = socketNode.size();
+               victims.assign( num_sockets, std::vector<unsigned int>() );
+
+               for ( unsigned int from = 0; from < num_sockets; from++ ) {
+                  if ( socketNode[from] < 0 ) continue;
+
+                  std::vector<unsigned int> node_distances;
+                  std::stringstream path;
+                  path << "/sys/devices/system/node/node" << socketNode[from] << "/distance";
+                  std::ifstream fDistances( path.str().c_str() );
+                  if ( fDistances.good() ) {
+                     std::copy( std::istream_iterator<unsigned int>( fDistances ), std::istream_iterator<unsigned int>(),
+                                std::back_inserter( node_distances ) );
+                  }
+
+                  std::vector<unsigned int> distances( num_sockets, 0 );
+                  for ( unsigned int to = 0; to < num_sockets; to++ ) {
+                     if ( socketNode[to] >= 0 && (size_t) socketNode[to] < node_distances.size() ) {
+                        distances[to] = node_distances[socketNode[to]];
+                     }
+                  }
+
+                  for ( unsigned int d = 1; d < num_sockets; d++ ) {
+                     unsigned int other = ( from + d ) % num_sockets;
+                     if ( socketNode[other] >= 0 ) victims[from].push_back( other );
+                  }
+                  std::stable_sort( victims[from].begin(), victims[from].end(), DistanceCmp( distances ) );
+               }
+            }
+
+            void buildTopology ()
+            {
+               unsigned int num_cpus = OS::getMaxProcessors();
+               if ( num_cpus == 0 ) num_cpus = 1;
+
+               for ( int level = 0; level < NUM_LEVELS; level++ ) {
+                  _location[level].assign( num_cpus, 0 );
+                  _numQueues[level] = 1;
+               }
+
+               for ( unsigned int cpu = 0; cpu < num_cpus; cpu++ ) {
+                  unsigned int index[NUM_LEVELS];
+                  sys._hwloc.getCpuLocation( cpu, index[CORE], index[CACHE], index[SOCKET] );
+                  for ( int level = 0; level < NUM_LEVELS; level++ ) {
+                     _location[level][cpu] = index[level];
+                     _numQueues[level] = std::max( _numQueues[level], index[level] + 1 );
+                  }
+               }
+
+               // Caches of every socket, in index order
+               std::vector< std::vector<unsigned int> > socket_caches( _numQueues[SOCKET] );
+               std::vector<int> socket_node( _numQueues[SOCKET], -1 );
+               for ( unsigned int cpu = 0; cpu < num_cpus; cpu++ ) {
+                  if ( !sys._hwloc.isCpuAvailable( cpu ) ) continue;
+                  addUnique( socket_caches[_location[SOCKET][cpu]], _location[CACHE][cpu] );
+                  if ( socket_node[_location[SOCKET][cpu]] < 0 ) {
+                     socket_node[_location[SOCKET][cpu]] = sys._hwloc.getNumaNodeOfCpu( cpu );
+                  }
+               }
+               for ( size_t i = 0; i < socket_caches.size(); i++ ) std::sort( socket_caches[i].begin(), socket_caches[i].end() );
+
+               std::vector< std::vector<unsigned int> > victims;
+               computeVictims( socket_node, victims );
+
+               _orders.resize( num_cpus );
+               for ( unsigned int cpu = 0; cpu < num_cpus; cpu++ ) {
+                  QueueOrder &order = _orders[cpu];
+                  unsigned int core = _location[CORE][cpu];
+                  unsigned int cache = _location[CACHE][cpu];
+                  unsigned int socket = _location[SOCKET][cpu];
+
+                  // Own queues (other core queues only hold tasks tied to their threads)
+                  order._queues.push_back( QueueId( CORE, core ) );
+                  order._queues.push_back( QueueId( CACHE, cache ) );
+                  order._queues.push_back( QueueId( SOCKET, socket ) );
+
+                  // Other caches of the socket
+                  const std::vector<unsigned int> &caches = socket_caches[socket];
+                  for ( size_t i = 0; i < caches.size(); i++ ) {
+                     if ( caches[i] != cache ) order._queues.push_back( QueueId( CACHE, caches[i] ) );
+                  }
+
+                  // Other sockets, nearest first
+                  for ( size_t v = 0; v < victims[socket].size(); v++ ) {
+                     unsigned int other = victims[socket][v];
+                     order._queues.push_back( QueueId( SOCKET, other ) );
+                     const std::vector<unsigned int> &other_caches = socket_caches[other];
+                     for ( size_t i = 0; i < other_caches.size(); i++ ) {
+                        order._queues.push_back( QueueId( CACHE, other_caches[i] ) );
+                     }
+                  }
+               }
+            }
+
+            unsigned int getCpu ( BaseThread *thread ) const
+            {
+               int cpu = thread->getCpuId();
+               return ( cpu < 0 || (size_t) cpu >= _orders.size() ) ? 0 : (unsigned int) cpu;
+            }
+
+         public:
+            HierarchicalBreadthFirst() : SchedulePolicy( "Hierarchical Breadth First" )
+            {
+               buildTopology();
+            }
+            virtual ~HierarchicalBreadthFirst () {}
+
+         private:
+
+            virtual size_t getTeamDataSize () const { return sizeof(TeamData); }
+            virtual size_t getThreadDataSize () const { return 0; }
+
+            virtual ScheduleTeamData * createTeamData ()
+            {
+               return NEW TeamData( _numQueues );
+            }
+
+            virtual ScheduleThreadData * createThreadData ()
+            {
+               return 0;
+            }
+
+            virtual void queue ( BaseThread *thread, WD &wd )
+            {
+               TeamData &tdata = (TeamData &) *thread->getTeam()->getScheduleData();
+               BaseThread *targetThread = wd.isTiedTo();
+               if ( targetThread ) {
+                  tdata._queues[CORE][_location[CORE][getCpu( targetThread )]]->push_back( &wd );
+                  sys.getThreadManager()->unblockThread( targetThread );
+               } else {
+                  tdata._queues[CACHE][_location[CACHE][getCpu( thread )]]->push_back( &wd );
+               }
+            }
+
+            virtual void queue ( BaseThread ** threads, WD ** wds, size_t numElems )
+            {
+               fatal_cond( numElems == 0, "Cannot queue 0 elements.");
+
+               ThreadTeam* team = threads[0]->getTeam();
+               for ( size_t i = 1; i < numElems; ++i ) {
+                  if ( threads[i]->getTeam() != team ) fatal( "Batch submission does not support different teams" );
+               }
+
+               // A batch is shared with all the caches of the socket
+               TeamData &tdata = (TeamData &) *team->getScheduleData();
+               tdata._queues[SOCKET][_location[SOCKET][getCpu( myThread )]]->push_back( wds, numElems );
+
+               // Unblock all participant threads
+               for ( size_t i = 1; i < numElems; ++i ) {
+                  sys.getThreadManager()->unblockThread(threads[i]);
+               }
+            }
+
+            /*! This scheduling policy supports all WDs, no restrictions. */
+            bool isValidForBatch ( const WD * wd ) const
+            {
+               return true;
+            }
+
+            virtual WD *atSubmit ( BaseThread *thread, WD &newWD )
+            {
+               queue( thread, newWD );
+               return 0;
+            }
+
+            WD * atIdle ( BaseThread *thread, int numSteal )
+            {
+               WD * next = thread->getNextWD();
+               if ( next ) return next;
+
+               TeamData &tdata = (TeamData &) *thread->getTeam()->getScheduleData();
+               unsigned int cpu = getCpu( thread );
+               const QueueOrder &order = _orders[cpu];
+
+               // Remote queues are dequeued like the local ones: the oldest task first
+               for ( size_t i = 0; i < order._queues.size(); i++ ) {
+                  WDPool *q = tdata.getQueue( order._queues[i] );
+                  if ( q->empty() ) continue;
+
+                  next = q->pop_front( thread );
+                  if ( next != NULL ) return next;
+               }
+               return NULL;
+            }
+
+            WD * atPrefetch ( BaseThread *thread, WD &current )
+            {
+               WD * found = current.getImmediateSuccessor(*thread);
+               return found != NULL ? found : atIdle(thread,false);
+            }
+
+            WD * atBeforeExit ( BaseThread *thread, WD &current, bool schedule )
+            {
+               return current.getImmediateSuccessor(*thread);
+            }
+      };
+
+      class HBFSchedPlugin : public Plugin
+      {
+
+         public:
+            HBFSchedPlugin() : Plugin( "Hierarchical BF scheduling Plugin",1 ) {}
+
+            virtual void init() {
+               sys.setDefaultSchedulePolicy(NEW HierarchicalBreadthFirst());
+            }
+      };
+
+   }
+}
+
+DECLARE_PLUGIN("sched-hbf",nanos::ext::HBFSchedPlugin);
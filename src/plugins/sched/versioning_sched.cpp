@@ -25,9 +25,15 @@
 #include "os.hpp"
 #include "config.hpp"
 #include "hashmap.hpp"
+#ifdef HAVE_SQLITE3_H
+#include "dbmanager_sqlite3.hpp"
+#endif
 
 #include <math.h>
+#include <algorithm>
 #include <limits>
+#include <map>
+#include <string>
 
 
 namespace nanos {
@@ -40,6 +46,8 @@ namespace ext
 #define MAX_DEVIATION   0.01
 #define MIN_RECORDS     3
 #define MAX_DIFFERENCE  4
+// Weight (in records) of the times loaded from the database, so that new runs can still move them
+#define MAX_LOADED_RECORDS 64
 
 /*
  * Some terminology and data structures schemas to understand the code
@@ -98,6 +106,142 @@ namespace ext
    typedef std::vector<WDExecRecord> WDExecInfoData;
    typedef HashMap< WDExecInfoKey, WDExecInfoData, false, 257, WDExecInfoHashKey > WDExecInfo;
 
+   // Persistent identity of a WDExecInfoKey: group ids are addresses, so they change from run to run
+   struct WDExecSymbol {
+      std::string                _symbol;
+      std::vector<std::string>   _devices;
+   };
+
+   typedef std::map< WDExecInfoKey, WDExecSymbol > WDExecSymbols;
+
+
+/*
+ * Execution times recorded by previous runs
+ *
+ *  Records are keyed by < task symbol, paramsSize bucket, versionId > and also keep the device
+ *  name of the version, so that they are not applied to another implementation if the versions
+ *  of a task change. The whole table is read when the policy is created and the records of the
+ *  tasks run are written back at shutdown.
+ */
+   class VersioningDb
+   {
+      public:
+         struct Key {
+            std::string    _symbol;
+            unsigned int   _sizeBucket;
+            unsigned int   _versionId;
+
+            Key ( const std::string &symbol, unsigned int sizeBucket, unsigned int versionId )
+               : _symbol( symbol ), _sizeBucket( sizeBucket ), _versionId( versionId ) {}
+
+            bool operator< ( const Key &other ) const
+            {
+               if ( _symbol != other._symbol ) return _symbol < other._symbol;
+               if ( _sizeBucket != other._sizeBucket ) return _sizeBucket < other._sizeBucket;
+               return _versionId < other._versionId;
+            }
+         };
+
+         struct Record {
+            std::string    _device;
+            double         _elapsedTime;
+            int            _numRecords;
+         };
+
+         typedef std::map< Key, Record > RecordMap;
+
+      private:
+         std::string    _fileName;
+         RecordMap      _records;
+
+#ifdef HAVE_SQLITE3_H
+         static void createTable ( SQLite3DbManager &db )
+         {
+            unsigned int stmt = db.prepareStmt( "CREATE TABLE IF NOT EXISTS versioning_records(symbol TEXT, size_bucket INT, "
+                  "version INT, device TEXT, time REAL, records INT, PRIMARY KEY(symbol, size_bucket, version));" );
+            db.doStep( stmt );
+         }
+#endif
+
+      public:
+         VersioningDb () : _fileName(), _records() {}
+
+         bool isEnabled () const { return !_fileName.empty(); }
+
+         //! \brief Power of two bucket of a data size
+         static unsigned int getSizeBucket ( size_t size )
+         {
+            unsigned int bucket = 0;
+            while ( size > 1 ) {
+               size >>= 1;
+               bucket++;
+            }
+            return bucket;
+         }
+
+         const Record * find ( const Key &key ) const
+         {
+            RecordMap::const_iterator it = _records.find( key );
+            return it != _records.end() ? &it->second : NULL;
+         }
+
+         void load ( const std::string &fileName )
+         {
+            if ( fileName.empty() ) return;
+#ifdef HAVE_SQLITE3_H
+            SQLite3DbManager db;
+            db.openConnection( fileName );
+            createTable( db );
+
+            unsigned int stmt = db.prepareStmt( "SELECT symbol, size_bucket, version, device, time, records FROM versioning_records;" );
+            while ( db.doStep( stmt ) ) {
+               Key key( db.getTextColumnValue( stmt, 0 ), db.getIntColumnValue( stmt, 1 ), db.getIntColumnValue( stmt, 2 ) );
+               Record &record = _records[key];
+               record._device = db.getTextColumnValue( stmt, 3 );
+               record._elapsedTime = db.getDoubleColumnValue( stmt, 4 );
+               record._numRecords = db.getIntColumnValue( stmt, 5 );
+            }
+            _fileName = fileName;
+
+            verbose0( "[versioning] Loaded " << _records.size() << " records from " << fileName );
+#else
+            warning0( "[versioning] This build has no SQLite3 support, ignoring versioning-db=" << fileName );
+#endif
+         }
+
+         //! \brief Replaces the given records in the database, the rest of them are kept
+         void save ( const RecordMap &records )
+         {
+            if ( !isEnabled() || records.empty() ) return;
+#ifdef HAVE_SQLITE3_H
+            SQLite3DbManager db;
+            db.openConnection( _fileName );
+            createTable( db );
+
+            unsigned int begin = db.prepareStmt( "BEGIN TRANSACTION;" );
+            unsigned int insert = db.prepareStmt( "INSERT OR REPLACE INTO versioning_records "
+                  "VALUES(@symbol, @bucket, @version, @device, @time, @records);" );
+            unsigned int commit = db.prepareStmt( "COMMIT;" );
+
+            db.doStep( begin );
+            for ( RecordMap::const_iterator it = records.begin(); it != records.end(); it++ ) {
+               db.bindTextParameter( insert, 1, it->first._symbol );
+               db.bindIntParameter( insert, 2, it->first._sizeBucket );
+               db.bindIntParameter( insert, 3, it->first._versionId );
+               db.bindTextParameter( insert, 4, it->second._device );
+               db.bindDoubleParameter( insert, 5, it->second._elapsedTime );
+               db.bindIntParameter( insert, 6, it->second._numRecords );
+               db.doStep( insert );
+               db.resetStmt( insert );
+               _records[it->first] = it->second;
+            }
+            db.doStep( commit );
+
+            verbose0( "[versioning] Saved " << records.size() << " records to " << _fileName );
+#endif
+         }
+   };
+
 
    typedef enum {
       NANOS_SCHED_VER_NULL_EVENT,                        /* 0 */
@@ -259,14 +403,17 @@ namespace ext
                WDBestRecord               _wdExecBest;
                WDExecInfo                 _wdExecStats;
                std::set<WDExecInfoKey>    _wdExecStatsKeys;
+               WDExecSymbols              _wdExecSymbols;
                ResourceMap                _executionMap;
+               const VersioningDb &       _db;
 
                static Lock                _bestLock;
                static Lock                _statsLock;
 
                WDDeque *                  _readyQueue;
 
-               TeamData ( unsigned int size ) : ScheduleTeamData(), _wdExecBest(), _wdExecStats(), _wdExecStatsKeys(), _executionMap( size )
+               TeamData ( unsigned int size, const VersioningDb &db ) : ScheduleTeamData(), _wdExecBest(), _wdExecStats(), _wdExecStatsKeys(),
+                     _wdExecSymbols(), _executionMap( size ), _db( db )
                {
                   unsigned int i;
                   for ( i = 0; i < size; i++ ) {
@@ -287,7 +434,11 @@ namespace ext
                }
 
 
-               void initExecInfoData ( WDExecInfoData & data, WD * wd )
+               /*
+                * Returns whether every version the system can run was found in the database, so that
+                * there is nothing left to explore
+                */
+               bool initExecInfoData ( WDExecInfoData & data, WD * wd )
                {
                   unsigned int numVersions = wd->getNumDevices();
 
@@ -301,7 +452,19 @@ namespace ext
                   data.reserve( numVersions );
                   data = *NEW WDExecInfoData( numVersions );
 
+                  WDExecInfoKey key = std::make_pair( wd->getVersionGroupId(), wd->getParamsSize() );
+                  const char *symbol = wd->getDescription();
+                  if ( symbol != NULL ) {
+                     WDExecSymbol &execSymbol = _wdExecSymbols[key];
+                     execSymbol._symbol = symbol;
+                     execSymbol._devices.resize( numVersions );
+                     for ( unsigned int i = 0; i < numVersions; i++ ) {
+                        execSymbol._devices[i] = wd->getDevices()[i]->getDevice()->getName();
+                     }
+                  }
+
                   bool compatible = false;
+                  bool loaded = symbol != NULL && _db.isEnabled();
                   unsigned int i;
                   for ( i = 0; i < numVersions; i++ ) {
                      // Check there is at least one thread for each compatible device type
@@ -312,6 +475,8 @@ namespace ext
                         data[i]._lastElapsedTime = std::numeric_limits<double>::max();
                         data[i]._numRecords = _minRecordTrial;
                         data[i]._numAssigned = _minRecordTrial;
+                     } else if ( loadExecRecord( data[i], wd, i ) ) {
+                        compatible = true;
                      } else {
                         data[i]._pe = NULL;
                         data[i]._elapsedTime = 0.0;
@@ -319,16 +484,111 @@ namespace ext
                         data[i]._numRecords = -1;
                         data[i]._numAssigned = 0;
                         compatible = true;
+                        loaded = false;
                      }
                   }
 
                   _statsLock.release();
 
-                  WDExecInfoKey key = std::make_pair( wd->getVersionGroupId(), wd->getParamsSize() );
                   _wdExecStatsKeys.insert( key );
 
                   fatal_cond( !compatible, "Error: there is no suitable device in the system to run the submitted task.");
 
+                  if ( _db.isEnabled() ) seedBestRecord( data, wd );
+
+                  return loaded;
+               }
+
+
+               /*
+                * Makes the fastest version loaded from the database the best one, so that it is known
+                * before any of the versions runs in this run
+                */
+               void seedBestRecord ( WDExecInfoData & data, WD * wd )
+               {
+                  unsigned int best = data.size();
+                  for ( unsigned int i = 0; i < data.size(); i++ ) {
+                     if ( data[i]._pe == NULL || data[i]._numRecords <= 0 ) continue;
+                     if ( best == data.size() || data[i]._elapsedTime < data[best]._elapsedTime ) best = i;
+                  }
+                  if ( best == data.size() ) return;
+
+                  _bestLock.acquire();
+                  WDBestRecordData &bestData = getWDBestRecord( wd );
+                  if ( bestData._pe == NULL || bestData._elapsedTime > data[best]._elapsedTime ) {
+                     bestData._versionId = best;
+                     bestData._pe = data[best]._pe;
+                     bestData._elapsedTime = data[best]._elapsedTime;
+                  }
+                  _bestLock.release();
+               }
+
+
+               /*
+                * Seeds the record of a version with the time found in the database, as if it had
+                * already been explored in this run
+                */
+               bool loadExecRecord ( WDExecRecord & record, WD * wd, unsigned int versionId )
+               {
+                  if ( !_db.isEnabled() || wd->getDescription() == NULL ) return false;
+
+                  const Device *device = wd->getDevices()[versionId]->getDevice();
+                  const VersioningDb::Record *stored = _db.find( VersioningDb::Key( wd->getDescription(),
+                        VersioningDb::getSizeBucket( wd->getParamsSize() ), versionId ) );
+                  if ( stored == NULL || stored->_numRecords <= 0 || stored->_device != device->getName() ) return false;
+
+                  // Any PE of the device will do: the scheduler only compares their device types
+                  ProcessingElement *pe = NULL;
+                  for ( unsigned int w = 0; w < _executionMap.size() && pe == NULL; w++ ) {
+                     if ( sys.getWorker( w )->runningOn()->supports( *device ) ) pe = sys.getWorker( w )->runningOn();
+                  }
+                  if ( pe == NULL ) return false;
+
+                  int numRecords = std::min( stored->_numRecords, MAX_LOADED_RECORDS );
+                  record._pe = pe;
+                  record._elapsedTime = stored->_elapsedTime;
+                  record._lastElapsedTime = stored->_elapsedTime;
+                  record._numRecords = numRecords;
+                  record._numAssigned = std::max( numRecords, _minRecordTrial );
+
+                  debug( "[versioning] Loaded record for key ("
+                        + toString<unsigned long>( wd->getVersionGroupId() )
+                        + ", " + toString<size_t>( wd->getParamsSize() ) + ") vId "
+                        + toString<unsigned int>( versionId ) + ": T=" + toString<double>( record._elapsedTime )
+                        + ", #=" + toString<int>( numRecords ) );
+
+                  return true;
+               }
+
+
+               //! \brief Records of this run, merged by database key
+               void getExecRecords ( VersioningDb::RecordMap &records )
+               {
+                  for ( std::set<WDExecInfoKey>::iterator it = _wdExecStatsKeys.begin(); it != _wdExecStatsKeys.end(); it++ ) {
+                     WDExecSymbols::iterator symbol = _wdExecSymbols.find( *it );
+                     if ( symbol == _wdExecSymbols.end() ) continue;
+
+                     WDExecInfoData &data = _wdExecStats[*it];
+                     for ( unsigned int i = 0; i < data.size(); i++ ) {
+                        WDExecRecord &record = data[i];
+                        if ( record._pe == NULL || record._numRecords <= 0 ) continue;
+
+                        VersioningDb::Key key( symbol->second._symbol, VersioningDb::getSizeBucket( it->second ), i );
+                        VersioningDb::RecordMap::iterator stored = records.find( key );
+                        if ( stored == records.end() ) {
+                           VersioningDb::Record &newRecord = records[key];
+                           newRecord._device = symbol->second._devices[i];
+                           newRecord._elapsedTime = record._elapsedTime;
+                           newRecord._numRecords = record._numRecords;
+                        } else {
+                           // Several paramsSizes fall in the same bucket: keep the weighted mean
+                           int numRecords = stored->second._numRecords + record._numRecords;
+                           stored->second._elapsedTime = ( stored->second._elapsedTime * stored->second._numRecords
+                                 + record._elapsedTime * record._numRecords ) / numRecords;
+                           stored->second._numRecords = numRecords;
+                        }
+                     }
+                  }
                }
 
 
@@ -395,10 +655,18 @@ namespace ext
          };
 
       public:
-         static bool       _useStack;
-         static int        _minRecordTrial;
+         static bool          _useStack;
+         static int           _minRecordTrial;
+         static std::string   _dbFile;
+
+      private:
+         VersioningDb         _db;
 
-         Versioning() : SchedulePolicy( "Versioning" ) {}
+      public:
+         Versioning() : SchedulePolicy( "Versioning" ), _db()
+         {
+            _db.load( _dbFile );
+         }
          virtual ~Versioning () {}
 
       private:
@@ -410,7 +678,7 @@ namespace ext
             TeamData *data;
 
             unsigned int num = sys.getNumWorkers();
-            data = NEW TeamData( num );
+            data = NEW TeamData( num, _db );
 
             return data;
          }
@@ -420,6 +688,20 @@ namespace ext
             return 0;
          }
 
+         virtual void atShutdown ( void )
+         {
+            if ( !_db.isEnabled() ) return;
+
+            TeamData &tdata = ( TeamData & ) *myThread->getTeam()->getScheduleData();
+            VersioningDb::RecordMap records;
+
+            tdata._statsLock.acquire();
+            tdata.getExecRecords( records );
+            tdata._statsLock.release();
+
+            _db.save( records );
+         }
+
          virtual void queue ( BaseThread *thread, WD &wd )
          {
             TeamData &tdata = ( TeamData & ) *thread->getTeam()->getScheduleData();
@@ -777,10 +1059,8 @@ namespace ext
             unsigned int numVersions = next->getNumDevices();
             DeviceData **devices = next->getDevices();
 
-            // First record for the given { wdId, paramsSize }
-            if ( data.empty() ) {
-
-               tdata.initExecInfoData( data, next );
+            // First record for the given { wdId, paramsSize }, unless all its versions were already in the database
+            if ( data.empty() && !tdata.initExecInfoData( data, next ) ) {
 
                tdata._statsLock.acquire();
 
@@ -1227,6 +1507,7 @@ namespace ext
 
    bool Versioning::_useStack = false;
    int Versioning::_minRecordTrial = MIN_RECORDS;
+   std::string Versioning::_dbFile;
    Lock Versioning::TeamData::_bestLock;
    Lock Versioning::TeamData::_statsLock;
 
@@ -1257,6 +1538,13 @@ namespace ext
                   NEW Config::IntegerVar( Versioning::_minRecordTrial ),
                   "Minimum number of task version trials for the versioning policy" );
             cfg.registerArgOption( "versioning-min-trials", "versioning-min-trials" );
+
+            // Set the database where the execution times are kept from run to run
+            cfg.registerConfigOption ( "versioning-db",
+                  NEW Config::StringVar( Versioning::_dbFile ),
+                  "SQLite3 database to load and save task version execution times (default: none)" );
+            cfg.registerArgOption( "versioning-db", "versioning-db" );
+            cfg.registerEnvOption( "versioning-db", "NX_VERSIONING_DB" );
          }
 
          virtual void init()
@@ -32,11 +32,16 @@ namespace nanos {
             struct ThreadData : public ScheduleThreadData
             {
                /*! queue of ready tasks to be executed */
-               WDDeque _readyQueue;
+               WDPool *_readyQueue;
 
-               ThreadData () : _readyQueue() {}
+               ThreadData () : _readyQueue( NULL )
+               {
+                  if ( _useLockFreeQueue ) _readyQueue = NEW WDChaseLevDeque( this );
+                  else _readyQueue = NEW WDDeque();
+               }
                virtual ~ThreadData () {
-                  ensure(_readyQueue.empty(),"Destroying non-empty queue");
+                  ensure(_readyQueue->empty(),"Destroying non-empty queue");
+                  delete _readyQueue;
                }
             };
 
@@ -50,6 +55,8 @@ namespace nanos {
             static bool          _stealParent;
             static QueuePolicy   _localPolicy;
             static QueuePolicy   _stealPolicy;
+            static bool          _useLockFreeQueue;
+            static bool          _stealHalf;
 
             // constructor
             WorkFirst() : SchedulePolicy( "Work First" ) {}
@@ -71,20 +78,37 @@ namespace nanos {
             /*! \brief Extracts a WD from the queue either from the beginning or the end of the queue
              *
              *  This function allows to simplify the code to extract code from the queues.
-             *  It's a wrapper around the WDDeque
+             *  It's a wrapper around the WDPool
              *  functions with the actual function chosen with the policy argument.
              *
              *   \param [inout] q The queue from we want to extract a WD
              *   \param [in] policy Either FIFO/LIFO to specify if we extract from the beginning or the end of the queue
              *   \param [in] thread The thread trying to extract the thread
              *   \returns either a WD if one was available in the queues or NULL
-             *   \sa WDDeque::pop_front, WDDeque::pop_back
+             *   \sa WDPool::pop_front, WDPool::pop_back
              */
-            WD * pop ( WDDeque &q, QueuePolicy policy, BaseThread *thread )
+            WD * pop ( WDPool &q, QueuePolicy policy, BaseThread *thread )
             {
                return policy == LIFO  ? q.pop_front(thread) : q.pop_back(thread);
             }
 
+            /*! \brief Steals from the queue of another thread
+             *
+             *  FIFO steals may take up to half of the victim's queue at once: one WD is returned and
+             *  the rest are moved to the thief's own queue.
+             *
+             *   \param [inout] q The queue of the victim
+             *   \param [inout] local The queue of the thief
+             *   \param [in] thread The thief
+             *   \returns either a WD if one was available in the victim queue or NULL
+             *   \sa WDPool::stealHalf
+             */
+            WD * steal ( WDPool &q, WDPool &local, BaseThread *thread )
+            {
+               if ( _stealHalf && _stealPolicy == FIFO ) return q.stealHalf( thread, local );
+               return pop( q, _stealPolicy, thread );
+            }
+
             /*!
             *  \brief Enqueue a work descriptor in the readyQueue of the passed thread
             *  \param thread pointer to the thread to which readyQueue the task must be appended
@@ -94,7 +118,7 @@ namespace nanos {
             virtual void queue ( BaseThread *thread, WD &wd )
             {
                 ThreadData &data = ( ThreadData & ) *thread->getTeamData()->getScheduleData();
-                data._readyQueue.push_front ( &wd );
+                data._readyQueue->push_front ( &wd );
             }
 
             virtual void queue ( BaseThread ** threads, WD ** wds, size_t numElems )
@@ -128,6 +152,8 @@ namespace nanos {
       bool WorkFirst::_stealParent = true;
       WorkFirst::QueuePolicy WorkFirst::_localPolicy = WorkFirst::LIFO;
       WorkFirst::QueuePolicy WorkFirst::_stealPolicy = WorkFirst::FIFO;
+      bool WorkFirst::_useLockFreeQueue = false;
+      bool WorkFirst::_stealHalf = false;
 
       /*!
        *  \brief Function called by the scheduler when a thread becomes idle to schedule it
@@ -147,7 +173,7 @@ namespace nanos {
          /*
           *  First try to schedule the thread with a task from its queue
           */
-         if ( ( wd = pop( data._readyQueue, _localPolicy, thread ) ) != NULL ) {
+         if ( ( wd = pop( *data._readyQueue, _localPolicy, thread ) ) != NULL ) {
             return wd;
          } else {
             /*
@@ -181,7 +207,7 @@ namespace nanos {
 
                if ( victim.getTeam() != NULL ) {
                  ThreadData &tdata = ( ThreadData & ) *victim.getTeamData()->getScheduleData();
-                 wd = pop( tdata._readyQueue, _stealPolicy, thread );
+                 wd = steal( *tdata._readyQueue, *data._readyQueue, thread );
                }
 
                count++;
@@ -226,6 +252,14 @@ namespace nanos {
                                              "Defines the steal access policy");
                cfg.registerArgOption ( "schedule-steal-policy", "schedule-steal-policy" );
 
+               cfg.registerConfigOption ( "schedule-lock-free-queue", NEW Config::FlagOption( WorkFirst::_useLockFreeQueue ),
+                                             "Uses a lock-free Chase-Lev deque as ready queue (owner pops LIFO, thieves steal FIFO)" );
+               cfg.registerArgOption ( "schedule-lock-free-queue", "schedule-lock-free-queue" );
+
+               cfg.registerConfigOption ( "schedule-steal-half", NEW Config::FlagOption( WorkFirst::_stealHalf ),
+                                             "FIFO steals move up to half of the victim queue to the thief queue (default = no)" );
+               cfg.registerArgOption ( "schedule-steal-half", "schedule-steal-half" );
+
             }
 
             virtual void init() {
@@ -0,0 +1,205 @@
+/*************************************************************************************/
+/*      Copyright 2015 Barcelona Supercomputing Center                               */
+/*                                                                                   */
+/*      This file is part of the NANOS++ library.                                    */
+/*                                                                                   */
+/*      NANOS++ is free software: you can redistribute it and/or modify              */
+/*      it under the terms of the GNU Lesser General Public License as published by  */
+/*      the Free Software Foundation, either version 3 of the License, or            */
+/*      (at your option) any later version.                                          */
+/*                                                                                   */
+/*      NANOS++ is distributed in the hope that it will be useful,                   */
+/*      but WITHOUT ANY WARRANTY; without even the implied warranty of               */
+/*      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                */
+/*      GNU Lesser General Public License for more details.                          */
+/*                                                                                   */
+/*      You should have received a copy of the GNU Lesser General Public License     */
+/*      along with NANOS++.  If not, see <http://www.gnu.org/licenses/>.             */
+/*************************************************************************************/
+
+#include "system.hpp"
+#include "throttle_decl.hpp"
+#include "plugin.hpp"
+#include "config.hpp"
+#include "atomic.hpp"
+#include "instrumentation.hpp"
+
+#include <time.h>
+
+namespace nanos {
+   namespace ext {
+
+      /*! \brief Throttle policy which tunes its cut-off (maximum number of live tasks) at run time
+       *
+       *  Every period, one of the threads creating tasks re-computes the cut-off from:
+       *  - the task granularity, measured from the tasks finished during the last period,
+       *    so that enough tasks are queued to keep all the threads busy for one period,
+       *  - the idle threads, which double the cut-off when they find no ready tasks,
+       *  - the memory used by the live tasks, which caps the cut-off.
+       */
+      class AdaptiveThrottle : public ThrottlePolicy
+      {
+         private:
+            int                  _minCutoff;      /**< Minimum number of live tasks */
+            int                  _maxCutoff;      /**< Maximum number of live tasks */
+            size_t               _maxBytes;       /**< Maximum memory used by live tasks */
+            uint64_t             _period;         /**< Adaptation period (ns) */
+
+            Atomic<int>          _cutoff;         /**< Current cut-off */
+            Atomic<int>          _completed;      /**< Tasks finished during the current period */
+            Atomic<uint64_t>     _nextAdapt;      /**< Time of the next adaptation */
+            uint64_t             _lastAdapt;      /**< Time of the last adaptation (updater only) */
+            double               _granularity;    /**< Smoothed task granularity in ns (updater only) */
+
+            AdaptiveThrottle ( const AdaptiveThrottle & );
+            const AdaptiveThrottle & operator= ( const AdaptiveThrottle & );
+
+            static uint64_t getTime ( void )
+            {
+               struct timespec ts;
+               clock_gettime( CLOCK_MONOTONIC, &ts );
+               return (uint64_t) ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+            }
+
+            void adapt ( uint64_t now );
+
+         public:
+            AdaptiveThrottle( int minTasks, int maxTasks, int maxMemory, int period )
+            :  _minCutoff( minTasks * sys.getNumThreads() ),
+               _maxCutoff( maxTasks * sys.getNumThreads() ),
+               _maxBytes( (size_t) maxMemory * 1024 * 1024 ),
+               _period( (uint64_t) period * 1000 ),
+               _cutoff( _minCutoff ), _completed( 0 ), _nextAdapt( 0 ), _lastAdapt( 0 ), _granularity( 0.0 )
+            {
+               if ( _maxCutoff < _minCutoff ) _maxCutoff = _minCutoff;
+
+               verbose0( "Throttle adaptive created");
+               verbose0( "   cut-off between " << _minCutoff << " and " << _maxCutoff << " tasks" );
+               verbose0( "   memory limit: " << maxMemory << " MB" );
+               verbose0( "   period: " << period << " us" );
+            }
+
+            ~AdaptiveThrottle() {}
+
+            bool throttleIn( void );
+            void throttleOut ( void );
+      };
+
+      bool AdaptiveThrottle::throttleIn ( void )
+      {
+         uint64_t now = getTime();
+         uint64_t next = _nextAdapt.value();
+         // Only the thread winning the race re-computes the cut-off
+         if ( now >= next && _nextAdapt.cswap( next, now + _period ) ) adapt( now );
+
+         return sys.getTaskNum() < _cutoff.value() && sys.getPendingBytes() <= _maxBytes;
+      }
+
+      void AdaptiveThrottle::throttleOut ( void )
+      {
+         _completed++;
+      }
+
+      void AdaptiveThrottle::adapt ( uint64_t now )
+      {
+         if ( _lastAdapt == 0 ) {
+            _lastAdapt = now;
+            return;
+         }
+
+         uint64_t elapsed = now - _lastAdapt;
+         _lastAdapt = now;
+
+         int completed = _completed.value();
+         _completed -= completed;
+
+         int threads = sys.getNumThreads();
+         int idle = sys.getIdleNum();
+         int busy = threads - idle;
+         if ( busy < 1 ) busy = 1;
+
+         // Each busy thread spent the whole period running the finished tasks
+         if ( completed > 0 ) {
+            double granularity = (double) busy * elapsed / completed;
+            _granularity = ( _granularity == 0.0 ) ? granularity : ( _granularity + granularity ) / 2;
+         }
+
+         int cutoff = _cutoff.value();
+         int target = cutoff;
+
+         // Enough tasks to keep every thread busy until the next adaptation (clamped
+         // before the conversion, as a long period over a tiny granularity does not fit in an int)
+         if ( _granularity > 0.0 ) {
+            double wanted = threads + threads * ( _period / _granularity );
+            target = wanted < (double) _maxCutoff ? (int) wanted : _maxCutoff;
+         }
+
+         // Starving threads: open up quickly
+         if ( idle > 0 && sys.getReadyNum() == 0 && target / 2 < cutoff ) target = cutoff < _maxCutoff / 2 ? 2 * cutoff : _maxCutoff;
+
+         // Do not let the live tasks exceed the memory limit
+         size_t bytes = sys.getPendingBytes();
+         int tasks = sys.getTaskNum();
+         if ( bytes > _maxBytes && tasks > 0 ) {
+            int fit = (int) ( tasks * ( (double) _maxBytes / bytes ) );
+            if ( fit < target ) target = fit;
+         }
+
+         if ( target < _minCutoff ) target = _minCutoff;
+         if ( target > _maxCutoff ) target = _maxCutoff;
+         _cutoff = target;
+
+#ifdef NANOS_INSTRUMENTATION_ENABLED
+         static nanos_event_key_t keys[3] = {
+            sys.getInstrumentation()->getInstrumentationDictionary()->getEventKey( "throttle-cutoff" ),
+            sys.getInstrumentation()->getInstrumentationDictionary()->getEventKey( "throttle-granularity" ),
+            sys.getInstrumentation()->getInstrumentationDictionary()->getEventKey( "throttle-pending-bytes" )
+         };
+         nanos_event_value_t values[3] = { (nanos_event_value_t) target, (nanos_event_value_t) _granularity, (nanos_event_value_t) bytes };
+         sys.getInstrumentation()->raisePointEvents( 3, keys, values );
+#endif
+      }
+
+      class AdaptiveThrottlePlugin : public Plugin
+      {
+         private:
+            int _minTasks;
+            int _maxTasks;
+            int _maxMemory;
+            int _period;
+
+         public:
+            AdaptiveThrottlePlugin() : Plugin( "Adaptive throttle plugin (cut-off tuned at run time)",1 ),
+                                       _minTasks( 2 ), _maxTasks( 500 ), _maxMemory( 1024 ), _period( 1000 ) {}
+
+            virtual void config( Config &cfg )
+            {
+               cfg.setOptionsSection( "Adaptive throttle", "Throttle policy tuning its cut-off from task granularity, idle threads and memory" );
+
+               cfg.registerConfigOption ( "throttle-min-tasks", NEW Config::PositiveVar( _minTasks ),
+                  "Defines the minimum cut-off, in live tasks per thread (2 * nthreads)" );
+               cfg.registerArgOption ( "throttle-min-tasks", "throttle-min-tasks" );
+
+               cfg.registerConfigOption ( "throttle-max-tasks", NEW Config::PositiveVar( _maxTasks ),
+                  "Defines the maximum cut-off, in live tasks per thread (500 * nthreads)" );
+               cfg.registerArgOption ( "throttle-max-tasks", "throttle-max-tasks" );
+
+               cfg.registerConfigOption ( "throttle-max-memory", NEW Config::PositiveVar( _maxMemory ),
+                  "Defines the maximum memory used by live tasks, in MB (1024)" );
+               cfg.registerArgOption ( "throttle-max-memory", "throttle-max-memory" );
+
+               cfg.registerConfigOption ( "throttle-period", NEW Config::PositiveVar( _period ),
+                  "Defines the period between cut-off adaptations, in microseconds (1000)" );
+               cfg.registerArgOption ( "throttle-period", "throttle-period" );
+            }
+
+            virtual void init() {
+               sys.countPendingBytes();
+               sys.setThrottlePolicy( NEW AdaptiveThrottle( _minTasks, _maxTasks, _maxMemory, _period ) );
+            }
+      };
+
+   }
+}
+
+DECLARE_PLUGIN("throttle-adaptive",nanos::ext::AdaptiveThrottlePlugin);
@@ -62,14 +62,12 @@ class WorkSharingGuidedFor : public WorkSharing {
 
             ((WorkSharingLoopInfo *)(*wsd)->data)->currentChunk  = 0;
 
-            memoryFence();     // Split initialization phase (before) from make it visible (after)
-
-            (*wsd)->ws = this; // Once 'ws' field has a value, any other thread can use the structure
+            publishWorkSharing( *wsd, this );
 
          }
 
          // wait until worksharing descriptor is initialized
-         while ( (*wsd)->ws == NULL ) {;}
+         waitWorkSharing( *wsd );
 
          return single;
       }
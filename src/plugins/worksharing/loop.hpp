@@ -17,8 +17,12 @@
 /*      along with NANOS++.  If not, see <http://www.gnu.org/licenses/>.             */
 /*************************************************************************************/
 
+#ifndef _NANOS_WORKSHARING_LOOP
+#define _NANOS_WORKSHARING_LOOP
+
 #include "nanos-int.h"
-#include "atomic_decl.hpp"
+#include "atomic.hpp"
+#include <sched.h>
 
 namespace nanos {
 namespace ext {
@@ -32,5 +36,30 @@ typedef struct {
    Atomic<int64_t>           currentChunk; // current chunk ready to execute
 } WorkSharingLoopInfo;
 
+//! \brief Make an initialized team worksharing descriptor visible to the team
+inline void publishWorkSharing ( nanos_ws_desc_t *wsd, nanos_ws_t ws )
+{
+   memoryFence();     // Split initialization phase (before) from make it visible (after)
+   wsd->ws = ws;      // Once 'ws' field has a value, any other thread can use the structure
+}
+
+//! \brief Wait until the team worksharing descriptor has been published
+//! Spins for a while and then yields the cpu, so an oversubscribed creator
+//! is not starved by the threads waiting for it
+inline void waitWorkSharing ( nanos_ws_desc_t *wsd )
+{
+   unsigned spins = 0;
+   while ( wsd->ws == NULL ) {
+      if ( ++spins < 1024 ) cpuRelax();
+      else {
+         sched_yield();
+         spins = 0;
+      }
+   }
+   memoryFence();     // Do not read descriptor data before seeing it published
+}
+
 } // namespace ext
 } // namespace nanos
+
+#endif
@@ -0,0 +1,189 @@
+/*************************************************************************************/
+/*      Copyright 2015 Barcelona Supercomputing Center                               */
+/*                                                                                   */
+/*      This file is part of the NANOS++ library.                                    */
+/*                                                                                   */
+/*      NANOS++ is free software: you can redistribute it and/or modify              */
+/*      it under the terms of the GNU Lesser General Public License as published by  */
+/*      the Free Software Foundation, either version 3 of the License, or            */
+/*      (at your option) any later version.                                          */
+/*                                                                                   */
+/*      NANOS++ is distributed in the hope that it will be useful,                   */
+/*      but WITHOUT ANY WARRANTY; without even the implied warranty of               */
+/*      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                */
+/*      GNU Lesser General Public License for more details.                          */
+/*                                                                                   */
+/*      You should have received a copy of the GNU Lesser General Public License     */
+/*      along with NANOS++.  If not, see <http://www.gnu.org/licenses/>.             */
+/*************************************************************************************/
+
+#include "nanos-int.h"
+#include "atomic.hpp"
+#include "loop.hpp"
+#include "plugin.hpp"
+#include "system.hpp"
+#include "worksharing_decl.hpp"
+#include "allocator_decl.hpp"
+
+namespace nanos {
+namespace ext {
+
+//! \brief Range of chunks owned by a thread, packed as [begin,end) in a single word
+//! so the owner taking a chunk and a thief splitting the range race on one CAS
+typedef struct {
+   char                      padHead[NANOS_CACHELINE];
+   Atomic<uint64_t>          chunks;       // begin << 32 | end
+   char                      padTail[NANOS_CACHELINE];
+} WorkSharingStealRange;
+
+typedef struct {
+   int64_t                   lowerBound;   // loop lower bound
+   int64_t                   upperBound;   // loop upper bound
+   int64_t                   loopStep;     // loop step
+   int64_t                   chunkSize;    // loop chunk size
+   int64_t                   numOfChunks;  // number of chunks for the loop
+   int                       numOfRanges;  // number of per-thread ranges
+   WorkSharingStealRange    *ranges;       // per-thread chunk ranges
+} WorkSharingStealInfo;
+
+class WorkSharingStealFor : public WorkSharing {
+
+      static inline uint64_t pack ( uint64_t begin, uint64_t end ) { return ( begin << 32 ) | end; }
+      static inline uint64_t begin ( uint64_t range ) { return range >> 32; }
+      static inline uint64_t end ( uint64_t range ) { return range & 0xFFFFFFFFULL; }
+
+      //! \brief Take the first chunk of my own range
+      bool takeOwn ( WorkSharingStealRange &range, int64_t &chunk )
+      {
+         uint64_t current = range.chunks.value();
+         while ( begin( current ) < end( current ) ) {
+            if ( range.chunks.cswap( current, pack( begin( current ) + 1, end( current ) ) ) ) {
+               chunk = begin( current );
+               return true;
+            }
+            current = range.chunks.value();
+         }
+         return false;
+      }
+
+      //! \brief Steal the upper half of a victim range, returning its first chunk and
+      //! keeping the rest as my new range
+      bool steal ( WorkSharingStealRange &victim, WorkSharingStealRange &mine, int64_t &chunk )
+      {
+         uint64_t current = victim.chunks.value();
+         while ( begin( current ) < end( current ) ) {
+            uint64_t middle = begin( current ) + ( end( current ) - begin( current ) ) / 2;
+            if ( victim.chunks.cswap( current, pack( begin( current ), middle ) ) ) {
+               chunk = middle;
+               // Only the owner refills its range, and nobody steals an empty one
+               mine.chunks = pack( middle + 1, end( current ) );
+               return true;
+            }
+            current = victim.chunks.value();
+         }
+         return false;
+      }
+
+      //! \brief create a loop descriptor
+      //! \return only one thread per loop will get 'true' (single like behaviour)
+      bool create( nanos_ws_desc_t **wsd, nanos_ws_info_t *info )
+      {
+         nanos_ws_info_loop_t *loop_info = (nanos_ws_info_loop_t *) info;
+         bool single = false;
+
+         *wsd = myThread->getTeamWorkSharingDescriptor( &single );
+
+         if ( single ) {
+            WorkSharingStealInfo *loop_data = NEW WorkSharingStealInfo();
+            (*wsd)->data = loop_data;
+
+            // Computing Lower and upper bound. Loop step.
+            loop_data->lowerBound = loop_info->lower_bound;
+            loop_data->upperBound = loop_info->upper_bound;
+            loop_data->loopStep   = loop_info->loop_step;
+
+            // Computing chunk size
+            int64_t chunk_size = (1 < loop_info->chunk_size) ? loop_info->chunk_size : 1;
+
+            // Computing number of chunks, grow them if they do not fit in a range
+            int64_t niters = (((loop_info->upper_bound - loop_info->lower_bound) / loop_info->loop_step ) + 1 );
+            if ( niters < 0 ) niters = 0;
+            while ( niters / chunk_size >= (int64_t) 0xFFFFFFFFLL ) chunk_size *= 2;
+            int64_t chunks = niters / chunk_size;
+            if ( niters % chunk_size != 0 ) chunks++;
+            loop_data->chunkSize   = chunk_size;
+            loop_data->numOfChunks = chunks;
+
+            // Pre-partitioning chunks among the team threads
+            int num_ranges = myThread->getTeam() ? myThread->getTeam()->getFinalSize() : 1;
+            if ( num_ranges < 1 ) num_ranges = 1;
+            loop_data->numOfRanges = num_ranges;
+            loop_data->ranges = NEW WorkSharingStealRange[num_ranges];
+            for ( int i = 0; i < num_ranges; i++ ) {
+               loop_data->ranges[i].chunks = pack( ( chunks * i ) / num_ranges, ( chunks * ( i + 1 ) ) / num_ranges );
+            }
+
+            publishWorkSharing( *wsd, this );
+         }
+
+         waitWorkSharing( *wsd );
+
+         return single;
+      }
+
+      //! \brief Get next chunk of iterations
+      void nextItem( nanos_ws_desc_t *wsd, nanos_ws_item_t *item )
+      {
+         nanos_ws_item_loop_t *loop_item = ( nanos_ws_item_loop_t *) item;
+         WorkSharingStealInfo *loop_data = ( WorkSharingStealInfo *) wsd->data;
+
+         int num_ranges = loop_data->numOfRanges;
+         int thid = myThread->getTeamId() % num_ranges;
+         WorkSharingStealRange &mine = loop_data->ranges[thid];
+
+         int64_t mychunk = 0;
+         bool found = takeOwn( mine, mychunk );
+
+         // Own range exhausted: split the victims' ranges, nearest team ids first
+         for ( int i = 1; !found && i < num_ranges; i++ ) {
+            found = steal( loop_data->ranges[(thid + i) % num_ranges], mine, mychunk );
+         }
+
+         if ( !found ) {
+            loop_item->execute = false;
+            return;
+         }
+
+         int sign = (( loop_data->loopStep < 0 ) ? -1 : +1);
+
+         loop_item->lower = loop_data->lowerBound + mychunk * loop_data->chunkSize * loop_data->loopStep;
+
+         loop_item->upper = loop_item->lower + loop_data->chunkSize * loop_data->loopStep - sign;
+         if ( ( loop_data->upperBound * sign ) < ( loop_item->upper * sign ) ) loop_item->upper = loop_data->upperBound;
+
+         loop_item->last = mychunk == (loop_data->numOfChunks - 1);
+
+         loop_item->execute = (loop_item->lower * sign) <= (loop_item->upper * sign);
+      }
+
+      void duplicateWS ( nanos_ws_desc_t *orig, nanos_ws_desc_t **copy) {}
+
+};
+
+class WorkSharingStealForPlugin : public Plugin {
+   public:
+      WorkSharingStealForPlugin () : Plugin("Worksharing plugin for loops using per-thread ranges and stealing",1) {}
+     ~WorkSharingStealForPlugin () {}
+
+      virtual void config( Config& cfg ) {}
+
+      void init ()
+      {
+         sys.registerWorkSharing("steal_for", NEW WorkSharingStealFor() );
+      }
+};
+
+} // namespace ext
+} // namespace nanos
+
+DECLARE_PLUGIN( "placeholder-name", nanos::ext::WorkSharingStealForPlugin );
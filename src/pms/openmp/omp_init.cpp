@@ -78,6 +78,16 @@ namespace nanos
          ws_names[omp_sched_dynamic] = std::string("dynamic_for");
          ws_names[omp_sched_guided] = std::string("guided_for");
          ws_names[omp_sched_auto] = std::string("static_for");
+
+         cfg.registerConfigOption( "omp-dynamic-ws", NEW Config::StringVar( ws_names[omp_sched_dynamic] ),
+                             "Worksharing plugin used for dynamic loops: dynamic_for (default), steal_for" );
+         cfg.registerArgOption( "omp-dynamic-ws", "omp-dynamic-ws" );
+         cfg.registerEnvOption( "omp-dynamic-ws", "NX_OMP_DYNAMIC_WS" );
+
+         cfg.registerConfigOption( "omp-guided-ws", NEW Config::StringVar( ws_names[omp_sched_guided] ),
+                             "Worksharing plugin used for guided loops: guided_for (default), steal_for" );
+         cfg.registerArgOption( "omp-guided-ws", "omp-guided-ws" );
+         cfg.registerEnvOption( "omp-guided-ws", "NX_OMP_GUIDED_WS" );
       }
 
 
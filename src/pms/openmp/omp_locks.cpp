@@ -40,20 +40,19 @@ extern "C"
 
    NANOS_API_DEF(void, omp_set_lock, ( omp_lock_t *arg ))
    {
-      Lock &lock = *(Lock *) arg;
-      lock++;
+      nanos_set_lock( (nanos_lock_t *) arg );
    }
 
    NANOS_API_DEF(void, omp_unset_lock,( omp_lock_t *arg ))
    {
-      Lock &lock = *(Lock *) arg;
-      lock--;
+      nanos_unset_lock( (nanos_lock_t *) arg );
    }
 
    NANOS_API_DEF(int, omp_test_lock ,( omp_lock_t *arg ))
    {
-      Lock &lock = *(Lock *) arg;
-      return lock.tryAcquire();
+      bool result;
+      nanos_try_lock( (nanos_lock_t *) arg, &result );
+      return result;
    }
 
    struct __omp_nest_lock {
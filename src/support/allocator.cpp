@@ -39,24 +39,76 @@ Allocator & nanos::getAllocator ( void )
    else return my_thread->getAllocator();
 }
 
-void * Allocator::Arena::allocate ( void )
+Allocator::Arena::Arena ( size_t sizeClass, size_t objectSize, Allocator *owner, Arena *next ) :
+   _objectSize( objectSize ), _class( sizeClass ), _numObjects( NANOS_ARENA_MAX_SIZE / objectSize ), _carved( 0 ),
+   _arena( NULL ), _next( next ), _owner( owner ), _remoteFree( NULL )
 {
-   unsigned int obj;
+   if ( _numObjects > NANOS_OBJECTS_PER_ARENA ) _numObjects = NANOS_OBJECTS_PER_ARENA;
+   if ( _numObjects == 0 ) _numObjects = 1;
 
-   if ( !_free ) return NULL;
+   _arena = (char *) malloc( _objectSize * _numObjects );
+   if ( _arena == NULL ) throw ( NANOS_ENOMEM );
+}
+
+Allocator::ObjectHeader * Allocator::refill ( size_t sizeClass )
+{
+   SizeClass &sc = _classes[sizeClass];
+   ObjectHeader *ptr = NULL;
+
+   // Objects never used in the Arena being carved
+   if ( sc._arenas != NULL && ( ptr = sc._arenas->carve() ) != NULL ) {
+      ptr->_arena = sc._arenas;
+      return ptr;
+   }
 
-   for ( obj = 0 ; obj < numObjects ; obj++ ) {
-      if ( _bitmap[obj]._bit ) break;
+   // Objects released by other threads
+   for ( Arena *arena = sc._arenas; arena != NULL; arena = arena->getNext() ) {
+      ObjectHeader *remote = arena->drainRemote();
+      while ( remote != NULL ) {
+         ObjectHeader *next = nextFree( remote );
+         nextFree( remote ) = sc._free;
+         sc._free = remote;
+         remote = next;
+         _stats._remoteDeallocations++;
+      }
    }
 
-   if (obj == numObjects) {
-      _free = false;
-      return NULL; 
+   if ( sc._free != NULL ) {
+      ptr = sc._free;
+      sc._free = nextFree( ptr );
+      return ptr;
    }
 
-   _bitmap[obj]._bit = false;
+   // A new Arena for this size class
+   Arena *arena = (Arena *) malloc( sizeof(Arena) );
+   if ( arena == NULL ) throw(NANOS_ENOMEM);
+   new ( arena ) Arena( sizeClass, (size_t) 1 << ( sizeClass + _minClass ), this, sc._arenas );
+   sc._arenas = arena;
 
-   return (void *) &_arena[obj*_objectSize];
+   _stats._arenas++;
+   _stats._arenaBytes += arena->getObjectSize() * arena->getNumObjects();
+
+   ptr = arena->carve();
+   ptr->_arena = arena;
+   return ptr;
 }
 
+Allocator::Stats & Allocator::Stats::operator+= ( const Stats &s )
+{
+   _allocations += s._allocations;
+   _deallocations += s._deallocations;
+   _remoteDeallocations += s._remoteDeallocations;
+   _bigAllocations += s._bigAllocations;
+   _arenas += s._arenas;
+   _arenaBytes += s._arenaBytes;
+   return *this;
+}
 
+void Allocator::printStats ( std::ostream &o, const Stats &stats )
+{
+   o << "=== " << stats._allocations << " objects allocated from size classes" << std::endl;
+   o << "=== " << stats._deallocations << " objects freed by their owner thread" << std::endl;
+   o << "=== " << stats._remoteDeallocations << " objects freed by other threads" << std::endl;
+   o << "=== " << stats._bigAllocations << " big objects allocated with malloc" << std::endl;
+   o << "=== " << stats._arenas << " arenas (" << stats._arenaBytes << " bytes) reserved" << std::endl;
+}
@@ -20,6 +20,7 @@
 #ifndef _NANOS_ALLOCATOR_HPP
 #define _NANOS_ALLOCATOR_HPP
 #include "allocator_decl.hpp"
+#include "atomic.hpp"
 #include <vector>
 #include <cstdlib>
 #include <cstring>
@@ -34,17 +35,44 @@ inline size_t Allocator::Arena::getObjectSize () const
    return _objectSize;
 }
 
-inline void Allocator::Arena::deallocate ( void *object )
+inline size_t Allocator::Arena::getSizeClass () const
 {
-   unsigned long offset = ((char *) object - _arena);
-   unsigned long index = offset / _objectSize;
+   return _class;
+}
+
+inline size_t Allocator::Arena::getNumObjects () const
+{
+   return _numObjects;
+}
+
+inline Allocator * Allocator::Arena::getOwner () const
+{
+   return _owner;
+}
 
-   //if (sys.getNetwork()->getNodeNum() == 0 && _objectSize > 32768) std::cerr << "Free object size " << _objectSize << " : " << (void *) _objectSize << " addr range is " << (void *) object << ":" << ((void *) (((char*)object)+_objectSize)) << " this is arena " << (void*) this << std::endl;
-   _free = true;
-   _bitmap[index]._bit = true;
+inline Allocator::ObjectHeader * Allocator::Arena::carve ( void )
+{
+   if ( _carved == _numObjects ) return NULL;
+   return (ObjectHeader *) &_arena[(_carved++)*_objectSize];
+}
 
-   //if (sys.getNetwork()->getNodeNum() == 0 && _objectSize > 32768) std::cerr << "memset from " << (void *) &_arena[index*_objectSize] << " to " << (void*) (&_arena[index*_objectSize+_objectSize]) << std::endl;
-   //memset( &_arena[index*_objectSize], 0, _objectSize );
+inline void Allocator::Arena::deallocateRemote ( ObjectHeader *object )
+{
+   ObjectHeader *head;
+   do {
+      head = _remoteFree.value();
+      nextFree( object ) = head;
+   } while ( !_remoteFree.cswap( head, object ) );
+}
+
+inline Allocator::ObjectHeader * Allocator::Arena::drainRemote ( void )
+{
+   ObjectHeader *head;
+   do {
+      head = _remoteFree.value();
+      if ( head == NULL ) return NULL;
+   } while ( !_remoteFree.cswap( head, (ObjectHeader *) NULL ) );
+   return head;
 }
 
 inline Allocator::Arena * Allocator::Arena::getNext ( void ) const
@@ -57,6 +85,11 @@ inline void Allocator::Arena::setNext ( Arena * a )
    _next = a;
 }
 
+inline Allocator::ObjectHeader *& Allocator::nextFree ( ObjectHeader *object )
+{
+   return *(ObjectHeader **) ( ((char *) object) + _headerSize );
+}
+
 inline void * Allocator::allocateBigObject ( size_t size )
 {
    ObjectHeader * ptr = NULL;
@@ -64,62 +97,37 @@ inline void * Allocator::allocateBigObject ( size_t size )
    ptr = (ObjectHeader *) malloc( size + _headerSize );
    if ( ptr == NULL ) throw(NANOS_ENOMEM);
    ptr->_arena = NULL; 
+   _stats._bigAllocations++;
 
    return  ((char *) ptr ) + _headerSize;
 }
 
 inline void * Allocator::allocate ( size_t size, const char* file, int line )
 {
-   if ( size > _sizeOfBig ) return allocateBigObject(size);
-
-   /* realSize is (size + header )'s next power of 2 */
-   size_t realSize = size + _headerSize + 1;
-   realSize |= realSize >> 1;
-   realSize |= realSize >> 2;
-   realSize |= realSize >> 4;
-   realSize |= realSize >> 8;
-   realSize |= realSize >> 16;
-   realSize++;
- 
-
-   ArenaCollection::iterator it;
-   for ( it = _arenas.begin(); it != _arenas.end(); it++ ) {
-      if ( (*it)->getObjectSize() == realSize ) break;
-   }
+   if ( size + _headerSize > ( (size_t) 1 << _maxClass ) ) return allocateBigObject(size);
 
-   Arena *arena = NULL;
+   /* sizeClass is log2 of (size + header)'s next power of 2 (at least _minClass) */
+   size_t sizeClass = _minClass;
+   while ( ( (size_t) 1 << sizeClass ) < size + _headerSize ) sizeClass++;
+   sizeClass -= _minClass;
 
-   if ( it == _arenas.end() ) {
-      // no arena found for that size, create a new one
-      arena = (Arena *) malloc ( sizeof(Arena) );
-      if ( arena == NULL ) throw(NANOS_ENOMEM);
-      new ( arena ) Arena( realSize );
-      _arenas.push_back( arena );
-   }
-   else arena = *it;
-
-
-   ObjectHeader * ptr = NULL;
+   ObjectHeader *ptr = _classes[sizeClass]._free;
+   if ( ptr != NULL ) _classes[sizeClass]._free = nextFree( ptr );
+   else ptr = refill( sizeClass );
 
-   while ( ptr == NULL ) {
-      ptr = (ObjectHeader *) arena->allocate();
-      if ( ptr == NULL ) { 
-          if ( arena->getNext() == NULL ) {
-             Arena *next = ( Arena *) malloc ( sizeof(Arena) );
-             if ( next == NULL ) throw(NANOS_ENOMEM);
-             new (next) Arena(realSize);
-             arena->setNext( next );
-          }
-          arena = arena->getNext(); 
-      }
-   }
-
-   ptr->_arena = arena;
-   //if (sys.getNetwork()->getNodeNum() == 0 && realSize > 32768) std::cerr << "Allocate object size " << realSize << " : " << (void *) realSize << " addr range is " << (void *) ptr << ":" << ((void *) (((char*)ptr)+realSize)) << " this is arena " << (void *) arena << std::endl;
+   _stats._allocations++;
 
    return  ((char *) ptr ) + _headerSize;
 }
 
+inline void Allocator::deallocateLocal ( ObjectHeader *object )
+{
+   SizeClass &sc = _classes[object->_arena->getSizeClass()];
+   nextFree( object ) = sc._free;
+   sc._free = object;
+   _stats._deallocations++;
+}
+
 inline void Allocator::deallocate ( void *object, const char *file, int line )
 {
    if ( object == NULL ) return;
@@ -131,8 +139,10 @@ inline void Allocator::deallocate ( void *object, const char *file, int line )
    // If there is no arena then it was a big object that just needs to be freed
    if ( arena == NULL )
      free(ptr);
+   else if ( arena->getOwner() == &getAllocator() )
+     arena->getOwner()->deallocateLocal(ptr);
    else
-     arena->deallocate(ptr);
+     arena->deallocateRemote(ptr);
 }
 
 inline size_t Allocator::getObjectSize ( void *object )
@@ -142,6 +152,11 @@ inline size_t Allocator::getObjectSize ( void *object )
    return arena->getObjectSize() - _headerSize ;
 }
 
+inline const Allocator::Stats & Allocator::getStats ( void ) const
+{
+   return _stats;
+}
+
 } // namespace nanos
 
 #endif
@@ -23,6 +23,7 @@
 #include "allocator_fwd.hpp"
 #include "new_decl.hpp"
 #include "malign.hpp"
+#include "atomic_decl.hpp"
 #include <list>
 #include <map>
 #include <cstdlib>
@@ -31,6 +32,7 @@
 
 #define NANOS_CACHELINE 128 /* FIXME: This definition must be architectural dependant */
 #define NANOS_OBJECTS_PER_ARENA 1000
+#define NANOS_ARENA_MAX_SIZE (1024*1024) /* Bytes, caps the number of objects per Arena for big size classes */
 
 namespace nanos {
 
@@ -85,27 +87,32 @@ class InternalAllocator
        inline void destroy( pointer p ) { p->~T(); }
 };
 /*! \class Allocator
+ *
+ *  Per thread size-class allocator. Objects are grouped in power of two size
+ *  classes, each of them with a free list of objects, so allocation and local
+ *  deallocation are O(1). Objects freed by a thread other than the owner of
+ *  their Arena are pushed (lock-free) to the remote free list of that Arena
+ *  and moved back to the owner's free list when it runs out of objects.
  */
 class Allocator
 {
    private:
+      struct ObjectHeader;
+
      /*! \class Arena
       */
       class Arena
       {
          private: /* Arena data members and disabled constructors */
-            static const size_t numObjects = NANOS_OBJECTS_PER_ARENA;      /** Number of maximum objects allocated in this arena*/
-
-            union bitmap_entry {
-               bool             _bit;
-               char             pad[NANOS_CACHELINE];
-            };                                         /**< bitmap_entry struct */
-
-            size_t            _objectSize;            /**< Object size in current Arena  */
-            char             *_arena;                 /**< Memory region used by Arena */
-            bitmap_entry     *_bitmap;                /**< Bit map (free/busy) */
-            Arena            *_next;                  /**< Next Arena in the list */
-            bool              _free;                  /**< Are there free entries */
+            size_t                  _objectSize;     /**< Object size in current Arena  */
+            size_t                  _class;          /**< Size class index of the Arena objects */
+            size_t                  _numObjects;     /**< Number of objects in this Arena */
+            size_t                  _carved;         /**< Objects already handed out at least once */
+            char                   *_arena;          /**< Memory region used by Arena */
+            Arena                  *_next;           /**< Next Arena of the same size class */
+            Allocator              *_owner;          /**< Allocator owning this Arena */
+            char                    _pad[NANOS_CACHELINE]; /**< Keeps remote frees off the owner's cache line */
+            Atomic<ObjectHeader *>  _remoteFree;     /**< Objects freed by other threads */
             /*! \brief Arena copy constructor (disabled)
              */
             Arena ( const Arena &a );
@@ -118,30 +125,34 @@ class Allocator
          public: /* Arena method members */
            /*! \brief Arena constructor
             */
-            Arena ( size_t objectSize ) : _objectSize(objectSize), _next (NULL), _free(true)
-            {
-               _arena = (char *) malloc( (objectSize + sizeof(bitmap_entry) ) * numObjects );
-               if ( _arena == NULL ) throw ( NANOS_ENOMEM );
-               _bitmap = (bitmap_entry *) (_arena + objectSize * numObjects);
-               for ( size_t i = 0; i < numObjects; i++ ) _bitmap[i]._bit = true;
-            }
+            Arena ( size_t sizeClass, size_t objectSize, Allocator *owner, Arena *next );
            /*! \brief Arena destructor
             */
             ~Arena ()
             {
-               delete _next;
                free(_arena);
-               free(_bitmap);
             }
            /*! \brief Returns the size of allocated object
             */
             size_t getObjectSize ( void ) const ; 
-           /*! \brief Returns a free object address (and mark it as busy)
+           /*! \brief Returns the size class index of allocated objects
+            */
+            size_t getSizeClass ( void ) const ;
+           /*! \brief Returns the number of objects in this Arena
+            */
+            size_t getNumObjects ( void ) const ;
+           /*! \brief Returns the Allocator owning this Arena
             */
-            void * allocate ( void ) ;
-           /*! \brief Mark 'object' as free
+            Allocator * getOwner ( void ) const;
+           /*! \brief Returns a never used object address, or NULL if all of them were handed out
             */
-            void deallocate ( void *object ) ;
+            ObjectHeader * carve ( void ) ;
+           /*! \brief Pushes 'object' to the remote free list (called from non-owner threads)
+            */
+            void deallocateRemote ( ObjectHeader *object ) ;
+           /*! \brief Detaches and returns the remote free list (called from the owner)
+            */
+            ObjectHeader * drainRemote ( void ) ;
            /*! \brief Returns next Arena object in the list
             */
             Arena * getNext ( void ) const;
@@ -158,14 +169,36 @@ class Allocator
          Arena     *_arena;
       };
 
+      /*! \brief Free objects and Arenas of a size class */
+      struct SizeClass {
+         ObjectHeader  *_free;      /**< Free list, linked through the first word after the header */
+         Arena         *_arenas;    /**< Arenas of this class, the first one is the one being carved */
+      };
+
+   public:
+      /*! \brief Allocator statistics, only updated by the owner thread */
+      struct Stats {
+         size_t _allocations;        /**< Objects allocated from the size classes */
+         size_t _deallocations;      /**< Objects freed by the owner */
+         size_t _remoteDeallocations;/**< Objects freed by other threads and reclaimed by the owner */
+         size_t _bigAllocations;     /**< Objects allocated directly with malloc */
+         size_t _arenas;             /**< Arenas created */
+         size_t _arenaBytes;         /**< Bytes reserved by those Arenas */
+
+         Stats () : _allocations(0), _deallocations(0), _remoteDeallocations(0), _bigAllocations(0), _arenas(0), _arenaBytes(0) {}
+
+         Stats & operator+= ( const Stats &s );
+      };
+
    private: /* Allocator data members */
-      typedef InternalCollection<Arena *>::type  ArenaCollection;
+      static const size_t           _minClass = 5;                 /**< log2 of the smallest object size (header and free list link) */
+      static const size_t           _maxClass = 20;                /**< log2 of the biggest object size served from Arenas */
+      static const size_t           _numClasses = _maxClass - _minClass + 1;
 
-      ArenaCollection               _arenas;      /**< Vector of Arenas in Allocator*/
+      SizeClass                     _classes[_numClasses];  /**< Size classes */
+      Stats                         _stats;       /**< Statistics */
       static size_t                 _headerSize;  /**< Size of ObjectHeader */
 
-      static const size_t                  _sizeOfBig = 1024*1024*10;
-
      /*! \brief Allocator copy constructor (disabled)
       */
       Allocator ( const Allocator &a );
@@ -177,20 +210,37 @@ class Allocator
      /*! \brief Alternative allocation method for big objects */
       void * allocateBigObject ( size_t size ); 
 
+     /*! \brief Free list link of a free object */
+      static ObjectHeader *& nextFree ( ObjectHeader *object );
+
+     /*! \brief Slow path: gets an object when the free list of a class is empty */
+      ObjectHeader * refill ( size_t sizeClass );
+
+     /*! \brief Returns 'object' to the free list of this (owner) Allocator */
+      void deallocateLocal ( ObjectHeader *object );
+
    public: /* Allocator method members */
     /*! \brief Allocator default constructor 
      */
-     Allocator ( ) : _arenas() {}
-    /*! \brief Allocator destructor 
+     Allocator ( ) : _stats()
+     {
+        for ( size_t i = 0; i < _numClasses; i++ ) {
+           _classes[i]._free = NULL;
+           _classes[i]._arenas = NULL;
+        }
+     }
+    /*! \brief Allocator destructor
+     *
+     *  Arenas are not freed, as objects allocated by this Allocator may
+     *  still be in use (and freed later) by other threads.
      */
      ~Allocator () { }
     /*! \brief Allocates 'size' bytes in memory and returns memory pointer
      *
-     *  This function will check in his list of Arenas looking for one who
-     *  stores objects of the given 'size'. If Allocator finds an Arena region
-     *  with this 'size' will ask to it for a new object. If none of the current
-     *  Arenas works with the given 'size' Allocator will create a new Arena entry
-     *  in order to manage this (and future) objects of the given 'size'.
+     *  The object is taken from the free list of the size class of 'size'.
+     *  If it is empty, it is taken from the Arena being carved, from the objects
+     *  freed by other threads or from a new Arena (in this order). Objects too
+     *  big for the size classes are allocated with malloc.
      */
      void * allocate ( size_t size, const char *file = NULL, int line = 0 ) ;
     /*! \brief Deallocates 'object' (object has a header which identifies related Arena
@@ -199,6 +249,12 @@ class Allocator
     /*! \brief Get 'object' size for a given pointer
      */
      static size_t getObjectSize ( void *object ) ;
+    /*! \brief Returns the statistics of this Allocator
+     */
+     const Stats & getStats ( void ) const;
+    /*! \brief Prints 'stats' in a human readable way
+     */
+     static void printStats ( std::ostream &o, const Stats &stats );
 };
 
 
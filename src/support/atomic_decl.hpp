@@ -106,6 +106,9 @@ namespace nanos {
 
    void memoryFence ();
 
+   //! \brief Hints the processor that the caller is busy-waiting
+   void cpuRelax ();
+
    template<typename T>
 #ifdef HAVE_NEW_GCC_ATOMIC_OPS
    bool compareAndSwap( T *ptr, T oldval, T  newval );
@@ -0,0 +1,145 @@
+/*************************************************************************************/
+/*      Copyright 2015 Barcelona Supercomputing Center                               */
+/*                                                                                   */
+/*      This file is part of the NANOS++ library.                                    */
+/*                                                                                   */
+/*      NANOS++ is free software: you can redistribute it and/or modify              */
+/*      it under the terms of the GNU Lesser General Public License as published by  */
+/*      the Free Software Foundation, either version 3 of the License, or            */
+/*      (at your option) any later version.                                          */
+/*                                                                                   */
+/*      NANOS++ is distributed in the hope that it will be useful,                   */
+/*      but WITHOUT ANY WARRANTY; without even the implied warranty of               */
+/*      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                */
+/*      GNU Lesser General Public License for more details.                          */
+/*                                                                                   */
+/*      You should have received a copy of the GNU Lesser General Public License     */
+/*      along with NANOS++.  If not, see <http://www.gnu.org/licenses/>.             */
+/*************************************************************************************/
+
+#include "bulkreducer_decl.hpp"
+#include "debug.hpp"
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#define NANOS_BULK_REDUCER_AVX2
+#endif
+
+// The combine loops must be vectorized whatever the optimization level of the library
+#if defined(__GNUC__) && !defined(__clang__) && !defined(__INTEL_COMPILER)
+#pragma GCC optimize ( "tree-vectorize", "vect-cost-model=dynamic" )
+#endif
+
+using namespace nanos;
+
+namespace {
+
+template <typename T> struct OpAdd  { static T apply ( T a, T b ) { return a + b; } };
+template <typename T> struct OpProd { static T apply ( T a, T b ) { return a * b; } };
+template <typename T> struct OpMin  { static T apply ( T a, T b ) { return a < b ? a : b; } };
+template <typename T> struct OpMax  { static T apply ( T a, T b ) { return a > b ? a : b; } };
+template <typename T> struct OpAnd  { static T apply ( T a, T b ) { return a & b; } };
+template <typename T> struct OpOr   { static T apply ( T a, T b ) { return a | b; } };
+template <typename T> struct OpXor  { static T apply ( T a, T b ) { return a ^ b; } };
+
+template <typename T, class O>
+void bulkReduce ( void *inout, const void *in, size_t n )
+{
+   T * __restrict__ s = ( T * ) inout;
+   const T * __restrict__ v = ( const T * ) in;
+   for ( size_t i = 0; i < n; i++ ) s[i] = O::apply( s[i], v[i] );
+}
+
+#ifdef NANOS_BULK_REDUCER_AVX2
+template <typename T, class O>
+__attribute__((target("avx2")))
+void bulkReduceAVX2 ( void *inout, const void *in, size_t n )
+{
+   T * __restrict__ s = ( T * ) inout;
+   const T * __restrict__ v = ( const T * ) in;
+   for ( size_t i = 0; i < n; i++ ) s[i] = O::apply( s[i], v[i] );
+}
+#define NANOS_BULK_LOOP(Type,Op) ( avx2 ? &bulkReduceAVX2<Type, Op<Type> > : &bulkReduce<Type, Op<Type> > )
+#else
+#define NANOS_BULK_LOOP(Type,Op) ( &bulkReduce<Type, Op<Type> > )
+#endif
+
+template <typename T>
+bulk_reducer_t arithmeticLoop ( BulkReducer::Op op, bool avx2 )
+{
+   switch ( op ) {
+      case BulkReducer::ADD:  return NANOS_BULK_LOOP( T, OpAdd );
+      case BulkReducer::PROD: return NANOS_BULK_LOOP( T, OpProd );
+      case BulkReducer::MIN:  return NANOS_BULK_LOOP( T, OpMin );
+      case BulkReducer::MAX:  return NANOS_BULK_LOOP( T, OpMax );
+      default:                return NULL;
+   }
+}
+
+template <typename T>
+bulk_reducer_t integerLoop ( BulkReducer::Op op, bool avx2 )
+{
+   switch ( op ) {
+      case BulkReducer::AND:  return NANOS_BULK_LOOP( T, OpAnd );
+      case BulkReducer::OR:   return NANOS_BULK_LOOP( T, OpOr );
+      case BulkReducer::XOR:  return NANOS_BULK_LOOP( T, OpXor );
+      default:                return arithmeticLoop<T>( op, avx2 );
+   }
+}
+
+bool cpuHasAVX2 ( void )
+{
+#ifdef NANOS_BULK_REDUCER_AVX2
+   // May run from a static constructor, before the compiler runtime has probed the CPU
+   __builtin_cpu_init();
+   return __builtin_cpu_supports( "avx2" );
+#else
+   return false;
+#endif
+}
+
+} // namespace
+
+BulkReducer::Entry BulkReducer::_entries[BulkReducer::MAX_ENTRIES];
+size_t BulkReducer::_numEntries = 0;
+
+bool BulkReducer::usesAVX2 ( void )
+{
+   static bool avx2 = cpuHasAVX2();
+   return avx2;
+}
+
+bulk_reducer_t BulkReducer::get ( Op op, Type type )
+{
+   bool avx2 = usesAVX2();
+
+   switch ( type ) {
+      case INT:       return integerLoop<int>( op, avx2 );
+      case UINT:      return integerLoop<unsigned int>( op, avx2 );
+      case LONG:      return integerLoop<long>( op, avx2 );
+      case ULONG:     return integerLoop<unsigned long>( op, avx2 );
+      case LONGLONG:  return integerLoop<long long>( op, avx2 );
+      case ULONGLONG: return integerLoop<unsigned long long>( op, avx2 );
+      case FLOAT:     return arithmeticLoop<float>( op, avx2 );
+      case DOUBLE:    return arithmeticLoop<double>( op, avx2 );
+      default:        return NULL;
+   }
+}
+
+void BulkReducer::registerReducer ( const void *reducer, Op op, Type type )
+{
+   bulk_reducer_t bulk = get( op, type );
+   if ( bulk == NULL || find( reducer ) != NULL ) return;
+
+   fatal_cond0( _numEntries == MAX_ENTRIES, "Too many built-in reducers registered" );
+   _entries[_numEntries]._reducer = reducer;
+   _entries[_numEntries]._bulk = bulk;
+   _numEntries++;
+}
+
+bulk_reducer_t BulkReducer::find ( const void *reducer )
+{
+   for ( size_t i = 0; i < _numEntries; i++ ) {
+      if ( _entries[i]._reducer == reducer ) return _entries[i]._bulk;
+   }
+   return NULL;
+}
@@ -0,0 +1,77 @@
+/*************************************************************************************/
+/*      Copyright 2015 Barcelona Supercomputing Center                               */
+/*                                                                                   */
+/*      This file is part of the NANOS++ library.                                    */
+/*                                                                                   */
+/*      NANOS++ is free software: you can redistribute it and/or modify              */
+/*      it under the terms of the GNU Lesser General Public License as published by  */
+/*      the Free Software Foundation, either version 3 of the License, or            */
+/*      (at your option) any later version.                                          */
+/*                                                                                   */
+/*      NANOS++ is distributed in the hope that it will be useful,                   */
+/*      but WITHOUT ANY WARRANTY; without even the implied warranty of               */
+/*      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                */
+/*      GNU Lesser General Public License for more details.                          */
+/*                                                                                   */
+/*      You should have received a copy of the GNU Lesser General Public License     */
+/*      along with NANOS++.  If not, see <http://www.gnu.org/licenses/>.             */
+/*************************************************************************************/
+
+#ifndef _NANOS_BULK_REDUCER_DECL
+#define _NANOS_BULK_REDUCER_DECL
+
+#include <stddef.h>
+
+namespace nanos {
+
+   /*! \brief Element-wise combine of two contiguous arrays: inout[i] = inout[i] op in[i], 0 <= i < n */
+   typedef void ( *bulk_reducer_t ) ( void *inout, const void *in, size_t n );
+
+   /*! \brief Vectorized combine loops of the built-in reduction operators
+    *
+    *  Every (operator, type) pair has a loop compiled for the baseline instruction set and, on
+    *  x86-64, another one compiled for AVX2. The AVX2 loops are used when the CPU supports them.
+    *
+    *  Reduction code only receives function pointers, so the built-in scalar reducers (see
+    *  nanos_reduction.h) register themselves here: a reduction whose reducer is a built-in one
+    *  can combine whole private copies with a single bulk call instead of a call per element.
+    */
+   class BulkReducer
+   {
+      public:
+         enum Op { ADD, PROD, MIN, MAX, AND, OR, XOR, NUM_OPS };
+         enum Type { INT, UINT, LONG, ULONG, LONGLONG, ULONGLONG, FLOAT, DOUBLE, NUM_TYPES };
+
+      private:
+         struct Entry {
+            const void       *_reducer;
+            bulk_reducer_t    _bulk;
+         };
+
+         enum { MAX_ENTRIES = 256 };
+
+         static Entry   _entries[MAX_ENTRIES];
+         static size_t  _numEntries;
+
+         BulkReducer ();
+
+      public:
+         /*! \brief Returns the combine loop of 'op' over 'type' (NULL for bitwise operators over reals) */
+         static bulk_reducer_t get ( Op op, Type type );
+
+         /*! \brief Associates a reducer function with the bulk loop of 'op' over 'type'
+          *
+          *  Meant to be called while libraries are loaded (before threads are started).
+          */
+         static void registerReducer ( const void *reducer, Op op, Type type );
+
+         /*! \brief Returns the bulk loop associated with 'reducer', or NULL if it is not a built-in one */
+         static bulk_reducer_t find ( const void *reducer );
+
+         /*! \brief Whether the AVX2 loops are in use */
+         static bool usesAVX2 ( void );
+   };
+
+} // namespace nanos
+
+#endif
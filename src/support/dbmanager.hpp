@@ -82,6 +82,44 @@ public:
     */
    virtual int getIntColumnValue(const unsigned int stmtNumber, const unsigned int columnIndex) { fatal0("DbManager: getIntColumnValue not implemented") };
 
+   /**
+    * @brief This function bind a double value to a prepared statement
+    * @param stmtNumber Parameter to reference the prepared statement
+    * @param parameterIndex Parameter to choose the parameter to reference
+    * @param value value to be set on the parameter
+    */
+   virtual void bindDoubleParameter(const unsigned int stmtNumber, const unsigned int parameterIndex, double value) { fatal0("DbManager: bindDoubleParameter not implemented") };
+
+   /**
+    * @brief This function bind a text value to a prepared statement
+    * @param stmtNumber Parameter to reference the prepared statement
+    * @param parameterIndex Parameter to choose the parameter to reference
+    * @param value value to be set on the parameter (copied by the database)
+    */
+   virtual void bindTextParameter(const unsigned int stmtNumber, const unsigned int parameterIndex, const std::string &value) { fatal0("DbManager: bindTextParameter not implemented") };
+
+   /**
+    * @brief This function return the double value of a given column
+    * @param stmtNumber stmtNumber Parameter to reference the prepared statement
+    * @param columnIndex Parameter to choose the column to reference
+    * @return The value of a given column
+    */
+   virtual double getDoubleColumnValue(const unsigned int stmtNumber, const unsigned int columnIndex) { fatal0("DbManager: getDoubleColumnValue not implemented") };
+
+   /**
+    * @brief This function return the text value of a given column
+    * @param stmtNumber stmtNumber Parameter to reference the prepared statement
+    * @param columnIndex Parameter to choose the column to reference
+    * @return The value of a given column
+    */
+   virtual std::string getTextColumnValue(const unsigned int stmtNumber, const unsigned int columnIndex) { fatal0("DbManager: getTextColumnValue not implemented") };
+
+   /**
+    * @brief Resets a prepared statement, so that it can be stepped again from its first row
+    * @param stmtNumber stmtNumber Parameter to reference the prepared statement
+    */
+   virtual void resetStmt(const unsigned int stmtNumber) { fatal0("DbManager: resetStmt not implemented") };
+
    /**
     * @brief This function makes to ask for a row with the according statement
     * @param stmtNumber stmtNumber Parameter to reference the prepared statement
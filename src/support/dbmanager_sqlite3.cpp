@@ -97,6 +97,34 @@ int SQLite3DbManager::getIntColumnValue(const unsigned int stmtNumber, const uns
    return sqlite3_column_int(_stmtVector[stmtNumber], columnIndex);
 }
 
+void SQLite3DbManager::bindDoubleParameter(const unsigned int stmtNumber, const unsigned int parameterIndex, double value)
+{
+   sqlCheck(sqlite3_bind_double(_stmtVector[stmtNumber], parameterIndex, value), "SQLite - Can't bind double value: ");
+}
+
+void SQLite3DbManager::bindTextParameter(const unsigned int stmtNumber, const unsigned int parameterIndex, const std::string &value)
+{
+   sqlCheck(sqlite3_bind_text(_stmtVector[stmtNumber], parameterIndex, value.c_str(), -1, SQLITE_TRANSIENT), "SQLite - Can't bind text value: ");
+}
+
+double SQLite3DbManager::getDoubleColumnValue(const unsigned int stmtNumber, const unsigned int columnIndex)
+{
+   return sqlite3_column_double(_stmtVector[stmtNumber], columnIndex);
+}
+
+std::string SQLite3DbManager::getTextColumnValue(const unsigned int stmtNumber, const unsigned int columnIndex)
+{
+   const unsigned char *text = sqlite3_column_text(_stmtVector[stmtNumber], columnIndex);
+   return text != NULL ? std::string( ( const char * ) text ) : std::string();
+}
+
+void SQLite3DbManager::resetStmt(const unsigned int stmtNumber)
+{
+   // The error code of sqlite3_reset() is the one of the last step, already reported by doStep()
+   sqlite3_reset(_stmtVector[stmtNumber]);
+   sqlite3_clear_bindings(_stmtVector[stmtNumber]);
+}
+
 bool SQLite3DbManager::doStep(const unsigned int stmtNumber)
 {
    const int err = sqlite3_step(_stmtVector[stmtNumber]);
@@ -85,6 +85,44 @@ public:
     */
    int getIntColumnValue(const unsigned int stmtNumber, const unsigned int columnIndex);
 
+   /**
+    * @brief This function bind a double value to a prepared statement
+    * @param stmtNumber Parameter to reference the prepared statement
+    * @param parameterIndex Parameter to choose the parameter to reference
+    * @param value value to be set on the parameter
+    */
+   void bindDoubleParameter(const unsigned int stmtNumber, const unsigned int parameterIndex, double value);
+
+   /**
+    * @brief This function bind a text value to a prepared statement
+    * @param stmtNumber Parameter to reference the prepared statement
+    * @param parameterIndex Parameter to choose the parameter to reference
+    * @param value value to be set on the parameter (copied by the database)
+    */
+   void bindTextParameter(const unsigned int stmtNumber, const unsigned int parameterIndex, const std::string &value);
+
+   /**
+    * @brief This function return the double value of a given column
+    * @param stmtNumber stmtNumber Parameter to reference the prepared statement
+    * @param columnIndex Parameter to choose the column to reference
+    * @return The value of a given column
+    */
+   double getDoubleColumnValue(const unsigned int stmtNumber, const unsigned int columnIndex);
+
+   /**
+    * @brief This function return the text value of a given column
+    * @param stmtNumber stmtNumber Parameter to reference the prepared statement
+    * @param columnIndex Parameter to choose the column to reference
+    * @return The value of a given column
+    */
+   std::string getTextColumnValue(const unsigned int stmtNumber, const unsigned int columnIndex);
+
+   /**
+    * @brief Resets a prepared statement, so that it can be stepped again from its first row
+    * @param stmtNumber stmtNumber Parameter to reference the prepared statement
+    */
+   void resetStmt(const unsigned int stmtNumber);
+
    /**
     * @brief This function makes to ask for a row with the according statement
     * @param stmtNumber stmtNumber Parameter to reference the prepared statement
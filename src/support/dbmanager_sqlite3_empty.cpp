@@ -76,6 +76,33 @@ int SQLite3DbManager::getIntColumnValue(const unsigned int stmtNumber, const uns
    fatal0("SQLite3DbManager: empty class compiled")
 }
 
+void SQLite3DbManager::bindDoubleParameter(const unsigned int stmtNumber, const unsigned int parameterIndex, double value)
+{
+   fatal0("SQLite3DbManager: empty class compiled")
+}
+
+void SQLite3DbManager::bindTextParameter(const unsigned int stmtNumber, const unsigned int parameterIndex, const std::string &value)
+{
+   fatal0("SQLite3DbManager: empty class compiled")
+}
+
+double SQLite3DbManager::getDoubleColumnValue(const unsigned int stmtNumber, const unsigned int columnIndex)
+{
+   fatal0("SQLite3DbManager: empty class compiled")
+   return 0.0;
+}
+
+std::string SQLite3DbManager::getTextColumnValue(const unsigned int stmtNumber, const unsigned int columnIndex)
+{
+   fatal0("SQLite3DbManager: empty class compiled")
+   return std::string();
+}
+
+void SQLite3DbManager::resetStmt(const unsigned int stmtNumber)
+{
+   fatal0("SQLite3DbManager: empty class compiled")
+}
+
 bool SQLite3DbManager::doStep(const unsigned int stmtNumber)
 {
    fatal0("SQLite3DbManager: empty class compiled")
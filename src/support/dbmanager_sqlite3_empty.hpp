@@ -34,6 +34,11 @@ public:
    void bindIntParameter(const unsigned int stmtNumber, const unsigned int parameterIndex, int value);
    void bindInt64Parameter(const unsigned int stmtNumber, const unsigned int parameterIndex, long long int value);
    int getIntColumnValue(const unsigned int stmtNumber, const unsigned int columnIndex);
+   void bindDoubleParameter(const unsigned int stmtNumber, const unsigned int parameterIndex, double value);
+   void bindTextParameter(const unsigned int stmtNumber, const unsigned int parameterIndex, const std::string &value);
+   double getDoubleColumnValue(const unsigned int stmtNumber, const unsigned int columnIndex);
+   std::string getTextColumnValue(const unsigned int stmtNumber, const unsigned int columnIndex);
+   void resetStmt(const unsigned int stmtNumber);
    bool doStep(const unsigned int stmtNumber);
 private:
    void sqlCheck(const int err, const std::string &msg);
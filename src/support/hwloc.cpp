@@ -150,6 +150,49 @@ void Hwloc::getNumSockets(unsigned int &allowedNodes, int &numSockets, unsigned
 #endif
 }
 
+void Hwloc::getTopologyFanIns( std::vector<unsigned int> &fanIns )
+{
+   fanIns.clear();
+#ifdef HWLOC
+   // Topologies are symmetric enough: climb from the first PU to the root
+   hwloc_obj_t obj = hwloc_get_obj_by_type( _hwlocTopology, HWLOC_OBJ_PU, 0 );
+   if ( obj == NULL ) return;
+
+   for ( obj = obj->parent; obj != NULL; obj = obj->parent ) {
+      if ( obj->arity > 1 ) fanIns.push_back( obj->arity );
+   }
+#endif
+}
+
+void Hwloc::getCpuLocation( unsigned int cpu, unsigned int &core, unsigned int &cache, unsigned int &socket )
+{
+   core = cpu;
+   cache = 0;
+   socket = 0;
+#ifdef HWLOC
+   hwloc_obj_t pu = hwloc_get_pu_obj_by_os_index( _hwlocTopology, cpu );
+   if ( pu == NULL ) return;
+
+   hwloc_obj_t obj = hwloc_get_ancestor_obj_by_type( _hwlocTopology, HWLOC_OBJ_CORE, pu );
+   if ( obj != NULL ) core = obj->logical_index;
+
+   obj = hwloc_get_ancestor_obj_by_type( _hwlocTopology, HWLOC_OBJ_SOCKET, pu );
+   if ( obj != NULL ) socket = obj->logical_index;
+   cache = socket;
+
+   for ( obj = pu->parent; obj != NULL; obj = obj->parent ) {
+#if HWLOC_API_VERSION >= 0x00020000
+      if ( obj->type == HWLOC_OBJ_L3CACHE ) {
+#else
+      if ( obj->type == HWLOC_OBJ_CACHE && obj->attr->cache.depth == 3 ) {
+#endif
+         cache = obj->logical_index;
+         break;
+      }
+   }
+#endif
+}
+
 unsigned int Hwloc::getNumaNodeOfGpu( unsigned int gpu ) {
    unsigned int node = 0;
 #ifdef GPU_DEV
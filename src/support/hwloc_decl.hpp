@@ -23,6 +23,7 @@
 
 #include <config.hpp>
 #include <string>
+#include <vector>
 
 #ifdef HWLOC
 #include <hwloc.h>
@@ -52,6 +53,29 @@ class Hwloc {
       unsigned int getNumaNodeOfGpu( unsigned int gpu );
       void getNumSockets(unsigned int &allowedNodes, int &numSockets, unsigned int &hwThreads);
 
+      /*!
+       * \brief Returns the fan-in of each topology level, from the
+       * hardware threads of a core up to the whole machine.
+       *
+       * Levels with a single child (e.g. a private L2 per core) are
+       * skipped, so the first entry is the number of siblings of a core
+       * (or of a shared cache) and the last one the number of sockets.
+       * If hwloc is not available, the list is left empty.
+       */
+      void getTopologyFanIns( std::vector<unsigned int> &fanIns );
+
+      /*!
+       * \brief Returns the logical indexes of the core, last level cache
+       * and socket of a CPU.
+       *
+       * If hwloc is not available (or does not know the CPU), the core is
+       * the OS CPU index and every CPU shares cache and socket 0. If the
+       * socket has no shared cache, the cache index is the socket one.
+       *
+       * @param cpu OS CPU index.
+       */
+      void getCpuLocation( unsigned int cpu, unsigned int &core, unsigned int &cache, unsigned int &socket );
+
       /*!
        * \brief Checks if we can see the CPU, to create the PE.
        * If hwloc has no info on that CPU, we should not continue creating
@@ -0,0 +1,50 @@
+/*************************************************************************************/
+/*      Copyright 2009 Barcelona Supercomputing Center                               */
+/*                                                                                   */
+/*      This file is part of the NANOS++ library.                                    */
+/*                                                                                   */
+/*      NANOS++ is free software: you can redistribute it and/or modify              */
+/*      it under the terms of the GNU Lesser General Public License as published by  */
+/*      the Free Software Foundation, either version 3 of the License, or            */
+/*      (at your option) any later version.                                          */
+/*                                                                                   */
+/*      NANOS++ is distributed in the hope that it will be useful,                   */
+/*      but WITHOUT ANY WARRANTY; without even the implied warranty of               */
+/*      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                */
+/*      GNU Lesser General Public License for more details.                          */
+/*                                                                                   */
+/*      You should have received a copy of the GNU Lesser General Public License     */
+/*      along with NANOS++.  If not, see <http://www.gnu.org/licenses/>.             */
+/*************************************************************************************/
+
+#include "atomic.hpp"
+#include "lock.hpp"
+#include "os.hpp"
+
+using namespace nanos;
+
+//! Backoff rounds before parking; round n spins 2^n pause instructions
+#define NANOS_LOCK_SPIN_ROUNDS 10
+
+void Lock::acquireContended ()
+{
+   // Short critical sections are released before a context switch pays off
+   for ( unsigned int round = 0; round < NANOS_LOCK_SPIN_ROUNDS; round++ ) {
+      for ( unsigned int i = 0; i < ( 1U << round ); i++ ) cpuRelax();
+      if ( tryAcquire() ) return;
+   }
+
+   // Take the lock as contended so that our release wakes up whoever parked after us
+#ifdef HAVE_NEW_GCC_ATOMIC_OPS
+   while ( __atomic_exchange_n( &state_, NANOS_LOCK_CONTENDED, __ATOMIC_ACQUIRE ) != NANOS_LOCK_FREE ) {
+#else
+   while ( __sync_lock_test_and_set( &state_, NANOS_LOCK_CONTENDED ) != NANOS_LOCK_FREE ) {
+#endif
+      OS::futexWait( (volatile int *) &state_, NANOS_LOCK_CONTENDED );
+   }
+}
+
+void Lock::wakeWaiter ()
+{
+   OS::futexWake( (volatile int *) &state_, 1 );
+}
@@ -51,20 +51,10 @@ inline void Lock::operator-- ( int val )
 
 inline void Lock::acquire ( void )
 {
-#ifdef HAVE_NEW_GCC_ATOMIC_OPS
-   acquire_noinst();
-#else
-   if ( (state_ == NANOS_LOCK_FREE) &&  !__sync_lock_test_and_set( &state_,NANOS_LOCK_BUSY ) ) return;
-
    // Disabling lock instrumentation; do not remove follow code which can be reenabled for testing purposes
    // NANOS_INSTRUMENT( InstrumentState inst(NANOS_ACQUIRING_LOCK) )
-spin:
-   while ( state_ == NANOS_LOCK_BUSY ) {}
-
-   if ( __sync_lock_test_and_set( &state_,NANOS_LOCK_BUSY ) ) goto spin;
-
+   acquire_noinst();
    // NANOS_INSTRUMENT( inst.close() )
-#endif
 }
 
 inline void Lock::lock()
@@ -75,12 +65,12 @@ inline void Lock::lock()
 inline void Lock::acquire_noinst ( void )
 {
 #ifdef HAVE_NEW_GCC_ATOMIC_OPS
-   while (__atomic_exchange_n( &state_, NANOS_LOCK_BUSY, __ATOMIC_ACQ_REL) == NANOS_LOCK_BUSY ) { }
+   state_t expected = NANOS_LOCK_FREE;
+   if ( __atomic_compare_exchange_n( &state_, &expected, NANOS_LOCK_BUSY, false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED ) ) return;
 #else
-spin:
-   while ( state_ == NANOS_LOCK_BUSY ) {}
-   if ( __sync_lock_test_and_set( &state_,NANOS_LOCK_BUSY ) ) goto spin;
+   if ( __sync_bool_compare_and_swap( &state_, NANOS_LOCK_FREE, NANOS_LOCK_BUSY ) ) return;
 #endif
+   acquireContended();
 }
 
 inline bool Lock::tryAcquire ( void )
@@ -88,10 +78,8 @@ inline bool Lock::tryAcquire ( void )
 #ifdef HAVE_NEW_GCC_ATOMIC_OPS
    if (__atomic_load_n(&state_, __ATOMIC_ACQUIRE) == NANOS_LOCK_FREE)
    {
-      if (__atomic_exchange_n(&state_, NANOS_LOCK_BUSY, __ATOMIC_ACQ_REL) == NANOS_LOCK_BUSY)
-         return false;
-      else // will return NANOS_LOCK_FREE
-         return true;
+      state_t expected = NANOS_LOCK_FREE;
+      return __atomic_compare_exchange_n( &state_, &expected, NANOS_LOCK_BUSY, false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED );
    }
    else
    {
@@ -99,8 +87,7 @@ inline bool Lock::tryAcquire ( void )
    }
 #else
    if ( state_ == NANOS_LOCK_FREE ) {
-      if ( __sync_lock_test_and_set( &state_,NANOS_LOCK_BUSY ) ) return false;
-      else return true;
+      return __sync_bool_compare_and_swap( &state_, NANOS_LOCK_FREE, NANOS_LOCK_BUSY );
    } else return false;
 #endif
 }
@@ -113,9 +100,10 @@ inline bool Lock::try_lock()
 inline void Lock::release ( void )
 {
 #ifdef HAVE_NEW_GCC_ATOMIC_OPS
-   __atomic_store_n(&state_, 0, __ATOMIC_RELEASE);
+   if ( __atomic_exchange_n( &state_, NANOS_LOCK_FREE, __ATOMIC_RELEASE ) == NANOS_LOCK_CONTENDED ) wakeWaiter();
 #else
-   __sync_lock_release( &state_ );
+   __sync_synchronize();
+   if ( __sync_lock_test_and_set( &state_, NANOS_LOCK_FREE ) == NANOS_LOCK_CONTENDED ) wakeWaiter();
 #endif
 }
 
@@ -24,6 +24,13 @@
 
 namespace nanos {
 
+   /*! \brief Adaptive mutual exclusion lock
+    *
+    *  Uncontended operations are a single atomic instruction. A contended acquire spins with
+    *  exponential backoff for a while and then parks the thread on a futex, marking the lock
+    *  as NANOS_LOCK_CONTENDED so that the holder wakes it up on release. The object keeps
+    *  the size of nanos_lock_t.
+    */
    class Lock : public nanos_lock_t
    {
       private:
@@ -33,6 +40,12 @@ namespace nanos {
          Lock( const Lock &lock );
          const Lock & operator= ( const Lock& );
 
+         //! \brief Slow path of acquire: spin with backoff, then park
+         void acquireContended();
+
+         //! \brief Wakes up one of the threads parked on the lock
+         void wakeWaiter();
+
       public:
          // constructor
          Lock( state_t init=NANOS_LOCK_FREE ) : nanos_lock_t( init ) {};
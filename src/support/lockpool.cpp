@@ -0,0 +1,153 @@
+/*************************************************************************************/
+/*      Copyright 2015 Barcelona Supercomputing Center                               */
+/*                                                                                   */
+/*      This file is part of the NANOS++ library.                                    */
+/*                                                                                   */
+/*      NANOS++ is free software: you can redistribute it and/or modify              */
+/*      it under the terms of the GNU Lesser General Public License as published by  */
+/*      the Free Software Foundation, either version 3 of the License, or            */
+/*      (at your option) any later version.                                          */
+/*                                                                                   */
+/*      NANOS++ is distributed in the hope that it will be useful,                   */
+/*      but WITHOUT ANY WARRANTY; without even the implied warranty of               */
+/*      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                */
+/*      GNU Lesser General Public License for more details.                          */
+/*                                                                                   */
+/*      You should have received a copy of the GNU Lesser General Public License     */
+/*      along with NANOS++.  If not, see <http://www.gnu.org/licenses/>.             */
+/*************************************************************************************/
+
+#include <stdlib.h>
+#include <new>
+#include "lockpool.hpp"
+#include "debug.hpp"
+
+using namespace nanos;
+
+LockPool::LockPool ( size_t size, bool grow, size_t maxEntries )
+   : _grow( grow ), _mask( 0 ), _slots( NULL ), _table( NULL ), _retired(), _numEntries( 0 ), _maxEntries( maxEntries ),
+     _full( false ), _overflows( 0 ), _chained( 0 ), _insertLock(), _collisions( 0 )
+{
+   size_t capacity = 2;
+   while ( capacity < size ) capacity <<= 1;
+
+   if ( _grow ) _table = newTable( capacity );
+
+   void *mem = NULL;
+   fatal_cond( posix_memalign( &mem, NANOS_CACHELINE, capacity * sizeof( Slot ) ) != 0, "Cannot allocate the lock pool" );
+   _slots = (Slot *) mem;
+   for ( size_t i = 0; i < capacity; i++ ) new ( &_slots[i] ) Slot();
+   _mask = capacity - 1;
+}
+
+LockPool::~LockPool ()
+{
+   if ( _grow ) {
+      // Every entry is linked from the current table
+      Table *table = _table.value();
+      for ( size_t i = 0; i <= table->_mask; i++ ) {
+         Entry *entry = table->_buckets[i].value();
+         while ( entry != NULL ) {
+            Entry *next = entry->_next;
+            free( entry );
+            entry = next;
+         }
+      }
+      _retired.push_back( table );
+      for ( TableList::iterator it = _retired.begin(); it != _retired.end(); it++ ) {
+         delete[] (*it)->_buckets;
+         delete *it;
+      }
+   }
+   free( _slots );
+}
+
+LockPool::Table * LockPool::newTable ( size_t size )
+{
+   Table *table = NEW Table;
+   table->_mask = size - 1;
+   table->_buckets = NEW Atomic<Entry *>[size];
+   for ( size_t i = 0; i < size; i++ ) table->_buckets[i] = NULL;
+   return table;
+}
+
+Lock * LockPool::insert ( void *addr )
+{
+   LockBlock lock( _insertLock );
+
+   // The lock-free lookup may have raced with an insertion or a grow
+   Table *table = _table.value();
+   Atomic<Entry *> &bucket = table->_buckets[ hash( addr ) & table->_mask ];
+   for ( Entry *entry = bucket.value(); entry != NULL; entry = entry->_next ) {
+      if ( entry->_addr == addr ) return &entry->_lock;
+   }
+
+   // Someone else filled the table after our lookup
+   if ( _full ) {
+      _overflows++;
+      return getSlotLock( addr );
+   }
+
+   // First touch from the requesting thread places the lock close to its users
+   void *mem = NULL;
+   fatal_cond( posix_memalign( &mem, NANOS_CACHELINE, sizeof( Entry ) ) != 0, "Cannot allocate a lock pool entry" );
+   Entry *entry = new ( mem ) Entry( addr );
+   entry->_next = bucket.value();
+   if ( entry->_next != NULL ) {
+      _collisions++;
+      _chained++;
+   }
+   bucket = entry;
+   _numEntries++;
+
+   // Collisions, not the load factor, decide: addresses that hash badly grow the table sooner
+   if ( _chained > ( table->_mask + 1 ) / 2 ) grow( table );
+
+   // The entry must be visible before the table is seen as full
+   if ( _numEntries >= _maxEntries ) {
+      memoryFence();
+      _full = true;
+   }
+
+   return &entry->_lock;
+}
+
+void LockPool::grow ( Table *old )
+{
+   Table *table = newTable( 2 * ( old->_mask + 1 ) );
+   _chained = 0;
+
+   // Relinking entries may divert concurrent lookups of the old table to a wrong chain. They
+   // will not find their address there and retry in insert(), which waits for us to finish.
+   for ( size_t i = 0; i <= old->_mask; i++ ) {
+      Entry *entry = old->_buckets[i].value();
+      while ( entry != NULL ) {
+         Entry *next = entry->_next;
+         Atomic<Entry *> &bucket = table->_buckets[ hash( entry->_addr ) & table->_mask ];
+         entry->_next = bucket.value();
+         if ( entry->_next != NULL ) _chained++;
+         bucket = entry;
+         entry = next;
+      }
+   }
+
+   // Lookups may still be walking the old table: keep it until the pool is destroyed
+   _retired.push_back( old );
+   _table = table;
+}
+
+void LockPool::printStats ( std::ostream &o ) const
+{
+   if ( _grow ) {
+      o << "=== Lock pool: " << _numEntries << " addresses in " << ( _table.value()->_mask + 1 ) << " buckets, "
+        << _collisions.value() << " collisions";
+      if ( _full ) o << ", limit reached (" << _overflows.value() << " lookups used the " << ( _mask + 1 ) << " shared locks)";
+      o << std::endl;
+   } else {
+      o << "=== Lock pool: " << ( _mask + 1 ) << " locks";
+#ifdef NANOS_DEBUG_ENABLED
+      o << ", " << _collisions.value() << " lookups shared a lock with another address";
+#endif
+      o << std::endl;
+   }
+}
@@ -0,0 +1,74 @@
+/*************************************************************************************/
+/*      Copyright 2015 Barcelona Supercomputing Center                               */
+/*                                                                                   */
+/*      This file is part of the NANOS++ library.                                    */
+/*                                                                                   */
+/*      NANOS++ is free software: you can redistribute it and/or modify              */
+/*      it under the terms of the GNU Lesser General Public License as published by  */
+/*      the Free Software Foundation, either version 3 of the License, or            */
+/*      (at your option) any later version.                                          */
+/*                                                                                   */
+/*      NANOS++ is distributed in the hope that it will be useful,                   */
+/*      but WITHOUT ANY WARRANTY; without even the implied warranty of               */
+/*      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                */
+/*      GNU Lesser General Public License for more details.                          */
+/*                                                                                   */
+/*      You should have received a copy of the GNU Lesser General Public License     */
+/*      along with NANOS++.  If not, see <http://www.gnu.org/licenses/>.             */
+/*************************************************************************************/
+
+#ifndef _NANOS_LOCK_POOL
+#define _NANOS_LOCK_POOL
+
+#include "lockpool_decl.hpp"
+#include "lock.hpp"
+#include "atomic.hpp"
+
+namespace nanos {
+
+inline size_t LockPool::hash ( void *addr )
+{
+   uintptr_t h = ( (uintptr_t) addr ) >> 3;
+   h ^= h >> 16;
+   h *= 0x45d9f3b;
+   h ^= h >> 16;
+   return (size_t) h;
+}
+
+inline Lock * LockPool::getSlotLock ( void *addr )
+{
+   Slot &slot = _slots[ hash( addr ) & _mask ];
+#ifdef NANOS_DEBUG_ENABLED
+   // Racy on purpose, it is only used for statistics. It writes to shared lines, so only in debug
+   if ( !_grow && slot._lastAddr != addr ) {
+      if ( slot._lastAddr != NULL ) _collisions++;
+      slot._lastAddr = addr;
+   }
+#endif
+   return &slot._lock;
+}
+
+inline Lock * LockPool::getLock ( void *addr )
+{
+   if ( !_grow ) return getSlotLock( addr );
+
+   // Read before the table: if it was already full, an address not found in it will never be
+   bool full = _full;
+   memoryFence();
+
+   Table *table = _table.value();
+   for ( Entry *entry = table->_buckets[ hash( addr ) & table->_mask ].value(); entry != NULL; entry = entry->_next ) {
+      if ( entry->_addr == addr ) return &entry->_lock;
+   }
+
+   if ( full ) {
+      _overflows++;
+      return getSlotLock( addr );
+   }
+
+   return insert( addr );
+}
+
+} // namespace nanos
+
+#endif
@@ -0,0 +1,127 @@
+/*************************************************************************************/
+/*      Copyright 2015 Barcelona Supercomputing Center                               */
+/*                                                                                   */
+/*      This file is part of the NANOS++ library.                                    */
+/*                                                                                   */
+/*      NANOS++ is free software: you can redistribute it and/or modify              */
+/*      it under the terms of the GNU Lesser General Public License as published by  */
+/*      the Free Software Foundation, either version 3 of the License, or            */
+/*      (at your option) any later version.                                          */
+/*                                                                                   */
+/*      NANOS++ is distributed in the hope that it will be useful,                   */
+/*      but WITHOUT ANY WARRANTY; without even the implied warranty of               */
+/*      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                */
+/*      GNU Lesser General Public License for more details.                          */
+/*                                                                                   */
+/*      You should have received a copy of the GNU Lesser General Public License     */
+/*      along with NANOS++.  If not, see <http://www.gnu.org/licenses/>.             */
+/*************************************************************************************/
+
+#ifndef _NANOS_LOCK_POOL_DECL
+#define _NANOS_LOCK_POOL_DECL
+
+#include <stdint.h>
+#include <ostream>
+#include <vector>
+#include "lock_decl.hpp"
+#include "atomic_decl.hpp"
+#include "allocator_decl.hpp"
+
+namespace nanos {
+
+   /*! \brief Pool of locks protecting arbitrary addresses (see nanos_get_lock_address)
+    *
+    *  By default the pool is a fixed array of cache line sized locks indexed by a hash of the
+    *  address, so unrelated addresses may share a lock (debug builds count how often that
+    *  happens). In growing mode every address gets a lock of its own, allocated by the first
+    *  thread that asks for it and kept in a hash table that doubles its buckets when too many
+    *  insertions collide in a bucket. Entries are never freed, so their number is bounded:
+    *  once the limit is reached the table is frozen and the addresses not in it share the
+    *  slots of a fixed array, as in the default mode. A lock never moves once it has been
+    *  handed out, so an address always maps to the same lock.
+    */
+   class LockPool
+   {
+      private:
+         //! \brief Fixed pool slot, alone in its cache line
+         struct Slot {
+#ifdef NANOS_DEBUG_ENABLED
+            void * volatile   _lastAddr; /**< Last address that used the slot, to count collisions */
+            Lock              _lock;
+            char              _pad[NANOS_CACHELINE - sizeof(void *) - sizeof(Lock)];
+
+            Slot () : _lastAddr( NULL ), _lock() {}
+#else
+            Lock              _lock;
+            char              _pad[NANOS_CACHELINE - sizeof(Lock)];
+
+            Slot () : _lock() {}
+#endif
+         };
+
+         //! \brief Lock of a single address (growing mode), alone in its cache line
+         struct Entry {
+            void             *_addr;
+            Entry * volatile  _next;
+            Lock              _lock;
+            char              _pad[NANOS_CACHELINE - 2 * sizeof(void *) - sizeof(Lock)];
+
+            Entry ( void *addr ) : _addr( addr ), _next( NULL ), _lock() {}
+         };
+
+         struct Table {
+            size_t            _mask;
+            Atomic<Entry *>  *_buckets;
+         };
+
+         typedef std::vector<Table *> TableList;
+
+         bool                 _grow;        /**< Growing mode */
+         size_t               _mask;        /**< Number of slots - 1 */
+         Slot                *_slots;       /**< Slot array (growing mode: for the addresses beyond the limit) */
+         Atomic<Table *>      _table;       /**< Growing mode: current table */
+         TableList            _retired;     /**< Growing mode: tables replaced by a bigger one */
+         size_t               _numEntries;  /**< Growing mode: number of addresses */
+         size_t               _maxEntries;  /**< Growing mode: maximum number of addresses with a lock of their own */
+         volatile bool        _full;        /**< Growing mode: the table has reached _maxEntries and does not change anymore */
+         Atomic<unsigned int> _overflows;   /**< Growing mode: lookups of addresses beyond the limit */
+         size_t               _chained;     /**< Growing mode: addresses not alone in their bucket of the current table */
+         Lock                 _insertLock;  /**< Growing mode: serializes insertions */
+         Atomic<unsigned int> _collisions;  /**< Insertions into a non-empty bucket (growing mode), or lookups that
+                                                 shared a lock with another address (fixed mode, debug only) */
+
+         // disable copy constructor and assignment operator
+         LockPool ( const LockPool & );
+         const LockPool & operator= ( const LockPool & );
+
+         static size_t hash ( void *addr );
+
+         static Table * newTable ( size_t size );
+
+         Lock * getSlotLock ( void *addr );
+
+         Lock * insert ( void *addr );
+
+         void grow ( Table *table );
+
+      public:
+         /*! \brief Creates the pool
+          *  \param size Number of locks (fixed mode) or initial number of buckets and number of
+          *  shared locks (growing mode), rounded up to a power of two
+          *  \param grow Whether every address gets its own lock
+          *  \param maxEntries Growing mode: maximum number of addresses with a lock of their own
+          */
+         LockPool ( size_t size, bool grow, size_t maxEntries );
+
+         ~LockPool ();
+
+         //! \brief Returns the lock associated to addr
+         Lock * getLock ( void *addr );
+
+         //! \brief Prints the pool statistics
+         void printStats ( std::ostream &o ) const;
+   };
+
+} // namespace nanos
+
+#endif
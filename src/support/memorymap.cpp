@@ -37,9 +37,24 @@
 
 #endif
 #include "memorymap.hpp"
+#ifdef NANOS_MEMORYMAP_POOL
+#include "allocator.hpp"
+#endif
 
 using namespace nanos;
 
+#ifdef NANOS_MEMORYMAP_POOL
+void * MemoryMapNodePool::allocate ( std::size_t size )
+{
+   return getAllocator().allocate( size );
+}
+
+void MemoryMapNodePool::deallocate ( void *node )
+{
+   Allocator::deallocate( node );
+}
+#endif
+
 const char* MemoryChunk::strOverlap[] = {
    "NO_OVERLAP",
    "BEGIN_OVERLAP",
@@ -22,6 +22,8 @@
 
 #include <map>
 #include <list>
+#include <cstddef>
+#include <new>
 #include <stdint.h>
 
 namespace nanos {
@@ -95,14 +97,81 @@ class MemoryChunk {
       static void partitionEnd( MemoryChunk &mcA, MemoryChunk const &mcB );
 };
 
+#ifdef NANOS_MEMORYMAP_POOL
+/*! \brief Node storage of the MemoryMaps, taken from the Nanos++ Allocator
+ *
+ *  The Allocator keeps per thread free lists of objects, so inserting and splitting chunks does
+ *  not go to malloc for every tree node, and nodes released by another thread go back to their
+ *  owner without locking. It is stateless: any instance frees what any other one allocated.
+ */
+class MemoryMapNodePool {
+   public:
+      static void * allocate ( std::size_t size );
+      static void deallocate ( void *node );
+};
+
+template <typename T>
+class MemoryMapAllocator
+{
+   public:
+      typedef T value_type;
+      typedef value_type* pointer;
+      typedef const value_type* const_pointer;
+      typedef value_type& reference;
+      typedef const value_type& const_reference;
+      typedef std::size_t size_type;
+      typedef std::ptrdiff_t difference_type;
+
+      template <typename U>
+      struct rebind {
+         typedef MemoryMapAllocator<U> other;
+      };
+
+      MemoryMapAllocator () {}
+      MemoryMapAllocator ( const MemoryMapAllocator & ) {}
+      template <typename U>
+      MemoryMapAllocator ( const MemoryMapAllocator<U> & ) {}
+      ~MemoryMapAllocator () {}
+
+      pointer address ( reference x ) const { return &x; }
+      const_pointer address ( const_reference x ) const { return &x; }
+
+      pointer allocate ( size_type n, const void * = 0 ) { return static_cast<pointer>( MemoryMapNodePool::allocate( n * sizeof( T ) ) ); }
+      void deallocate ( pointer p, size_type ) { MemoryMapNodePool::deallocate( p ); }
+      size_type max_size () const { return size_type( -1 ) / sizeof( T ); }
+
+      void construct ( pointer p, const T &t ) { new ( p ) T( t ); }
+      void destroy ( pointer p ) { p->~T(); }
+
+      template <typename U>
+      bool operator== ( const MemoryMapAllocator<U> & ) const { return true; }
+      template <typename U>
+      bool operator!= ( const MemoryMapAllocator<U> & ) const { return false; }
+};
+#endif
+
+/*! \brief Ordered container behind MemoryMap
+ *
+ *  Configuring with --enable-memorymap-pool keeps the same red-black tree, with its nodes taken
+ *  from MemoryMapNodePool instead of the default heap allocator.
+ */
+template <typename _Value>
+struct MemoryMapContainer {
+#ifdef NANOS_MEMORYMAP_POOL
+   typedef std::map< MemoryChunk, _Value, std::less< MemoryChunk >, MemoryMapAllocator< std::pair< const MemoryChunk, _Value > > > type;
+#else
+   typedef std::map< MemoryChunk, _Value > type;
+#endif
+};
+
 template <typename _Type>
-class MemoryMap : public std::map< MemoryChunk, _Type * > { 
-   using std::map< MemoryChunk, _Type *>::operator=;
+class MemoryMap : public MemoryMapContainer< _Type * >::type { 
+   using MemoryMapContainer< _Type * >::type::operator=;
    //private:
    //   const MemoryMap & operator=( const MemoryMap &mm ) { this->std::map< MemoryChunk}
    public:
       //typedef enum { MEM_CHUNK_FOUND, MEM_CHUNK_NOT_FOUND, MEM_CHUNK_NOT_FOUND_BUT_ALLOCATED } QueryResult;
-      typedef std::map< MemoryChunk, _Type * > BaseMap;
+      typedef typename MemoryMapContainer< _Type * >::type BaseMap;
       typedef std::pair< const MemoryChunk *, _Type ** > MemChunkPair;
       typedef std::list< MemChunkPair > MemChunkList;
       typedef std::pair< MemoryChunk, _Type * > ConstMemChunkPair;
@@ -110,8 +179,8 @@ class MemoryMap : public std::map< MemoryChunk, _Type * > {
       typedef typename BaseMap::iterator iterator;
       typedef typename BaseMap::const_iterator const_iterator;
 
-      MemoryMap() : std::map< MemoryChunk, _Type * >() { }
-      MemoryMap( const MemoryMap &mm ) : std::map< MemoryChunk, _Type * >( mm ) { }
+      MemoryMap() : BaseMap() { }
+      MemoryMap( const MemoryMap &mm ) : BaseMap( mm ) { }
       ~MemoryMap() {
          for ( iterator it = this->begin(); it != this->end(); it++ ) {
             delete it->second;
@@ -137,11 +206,11 @@ class MemoryMap : public std::map< MemoryChunk, _Type * > {
 
 #if 1
 template <> 
-class MemoryMap<uint64_t> : public std::map< MemoryChunk, uint64_t > {
+class MemoryMap<uint64_t> : public MemoryMapContainer< uint64_t >::type {
    public:
-      MemoryMap( const MemoryMap &mm ) : std::map< MemoryChunk, uint64_t> () { }
+      typedef MemoryMapContainer< uint64_t >::type BaseMap;
+      MemoryMap( const MemoryMap &mm ) : BaseMap() { }
       const MemoryMap & operator=( const MemoryMap &mm );// { return *this; }
-      typedef std::map< MemoryChunk, uint64_t > BaseMap;
       typedef BaseMap::iterator iterator;
       typedef BaseMap::const_iterator const_iterator;
 
@@ -168,3 +168,14 @@ SyncRecursiveLockBlock::~SyncRecursiveLockBlock ( )
    nanos::memoryFence();
 }
 
+CondSyncRecursiveLockBlock::CondSyncRecursiveLockBlock ( RecursiveLock & lock, bool needed ) : _lock(lock), _needed(needed)
+{
+   if ( _needed ) _lock.acquire();
+   nanos::memoryFence();
+}
+
+CondSyncRecursiveLockBlock::~CondSyncRecursiveLockBlock ( )
+{
+   nanos::memoryFence();
+   if ( _needed ) _lock.release();
+}
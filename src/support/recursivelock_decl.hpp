@@ -89,6 +89,21 @@ namespace nanos {
        ~SyncRecursiveLockBlock ( );
    };
 
+   /*! \brief SyncRecursiveLockBlock that only takes the lock when 'needed' is set */
+   class CondSyncRecursiveLockBlock
+   {
+     private:
+       RecursiveLock & _lock;
+       bool            _needed;
+
+       // disable copy-constructor
+       explicit CondSyncRecursiveLockBlock ( const CondSyncRecursiveLockBlock & );
+
+     public:
+       CondSyncRecursiveLockBlock ( RecursiveLock & lock, bool needed );
+       ~CondSyncRecursiveLockBlock ( );
+   };
+
 } // namespace nanos
 
 #endif
@@ -0,0 +1,162 @@
+/*************************************************************************************/
+/*      Copyright 2015 Barcelona Supercomputing Center                               */
+/*                                                                                   */
+/*      This file is part of the NANOS++ library.                                    */
+/*                                                                                   */
+/*      NANOS++ is free software: you can redistribute it and/or modify              */
+/*      it under the terms of the GNU Lesser General Public License as published by  */
+/*      the Free Software Foundation, either version 3 of the License, or            */
+/*      (at your option) any later version.                                          */
+/*                                                                                   */
+/*      NANOS++ is distributed in the hope that it will be useful,                   */
+/*      but WITHOUT ANY WARRANTY; without even the implied warranty of               */
+/*      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                */
+/*      GNU Lesser General Public License for more details.                          */
+/*                                                                                   */
+/*      You should have received a copy of the GNU Lesser General Public License     */
+/*      along with NANOS++.  If not, see <http://www.gnu.org/licenses/>.             */
+/*************************************************************************************/
+
+#ifndef _NANOS_SMALL_VECTOR
+#define _NANOS_SMALL_VECTOR
+
+#include "smallvector_decl.hpp"
+#include "allocator.hpp"
+#include <algorithm>
+
+namespace nanos {
+
+template <typename T, size_t N>
+inline SmallVector<T,N>::SmallVector ( const SmallVector &v ) : _buffer( _inline ), _data( _inline ), _size( 0 ), _capacity( N )
+{
+   *this = v;
+}
+
+template <typename T, size_t N>
+inline const SmallVector<T,N> & SmallVector<T,N>::operator= ( const SmallVector &v )
+{
+   if ( this == &v ) return *this;
+
+   clear();
+   while ( _capacity < v._size ) grow();
+   std::copy( v.begin(), v.end(), _data );
+   _size = v._size;
+   return *this;
+}
+
+template <typename T, size_t N>
+inline SmallVector<T,N>::~SmallVector ()
+{
+   if ( isSpilled() ) Allocator::deallocate( _buffer );
+}
+
+template <typename T, size_t N>
+inline void SmallVector<T,N>::grow ( void )
+{
+   unsigned int capacity = _capacity * 2;
+   T *buffer = ( T * ) getAllocator().allocate( capacity * sizeof( T ) );
+   std::copy( begin(), end(), buffer );
+   if ( isSpilled() ) Allocator::deallocate( _buffer );
+   _buffer = _data = buffer;
+   _capacity = capacity;
+}
+
+template <typename T, size_t N>
+inline void SmallVector<T,N>::reserveBack ( void )
+{
+   if ( ( _data - _buffer ) + _size < _capacity ) return;
+
+   if ( _size == _capacity ) {
+      grow();
+   } else {
+      // Reuse the room left by the elements erased at the front
+      std::copy( begin(), end(), _buffer );
+      _data = _buffer;
+   }
+}
+
+template <typename T, size_t N>
+inline typename SmallVector<T,N>::iterator SmallVector<T,N>::openGap ( iterator pos )
+{
+   size_t index = pos - _data;
+   reserveBack();
+   std::copy_backward( _data + index, _data + _size, _data + _size + 1 );
+   _size++;
+   return _data + index;
+}
+
+template <typename T, size_t N>
+inline void SmallVector<T,N>::push_back ( const T &value )
+{
+   reserveBack();
+   _data[_size++] = value;
+}
+
+template <typename T, size_t N>
+inline typename SmallVector<T,N>::iterator SmallVector<T,N>::erase ( iterator pos )
+{
+   size_t index = pos - _data;
+
+   if ( index < _size / 2 ) {
+      // Closer to the front: the preceding elements move forward
+      std::copy_backward( _data, pos, pos + 1 );
+      _data++;
+   } else {
+      std::copy( pos + 1, end(), pos );
+   }
+   _size--;
+   return _data + index;
+}
+
+template <typename T, size_t N>
+inline typename SmallVector<T,N>::iterator SmallVector<T,N>::erase ( iterator first, iterator last )
+{
+   size_t index = first - _data;
+   std::copy( last, end(), first );
+   _size -= last - first;
+   return _data + index;
+}
+
+template <typename T, size_t N>
+inline void SmallVector<T,N>::remove ( const T &value )
+{
+   _size = std::remove( begin(), end(), value ) - _data;
+}
+
+template <typename T, size_t N>
+inline typename SmallSet<T,N>::iterator SmallSet<T,N>::find ( const T &value )
+{
+   iterator it = std::lower_bound( this->begin(), this->end(), value );
+   return ( it != this->end() && !( value < *it ) ) ? it : this->end();
+}
+
+template <typename T, size_t N>
+inline typename SmallSet<T,N>::const_iterator SmallSet<T,N>::find ( const T &value ) const
+{
+   const_iterator it = std::lower_bound( this->begin(), this->end(), value );
+   return ( it != this->end() && !( value < *it ) ) ? it : this->end();
+}
+
+template <typename T, size_t N>
+inline std::pair<typename SmallSet<T,N>::iterator, bool> SmallSet<T,N>::insert ( const T &value )
+{
+   iterator it = std::lower_bound( this->begin(), this->end(), value );
+   if ( it != this->end() && !( value < *it ) ) return std::make_pair( it, false );
+
+   it = this->openGap( it );
+   *it = value;
+   return std::make_pair( it, true );
+}
+
+template <typename T, size_t N>
+inline typename SmallSet<T,N>::size_type SmallSet<T,N>::erase ( const T &value )
+{
+   iterator it = find( value );
+   if ( it == this->end() ) return 0;
+   BaseVector::erase( it );
+   return 1;
+}
+
+} // namespace nanos
+
+#endif
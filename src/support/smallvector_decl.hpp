@@ -0,0 +1,149 @@
+/*************************************************************************************/
+/*      Copyright 2015 Barcelona Supercomputing Center                               */
+/*                                                                                   */
+/*      This file is part of the NANOS++ library.                                    */
+/*                                                                                   */
+/*      NANOS++ is free software: you can redistribute it and/or modify              */
+/*      it under the terms of the GNU Lesser General Public License as published by  */
+/*      the Free Software Foundation, either version 3 of the License, or            */
+/*      (at your option) any later version.                                          */
+/*                                                                                   */
+/*      NANOS++ is distributed in the hope that it will be useful,                   */
+/*      but WITHOUT ANY WARRANTY; without even the implied warranty of               */
+/*      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                */
+/*      GNU Lesser General Public License for more details.                          */
+/*                                                                                   */
+/*      You should have received a copy of the GNU Lesser General Public License     */
+/*      along with NANOS++.  If not, see <http://www.gnu.org/licenses/>.             */
+/*************************************************************************************/
+
+#ifndef _NANOS_SMALL_VECTOR_DECL
+#define _NANOS_SMALL_VECTOR_DECL
+
+#include <stddef.h>
+#include <utility>
+
+namespace nanos {
+
+/*! \class SmallVector
+ *  \brief Sequence that keeps its first N elements inside the object
+ *
+ *  Elements only spill out of the object when there are more than N of them. The
+ *  spill buffer comes from the runtime Allocator (per-thread size-class free lists,
+ *  whatever the global operator new is), grows geometrically and it is kept until
+ *  the SmallVector is destroyed. Elements must be trivially copyable and destructible
+ *  (pointers, pairs of them...). Erasing an element shifts the shorter side of the
+ *  sequence, so removing elements from either end is constant time. Iterators are
+ *  plain pointers and any insertion or erasure invalidates them.
+ */
+template <typename T, size_t N>
+class SmallVector
+{
+   public:
+      typedef T         value_type;
+      typedef T *       iterator;
+      typedef T const * const_iterator;
+      typedef size_t    size_type;
+
+   private:
+      T *               _buffer;     /**< Inline buffer or spill buffer */
+      T *               _data;       /**< First element, erasing at the front moves it forward in _buffer */
+      unsigned int      _size;       /**< Number of elements */
+      unsigned int      _capacity;   /**< Elements that fit in _buffer */
+      T                 _inline[N];  /**< Inline buffer */
+
+      void grow ( void );
+
+      /*! \brief Makes room for one more element at the end */
+      void reserveBack ( void );
+
+   protected:
+      /*! \brief Makes room for an element at 'pos' and returns its (new) address */
+      iterator openGap ( iterator pos );
+
+   public:
+      SmallVector () : _buffer( _inline ), _data( _inline ), _size( 0 ), _capacity( N ) {}
+
+      SmallVector ( const SmallVector &v );
+
+      const SmallVector & operator= ( const SmallVector &v );
+
+      ~SmallVector ();
+
+      iterator begin ( void ) { return _data; }
+      iterator end ( void ) { return _data + _size; }
+      const_iterator begin ( void ) const { return _data; }
+      const_iterator end ( void ) const { return _data + _size; }
+
+      size_type size ( void ) const { return _size; }
+      bool empty ( void ) const { return _size == 0; }
+
+      T & operator[] ( size_type i ) { return _data[i]; }
+      T const & operator[] ( size_type i ) const { return _data[i]; }
+
+      /*! \brief Tells whether the elements are stored in the heap */
+      bool isSpilled ( void ) const { return _buffer != _inline; }
+
+      void push_back ( const T &value );
+
+      /*! \brief Removes the element at 'pos', keeping the order of the rest
+       *  \return Iterator to the element that followed the removed one
+       */
+      iterator erase ( iterator pos );
+
+      /*! \brief Removes the elements in [first, last), keeping the order of the rest
+       *  \return Iterator to the element that followed the removed ones
+       */
+      iterator erase ( iterator first, iterator last );
+
+      /*! \brief Removes all the elements equal to 'value', keeping the order of the rest */
+      void remove ( const T &value );
+
+      /*! \brief Removes all the elements. The heap buffer, if any, is kept */
+      void clear ( void ) { _data = _buffer; _size = 0; }
+};
+
+/*! \class SmallSet
+ *  \brief Ordered set of unique elements stored in a SmallVector
+ *
+ *  Provides the subset of the std::set interface used by the runtime. Lookups
+ *  are binary searches and insertions and erasures shift the elements that
+ *  follow, which is cheaper than allocating tree nodes for the few elements
+ *  these sets usually hold.
+ */
+template <typename T, size_t N>
+class SmallSet : public SmallVector<T, N>
+{
+   private:
+      typedef SmallVector<T, N> BaseVector;
+
+   public:
+      typedef typename BaseVector::iterator        iterator;
+      typedef typename BaseVector::const_iterator  const_iterator;
+      typedef typename BaseVector::size_type       size_type;
+
+      SmallSet () : BaseVector() {}
+
+      iterator find ( const T &value );
+      const_iterator find ( const T &value ) const;
+
+      /*! \brief Inserts 'value' unless it is already in the set
+       *  \return Iterator to the element equal to 'value' and whether it was inserted
+       */
+      std::pair<iterator, bool> insert ( const T &value );
+
+      iterator erase ( iterator pos ) { return BaseVector::erase( pos ); }
+      iterator erase ( iterator first, iterator last ) { return BaseVector::erase( first, last ); }
+
+      /*! \brief Removes 'value' from the set and returns the number of removed elements */
+      size_type erase ( const T &value );
+
+   private:
+      // Order is kept by insert, so the plain sequence modifiers are not available
+      void push_back ( const T &value );
+      void remove ( const T &value );
+};
+
+} // namespace nanos
+
+#endif
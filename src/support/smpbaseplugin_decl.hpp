@@ -64,6 +64,7 @@ class SMPBasePlugin : public ArchPlugin {
       virtual void createWorker( std::map<unsigned int, BaseThread *> &workers ) = 0;
       virtual std::string getBindingMaskString() const = 0;
       virtual bool asyncTransfersEnabled() const = 0;
+      virtual unsigned int getPrefetchedTasks() const = 0;
 };
 
 } // namespace nanos
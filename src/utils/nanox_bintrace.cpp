@@ -0,0 +1,520 @@
+/*************************************************************************************/
+/*      Copyright 2015 Barcelona Supercomputing Center                               */
+/*                                                                                   */
+/*      This file is part of the NANOS++ library.                                    */
+/*                                                                                   */
+/*      NANOS++ is free software: you can redistribute it and/or modify              */
+/*      it under the terms of the GNU Lesser General Public License as published by  */
+/*      the Free Software Foundation, either version 3 of the License, or            */
+/*      (at your option) any later version.                                          */
+/*                                                                                   */
+/*      NANOS++ is distributed in the hope that it will be useful,                   */
+/*      but WITHOUT ANY WARRANTY; without even the implied warranty of               */
+/*      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                */
+/*      GNU Lesser General Public License for more details.                          */
+/*                                                                                   */
+/*      You should have received a copy of the GNU Lesser General Public License     */
+/*      along with NANOS++.  If not, see <http://www.gnu.org/licenses/>.             */
+/*************************************************************************************/
+
+/*! \file nanox_bintrace.cpp
+ *  \brief Offline converter for the traces written by the binary_trace instrumentation plugin
+ *
+ *  Paraver output uses the same event types as the extrae plugin, so the
+ *  configurations in doc/paraver_configs can be loaded on the converted traces.
+ */
+
+#include "binary_trace_format.hpp"
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <map>
+
+using namespace nanos;
+
+// Mirrors nanos_event_type_t (nanos-int.h)
+enum { STATE_START, STATE_END, SUBSTATE_START, SUBSTATE_END, BURST_START, BURST_END, PTP_START, PTP_END, POINT };
+
+// Mirrors the Paraver types used by the extrae plugin
+const unsigned long long EVENT_STATE     = 9000000;
+const unsigned long long EVENT_SUBSTATE  = 9000004;
+const unsigned long long EVENT_BASE      = 9200000;
+
+// Mirrors nanos_event_state_value_t (nanos-int.h), as named by the extrae plugin
+static const char *stateNames[] = { "NOT CREATED", "NOT RUNNING",
+   "STARTUP", "SHUTDOWN", "ERROR", "IDLE",
+   "RUNTIME", "RUNNING", "SYNCHRONIZATION", "SCHEDULING", "CREATION",
+   "DATA TRANSFER ISSUE", "CACHE ALLOC/FREE", "YIELD", "ACQUIRING LOCK", "CONTEXT SWITCH",
+   "FILL COLOR", "WAKING UP", "STOPPED", "SYNCED RUNNING", "DEBUG" };
+static const unsigned numStates = sizeof( stateNames ) / sizeof( stateNames[0] );
+
+typedef struct {
+   std::string name;
+   std::string description;
+   bool stacked;
+   std::map<unsigned long long, std::string> values;
+} KeyInfo;
+
+typedef std::map<unsigned, KeyInfo> KeyMap;
+
+typedef struct {
+   BinaryTraceRecord record;
+   unsigned stream;
+   size_t seq;
+} TraceEvent;
+
+static bool eventBefore ( const TraceEvent &a, const TraceEvent &b )
+{
+   if ( a.record.time != b.record.time ) return a.record.time < b.record.time;
+   if ( a.stream != b.stream ) return a.stream < b.stream;
+   return a.seq < b.seq;
+}
+
+typedef std::pair<uint64_t, std::string> Line;
+
+static bool lineBefore ( const Line &a, const Line &b ) { return a.first < b.first; }
+
+static bool readDictionary ( const std::string &fileName, unsigned &streams, KeyMap &keys )
+{
+   std::ifstream dict( fileName.c_str() );
+   if ( !dict.good() ) return false;
+
+   streams = 0;
+   std::string line;
+   while ( std::getline( dict, line ) ) {
+      std::istringstream in( line );
+      std::string what;
+      in >> what;
+      if ( what == "streams" ) {
+         in >> streams;
+      } else if ( what == "key" ) {
+         unsigned id; int stacked;
+         in >> id >> stacked >> keys[id].name;
+         std::getline( in >> std::ws, keys[id].description );
+         keys[id].stacked = stacked != 0;
+      } else if ( what == "value" ) {
+         unsigned id; unsigned long long value;
+         in >> id >> value;
+         std::getline( in >> std::ws, keys[id].values[value] );
+      }
+   }
+   return true;
+}
+
+static bool readStream ( const std::string &fileName, unsigned stream, std::vector<TraceEvent> &events,
+                         uint64_t &startTime, int &threadId )
+{
+   FILE *f = fopen( fileName.c_str(), "rb" );
+   if ( f == NULL ) {
+      std::cerr << "nanox-bintrace: cannot open " << fileName << std::endl;
+      return false;
+   }
+
+   BinaryTraceHeader header;
+   if ( fread( &header, sizeof( header ), 1, f ) != 1 ||
+        memcmp( header.magic, NANOS_BINARY_TRACE_MAGIC, sizeof( header.magic ) ) != 0 ||
+        header.version != NANOS_BINARY_TRACE_VERSION || header.recordSize != sizeof( BinaryTraceRecord ) ) {
+      std::cerr << "nanox-bintrace: " << fileName << " is not a binary trace stream" << std::endl;
+      fclose( f );
+      return false;
+   }
+   startTime = header.startTime;
+   threadId = header.threadId;
+
+   TraceEvent e;
+   e.stream = stream;
+   e.seq = 0;
+   while ( fread( &e.record, sizeof( e.record ), 1, f ) == 1 ) {
+      events.push_back( e );
+      e.seq++;
+   }
+   fclose( f );
+   return true;
+}
+
+static std::string stateName ( unsigned long long state )
+{
+   if ( state < numStates ) return stateNames[state];
+   std::ostringstream name;
+   name << "STATE " << state;
+   return name.str();
+}
+
+static std::string keyName ( const KeyMap &keys, unsigned key )
+{
+   KeyMap::const_iterator it = keys.find( key );
+   if ( it != keys.end() ) return it->second.description;
+   std::ostringstream name;
+   name << "key " << key;
+   return name.str();
+}
+
+static std::string valueName ( const KeyMap &keys, unsigned key, unsigned long long value )
+{
+   KeyMap::const_iterator it = keys.find( key );
+   if ( it != keys.end() ) {
+      std::map<unsigned long long, std::string>::const_iterator itV = it->second.values.find( value );
+      if ( itV != it->second.values.end() ) return itV->second;
+   }
+   std::ostringstream name;
+   name << value;
+   return name.str();
+}
+
+/* Paraver */
+
+static void writeRow ( const std::string &fileName, unsigned streams )
+{
+   std::ofstream row( fileName.c_str() );
+   row << "LEVEL CPU SIZE " << streams << std::endl;
+   for ( unsigned i = 0; i < streams; i++ ) row << "CPU " << i + 1 << std::endl;
+   row << std::endl << "LEVEL NODE SIZE 1" << std::endl << "localhost" << std::endl;
+   row << std::endl << "LEVEL THREAD SIZE " << streams << std::endl;
+   for ( unsigned i = 0; i < streams; i++ ) row << "THREAD 1.1." << i + 1 << std::endl;
+}
+
+static void writePcfStates ( std::ofstream &pcf, unsigned long long type, const char *description )
+{
+   pcf << "EVENT_TYPE" << std::endl;
+   pcf << "0    " << type << "    " << description << std::endl;
+   pcf << "VALUES" << std::endl;
+   for ( unsigned i = 0; i < numStates - 1; i++ ) pcf << i << "      " << stateNames[i] << std::endl; // Do not show the DEBUG state
+   pcf << std::endl << std::endl;
+}
+
+static void writePcf ( const std::string &fileName, const KeyMap &keys )
+{
+   std::ofstream pcf( fileName.c_str() );
+   pcf << "DEFAULT_OPTIONS" << std::endl << std::endl;
+   pcf << "LEVEL               THREAD" << std::endl;
+   pcf << "UNITS               NANOSEC" << std::endl;
+   pcf << "LOOK_BACK           100" << std::endl;
+   pcf << "SPEED               1" << std::endl;
+   pcf << "FLAG_ICONS          ENABLED" << std::endl;
+   pcf << "NUM_OF_STATE_COLORS 1000" << std::endl;
+   pcf << "YMAX_SCALE          37" << std::endl << std::endl << std::endl;
+   pcf << "DEFAULT_SEMANTIC" << std::endl << std::endl;
+   pcf << "THREAD_FUNC          State As Is" << std::endl << std::endl << std::endl;
+   pcf << "STATES" << std::endl << "0    Idle" << std::endl << "1    Running" << std::endl << std::endl << std::endl;
+
+   writePcfStates( pcf, EVENT_STATE, "Thread state: " );
+   writePcfStates( pcf, EVENT_SUBSTATE, "Thread sub-state" );
+
+   for ( KeyMap::const_iterator it = keys.begin(); it != keys.end(); it++ ) {
+      pcf << "EVENT_TYPE" << std::endl;
+      pcf << "0    " << EVENT_BASE + it->first << "    " << it->second.description << std::endl;
+      if ( !it->second.values.empty() ) {
+         pcf << "VALUES" << std::endl;
+         std::map<unsigned long long, std::string>::const_iterator itV;
+         for ( itV = it->second.values.begin(); itV != it->second.values.end(); itV++ ) {
+            pcf << itV->first << "      " << itV->second << std::endl;
+         }
+      }
+      pcf << std::endl << std::endl;
+   }
+}
+
+//! \brief Paraver type and value of a record, false if it is not a Paraver event
+static bool paraverEvent ( const BinaryTraceRecord &r, unsigned long long &type, unsigned long long &value )
+{
+   switch ( r.type ) {
+      case STATE_START:    type = EVENT_STATE;    value = r.value; return true;
+      case STATE_END:      type = EVENT_STATE;    value = 0;       return true;
+      case SUBSTATE_START: type = EVENT_SUBSTATE; value = r.value; return true;
+      case SUBSTATE_END:   type = EVENT_SUBSTATE; value = 0;       return true;
+      case POINT:
+      case BURST_START:    type = EVENT_BASE + r.key; value = r.value; return r.key != 0;
+      case BURST_END:      type = EVENT_BASE + r.key; value = 0;       return r.key != 0;
+      default: return false;
+   }
+}
+
+static void writePrv ( const std::string &fileName, unsigned streams, const std::vector<TraceEvent> &events,
+                       uint64_t startTime, uint64_t endTime, const KeyMap &keys )
+{
+   std::vector<Line> lines;
+
+   // Transfer sizes travel in a PtP key, otherwise the id is used as size like in extrae
+   unsigned sizeKey = 0;
+   for ( KeyMap::const_iterator it = keys.begin(); it != keys.end(); it++ ) {
+      if ( it->second.name == "xfer-size" ) sizeKey = it->first;
+   }
+
+   std::map<std::pair<unsigned, int64_t>, TraceEvent> sends;
+   std::map<std::pair<unsigned, int64_t>, TraceEvent> receives;
+
+   size_t i = 0;
+   while ( i < events.size() ) {
+      // Records of the same stream at the same time come from the same event list
+      const TraceEvent &first = events[i];
+      unsigned thread = first.stream + 1;
+      uint64_t time = first.record.time - startTime;
+
+      std::ostringstream line;
+      bool empty = true;
+      for ( ; i < events.size() && events[i].stream == first.stream && events[i].record.time == first.record.time; i++ ) {
+         const TraceEvent &e = events[i];
+         unsigned long long type, value;
+         if ( paraverEvent( e.record, type, value ) ) {
+            if ( empty ) line << "2:" << thread << ":1:1:" << thread << ":" << time;
+            line << ":" << type << ":" << value;
+            empty = false;
+         } else if ( e.record.type == PTP_START || e.record.type == PTP_END ) {
+            std::pair<unsigned, int64_t> tag( e.record.domain, e.record.id );
+            bool isSend = e.record.type == PTP_START;
+            std::map<std::pair<unsigned, int64_t>, TraceEvent> &pending = isSend ? receives : sends;
+            std::map<std::pair<unsigned, int64_t>, TraceEvent>::iterator it = pending.find( tag );
+            if ( it == pending.end() ) {
+               ( isSend ? sends : receives )[tag] = e;
+               continue;
+            }
+            const TraceEvent &s = isSend ? e : it->second;
+            const TraceEvent &r = isSend ? it->second : e;
+            uint64_t size = ( s.record.key != 0 && s.record.key == sizeKey ) ? s.record.value : (uint64_t) s.record.id;
+            uint64_t sTime = s.record.time - startTime;
+            uint64_t rTime = r.record.time - startTime;
+            std::ostringstream comm;
+            comm << "3:" << s.stream + 1 << ":1:1:" << s.stream + 1 << ":" << sTime << ":" << sTime
+                 << ":" << r.stream + 1 << ":1:1:" << r.stream + 1 << ":" << rTime << ":" << rTime
+                 << ":" << size << ":" << s.record.domain;
+            lines.push_back( Line( sTime, comm.str() ) );
+            pending.erase( it );
+         }
+      }
+      if ( !empty ) lines.push_back( Line( time, line.str() ) );
+   }
+
+   std::stable_sort( lines.begin(), lines.end(), lineBefore );
+
+   FILE *prv = fopen( fileName.c_str(), "w" );
+   if ( prv == NULL ) {
+      std::cerr << "nanox-bintrace: cannot write " << fileName << std::endl;
+      return;
+   }
+
+   char date[64];
+   time_t now = time( NULL );
+   strftime( date, sizeof( date ), "%d/%m/%y at %H:%M", localtime( &now ) );
+   uint64_t duration = endTime - startTime;
+   fprintf( prv, "#Paraver (%s):%llu_ns:1(%u):1:1(%u:1)\n", date, (unsigned long long) duration, streams, streams );
+
+   for ( unsigned t = 1; t <= streams; t++ ) {
+      fprintf( prv, "1:%u:1:1:%u:0:%llu:1\n", t, t, (unsigned long long) duration );
+   }
+   for ( size_t l = 0; l < lines.size(); l++ ) {
+      fprintf( prv, "%s\n", lines[l].second.c_str() );
+   }
+   fclose( prv );
+}
+
+/* Chrome trace (JSON) */
+
+static std::string jsonEscape ( const std::string &s )
+{
+   std::string out;
+   for ( size_t i = 0; i < s.size(); i++ ) {
+      char c = s[i];
+      if ( c == '"' || c == '\\' ) {
+         out += '\\';
+         out += c;
+      } else if ( (unsigned char) c < 0x20 ) {
+         out += ' ';
+      } else {
+         out += c;
+      }
+   }
+   return out;
+}
+
+//! \brief Timestamp in microseconds, the Chrome trace unit
+static std::string jsonTime ( uint64_t ns )
+{
+   char buf[64];
+   snprintf( buf, sizeof( buf ), "%llu.%03llu", (unsigned long long) ( ns / 1000 ), (unsigned long long) ( ns % 1000 ) );
+   return buf;
+}
+
+typedef struct {
+   uint64_t time;
+   std::string name;
+   std::string category;
+   std::string args;
+} OpenInterval;
+
+typedef std::vector<OpenInterval> IntervalStack;
+
+static void closeInterval ( std::ofstream &json, bool &firstEvent, unsigned stream, IntervalStack &stack, uint64_t time )
+{
+   if ( stack.empty() ) return;
+   const OpenInterval &o = stack.back();
+   json << ( firstEvent ? "\n" : ",\n" );
+   firstEvent = false;
+   json << "{\"name\":\"" << jsonEscape( o.name ) << "\",\"cat\":\"" << o.category << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << stream
+        << ",\"ts\":" << jsonTime( o.time ) << ",\"dur\":" << jsonTime( time - o.time ) << o.args << "}";
+   stack.pop_back();
+}
+
+static void writeJson ( const std::string &fileName, unsigned streams, const std::vector<int> &threadIds,
+                        const std::vector<TraceEvent> &events, uint64_t startTime, uint64_t endTime, const KeyMap &keys )
+{
+   std::ofstream json( fileName.c_str() );
+   if ( !json.good() ) {
+      std::cerr << "nanox-bintrace: cannot write " << fileName << std::endl;
+      return;
+   }
+
+   json << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+   bool firstEvent = true;
+
+   for ( unsigned s = 0; s < streams; s++ ) {
+      json << ( firstEvent ? "\n" : ",\n" );
+      firstEvent = false;
+      json << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << s << ",\"args\":{\"name\":\"thread " << threadIds[s] << "\"}}";
+   }
+
+   // Open states, sub-states and bursts of each stream
+   std::vector<IntervalStack> states( streams );
+   std::vector<IntervalStack> substates( streams );
+   std::vector<std::map<unsigned, IntervalStack> > bursts( streams );
+
+   for ( size_t i = 0; i < events.size(); i++ ) {
+      const TraceEvent &e = events[i];
+      const BinaryTraceRecord &r = e.record;
+      uint64_t time = r.time - startTime;
+      OpenInterval o;
+      o.time = time;
+
+      switch ( r.type ) {
+         case STATE_START:
+         case SUBSTATE_START:
+            o.name = stateName( r.value );
+            o.category = r.type == STATE_START ? "state" : "substate";
+            ( r.type == STATE_START ? states : substates )[e.stream].push_back( o );
+            break;
+         case STATE_END:
+            closeInterval( json, firstEvent, e.stream, states[e.stream], time );
+            break;
+         case SUBSTATE_END:
+            closeInterval( json, firstEvent, e.stream, substates[e.stream], time );
+            break;
+         case BURST_START:
+            if ( r.key == 0 ) break;
+            o.name = keyName( keys, r.key ) + ": " + valueName( keys, r.key, r.value );
+            o.category = "burst";
+            bursts[e.stream][r.key].push_back( o );
+            break;
+         case BURST_END:
+            if ( r.key == 0 ) break;
+            closeInterval( json, firstEvent, e.stream, bursts[e.stream][r.key], time );
+            break;
+         case POINT:
+            if ( r.key == 0 ) break;
+            json << ( firstEvent ? "\n" : ",\n" );
+            firstEvent = false;
+            json << "{\"name\":\"" << jsonEscape( keyName( keys, r.key ) ) << "\",\"cat\":\"point\",\"ph\":\"i\",\"s\":\"t\",\"pid\":1,\"tid\":" << e.stream
+                 << ",\"ts\":" << jsonTime( time ) << ",\"args\":{\"value\":\"" << jsonEscape( valueName( keys, r.key, r.value ) ) << "\"}}";
+            break;
+         case PTP_START:
+         case PTP_END:
+            json << ( firstEvent ? "\n" : ",\n" );
+            firstEvent = false;
+            json << "{\"name\":\"ptp\",\"cat\":\"ptp " << r.domain << "\",\"ph\":\"" << ( r.type == PTP_START ? "s" : "f\",\"bp\":\"e" )
+                 << "\",\"id\":\"" << r.domain << ":" << r.id << "\",\"pid\":1,\"tid\":" << e.stream << ",\"ts\":" << jsonTime( time ) << "}";
+            break;
+         default: break;
+      }
+   }
+
+   // Close whatever is still open at the end of the trace
+   uint64_t end = endTime - startTime;
+   for ( unsigned s = 0; s < streams; s++ ) {
+      while ( !states[s].empty() ) closeInterval( json, firstEvent, s, states[s], end );
+      while ( !substates[s].empty() ) closeInterval( json, firstEvent, s, substates[s], end );
+      std::map<unsigned, IntervalStack>::iterator it;
+      for ( it = bursts[s].begin(); it != bursts[s].end(); it++ ) {
+         while ( !it->second.empty() ) closeInterval( json, firstEvent, s, it->second, end );
+      }
+   }
+
+   json << "\n]}" << std::endl;
+}
+
+static void usage ( void )
+{
+   std::cerr << "Usage: nanox-bintrace [--json] [-o <output prefix>] <trace prefix>" << std::endl << std::endl;
+   std::cerr << "Converts <trace prefix>.dict and <trace prefix>.<n>.bin, written by the binary_trace" << std::endl;
+   std::cerr << "instrumentation plugin, into a Paraver trace (.prv, .pcf, .row) or, with --json," << std::endl;
+   std::cerr << "into a Chrome trace (.json)." << std::endl;
+}
+
+int main ( int argc, char **argv )
+{
+   bool toJson = false;
+   std::string input, output;
+
+   for ( int i = 1; i < argc; i++ ) {
+      std::string arg( argv[i] );
+      if ( arg == "--json" || arg == "-j" ) {
+         toJson = true;
+      } else if ( arg == "-o" && i + 1 < argc ) {
+         output = argv[++i];
+      } else if ( arg == "--help" || arg == "-h" ) {
+         usage();
+         return 0;
+      } else if ( input.empty() && arg[0] != '-' ) {
+         input = arg;
+      } else {
+         usage();
+         return 1;
+      }
+   }
+   if ( input.empty() ) {
+      usage();
+      return 1;
+   }
+   if ( output.empty() ) output = input;
+
+   unsigned streams;
+   KeyMap keys;
+   if ( !readDictionary( input + ".dict", streams, keys ) ) {
+      std::cerr << "nanox-bintrace: cannot read " << input << ".dict" << std::endl;
+      return 1;
+   }
+
+   std::vector<TraceEvent> events;
+   std::vector<int> threadIds( streams, -1 );
+   uint64_t startTime = 0;
+   for ( unsigned s = 0; s < streams; s++ ) {
+      std::ostringstream fileName;
+      fileName << input << "." << s << ".bin";
+      if ( !readStream( fileName.str(), s, events, startTime, threadIds[s] ) ) return 1;
+   }
+
+   std::sort( events.begin(), events.end(), eventBefore );
+
+   uint64_t endTime = startTime;
+   if ( !events.empty() ) {
+      startTime = std::min( startTime, events.front().record.time );
+      endTime = events.back().record.time;
+   }
+
+   if ( toJson ) {
+      writeJson( output + ".json", streams, threadIds, events, startTime, endTime, keys );
+   } else {
+      writePrv( output + ".prv", streams, events, startTime, endTime, keys );
+      writePcf( output + ".pcf", keys );
+      writeRow( output + ".row", streams );
+   }
+
+   std::cout << "nanox-bintrace: " << events.size() << " events from " << streams << " streams written to " << output
+             << ( toJson ? ".json" : ".prv" ) << std::endl;
+
+   return 0;
+}
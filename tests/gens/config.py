@@ -70,9 +70,9 @@ max_cpus=int(max_cpus)
 
 scheduling_performance=[]
 scheduling_small=['--schedule=dbf','--schedule=dbf --schedule-priority']
-scheduling_large=['--schedule=bf --bf-stack','--schedule=bf --no-bf-stack','--schedule=dbf', '--schedule=affinity']
-throttle=['--throttle=dummy','--throttle=idlethreads','--throttle=numtasks','--throttle=readytasks','--throttle=taskdepth']
-barriers=['--barrier=centralized','--barrier=tree']
+scheduling_large=['--schedule=bf --bf-stack','--schedule=bf --no-bf-stack','--schedule=dbf','--schedule=dbf --schedule-lock-free-queue','--schedule=dbf --schedule-steal-half','--schedule=wf --schedule-lock-free-queue','--schedule=wf --schedule-steal-half','--schedule=hbf','--schedule=affinity']
+throttle=['--throttle=dummy','--throttle=idlethreads','--throttle=numtasks','--throttle=readytasks','--throttle=taskdepth','--throttle=adaptive']
+barriers=['--barrier=centralized','--barrier=tree','--barrier=combining']
 binding=['--disable-binding','--no-disable-binding']
 architecture=['--architecture=smp']
 
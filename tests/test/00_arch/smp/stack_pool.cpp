@@ -0,0 +1,78 @@
+/*************************************************************************************/
+/*      Copyright 2015 Barcelona Supercomputing Center                               */
+/*                                                                                   */
+/*      This file is part of the NANOS++ library.                                    */
+/*                                                                                   */
+/*      NANOS++ is free software: you can redistribute it and/or modify              */
+/*      it under the terms of the GNU Lesser General Public License as published by  */
+/*      the Free Software Foundation, either version 3 of the License, or            */
+/*      (at your option) any later version.                                          */
+/*                                                                                   */
+/*      NANOS++ is distributed in the hope that it will be useful,                   */
+/*      but WITHOUT ANY WARRANTY; without even the implied warranty of               */
+/*      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                */
+/*      GNU Lesser General Public License for more details.                          */
+/*                                                                                   */
+/*      You should have received a copy of the GNU Lesser General Public License     */
+/*      along with NANOS++.  If not, see <http://www.gnu.org/licenses/>.             */
+/*************************************************************************************/
+
+/* DESCRIPTION: Checking SMP stack pool: stacks are usable in all their size,
+ * they are recycled, and writing right below a stack hits its guard page.
+ */
+
+/*<testinfo>
+test_generator="gens/core-generator"
+</testinfo>*/
+
+#include <iostream>
+#include <stdint.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "smpstackpool_decl.hpp"
+
+using namespace nanos::ext;
+
+#define STACK_SIZE (64*1024)
+#define NUM_STACKS 64
+
+int main (int argc, char **argv)
+{
+   SMPStackPool pool;
+   char *stacks[NUM_STACKS];
+
+   for ( int i = 0; i < NUM_STACKS; i++ ) {
+      stacks[i] = (char *) pool.acquire( STACK_SIZE );
+      if ( stacks[i] == NULL || ( (uintptr_t) stacks[i] % 16 ) != 0 ) return -1;
+      for ( int j = 0; j < STACK_SIZE; j++ ) stacks[i][j] = (char) i;
+   }
+
+   for ( int i = 0; i < NUM_STACKS; i++ ) {
+      for ( int j = 0; j < STACK_SIZE; j++ ) if ( stacks[i][j] != (char) i ) return -1;
+   }
+
+   // Released stacks are given back before mapping new ones
+   for ( int i = 0; i < NUM_STACKS; i++ ) pool.release( stacks[i], STACK_SIZE );
+   char *recycled[NUM_STACKS];
+   for ( int i = 0; i < NUM_STACKS; i++ ) {
+      recycled[i] = (char *) pool.acquire( STACK_SIZE );
+      bool found = false;
+      for ( int j = 0; j < NUM_STACKS; j++ ) if ( recycled[i] == stacks[j] ) found = true;
+      if ( !found ) return -1;
+   }
+
+   // Overflowing a stack must raise SIGSEGV
+   pid_t pid = fork();
+   if ( pid == 0 ) {
+      char *overflow = (char *) ( (uintptr_t) recycled[0] & ~( (uintptr_t) getpagesize() - 1 ) ) - 1;
+      *(volatile char *) overflow = 0;
+      _exit( 0 );
+   }
+   int status;
+   if ( waitpid( pid, &status, 0 ) != pid ) return -1;
+   if ( !WIFSIGNALED( status ) || WTERMSIG( status ) != SIGSEGV ) return -1;
+
+   for ( int i = 0; i < NUM_STACKS; i++ ) pool.release( recycled[i], STACK_SIZE );
+
+   return 0;
+}
@@ -0,0 +1,88 @@
+/*************************************************************************************/
+/*      Copyright 2015 Barcelona Supercomputing Center                               */
+/*                                                                                   */
+/*      This file is part of the NANOS++ library.                                    */
+/*                                                                                   */
+/*      NANOS++ is free software: you can redistribute it and/or modify              */
+/*      it under the terms of the GNU Lesser General Public License as published by  */
+/*      the Free Software Foundation, either version 3 of the License, or            */
+/*      (at your option) any later version.                                          */
+/*                                                                                   */
+/*      NANOS++ is distributed in the hope that it will be useful,                   */
+/*      but WITHOUT ANY WARRANTY; without even the implied warranty of               */
+/*      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                */
+/*      GNU Lesser General Public License for more details.                          */
+/*                                                                                   */
+/*      You should have received a copy of the GNU Lesser General Public License     */
+/*      along with NANOS++.  If not, see <http://www.gnu.org/licenses/>.             */
+/*************************************************************************************/
+
+/* DESCRIPTION: Checking that objects freed by a thread other than the owner of their
+ * Allocator go to the remote free lists and are reclaimed by the owner (without new
+ * Arenas) once its size class runs out of objects.
+ */
+
+/*<testinfo>
+test_generator="gens/core-generator"
+</testinfo>*/
+
+#include <iostream>
+#include <algorithm>
+#include <pthread.h>
+#include "config.hpp"
+#include "system.hpp"
+#include "allocator.hpp"
+
+using namespace std;
+using namespace nanos;
+
+// A size class no other object of the test uses: a few objects per Arena, so they span several
+#define OBJECT_SIZE  ( 100 * 1024 )
+#define NUM_OBJECTS  32
+
+void *objects[NUM_OBJECTS];
+
+// Not a runtime thread: every object it frees is a remote free for the owner
+void * remote_free ( void *args );
+void * remote_free ( void *args )
+{
+   for ( int i = 0; i < NUM_OBJECTS; i++ ) Allocator::deallocate( objects[i] );
+   return NULL;
+}
+
+int main ( int argc, char **argv )
+{
+   Allocator &owner = getAllocator();
+
+   for ( int i = 0; i < NUM_OBJECTS; i++ ) {
+      objects[i] = owner.allocate( OBJECT_SIZE );
+      if ( objects[i] == NULL ) return -1;
+   }
+
+   pthread_t thread;
+   if ( pthread_create( &thread, NULL, remote_free, NULL ) != 0 ) return -1;
+   pthread_join( thread, NULL );
+
+   // The owner gets the very same objects back, all of them through the remote lists
+   Allocator::Stats before = owner.getStats();
+   void *reclaimed[NUM_OBJECTS];
+   for ( int i = 0; i < NUM_OBJECTS; i++ ) reclaimed[i] = owner.allocate( OBJECT_SIZE );
+   Allocator::Stats after = owner.getStats();
+
+   bool check = after._arenas == before._arenas &&
+                after._remoteDeallocations - before._remoteDeallocations == NUM_OBJECTS;
+
+   std::sort( objects, objects + NUM_OBJECTS );
+   std::sort( reclaimed, reclaimed + NUM_OBJECTS );
+   check = check && std::equal( objects, objects + NUM_OBJECTS, reclaimed );
+
+   for ( int i = 0; i < NUM_OBJECTS; i++ ) Allocator::deallocate( reclaimed[i] );
+
+   if ( check ) {
+      cerr << argv[0] << ": successful" << endl;
+      return 0;
+   }
+   cerr << argv[0] << ": unsuccessful (" << after._remoteDeallocations - before._remoteDeallocations
+        << " objects reclaimed, " << after._arenas - before._arenas << " new arenas)" << endl;
+   return -1;
+}
@@ -0,0 +1,73 @@
+/*************************************************************************************/
+/*      Copyright 2015 Barcelona Supercomputing Center                               */
+/*                                                                                   */
+/*      This file is part of the NANOS++ library.                                    */
+/*                                                                                   */
+/*      NANOS++ is free software: you can redistribute it and/or modify              */
+/*      it under the terms of the GNU Lesser General Public License as published by  */
+/*      the Free Software Foundation, either version 3 of the License, or            */
+/*      (at your option) any later version.                                          */
+/*                                                                                   */
+/*      NANOS++ is distributed in the hope that it will be useful,                   */
+/*      but WITHOUT ANY WARRANTY; without even the implied warranty of               */
+/*      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                */
+/*      GNU Lesser General Public License for more details.                          */
+/*                                                                                   */
+/*      You should have received a copy of the GNU Lesser General Public License     */
+/*      along with NANOS++.  If not, see <http://www.gnu.org/licenses/>.             */
+/*************************************************************************************/
+
+/*
+<testinfo>
+test_generator=gens/core-generator
+</testinfo>
+*/
+
+#include "nanos.h"
+#include "lock.hpp"
+#include <iostream>
+#include <pthread.h>
+
+using namespace nanos;
+
+#define NUM_THREADS 8
+#define NUM_ITERS   50000
+
+Lock lock;
+volatile int inside = 0;
+long counter = 0;
+bool failed = false;
+
+void * contend ( void * );
+void * contend ( void * )
+{
+   for ( int i = 0; i < NUM_ITERS; i++ ) {
+      // Alternate both acquire paths and hold the lock long enough to park waiters
+      if ( i % 2 == 0 ) lock.acquire();
+      else while ( !lock.tryAcquire() ) {}
+
+      if ( ++inside != 1 ) failed = true;
+      counter++;
+      if ( i % 1000 == 0 ) sched_yield();
+      inside--;
+
+      lock.release();
+   }
+   return NULL;
+}
+
+int main ( int argc, char **argv )
+{
+   pthread_t threads[NUM_THREADS];
+
+   // Threads outnumber CPUs so waiters end up parked in the kernel
+   for ( int i = 0; i < NUM_THREADS; i++ ) pthread_create( &threads[i], NULL, contend, NULL );
+   for ( int i = 0; i < NUM_THREADS; i++ ) pthread_join( threads[i], NULL );
+
+   if ( failed || counter != (long) NUM_THREADS * NUM_ITERS || lock.getState() != NANOS_LOCK_FREE ) {
+      std::cout << "Error: counter is " << counter << " (expected " << (long) NUM_THREADS * NUM_ITERS << ")" << std::endl;
+      return 1;
+   }
+
+   return 0;
+}
@@ -0,0 +1,120 @@
+/*************************************************************************************/
+/*      Copyright 2015 Barcelona Supercomputing Center                               */
+/*                                                                                   */
+/*      This file is part of the NANOS++ library.                                    */
+/*                                                                                   */
+/*      NANOS++ is free software: you can redistribute it and/or modify              */
+/*      it under the terms of the GNU Lesser General Public License as published by  */
+/*      the Free Software Foundation, either version 3 of the License, or            */
+/*      (at your option) any later version.                                          */
+/*                                                                                   */
+/*      NANOS++ is distributed in the hope that it will be useful,                   */
+/*      but WITHOUT ANY WARRANTY; without even the implied warranty of               */
+/*      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                */
+/*      GNU Lesser General Public License for more details.                          */
+/*                                                                                   */
+/*      You should have received a copy of the GNU Lesser General Public License     */
+/*      along with NANOS++.  If not, see <http://www.gnu.org/licenses/>.             */
+/*************************************************************************************/
+
+/*
+<testinfo>
+test_generator=gens/core-generator
+</testinfo>
+*/
+
+#include "config.hpp"
+#include "nanos.h"
+#include "nanos_reduction.h"
+#include <iostream>
+#include "system.hpp"
+#include "task_reduction.hpp"
+#include "bulkreducer_decl.hpp"
+
+using namespace std;
+
+using namespace nanos;
+
+#define VECTOR_SIZE   1003
+#define NUM_COPIES    4
+
+// Compares the bulk loop of every integer operator with its scalar definition
+static bool check_int_loops ( void )
+{
+   int a[VECTOR_SIZE], b[VECTOR_SIZE], r[VECTOR_SIZE];
+
+   for ( int op = 0; op < BulkReducer::NUM_OPS; op++ ) {
+      for ( int i = 0; i < VECTOR_SIZE; i++ ) {
+         a[i] = r[i] = ( i * 7919 ) % 97 - 48;
+         b[i] = ( i * 104729 ) % 89 - 44;
+      }
+
+      bulk_reducer_t bulk = BulkReducer::get( ( BulkReducer::Op ) op, BulkReducer::INT );
+      if ( bulk == NULL ) return false;
+      bulk( r, b, VECTOR_SIZE );
+
+      for ( int i = 0; i < VECTOR_SIZE; i++ ) {
+         int expected = 0;
+         switch ( op ) {
+            case BulkReducer::ADD:  expected = a[i] + b[i]; break;
+            case BulkReducer::PROD: expected = a[i] * b[i]; break;
+            case BulkReducer::MIN:  expected = a[i] < b[i] ? a[i] : b[i]; break;
+            case BulkReducer::MAX:  expected = a[i] > b[i] ? a[i] : b[i]; break;
+            case BulkReducer::AND:  expected = a[i] & b[i]; break;
+            case BulkReducer::OR:   expected = a[i] | b[i]; break;
+            case BulkReducer::XOR:  expected = a[i] ^ b[i]; break;
+         }
+         if ( r[i] != expected ) return false;
+      }
+   }
+
+   // No bitwise operators over reals
+   return BulkReducer::get( BulkReducer::XOR, BulkReducer::DOUBLE ) == NULL;
+}
+
+void init_double ( void *priv, void *orig );
+void init_double ( void *priv, void *orig )
+{
+   *(double *) priv = 0.0;
+}
+
+// The built-in reducers are registered and drive task reductions through their bulk loop
+static bool check_task_reduction ( bool tree )
+{
+   static double orig[VECTOR_SIZE];
+
+   if ( BulkReducer::find( ( const void * ) &nanos_reduction_bop_add_double ) == NULL ) return false;
+   if ( BulkReducer::find( ( const void * ) &nanos_reduction_bop_add_double ) !=
+        BulkReducer::find( ( const void * ) &nanos_reduction_bop_array_add_double ) ) return false;
+
+   for ( int i = 0; i < VECTOR_SIZE; i++ ) orig[i] = 0.5;
+
+   TaskReduction tr( orig, init_double, nanos_reduction_bop_add_double, sizeof( orig ), sizeof( double ), NUM_COPIES, 0, false, tree );
+
+   for ( size_t id = 0; id < NUM_COPIES; id++ ) {
+      double *priv = ( double * ) tr.get( id );
+      tr.initialize( id );
+      for ( int i = 0; i < VECTOR_SIZE; i++ ) priv[i] = i + id;
+   }
+
+   tr.reduce();
+
+   for ( int i = 0; i < VECTOR_SIZE; i++ ) {
+      if ( orig[i] != 0.5 + NUM_COPIES * i + NUM_COPIES * ( NUM_COPIES - 1 ) / 2 ) return false;
+   }
+   return true;
+}
+
+int main ( int argc, char **argv )
+{
+   bool check = check_int_loops() && check_task_reduction( false ) && check_task_reduction( true );
+
+   if ( check ) {
+      fprintf(stderr, "%s : %s (avx2: %d)\n", argv[0], "successful", BulkReducer::usesAVX2() );
+      return 0;
+   }
+   else {
+      fprintf(stderr, "%s: %s\n", argv[0], "unsuccessful");
+      return -1;
+   }
+}
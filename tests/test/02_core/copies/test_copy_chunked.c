@@ -0,0 +1,137 @@
+/*************************************************************************************/
+/*      Copyright 2015 Barcelona Supercomputing Center                               */
+/*                                                                                   */
+/*      This file is part of the NANOS++ library.                                    */
+/*                                                                                   */
+/*      NANOS++ is free software: you can redistribute it and/or modify              */
+/*      it under the terms of the GNU Lesser General Public License as published by  */
+/*      the Free Software Foundation, either version 3 of the License, or            */
+/*      (at your option) any later version.                                          */
+/*                                                                                   */
+/*      NANOS++ is distributed in the hope that it will be useful,                   */
+/*      but WITHOUT ANY WARRANTY; without even the implied warranty of               */
+/*      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                */
+/*      GNU Lesser General Public License for more details.                          */
+/*                                                                                   */
+/*      You should have received a copy of the GNU Lesser General Public License     */
+/*      along with NANOS++.  If not, see <http://www.gnu.org/licenses/>.             */
+/*************************************************************************************/
+
+/*
+<testinfo>
+test_generator=gens/api-generator
+exec_versions="chunked chunked_sync"
+
+declare test_ENV_chunked="NX_SMP_PRIVATE_MEMORY=true NX_SMP_TRANSFER_CHUNK_SIZE=4096 NX_SMP_TRANSFER_STREAMING_THRESHOLD=65536"
+declare test_ENV_chunked_sync="NX_SMP_PRIVATE_MEMORY=true NX_SMP_TRANSFER_CHUNK_SIZE=4096 NX_SMP_TRANSFER_STREAMING_THRESHOLD=65536 NX_SMP_SYNC_TRANSFERS=true"
+
+</testinfo>
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <nanos.h>
+
+/* Copies of a matrix bigger than the transfer chunk size: the whole matrix (split in
+ * chunks, non-temporal stores), a block of narrow columns (groups of short rows) and a
+ * block of wide columns (every row split in chunks) */
+
+#define ROWS        256
+#define COLS       1024
+#define NUM_ROUNDS    3
+
+double matrix[ROWS][COLS];
+
+typedef struct {
+   int first_col;
+   int last_col;
+   double value;
+} my_args;
+
+void add_value( void *ptr );
+void add_value( void *ptr )
+{
+   my_args *args = (my_args *) ptr;
+   double (*local)[COLS];
+   int i, j;
+
+   nanos_get_addr( 0, (void **) &local, nanos_current_wd() );
+   for ( i = 0; i < ROWS; i++ )
+      for ( j = args->first_col; j < args->last_col; j++ )
+         local[i][j] += args->value;
+}
+
+nanos_smp_args_t test_device_arg = { add_value };
+
+struct nanos_const_wd_definition_1
+{
+     nanos_const_wd_definition_t base;
+     nanos_device_t devices[1];
+};
+
+struct nanos_const_wd_definition_1 const_data =
+{
+   {{
+      .mandatory_creation = true,
+      .tied = false},
+   __alignof__(my_args),
+   1,
+   1,
+   2,NULL},
+   {
+      {
+         nanos_smp_factory,
+         &test_device_arg
+      }
+   }
+};
+
+static void add_to_columns( int first_col, int last_col, double value )
+{
+   my_args *args = 0;
+   nanos_copy_data_t *cd = 0;
+   nanos_region_dimension_internal_t *dims = 0;
+   nanos_wd_t wd = 0;
+   nanos_wd_dyn_props_t dyn_props = {0};
+
+   NANOS_SAFE( nanos_create_wd_compact( &wd, &const_data.base, &dyn_props, sizeof(my_args), (void **) &args,
+                                        nanos_current_wd(), &cd, &dims ) );
+   args->first_col = first_col;
+   args->last_col = last_col;
+   args->value = value;
+   dims[0] = (nanos_region_dimension_internal_t) { sizeof(double) * COLS, sizeof(double) * first_col, sizeof(double) * ( last_col - first_col ) };
+   dims[1] = (nanos_region_dimension_internal_t) { ROWS, 0, ROWS };
+   cd[0] = (nanos_copy_data_t) { (void *) matrix, NANOS_SHARED, {true, true}, 2, &dims[0], 0 };
+
+   NANOS_SAFE( nanos_submit( wd, 0, 0, 0 ) );
+   NANOS_SAFE( nanos_wg_wait_completion( nanos_current_wd(), false ) );
+}
+
+int main ( int argc, char **argv )
+{
+   int round, i, j;
+
+   for ( i = 0; i < ROWS; i++ )
+      for ( j = 0; j < COLS; j++ )
+         matrix[i][j] = i * COLS + j;
+
+   for ( round = 0; round < NUM_ROUNDS; round++ ) {
+      add_to_columns( 0, COLS, 1.0 );
+      add_to_columns( 16, 24, 10.0 );
+      add_to_columns( 4, 1004, 100.0 );
+   }
+
+   for ( i = 0; i < ROWS; i++ ) {
+      for ( j = 0; j < COLS; j++ ) {
+         double expected = i * COLS + j + NUM_ROUNDS * 1.0;
+         if ( j >= 16 && j < 24 ) expected += NUM_ROUNDS * 10.0;
+         if ( j >= 4 && j < 1004 ) expected += NUM_ROUNDS * 100.0;
+         if ( matrix[i][j] != expected ) {
+            printf( "Element [%d][%d] is %f, expected %f  FAIL\n", i, j, matrix[i][j], expected );
+            return 1;
+         }
+      }
+   }
+   printf( "Checking chunked copies ...  PASS\n" );
+   return 0;
+}
@@ -0,0 +1,160 @@
+/*************************************************************************************/
+/*      Copyright 2015 Barcelona Supercomputing Center                               */
+/*                                                                                   */
+/*      This file is part of the NANOS++ library.                                    */
+/*                                                                                   */
+/*      NANOS++ is free software: you can redistribute it and/or modify              */
+/*      it under the terms of the GNU Lesser General Public License as published by  */
+/*      the Free Software Foundation, either version 3 of the License, or            */
+/*      (at your option) any later version.                                          */
+/*                                                                                   */
+/*      NANOS++ is distributed in the hope that it will be useful,                   */
+/*      but WITHOUT ANY WARRANTY; without even the implied warranty of               */
+/*      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                */
+/*      GNU Lesser General Public License for more details.                          */
+/*                                                                                   */
+/*      You should have received a copy of the GNU Lesser General Public License     */
+/*      along with NANOS++.  If not, see <http://www.gnu.org/licenses/>.             */
+/*************************************************************************************/
+
+/*
+<testinfo>
+test_generator="gens/api-generator -c 1"
+exec_versions="builtin lru lfu writeback"
+
+declare test_ENV_builtin="NX_SMP_PRIVATE_MEMORY=yes NX_SMP_PRIVATE_MEMORY_SIZE=65536"
+declare test_ENV_lru="NX_SMP_PRIVATE_MEMORY=yes NX_SMP_PRIVATE_MEMORY_SIZE=65536 NX_CACHE_EVICTION=lru"
+declare test_ENV_lfu="NX_SMP_PRIVATE_MEMORY=yes NX_SMP_PRIVATE_MEMORY_SIZE=65536 NX_CACHE_EVICTION=lfu"
+declare test_ENV_writeback="NX_SMP_PRIVATE_MEMORY=yes NX_SMP_PRIVATE_MEMORY_SIZE=65536 NX_CACHE_EVICTION=writeback"
+
+</testinfo>
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <nanos.h>
+
+/* Twice as many objects as fit in the private memory of a thread, accessed in turns and
+ * with a hot object accessed between every other access: the cache must keep evicting.
+ * Every task is waited for, otherwise the chain of tasks of an object would run in a row.
+ * A single thread runs them, so that objects do not move between private memories */
+
+#define NUM_OBJS       8
+#define OBJ_ELEMS   4096
+#define NUM_ROUNDS    10
+#define HOT_OBJ        0
+
+int objs[NUM_OBJS][OBJ_ELEMS];
+int expected[NUM_OBJS];
+
+typedef struct {
+   int obj;
+} my_args;
+
+void increment( void *ptr );
+void increment( void *ptr )
+{
+   int *local;
+   int i;
+
+   nanos_get_addr( 0, (void **) &local, nanos_current_wd() );
+   for ( i = 0; i < OBJ_ELEMS; i++ ) local[i]++;
+}
+
+nanos_smp_args_t test_device_arg = { increment };
+
+struct nanos_const_wd_definition_1
+{
+     nanos_const_wd_definition_t base;
+     nanos_device_t devices[1];
+};
+
+struct nanos_const_wd_definition_1 const_data =
+{
+   {{
+      .mandatory_creation = true,
+      .tied = false},
+   __alignof__(my_args),
+   1,
+   1,
+   1,NULL},
+   {
+      {
+         nanos_smp_factory,
+         &test_device_arg
+      }
+   }
+};
+
+static void increment_obj( int obj )
+{
+   my_args *args = 0;
+   nanos_copy_data_t *cd = 0;
+   nanos_region_dimension_internal_t *dims = 0;
+   nanos_wd_t wd = 0;
+   nanos_wd_dyn_props_t dyn_props = {0};
+
+   NANOS_SAFE( nanos_create_wd_compact( &wd, &const_data.base, &dyn_props, sizeof(my_args), (void **) &args,
+                                        nanos_current_wd(), &cd, &dims ) );
+   args->obj = obj;
+   dims[0] = (nanos_region_dimension_internal_t) { sizeof(objs[obj]), 0, sizeof(objs[obj]) };
+   cd[0] = (nanos_copy_data_t) { (void *) objs[obj], NANOS_SHARED, {true, true}, 1, &dims[0], 0 };
+
+   nanos_region_dimension_t dep_dims[1] = {{ sizeof(objs[obj]), 0, sizeof(objs[obj]) }};
+   nanos_data_access_t deps[1] = {{ (void *) objs[obj], {1,1,0,0,0}, 1, dep_dims, 0 }};
+   NANOS_SAFE( nanos_submit( wd, 1, deps, 0 ) );
+
+   expected[obj]++;
+}
+
+//! Returns 0 if every object was incremented by all of its tasks, once they were flushed
+static int check_objs( void )
+{
+   int obj, i;
+
+   for ( obj = 0; obj < NUM_OBJS; obj++ ) {
+      for ( i = 0; i < OBJ_ELEMS; i++ ) {
+         if ( objs[obj][i] != expected[obj] ) {
+            printf( "Element %d of object %d is %d, expected %d  FAIL\n", i, obj, objs[obj][i], expected[obj] );
+            return 1;
+         }
+      }
+   }
+   return 0;
+}
+
+int main ( int argc, char **argv )
+{
+   const char *policy = getenv( "NX_CACHE_EVICTION" );
+   int round, obj, evicted = 0;
+
+   for ( round = 0; round < NUM_ROUNDS; round++ ) {
+      for ( obj = 0; obj < NUM_OBJS; obj++ ) {
+         increment_obj( obj );
+         NANOS_SAFE( nanos_wg_wait_completion( nanos_current_wd(), true ) );
+         increment_obj( HOT_OBJ );
+         NANOS_SAFE( nanos_wg_wait_completion( nanos_current_wd(), true ) );
+      }
+   }
+
+   /* Nothing has been flushed yet: the host copy of an object is only updated when it is evicted.
+    * All the chunks are dirty and of the same size, so every policy (but the built-in heuristic)
+    * must have chosen its victims among the other objects and kept the hot one */
+   for ( obj = 0; obj < NUM_OBJS; obj++ ) {
+      if ( obj != HOT_OBJ && objs[obj][0] != 0 ) evicted++;
+   }
+   if ( evicted == 0 ) {
+      printf( "No object was evicted  FAIL\n" );
+      return 1;
+   }
+   if ( policy != NULL && objs[HOT_OBJ][0] != 0 ) {
+      printf( "The hot object was evicted by the %s policy  FAIL\n", policy );
+      return 1;
+   }
+
+   NANOS_SAFE( nanos_wg_wait_completion( nanos_current_wd(), false ) );
+   if ( check_objs() != 0 ) return 1;
+
+   printf( "Checking evictions ...  PASS\n" );
+   return 0;
+}
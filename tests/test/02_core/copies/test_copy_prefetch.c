@@ -0,0 +1,142 @@
+/*************************************************************************************/
+/*      Copyright 2015 Barcelona Supercomputing Center                               */
+/*                                                                                   */
+/*      This file is part of the NANOS++ library.                                    */
+/*                                                                                   */
+/*      NANOS++ is free software: you can redistribute it and/or modify              */
+/*      it under the terms of the GNU Lesser General Public License as published by  */
+/*      the Free Software Foundation, either version 3 of the License, or            */
+/*      (at your option) any later version.                                          */
+/*                                                                                   */
+/*      NANOS++ is distributed in the hope that it will be useful,                   */
+/*      but WITHOUT ANY WARRANTY; without even the implied warranty of               */
+/*      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                */
+/*      GNU Lesser General Public License for more details.                          */
+/*                                                                                   */
+/*      You should have received a copy of the GNU Lesser General Public License     */
+/*      along with NANOS++.  If not, see <http://www.gnu.org/licenses/>.             */
+/*************************************************************************************/
+
+/*
+<testinfo>
+test_generator=gens/api-generator
+exec_versions="prefetch prefetch_sync prefetch_small"
+
+declare test_ENV_prefetch="NX_SMP_PRIVATE_MEMORY=yes NX_SMP_PREFETCH=2"
+declare test_ENV_prefetch_sync="NX_SMP_PRIVATE_MEMORY=yes NX_SMP_PREFETCH=2 NX_SMP_SYNC_TRANSFERS=true"
+declare test_ENV_prefetch_small="NX_SMP_PRIVATE_MEMORY=yes NX_SMP_PREFETCH=4 NX_SMP_PRIVATE_MEMORY_SIZE=65536"
+
+</testinfo>
+*/
+
+#include <stdio.h>
+#include <nanos.h>
+
+/* Chains of tasks over objects of the private memory of the threads: while a task runs, the
+ * copies of the next ready ones are started, also when they do not fit in the cache yet */
+
+#define NUM_OBJS      16
+#define NUM_ROUNDS     8
+
+#define OBJ_ELEMS   4096
+
+int objs[NUM_OBJS][OBJ_ELEMS];
+int expected[NUM_OBJS];
+
+typedef struct {
+   int obj;
+} my_args;
+
+void increment( void *ptr );
+void increment( void *ptr )
+{
+   int *local;
+   int i;
+
+   nanos_get_addr( 0, (void **) &local, nanos_current_wd() );
+   for ( i = 0; i < OBJ_ELEMS; i++ ) local[i]++;
+}
+
+nanos_smp_args_t test_device_arg = { increment };
+
+struct nanos_const_wd_definition_1
+{
+     nanos_const_wd_definition_t base;
+     nanos_device_t devices[1];
+};
+
+struct nanos_const_wd_definition_1 const_data =
+{
+   {{
+      .mandatory_creation = true,
+      .tied = false},
+   __alignof__(my_args),
+   1,
+   1,
+   1,NULL},
+   {
+      {
+         nanos_smp_factory,
+         &test_device_arg
+      }
+   }
+};
+
+static void increment_obj( int obj )
+{
+   my_args *args = 0;
+   nanos_copy_data_t *cd = 0;
+   nanos_region_dimension_internal_t *dims = 0;
+   nanos_wd_t wd = 0;
+   nanos_wd_dyn_props_t dyn_props = {0};
+
+   NANOS_SAFE( nanos_create_wd_compact( &wd, &const_data.base, &dyn_props, sizeof(my_args), (void **) &args,
+                                        nanos_current_wd(), &cd, &dims ) );
+   args->obj = obj;
+   dims[0] = (nanos_region_dimension_internal_t) { sizeof(objs[obj]), 0, sizeof(objs[obj]) };
+   cd[0] = (nanos_copy_data_t) { (void *) objs[obj], NANOS_SHARED, {true, true}, 1, &dims[0], 0 };
+
+   nanos_region_dimension_t dep_dims[1] = {{ sizeof(objs[obj]), 0, sizeof(objs[obj]) }};
+   nanos_data_access_t deps[1] = {{ (void *) objs[obj], {1,1,0,0,0}, 1, dep_dims, 0 }};
+   NANOS_SAFE( nanos_submit( wd, 1, deps, 0 ) );
+
+   expected[obj]++;
+}
+
+//! Returns 0 if every object was incremented by all of its tasks, once they were flushed
+static int check_objs( void )
+{
+   int obj, i;
+
+   for ( obj = 0; obj < NUM_OBJS; obj++ ) {
+      for ( i = 0; i < OBJ_ELEMS; i++ ) {
+         if ( objs[obj][i] != expected[obj] ) {
+            printf( "Element %d of object %d is %d, expected %d  FAIL\n", i, obj, objs[obj][i], expected[obj] );
+            return 1;
+         }
+      }
+   }
+   return 0;
+}
+
+int main ( int argc, char **argv )
+{
+   unsigned int prefetched = 0;
+   int round, obj;
+
+   for ( round = 0; round < NUM_ROUNDS; round++ ) {
+      for ( obj = 0; obj < NUM_OBJS; obj++ ) increment_obj( obj );
+   }
+   NANOS_SAFE( nanos_wg_wait_completion( nanos_current_wd(), false ) );
+
+   if ( check_objs() != 0 ) return 1;
+   printf( "Checking prefetched copies ...  PASS\n" );
+
+   NANOS_SAFE( nanos_get_num_prefetched_tasks( &prefetched ) );
+   if ( prefetched == 0 ) {
+      printf( "No task had its copies started ahead of its execution  FAIL\n" );
+      return 1;
+   }
+   printf( "Checking prefetched tasks (%u) ...  PASS\n", prefetched );
+   return 0;
+}
@@ -0,0 +1,126 @@
+/*************************************************************************************/
+/*      Copyright 2015 Barcelona Supercomputing Center                               */
+/*                                                                                   */
+/*      This file is part of the NANOS++ library.                                    */
+/*                                                                                   */
+/*      NANOS++ is free software: you can redistribute it and/or modify              */
+/*      it under the terms of the GNU Lesser General Public License as published by  */
+/*      the Free Software Foundation, either version 3 of the License, or            */
+/*      (at your option) any later version.                                          */
+/*                                                                                   */
+/*      NANOS++ is distributed in the hope that it will be useful,                   */
+/*      but WITHOUT ANY WARRANTY; without even the implied warranty of               */
+/*      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                */
+/*      GNU Lesser General Public License for more details.                          */
+/*                                                                                   */
+/*      You should have received a copy of the GNU Lesser General Public License     */
+/*      along with NANOS++.  If not, see <http://www.gnu.org/licenses/>.             */
+/*************************************************************************************/
+
+/*
+<testinfo>
+test_generator=gens/api-generator
+</testinfo>
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <nanos.h>
+
+/* Objects are registered and unregistered again at the same address, with the same
+ * and with a different size, while tasks keep looking them up through their copies */
+
+#define NUM_ELEMS    64
+#define NUM_TASKS    20
+#define NUM_ROUNDS    6
+
+int data[NUM_ELEMS];
+
+typedef struct {
+   int size;
+} my_args;
+
+void increment( void *ptr );
+void increment( void *ptr )
+{
+   my_args *args = (my_args *) ptr;
+   int *local;
+   int i;
+
+   nanos_get_addr( 0, (void **) &local, nanos_current_wd() );
+   for ( i = 0; i < args->size; i++ ) local[i]++;
+}
+
+nanos_smp_args_t test_device_arg = { increment };
+
+struct nanos_const_wd_definition_1
+{
+     nanos_const_wd_definition_t base;
+     nanos_device_t devices[1];
+};
+
+struct nanos_const_wd_definition_1 const_data =
+{
+   {{
+      .mandatory_creation = true,
+      .tied = false},
+   __alignof__(my_args),
+   1,
+   1,
+   1,NULL},
+   {
+      {
+         nanos_smp_factory,
+         &test_device_arg
+      }
+   }
+};
+
+int main ( int argc, char **argv )
+{
+   int expected[NUM_ELEMS] = { 0 };
+   int round, t, i;
+
+   for ( round = 0; round < NUM_ROUNDS; round++ ) {
+      /* Two rounds of each size, so a round can hit what the previous one registered */
+      int size = ( round / 2 ) % 2 == 0 ? NUM_ELEMS : NUM_ELEMS / 2;
+      nanos_region_dimension_internal_t obj_dims[1] = {{ sizeof(int) * size, 0, sizeof(int) * size }};
+      nanos_copy_data_t obj = { (void *) data, NANOS_SHARED, {true, true}, 1, obj_dims, 0 };
+      uint64_t base_address = (uint64_t) data;
+
+      NANOS_SAFE( nanos_register_object( 1, &obj ) );
+
+      for ( t = 0; t < NUM_TASKS; t++ ) {
+         my_args *args = 0;
+         nanos_copy_data_t *cd = 0;
+         nanos_region_dimension_internal_t *dims = 0;
+         nanos_wd_t wd = 0;
+         nanos_wd_dyn_props_t dyn_props = {0};
+
+         NANOS_SAFE( nanos_create_wd_compact( &wd, &const_data.base, &dyn_props, sizeof(my_args), (void **) &args,
+                                              nanos_current_wd(), &cd, &dims ) );
+         args->size = size;
+         dims[0] = (nanos_region_dimension_internal_t) { sizeof(int) * size, 0, sizeof(int) * size };
+         cd[0] = (nanos_copy_data_t) { (void *) data, NANOS_SHARED, {true, true}, 1, &dims[0], 0 };
+
+         nanos_region_dimension_t dep_dims[1] = {{ sizeof(int) * size, 0, sizeof(int) * size }};
+         nanos_data_access_t deps[1] = {{ (void *) data, {1,1,0,0,0}, 1, dep_dims, 0 }};
+         NANOS_SAFE( nanos_submit( wd, 1, deps, 0 ) );
+
+         for ( i = 0; i < size; i++ ) expected[i]++;
+      }
+
+      NANOS_SAFE( nanos_wg_wait_completion( nanos_current_wd(), false ) );
+      NANOS_SAFE( nanos_unregister_object( 1, &base_address ) );
+   }
+
+   for ( i = 0; i < NUM_ELEMS; i++ ) {
+      if ( data[i] != expected[i] ) {
+         printf( "Element %d is %d, expected %d  FAIL\n", i, data[i], expected[i] );
+         return 1;
+      }
+   }
+   printf( "Checking register/unregister cycles ...  PASS\n" );
+   return 0;
+}
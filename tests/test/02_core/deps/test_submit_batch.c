@@ -0,0 +1,146 @@
+/*************************************************************************************/
+/*      Copyright 2015 Barcelona Supercomputing Center                               */
+/*                                                                                   */
+/*      This file is part of the NANOS++ library.                                    */
+/*                                                                                   */
+/*      NANOS++ is free software: you can redistribute it and/or modify              */
+/*      it under the terms of the GNU Lesser General Public License as published by  */
+/*      the Free Software Foundation, either version 3 of the License, or            */
+/*      (at your option) any later version.                                          */
+/*                                                                                   */
+/*      NANOS++ is distributed in the hope that it will be useful,                   */
+/*      but WITHOUT ANY WARRANTY; without even the implied warranty of               */
+/*      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                */
+/*      GNU Lesser General Public License for more details.                          */
+/*                                                                                   */
+/*      You should have received a copy of the GNU Lesser General Public License     */
+/*      along with NANOS++.  If not, see <http://www.gnu.org/licenses/>.             */
+/*************************************************************************************/
+
+/*
+<testinfo>
+test_generator=gens/api-generator
+test_deps_plugins=plain,sharded,regions,perfect-regions
+</testinfo>
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <nanos.h>
+
+#define NUM_BATCHES  8
+#define BATCH_SIZE   32
+
+int chain = 0;
+int independent = 0;
+
+typedef struct {
+   int step;
+} task_data_t;
+
+void chain_task ( void *args );
+void chain_task ( void *args )
+{
+   task_data_t *hargs = (task_data_t *) args;
+
+   if ( chain != hargs->step ) {
+      printf("Error, order of tasks not respected (%d != %d)!\n", chain, hargs->step);
+      abort();
+   }
+   chain++;
+}
+
+void independent_task ( void *args );
+void independent_task ( void *args )
+{
+   __sync_fetch_and_add( &independent, 1 );
+}
+
+nanos_smp_args_t test_device_arg_1 = { chain_task };
+nanos_smp_args_t test_device_arg_2 = { independent_task };
+
+/* ************** CONSTANT PARAMETERS IN WD CREATION ******************** */
+
+struct nanos_const_wd_definition_1
+{
+     nanos_const_wd_definition_t base;
+     nanos_device_t devices[1];
+};
+
+struct nanos_const_wd_definition_1 const_data1 = 
+{
+   {{
+      .mandatory_creation = true,
+      .tied = false},
+   __alignof__(task_data_t),
+   0,
+   1,
+   0,NULL},
+   {
+      {
+         nanos_smp_factory,
+         &test_device_arg_1
+      }
+   }
+};
+
+struct nanos_const_wd_definition_1 const_data2 = 
+{
+   {{
+      .mandatory_creation = true,
+      .tied = false},
+   __alignof__(task_data_t),
+   0,
+   1,
+   0,NULL},
+   {
+      {
+         nanos_smp_factory,
+         &test_device_arg_2
+      }
+   }
+};
+
+int main ( int argc, char **argv )
+{
+   nanos_region_dimension_t dimensions[1] = {{sizeof(int), 0, sizeof(int)}};
+   nanos_data_access_t chain_access[1] = {{&chain, {1,1,0,0,0}, 1, dimensions}};
+   nanos_wd_dyn_props_t dyn_props = {0};
+   int batch, i, step = 0;
+
+   for ( batch = 0; batch < NUM_BATCHES; batch++ ) {
+      nanos_wd_t wds[BATCH_SIZE];
+      size_t num_data_accesses[BATCH_SIZE];
+      nanos_data_access_t *data_accesses[BATCH_SIZE];
+
+      // Odd positions are independent tasks, the rest are chained through an inout access
+      for ( i = 0; i < BATCH_SIZE; i++ ) {
+         task_data_t *task_data = NULL;
+         wds[i] = NULL;
+         if ( i % 2 == 0 ) {
+            NANOS_SAFE( nanos_create_wd_compact ( &wds[i], &const_data1.base, &dyn_props, sizeof(task_data_t),
+                                                  (void **) &task_data, nanos_current_wd(), NULL, NULL ) );
+            task_data->step = step++;
+            num_data_accesses[i] = 1;
+            data_accesses[i] = chain_access;
+         } else {
+            NANOS_SAFE( nanos_create_wd_compact ( &wds[i], &const_data2.base, &dyn_props, sizeof(task_data_t),
+                                                  (void **) &task_data, nanos_current_wd(), NULL, NULL ) );
+            num_data_accesses[i] = 0;
+            data_accesses[i] = NULL;
+         }
+      }
+
+      NANOS_SAFE( nanos_submit_batch( BATCH_SIZE, wds, num_data_accesses, data_accesses, 0 ) );
+   }
+
+   NANOS_SAFE( nanos_wg_wait_completion( nanos_current_wd(), false ) );
+
+   if ( chain != step || independent != NUM_BATCHES * BATCH_SIZE / 2 ) {
+      printf("Error: %d/%d chained and %d/%d independent tasks executed.\n",
+             chain, step, independent, NUM_BATCHES * BATCH_SIZE / 2);
+      return 1;
+   }
+
+   return 0;
+}
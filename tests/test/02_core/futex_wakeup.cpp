@@ -0,0 +1,107 @@
+/*************************************************************************************/
+/*      Copyright 2015 Barcelona Supercomputing Center                               */
+/*                                                                                   */
+/*      This file is part of the NANOS++ library.                                    */
+/*                                                                                   */
+/*      NANOS++ is free software: you can redistribute it and/or modify              */
+/*      it under the terms of the GNU Lesser General Public License as published by  */
+/*      the Free Software Foundation, either version 3 of the License, or            */
+/*      (at your option) any later version.                                          */
+/*                                                                                   */
+/*      NANOS++ is distributed in the hope that it will be useful,                   */
+/*      but WITHOUT ANY WARRANTY; without even the implied warranty of               */
+/*      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                */
+/*      GNU Lesser General Public License for more details.                          */
+/*                                                                                   */
+/*      You should have received a copy of the GNU Lesser General Public License     */
+/*      along with NANOS++.  If not, see <http://www.gnu.org/licenses/>.             */
+/*************************************************************************************/
+
+/*
+<testinfo>
+test_generator="gens/core-generator -m performance -a \"--smp-workers=4 --enable-futex --futex-timeout=2000000000,--schedule=wf|--schedule=dbf\""
+test_exec_command="timeout 1m"
+</testinfo>
+*/
+
+#include "config.hpp"
+#include <iostream>
+#include <sstream>
+#include "smpprocessor.hpp"
+#include "system.hpp"
+#include "os.hpp"
+#include <unistd.h>
+#include <stdio.h>
+
+using namespace std;
+
+using namespace nanos;
+using namespace nanos::ext;
+
+#define NUM_WAVES    20
+#define NUM_TASKS    16
+
+BaseThread *master;
+Atomic<int> executed( 0 );
+Atomic<int> helped[NUM_WAVES];
+
+void task ( void *args );
+void task ( void *args )
+{
+   int wave = *( int * ) args;
+
+   usleep( 1000 );
+   if ( getMyThreadSafe() != master ) helped[wave]++;
+   executed++;
+}
+
+// Workers go idle between waves and block on their futex, with a timeout far longer than
+// the whole test: every wave needs a targeted wake-up for them to take part in it
+int main ( int argc, char **argv )
+{
+   WD *wg = getMyThreadSafe()->getCurrentWD();
+   int waves[NUM_WAVES];
+   double slowest = 0.0;
+
+   master = getMyThreadSafe();
+
+   for ( int wave = 0; wave < NUM_WAVES; wave++ ) {
+      usleep( 5000 );
+
+      waves[wave] = wave;
+      double start = OS::getMonotonicTime();
+      for ( int i = 0; i < NUM_TASKS; i++ ) {
+         WD *wd = new WD( new SMPDD( task ), sizeof( int ), __alignof__( int ), &waves[wave] );
+         wg->addWork( *wd );
+         sys.submit( *wd );
+      }
+
+      wg->waitCompletion();
+      double elapsed = OS::getMonotonicTime() - start;
+      if ( elapsed > slowest ) slowest = elapsed;
+   }
+
+   std::ostringstream stats;
+   sys.getThreadManager()->printStats( stats );
+   unsigned long long wake_ups = 0;
+   sscanf( stats.str().c_str(), "=== Thread Manager: %llu targeted wake-ups", &wake_ups );
+
+   // Without futexes (or with the master as the only thread) there is nobody to wake up
+   bool futex = !stats.str().empty() && sys.getNumWorkers() > 1;
+
+   bool ok = executed.value() == NUM_WAVES * NUM_TASKS && ( !futex || ( wake_ups > 0 && slowest < 1.0 ) );
+   for ( int wave = 0; futex && wave < NUM_WAVES; wave++ ) {
+      if ( helped[wave].value() == 0 ) {
+         cerr << "No worker took part in wave " << wave << endl;
+         ok = false;
+      }
+   }
+
+   if ( !ok ) {
+      cerr << argv[0] << ": unsuccessful (" << executed.value() << " tasks, slowest wave " << slowest << " s) " << stats.str() << endl;
+      return -1;
+   }
+
+   cerr << argv[0] << ": successful " << stats.str();
+   return 0;
+}
@@ -0,0 +1,125 @@
+/*************************************************************************************/
+/*      Copyright 2015 Barcelona Supercomputing Center                               */
+/*                                                                                   */
+/*      This file is part of the NANOS++ library.                                    */
+/*                                                                                   */
+/*      NANOS++ is free software: you can redistribute it and/or modify              */
+/*      it under the terms of the GNU Lesser General Public License as published by  */
+/*      the Free Software Foundation, either version 3 of the License, or            */
+/*      (at your option) any later version.                                          */
+/*                                                                                   */
+/*      NANOS++ is distributed in the hope that it will be useful,                   */
+/*      but WITHOUT ANY WARRANTY; without even the implied warranty of               */
+/*      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                */
+/*      GNU Lesser General Public License for more details.                          */
+/*                                                                                   */
+/*      You should have received a copy of the GNU Lesser General Public License     */
+/*      along with NANOS++.  If not, see <http://www.gnu.org/licenses/>.             */
+/*************************************************************************************/
+
+/*
+<testinfo>
+test_generator=gens/core-generator
+</testinfo>
+*/
+
+#include "config.hpp"
+#include "nanos.h"
+#include <iostream>
+#include <stdio.h>
+#include "memorymap.hpp"
+#include "os.hpp"
+
+using namespace nanos;
+
+#define NUM_CHUNKS   20000
+#define CHUNK_SIZE   64
+
+typedef MemoryMap<int> IntMap;
+
+static int value_of ( IntMap::MemChunkPair const &entry )
+{
+   return *entry.second == NULL ? -1 : **entry.second;
+}
+
+// Overlapping insertions split the chunks already in the map
+static bool check_overlaps ( void )
+{
+   IntMap map;
+   IntMap::MemChunkList added;
+
+   map.getOrAddChunk( 1000, 100, added );
+   if ( added.size() != 1 || value_of( added.front() ) != -1 ) return false;
+   *added.front().second = NEW int( 1 );
+
+   added.clear();
+   map.getOrAddChunk( 1050, 100, added );
+   for ( IntMap::MemChunkList::iterator it = added.begin(); it != added.end(); it++ ) {
+      if ( *it->second == NULL ) *it->second = NEW int( 2 );
+   }
+   if ( map.size() != 3 ) return false;
+
+   IntMap::const_iterator it = map.begin();
+   if ( it->first.getAddress() != 1000 || it->first.getLength() != 50 || *it->second != 1 ) return false;
+   it++;
+   if ( it->first.getAddress() != 1050 || it->first.getLength() != 50 || *it->second != 1 ) return false;
+   it++;
+   if ( it->first.getAddress() != 1100 || it->first.getLength() != 50 || *it->second != 2 ) return false;
+
+   IntMap::ConstMemChunkList found;
+   map.getChunk( 1025, 100, found );
+   if ( found.size() != 3 ) return false;
+
+   int *exact = map.getExactByAddress( 1100 );
+   return exact != NULL && *exact == 2 && map.getExactByAddress( 1101 ) == NULL;
+}
+
+// Many disjoint chunks: lookups go straight to the overlapping ones
+static bool check_many_chunks ( void )
+{
+   IntMap map;
+   double start = OS::getMonotonicTime();
+
+   for ( int i = 0; i < NUM_CHUNKS; i++ ) {
+      IntMap::MemChunkList added;
+      map.getOrAddChunk( ( uint64_t ) ( NUM_CHUNKS - i ) * 2 * CHUNK_SIZE, CHUNK_SIZE, added );
+      if ( added.size() != 1 || *added.front().second != NULL ) return false;
+      *added.front().second = NEW int( NUM_CHUNKS - i );
+   }
+   if ( map.size() != NUM_CHUNKS ) return false;
+
+   for ( int i = 1; i < NUM_CHUNKS; i++ ) {
+      IntMap::ConstMemChunkList found;
+      // Spans the end of chunk i, the gap and the beginning of chunk i + 1: whole chunks and the gap are returned
+      map.getChunk( ( uint64_t ) i * 2 * CHUNK_SIZE + CHUNK_SIZE / 2, 2 * CHUNK_SIZE, found );
+      if ( found.size() != 3 || *found.front().second != i || found.back().second == NULL || *found.back().second != i + 1 ) return false;
+      if ( found.front().first.getAddress() != ( uint64_t ) i * 2 * CHUNK_SIZE || found.front().first.getLength() != CHUNK_SIZE ) return false;
+      IntMap::ConstMemChunkList::const_iterator gap = ++found.begin();
+      if ( gap->second != NULL || gap->first.getLength() != CHUNK_SIZE ) return false;
+   }
+
+   for ( int i = 1; i <= NUM_CHUNKS; i += 2 ) {
+      int *value = map.getExactByAddress( ( uint64_t ) i * 2 * CHUNK_SIZE );
+      if ( value == NULL || *value != i ) return false;
+      delete value;
+      map.eraseByAddress( ( uint64_t ) i * 2 * CHUNK_SIZE );
+   }
+   if ( map.size() != NUM_CHUNKS / 2 ) return false;
+
+   std::cerr << NUM_CHUNKS << " chunks inserted, queried and half erased in " << OS::getMonotonicTime() - start << " s" << std::endl;
+   return true;
+}
+
+int main ( int argc, char **argv )
+{
+   bool check = check_overlaps() && check_many_chunks();
+
+   if ( check ) {
+      fprintf(stderr, "%s : %s\n", argv[0], "successful" );
+      return 0;
+   }
+   else {
+      fprintf(stderr, "%s: %s\n", argv[0], "unsuccessful");
+      return -1;
+   }
+}
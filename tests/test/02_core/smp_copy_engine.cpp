@@ -0,0 +1,106 @@
+/*************************************************************************************/
+/*      Copyright 2015 Barcelona Supercomputing Center                               */
+/*                                                                                   */
+/*      This file is part of the NANOS++ library.                                    */
+/*                                                                                   */
+/*      NANOS++ is free software: you can redistribute it and/or modify              */
+/*      it under the terms of the GNU Lesser General Public License as published by  */
+/*      the Free Software Foundation, either version 3 of the License, or            */
+/*      (at your option) any later version.                                          */
+/*                                                                                   */
+/*      NANOS++ is distributed in the hope that it will be useful,                   */
+/*      but WITHOUT ANY WARRANTY; without even the implied warranty of               */
+/*      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                */
+/*      GNU Lesser General Public License for more details.                          */
+/*                                                                                   */
+/*      You should have received a copy of the GNU Lesser General Public License     */
+/*      along with NANOS++.  If not, see <http://www.gnu.org/licenses/>.             */
+/*************************************************************************************/
+
+/*
+<testinfo>
+test_generator=gens/core-generator
+</testinfo>
+*/
+
+#include "config.hpp"
+#include "nanos.h"
+#include <iostream>
+#include <stdio.h>
+#include <string.h>
+#include "smpcopyengine_decl.hpp"
+
+using namespace nanos;
+using namespace nanos::ext;
+
+#define BUFFER_SIZE  ( 64 * 1024 )
+
+static char src[BUFFER_SIZE + 64];
+static char dst[BUFFER_SIZE + 64];
+
+static void fill ( void )
+{
+   for ( int i = 0; i < BUFFER_SIZE + 64; i++ ) {
+      src[i] = (char) ( i * 31 + 7 );
+      dst[i] = 0;
+   }
+}
+
+// Copies 'count' rows of 'len' bytes with stride 'ld', at an offset of both buffers, and
+// checks that nothing outside the rows is touched
+static bool check_copy ( size_t offset, size_t len, size_t count, size_t ld, bool streaming )
+{
+   fill();
+   SMPCopyEngine::copy( dst + offset, src + offset, len, count, ld, streaming );
+
+   for ( size_t i = 0; i < BUFFER_SIZE + 64; i++ ) {
+      bool copied = false;
+      if ( i >= offset ) {
+         size_t pos = i - offset;
+         size_t row = ( count == 1 || ld == 0 ) ? 0 : pos / ld;
+         size_t col = ( count == 1 || ld == 0 ) ? pos : pos % ld;
+         copied = row < count && col < len;
+      }
+      if ( dst[i] != ( copied ? src[i] : 0 ) ) {
+         std::cerr << "Wrong byte " << i << " copying " << count << " rows of " << len << " bytes (ld " << ld
+                   << ", offset " << offset << ", streaming " << streaming << ")" << std::endl;
+         return false;
+      }
+   }
+   return true;
+}
+
+int main ( int argc, char **argv )
+{
+   const size_t offsets[] = { 0, 1, 5, 15, 16 };
+   const size_t lengths[] = { 1, 15, 16, 17, 63, 64, 65, 1000, 4096, 40000 };
+   const size_t rows[] = { 4, 8, 16, 32, 64, 128, 100, 256, 300 };
+   bool check = true;
+
+   // Contiguous copies, regular and streaming
+   for ( size_t o = 0; o < sizeof( offsets ) / sizeof( size_t ); o++ ) {
+      for ( size_t l = 0; l < sizeof( lengths ) / sizeof( size_t ); l++ ) {
+         check = check && check_copy( offsets[o], lengths[l], 1, 0, false );
+         check = check && check_copy( offsets[o], lengths[l], 1, 0, true );
+      }
+   }
+
+   // Strided rows: fixed-size kernels, generic rows and streaming rows
+   for ( size_t o = 0; o < sizeof( offsets ) / sizeof( size_t ); o++ ) {
+      for ( size_t r = 0; r < sizeof( rows ) / sizeof( size_t ); r++ ) {
+         check = check && check_copy( offsets[o], rows[r], 50, rows[r] * 2 + 8, false );
+         check = check && check_copy( offsets[o], rows[r], 50, rows[r] * 2 + 8, true );
+      }
+      // Contiguous rows
+      check = check && check_copy( offsets[o], 64, 50, 64, true );
+   }
+
+   if ( check ) {
+      fprintf(stderr, "%s : %s\n", argv[0], "successful" );
+      return 0;
+   }
+   else {
+      fprintf(stderr, "%s: %s\n", argv[0], "unsuccessful");
+      return -1;
+   }
+}
@@ -0,0 +1,103 @@
+/*************************************************************************************/
+/*      Copyright 2015 Barcelona Supercomputing Center                               */
+/*                                                                                   */
+/*      This file is part of the NANOS++ library.                                    */
+/*                                                                                   */
+/*      NANOS++ is free software: you can redistribute it and/or modify              */
+/*      it under the terms of the GNU Lesser General Public License as published by  */
+/*      the Free Software Foundation, either version 3 of the License, or            */
+/*      (at your option) any later version.                                          */
+/*                                                                                   */
+/*      NANOS++ is distributed in the hope that it will be useful,                   */
+/*      but WITHOUT ANY WARRANTY; without even the implied warranty of               */
+/*      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                */
+/*      GNU Lesser General Public License for more details.                          */
+/*                                                                                   */
+/*      You should have received a copy of the GNU Lesser General Public License     */
+/*      along with NANOS++.  If not, see <http://www.gnu.org/licenses/>.             */
+/*************************************************************************************/
+
+/*
+<testinfo>
+test_generator=gens/core-generator
+</testinfo>
+*/
+
+#include "config.hpp"
+#include "nanos.h"
+#include <iostream>
+#include "system.hpp"
+#include "task_reduction.hpp"
+
+using namespace std;
+
+using namespace nanos;
+
+#define NUM_COPIES    13
+#define SKIPPED_COPY  5
+#define VECTOR_SIZE   100000
+
+int A[VECTOR_SIZE];
+
+void init_int ( void *priv, void *orig );
+void init_int ( void *priv, void *orig )
+{
+   *(int *) priv = 0;
+}
+
+void red_int ( void *obj1, void *obj2 );
+void red_int ( void *obj1, void *obj2 )
+{
+   *(int *) obj1 += *(int *) obj2;
+}
+
+// Fills every private copy but one with (id+1) and reduces them into A
+static bool check_reduction ( bool lazy )
+{
+   for ( int i = 0; i < VECTOR_SIZE; i++ ) A[i] = 1;
+
+   TaskReduction tr( A, init_int, red_int, sizeof( A ), sizeof( int ), NUM_COPIES, 0, lazy, /* tree */ true );
+
+   int expected = 1;
+   for ( size_t id = 0; id < NUM_COPIES; id++ ) {
+      if ( id == SKIPPED_COPY ) continue;
+
+      int *priv = (int *) tr.get( id );
+      if ( priv == NULL ) priv = (int *) tr.allocate( id );
+      tr.initialize( id );
+
+      if ( !lazy && !tr.has( priv ) ) return false;
+      if ( ( (uintptr_t) priv & 63 ) != 0 ) return false;
+
+      for ( int i = 0; i < VECTOR_SIZE; i++ ) {
+         if ( priv[i] != 0 ) return false;
+         priv[i] = id + 1;
+      }
+      expected += id + 1;
+   }
+
+   tr.reduce();
+
+   for ( int i = 0; i < VECTOR_SIZE; i++ ) if ( A[i] != expected ) return false;
+
+   // Copies are not initialized anymore: a second reduction leaves A unchanged
+   tr.reduce();
+
+   for ( int i = 0; i < VECTOR_SIZE; i++ ) if ( A[i] != expected ) return false;
+
+   return true;
+}
+
+int main ( int argc, char **argv )
+{
+   bool check = check_reduction( false ) && check_reduction( true );
+
+   if ( check ) {
+      fprintf(stderr, "%s : %s\n", argv[0], "successful");
+      return 0;
+   }
+   else {
+      fprintf(stderr, "%s: %s\n", argv[0], "unsuccessful");
+      return -1;
+   }
+}
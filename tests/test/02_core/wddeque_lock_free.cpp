@@ -0,0 +1,130 @@
+/*************************************************************************************/
+/*      Copyright 2015 Barcelona Supercomputing Center                               */
+/*                                                                                   */
+/*      This file is part of the NANOS++ library.                                    */
+/*                                                                                   */
+/*      NANOS++ is free software: you can redistribute it and/or modify              */
+/*      it under the terms of the GNU Lesser General Public License as published by  */
+/*      the Free Software Foundation, either version 3 of the License, or            */
+/*      (at your option) any later version.                                          */
+/*                                                                                   */
+/*      NANOS++ is distributed in the hope that it will be useful,                   */
+/*      but WITHOUT ANY WARRANTY; without even the implied warranty of               */
+/*      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                */
+/*      GNU Lesser General Public License for more details.                          */
+/*                                                                                   */
+/*      You should have received a copy of the GNU Lesser General Public License     */
+/*      along with NANOS++.  If not, see <http://www.gnu.org/licenses/>.             */
+/*************************************************************************************/
+
+/*
+<testinfo>
+test_generator="gens/core-generator -m performance -a \"--smp-workers=4\""
+test_exec_command="timeout 1m"
+</testinfo>
+*/
+
+#include "config.hpp"
+#include <iostream>
+#include "smpprocessor.hpp"
+#include "system.hpp"
+#include "wddeque.hpp"
+
+using namespace std;
+
+using namespace nanos;
+using namespace nanos::ext;
+
+#define NUM_WDS       20000
+#define NUM_THIEVES   3
+
+// Small, so that the queue grows while it is being stolen from
+#define CAPACITY      16
+
+WDChaseLevDeque *queue;
+int indexes[NUM_WDS];
+Atomic<int> taken[NUM_WDS];
+Atomic<int> stolen;
+volatile bool done = false;
+
+static void take ( WD *wd )
+{
+   taken[ *( int * ) wd->getData() ]++;
+}
+
+void task ( void *args );
+void task ( void *args ) {}
+
+// Steals from the top of the queue until the owner has finished and it is empty
+void thief ( void *args );
+void thief ( void *args )
+{
+   for ( ; ; ) {
+      bool finished = done;
+      WD *wd = queue->pop_front( getMyThreadSafe() );
+      if ( wd != NULL ) {
+         take( wd );
+         stolen++;
+      } else if ( finished ) {
+         break;
+      }
+   }
+}
+
+// The owner pushes and pops at the bottom of the queue while the thieves steal from the top:
+// every WD must be taken exactly once, and the ready task count must be back where it was
+static bool check_lock_free ( void )
+{
+   BaseThread *owner = getMyThreadSafe();
+   WD *wg = owner->getCurrentWD();
+   int ready = sys.getReadyNum();
+   WD *wds[NUM_WDS];
+
+   queue = new WDChaseLevDeque( owner->getTeamData()->getScheduleData(), true, CAPACITY );
+
+   for ( int i = 0; i < NUM_WDS; i++ ) {
+      indexes[i] = i;
+      wds[i] = new WD( new SMPDD( task ), sizeof( int ), __alignof__( int ), &indexes[i] );
+   }
+
+   for ( int i = 0; i < NUM_THIEVES; i++ ) {
+      WD *wd = new WD( new SMPDD( thief ) );
+      wg->addWork( *wd );
+      sys.submit( *wd );
+   }
+
+   for ( int i = 0; i < NUM_WDS; i++ ) {
+      queue->push_front( wds[i] );
+      if ( i % 3 == 2 ) {
+         WD *wd = queue->pop_front( owner );
+         if ( wd != NULL ) take( wd );
+      }
+   }
+
+   done = true;
+   WD *wd;
+   while ( ( wd = queue->pop_front( owner ) ) != NULL ) take( wd );
+
+   wg->waitCompletion();
+
+   bool check = queue->empty() && sys.getReadyNum() == ready;
+   for ( int i = 0; i < NUM_WDS; i++ ) {
+      if ( taken[i].value() != 1 ) {
+         cerr << "WD " << i << " was taken " << taken[i].value() << " times" << endl;
+         check = false;
+      }
+   }
+   delete queue;
+
+   return check;
+}
+
+int main ( int argc, char **argv )
+{
+   if ( check_lock_free() ) {
+      cerr << argv[0] << ": successful (" << stolen.value() << " WDs stolen)" << endl;
+      return 0;
+   }
+   cerr << argv[0] << ": unsuccessful" << endl;
+   return -1;
+}
@@ -0,0 +1,150 @@
+/*************************************************************************************/
+/*      Copyright 2015 Barcelona Supercomputing Center                               */
+/*                                                                                   */
+/*      This file is part of the NANOS++ library.                                    */
+/*                                                                                   */
+/*      NANOS++ is free software: you can redistribute it and/or modify              */
+/*      it under the terms of the GNU Lesser General Public License as published by  */
+/*      the Free Software Foundation, either version 3 of the License, or            */
+/*      (at your option) any later version.                                          */
+/*                                                                                   */
+/*      NANOS++ is distributed in the hope that it will be useful,                   */
+/*      but WITHOUT ANY WARRANTY; without even the implied warranty of               */
+/*      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                */
+/*      GNU Lesser General Public License for more details.                          */
+/*                                                                                   */
+/*      You should have received a copy of the GNU Lesser General Public License     */
+/*      along with NANOS++.  If not, see <http://www.gnu.org/licenses/>.             */
+/*************************************************************************************/
+
+/*
+<testinfo>
+test_generator="gens/core-generator -a \"--smp-workers=2\""
+</testinfo>
+*/
+
+#include "config.hpp"
+#include <iostream>
+#include "smpprocessor.hpp"
+#include "system.hpp"
+#include "wddeque.hpp"
+
+using namespace std;
+
+using namespace nanos;
+using namespace nanos::ext;
+
+#define NUM_WDS   6
+
+void task ( void *args );
+void task ( void *args ) {}
+
+static WD * new_wd ( WD::PriorityType priority )
+{
+   WD *wd = new WD( new SMPDD( task ) );
+   wd->setPriority( priority );
+   return wd;
+}
+
+// Pops every WD of the queue and checks they come out in the 'expected' order
+static bool check_order ( WDPriorityQueue<> &queue, BaseThread *thread, WD **expected, int n )
+{
+   bool check = true;
+   for ( int i = 0; i < n; i++ ) {
+      if ( queue.pop_front( thread ) != expected[i] ) {
+         cerr << "Unexpected WD at position " << i << endl;
+         check = false;
+      }
+   }
+   return check && queue.empty();
+}
+
+// Ties are FIFO with push_back and LIFO with push_front, higher priorities go first
+static bool check_ties ( BaseThread *thread )
+{
+   WDPriorityQueue<> queue;
+   WD *wds[NUM_WDS];
+
+   for ( int i = 0; i < NUM_WDS; i++ ) wds[i] = new_wd( i < 3 ? 1 : 2 );
+
+   queue.push_back( wds[0] );
+   queue.push_back( wds[1] );
+   queue.push_front( wds[2] );
+   queue.push_front( wds[3] );
+   queue.push_back( wds[4] );
+   queue.push_front( wds[5] );
+
+   WD *expected[NUM_WDS] = { wds[5], wds[3], wds[4], wds[2], wds[0], wds[1] };
+   return check_order( queue, thread, expected, NUM_WDS );
+}
+
+// A reverse queue dequeues lower priorities first
+static bool check_reverse ( BaseThread *thread )
+{
+   WDPriorityQueue<> queue( true /* enableDeviceCounter */, true /* reverse */ );
+   WD *wds[NUM_WDS];
+
+   for ( int i = 0; i < NUM_WDS; i++ ) {
+      wds[i] = new_wd( NUM_WDS - i );
+      queue.push_back( wds[i] );
+   }
+
+   WD *expected[NUM_WDS] = { wds[5], wds[4], wds[3], wds[2], wds[1], wds[0] };
+   return check_order( queue, thread, expected, NUM_WDS );
+}
+
+// A WD whose priority changes moves to its new place once reordered
+static bool check_reorder ( BaseThread *thread )
+{
+   WDPriorityQueue<> queue;
+   WD *wds[NUM_WDS];
+
+   for ( int i = 0; i < NUM_WDS; i++ ) {
+      wds[i] = new_wd( i );
+      queue.push_back( wds[i] );
+   }
+
+   wds[1]->setPriority( NUM_WDS );
+   wds[5]->setPriority( 0 );
+   bool check = queue.reorderWD( wds[1] ) && queue.reorderWD( wds[5] );
+
+   // wds[5] was reordered after wds[0], which had the same priority
+   WD *expected[NUM_WDS] = { wds[1], wds[4], wds[3], wds[2], wds[0], wds[5] };
+   return check && check_order( queue, thread, expected, NUM_WDS );
+}
+
+// WDs not fulfilling the constraints are skipped without changing the order of the others
+static bool check_constraints ( BaseThread *thread )
+{
+   BaseThread *other = sys.getWorker( 0 ) != thread ? sys.getWorker( 0 ) : sys.getWorker( 1 );
+   WDPriorityQueue<> queue;
+   WD *wds[NUM_WDS];
+
+   for ( int i = 0; i < NUM_WDS; i++ ) {
+      wds[i] = new_wd( i );
+      if ( i % 2 == 1 ) wds[i]->tieTo( *other );
+      queue.push_back( wds[i] );
+   }
+
+   WD *expected[NUM_WDS / 2] = { wds[4], wds[2], wds[0] };
+   bool check = true;
+   for ( int i = 0; i < NUM_WDS / 2; i++ ) {
+      if ( queue.pop_front( thread ) != expected[i] ) check = false;
+   }
+   check = check && queue.size() == NUM_WDS / 2 && queue.pop_front( thread ) == NULL;
+
+   WD *tied[NUM_WDS / 2] = { wds[5], wds[3], wds[1] };
+   return check && check_order( queue, other, tied, NUM_WDS / 2 );
+}
+
+int main ( int argc, char **argv )
+{
+   BaseThread *thread = getMyThreadSafe();
+
+   if ( check_ties( thread ) && check_reverse( thread ) && check_reorder( thread ) && check_constraints( thread ) ) {
+      cerr << argv[0] << ": successful" << endl;
+      return 0;
+   }
+   cerr << argv[0] << ": unsuccessful" << endl;
+   return -1;
+}
@@ -0,0 +1,82 @@
+/*************************************************************************************/
+/*      Copyright 2015 Barcelona Supercomputing Center                               */
+/*                                                                                   */
+/*      This file is part of the NANOS++ library.                                    */
+/*                                                                                   */
+/*      NANOS++ is free software: you can redistribute it and/or modify              */
+/*      it under the terms of the GNU Lesser General Public License as published by  */
+/*      the Free Software Foundation, either version 3 of the License, or            */
+/*      (at your option) any later version.                                          */
+/*                                                                                   */
+/*      NANOS++ is distributed in the hope that it will be useful,                   */
+/*      but WITHOUT ANY WARRANTY; without even the implied warranty of               */
+/*      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                */
+/*      GNU Lesser General Public License for more details.                          */
+/*                                                                                   */
+/*      You should have received a copy of the GNU Lesser General Public License     */
+/*      along with NANOS++.  If not, see <http://www.gnu.org/licenses/>.             */
+/*************************************************************************************/
+/*
+<testinfo>
+test_generator=gens/core-generator
+</testinfo>
+*/
+
+#include "config.hpp"
+#include <iostream>
+#include "smpprocessor.hpp"
+#include "system.hpp"
+#include "wddeque.hpp"
+
+using namespace std;
+
+using namespace nanos;
+using namespace nanos::ext;
+
+#define NUM_WDS   10
+#define TIED_WD   7
+
+void task ( void *args );
+void task ( void *args ) {}
+
+// A steal takes the last WD to run it and moves up to half of the queue, skipping tied WDs
+static bool check_steal_half ( void )
+{
+   BaseThread *thread = getMyThreadSafe();
+   WDDeque victim;
+   WDDeque thief;
+   WD *wds[NUM_WDS];
+
+   for ( int i = 0; i < NUM_WDS; i++ ) {
+      wds[i] = new WD( new SMPDD( task ) );
+      if ( i == TIED_WD ) wds[i]->tieTo( *thread );
+      victim.push_back( wds[i] );
+   }
+
+   bool check = victim.stealHalf( thread, thief ) == wds[9] &&
+                victim.size() == NUM_WDS / 2 && thief.size() == NUM_WDS / 2 - 1 &&
+                wds[TIED_WD]->getMyQueue() == &victim && wds[8]->getMyQueue() == &thief;
+
+   // The oldest moved WD is at the back of the thief queue, where it will be stolen first
+   check = check && thief.pop_back( thread ) == wds[8] && thief.pop_front( thread ) == wds[4];
+
+   while ( thief.pop_front( thread ) != NULL );
+   while ( victim.pop_front( thread ) != NULL );
+
+   // A single WD is just taken
+   WDDeque single;
+   single.push_back( wds[0] );
+   check = check && single.stealHalf( thread, thief ) == wds[0] && single.empty() && thief.empty();
+
+   return check && victim.empty();
+}
+
+int main ( int argc, char **argv )
+{
+   if ( check_steal_half() ) {
+      cerr << argv[0] << ": successful" << endl;
+      return 0;
+   }
+   cerr << argv[0] << ": unsuccessful" << endl;
+   return -1;
+}
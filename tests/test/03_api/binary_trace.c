@@ -0,0 +1,214 @@
+/*************************************************************************************/
+/*      Copyright 2015 Barcelona Supercomputing Center                               */
+/*                                                                                   */
+/*      This file is part of the NANOS++ library.                                    */
+/*                                                                                   */
+/*      NANOS++ is free software: you can redistribute it and/or modify              */
+/*      it under the terms of the GNU Lesser General Public License as published by  */
+/*      the Free Software Foundation, either version 3 of the License, or            */
+/*      (at your option) any later version.                                          */
+/*                                                                                   */
+/*      NANOS++ is distributed in the hope that it will be useful,                   */
+/*      but WITHOUT ANY WARRANTY; without even the implied warranty of               */
+/*      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                */
+/*      GNU Lesser General Public License for more details.                          */
+/*                                                                                   */
+/*      You should have received a copy of the GNU Lesser General Public License     */
+/*      along with NANOS++.  If not, see <http://www.gnu.org/licenses/>.             */
+/*************************************************************************************/
+/*
+<testinfo>
+test_generator=gens/api-generator
+</testinfo>
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <nanos.h>
+
+#define NUM_TASKS   50
+
+void task ( void *args );
+
+nanos_smp_args_t task_device_args = { task };
+
+struct nanos_const_wd_definition_1
+{
+     nanos_const_wd_definition_t base;
+     nanos_device_t devices[1];
+};
+
+struct nanos_const_wd_definition_1 task_data =
+{
+   {
+     { .mandatory_creation = true, .tied = false},
+     __alignof__( int ), 0, 1, 0, "task"
+   },
+   {
+      { nanos_smp_factory, &task_device_args }
+   }
+};
+
+nanos_wd_dyn_props_t dyn_props = {0};
+
+void task ( void *args )
+{
+   usleep ( *(int *) args );
+}
+
+static int run_tasks ( void )
+{
+   int i;
+   for ( i = 0; i < NUM_TASKS; i++ ) {
+      nanos_wd_t wd = NULL;
+      int *value = NULL;
+
+      NANOS_SAFE( nanos_create_wd_compact ( &wd, &task_data.base, &dyn_props, sizeof( int ),
+                                            (void **) &value, nanos_current_wd(), NULL, NULL ) );
+      *value = 100;
+      NANOS_SAFE( nanos_submit( wd, 0, 0, 0 ) );
+   }
+   NANOS_SAFE( nanos_wg_wait_completion( nanos_current_wd(), false ) );
+   return 0;
+}
+
+#ifdef NANOS_INSTRUMENTATION_ENABLED
+static char * read_file ( const char *name )
+{
+   FILE *f = fopen( name, "r" );
+   long len;
+   char *contents;
+
+   if ( f == NULL ) {
+      fprintf( stderr, "Cannot open %s\n", name );
+      return NULL;
+   }
+   fseek( f, 0, SEEK_END );
+   len = ftell( f );
+   fseek( f, 0, SEEK_SET );
+   contents = (char *) malloc( len + 1 );
+   len = fread( contents, 1, len, f );
+   contents[len] = '\0';
+   fclose( f );
+   return contents;
+}
+
+static int count ( const char *text, const char *what )
+{
+   int n = 0;
+   const char *p = text;
+   while ( ( p = strstr( p, what ) ) != NULL ) {
+      n++;
+      p += strlen( what );
+   }
+   return n;
+}
+
+static int check_count ( const char *file, const char *what, int expected )
+{
+   char *contents = read_file( file );
+   int n;
+
+   if ( contents == NULL ) return 0;
+   n = count( contents, what );
+   free( contents );
+   if ( n == expected ) return 1;
+   fprintf( stderr, "Found %d '%s' in %s instead of %d\n", n, what, file, expected );
+   return 0;
+}
+
+static void remove_files ( const char *prefix, int streams )
+{
+   const char *suffixes[] = { ".dict", ".prv", ".pcf", ".row", ".json" };
+   char file[128];
+   int i;
+
+   for ( i = 0; i < (int) ( sizeof( suffixes ) / sizeof( suffixes[0] ) ); i++ ) {
+      snprintf( file, sizeof( file ), "%s%s", prefix, suffixes[i] );
+      unlink( file );
+   }
+   for ( i = 0; i < streams; i++ ) {
+      snprintf( file, sizeof( file ), "%s.%d.bin", prefix, i );
+      unlink( file );
+   }
+}
+
+// The trace is written when the runtime finishes, so the tasks run in a child process whose
+// trace is then converted to Paraver and JSON: both must have every stream and every task creation
+static int check_trace ( const char *self )
+{
+   char prefix[64], file[128], args[1024], what[128];
+   const char *nx_args = getenv( "NX_ARGS" );
+   const char *converter = getenv( "NANOX_BINTRACE" );
+   char *dict, *line;
+   int streams = 0, key = 0, ok, i;
+
+   snprintf( prefix, sizeof( prefix ), "bintrace_%d", (int) getpid() );
+   snprintf( args, sizeof( args ), "%s --instrumentation=binary_trace --bintrace-prefix=%s --instrument-enable=create-wd-id",
+             nx_args ? nx_args : "", prefix );
+   setenv( "NX_ARGS", args, 1 );
+   setenv( "BINARY_TRACE_CHILD", "1", 1 );
+
+   if ( system( self ) != 0 ) {
+      fprintf( stderr, "The traced run failed\n" );
+      return 1;
+   }
+
+   // The dictionary gives the number of streams and the key of the task creation events
+   snprintf( file, sizeof( file ), "%s.dict", prefix );
+   dict = read_file( file );
+   if ( dict == NULL ) return 1;
+   for ( line = strtok( dict, "\n" ); line != NULL; line = strtok( NULL, "\n" ) ) {
+      sscanf( line, "streams %d", &streams );
+      if ( strstr( line, " create-wd-id " ) != NULL ) sscanf( line, "key %d", &key );
+   }
+   free( dict );
+   if ( streams < 1 || key == 0 ) {
+      fprintf( stderr, "Wrong dictionary: %d streams, create-wd-id key %d\n", streams, key );
+      remove_files( prefix, streams );
+      return 1;
+   }
+   for ( i = 0; i < streams; i++ ) {
+      snprintf( file, sizeof( file ), "%s.%d.bin", prefix, i );
+      if ( access( file, R_OK ) != 0 ) {
+         fprintf( stderr, "Missing stream %s\n", file );
+         remove_files( prefix, streams );
+         return 1;
+      }
+   }
+
+   snprintf( args, sizeof( args ), "%s %s > /dev/null && %s --json %s > /dev/null",
+             converter ? converter : "nanox-bintrace", prefix, converter ? converter : "nanox-bintrace", prefix );
+   if ( system( args ) != 0 ) {
+      fprintf( stderr, "The conversion failed\n" );
+      remove_files( prefix, streams );
+      return 1;
+   }
+
+   snprintf( file, sizeof( file ), "%s.row", prefix );
+   snprintf( what, sizeof( what ), "LEVEL THREAD SIZE %d\n", streams );
+   ok = check_count( file, what, 1 );
+
+   // Events raised at the same time are merged in one Paraver record, so the event types are counted
+   snprintf( file, sizeof( file ), "%s.prv", prefix );
+   snprintf( what, sizeof( what ), ":%d:", 9200000 + key );
+   ok = check_count( file, what, NUM_TASKS ) && ok;
+
+   snprintf( file, sizeof( file ), "%s.json", prefix );
+   ok = check_count( file, "\"ph\":\"M\"", streams ) && ok;
+   ok = check_count( file, "\"name\":\"Create WD Id:\",\"cat\":\"point\"", NUM_TASKS ) && ok;
+
+   remove_files( prefix, streams );
+   return ok ? 0 : 1;
+}
+#endif
+
+int main ( int argc, char **argv )
+{
+#ifdef NANOS_INSTRUMENTATION_ENABLED
+   if ( getenv( "BINARY_TRACE_CHILD" ) == NULL ) return check_trace( argv[0] );
+#endif
+   return run_tasks();
+}
@@ -0,0 +1,116 @@
+/*************************************************************************************/
+/*      Copyright 2015 Barcelona Supercomputing Center                               */
+/*                                                                                   */
+/*      This file is part of the NANOS++ library.                                    */
+/*                                                                                   */
+/*      NANOS++ is free software: you can redistribute it and/or modify              */
+/*      it under the terms of the GNU Lesser General Public License as published by  */
+/*      the Free Software Foundation, either version 3 of the License, or            */
+/*      (at your option) any later version.                                          */
+/*                                                                                   */
+/*      NANOS++ is distributed in the hope that it will be useful,                   */
+/*      but WITHOUT ANY WARRANTY; without even the implied warranty of               */
+/*      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                */
+/*      GNU Lesser General Public License for more details.                          */
+/*                                                                                   */
+/*      You should have received a copy of the GNU Lesser General Public License     */
+/*      along with NANOS++.  If not, see <http://www.gnu.org/licenses/>.             */
+/*************************************************************************************/
+
+/*
+<testinfo>
+test_generator="gens/api-generator -a \"--lock-pool-size=1|--lock-pool-grow|--lock-pool-grow --lock-pool-max-locks=100\""
+</testinfo>
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <nanos.h>
+
+#define NUM_COUNTERS 1024
+#define NUM_TASKS    64
+
+int counters[NUM_COUNTERS];
+
+typedef struct {
+   int first;
+} task_data_t;
+
+void increment ( void *args );
+void increment ( void *args )
+{
+   task_data_t *hargs = (task_data_t *) args;
+   int i;
+
+   for ( i = 0; i < NUM_COUNTERS; i++ ) {
+      int *counter = &counters[( hargs->first + i ) % NUM_COUNTERS];
+      nanos_lock_t *lock;
+      NANOS_SAFE( nanos_get_lock_address( counter, &lock ) );
+      NANOS_SAFE( nanos_set_lock( lock ) );
+      *counter = *counter + 1;
+      NANOS_SAFE( nanos_unset_lock( lock ) );
+   }
+}
+
+nanos_smp_args_t test_device_arg_1 = { increment };
+
+/* ************** CONSTANT PARAMETERS IN WD CREATION ******************** */
+
+struct nanos_const_wd_definition_1
+{
+     nanos_const_wd_definition_t base;
+     nanos_device_t devices[1];
+};
+
+struct nanos_const_wd_definition_1 const_data1 = 
+{
+   {{
+      .mandatory_creation = true,
+      .tied = false},
+   __alignof__(task_data_t),
+   0,
+   1,
+   0,NULL},
+   {
+      {
+         nanos_smp_factory,
+         &test_device_arg_1
+      }
+   }
+};
+
+int main ( int argc, char **argv )
+{
+   nanos_wd_dyn_props_t dyn_props = {0};
+   nanos_lock_t *first_lock, *lock;
+   int i;
+
+   NANOS_SAFE( nanos_get_lock_address( &counters[0], &first_lock ) );
+
+   for ( i = 0; i < NUM_TASKS; i++ ) {
+      nanos_wd_t wd = NULL;
+      task_data_t *task_data = NULL;
+      NANOS_SAFE( nanos_create_wd_compact ( &wd, &const_data1.base, &dyn_props, sizeof(task_data_t),
+                                            (void **) &task_data, nanos_current_wd(), NULL, NULL ) );
+      task_data->first = i * ( NUM_COUNTERS / NUM_TASKS );
+      NANOS_SAFE( nanos_submit( wd, 0, NULL, NULL ) );
+   }
+
+   NANOS_SAFE( nanos_wg_wait_completion( nanos_current_wd(), false ) );
+
+   // An address must keep its lock even if the pool has changed meanwhile
+   NANOS_SAFE( nanos_get_lock_address( &counters[0], &lock ) );
+   if ( lock != first_lock ) {
+      printf( "Error: the lock of an address has changed\n" );
+      return 1;
+   }
+
+   for ( i = 0; i < NUM_COUNTERS; i++ ) {
+      if ( counters[i] != NUM_TASKS ) {
+         printf( "Error: counter %d is %d (expected %d)\n", i, counters[i], NUM_TASKS );
+         return 1;
+      }
+   }
+
+   return 0;
+}
@@ -23,7 +23,7 @@
 
 /*
 <testinfo>
-  test_generator=gens/api-omp-generator
+  test_generator="gens/api-omp-generator -a \"--omp-dynamic-ws=dynamic_for|--omp-dynamic-ws=steal_for\""
 </testinfo>
 */
 
@@ -23,7 +23,7 @@
 
 /*
 <testinfo>
-  test_generator=gens/api-omp-generator
+  test_generator="gens/api-omp-generator -a \"--omp-guided-ws=guided_for|--omp-guided-ws=steal_for\""
 </testinfo>
 */
 
@@ -0,0 +1,158 @@
+/*************************************************************************************/
+/*      Copyright 2015 Barcelona Supercomputing Center                               */
+/*                                                                                   */
+/*      This file is part of the NANOS++ library.                                    */
+/*                                                                                   */
+/*      NANOS++ is free software: you can redistribute it and/or modify              */
+/*      it under the terms of the GNU Lesser General Public License as published by  */
+/*      the Free Software Foundation, either version 3 of the License, or            */
+/*      (at your option) any later version.                                          */
+/*                                                                                   */
+/*      NANOS++ is distributed in the hope that it will be useful,                   */
+/*      but WITHOUT ANY WARRANTY; without even the implied warranty of               */
+/*      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                */
+/*      GNU Lesser General Public License for more details.                          */
+/*                                                                                   */
+/*      You should have received a copy of the GNU Lesser General Public License     */
+/*      along with NANOS++.  If not, see <http://www.gnu.org/licenses/>.             */
+/*************************************************************************************/
+/*
+<testinfo>
+test_generator=gens/api-generator
+</testinfo>
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <nanos.h>
+
+#define NUM_OUTER   8
+#define NUM_INNER   4
+
+typedef struct {
+   int value;
+} task_data_t;
+
+void inner_task ( void *args );
+void outer_task ( void *args );
+
+nanos_smp_args_t inner_device_args = { inner_task };
+nanos_smp_args_t outer_device_args = { outer_task };
+
+struct nanos_const_wd_definition_1
+{
+     nanos_const_wd_definition_t base;
+     nanos_device_t devices[1];
+};
+
+struct nanos_const_wd_definition_1 inner_data =
+{
+   {
+     { .mandatory_creation = true, .tied = false},
+     __alignof__( task_data_t ), 0, 1, 0, "inner"
+   },
+   {
+      { nanos_smp_factory, &inner_device_args }
+   }
+};
+
+struct nanos_const_wd_definition_1 outer_data =
+{
+   {
+     { .mandatory_creation = true, .tied = false},
+     __alignof__( task_data_t ), 0, 1, 0, "outer"
+   },
+   {
+      { nanos_smp_factory, &outer_device_args }
+   }
+};
+
+nanos_wd_dyn_props_t dyn_props = {0};
+
+static void create_task ( struct nanos_const_wd_definition_1 *def, int value )
+{
+   nanos_wd_t wd = NULL;
+   task_data_t *task_data = NULL;
+
+   NANOS_SAFE( nanos_create_wd_compact ( &wd, &def->base, &dyn_props, sizeof( task_data_t ),
+                                         (void **) &task_data, nanos_current_wd(), NULL, NULL ) );
+   task_data->value = value;
+   NANOS_SAFE( nanos_submit( wd, 0, 0, 0 ) );
+}
+
+void inner_task ( void *args )
+{
+   usleep ( ( (task_data_t *) args )->value );
+}
+
+// Untied tasks that wait for their children: they may be resumed by a thread other than the
+// one that started them, and every one must still be accounted once
+void outer_task ( void *args )
+{
+   int i;
+   for ( i = 0; i < NUM_INNER; i++ ) create_task( &inner_data, 200 );
+   NANOS_SAFE( nanos_wg_wait_completion( nanos_current_wd(), false ) );
+}
+
+static int run_tasks ( void )
+{
+   int i;
+   for ( i = 0; i < NUM_OUTER; i++ ) create_task( &outer_data, 0 );
+   NANOS_SAFE( nanos_wg_wait_completion( nanos_current_wd(), false ) );
+   return 0;
+}
+
+#ifdef NANOS_INSTRUMENTATION_ENABLED
+static int count_is ( const char *profile, const char *name, int count )
+{
+   char expected[128];
+   snprintf( expected, sizeof( expected ), "\"name\": \"%s\", \"count\": %d,", name, count );
+   if ( strstr( profile, expected ) != NULL ) return 1;
+   fprintf( stderr, "Task type %s was not executed %d times in the profile:\n%s\n", name, count, profile );
+   return 0;
+}
+
+// The summary is written when the runtime finishes, so the tasks run in a child process
+static int check_profile ( const char *self )
+{
+   char file[64], args[1024];
+   static char profile[65536];
+   const char *nx_args = getenv( "NX_ARGS" );
+   FILE *f;
+   size_t len;
+   int ok;
+
+   snprintf( file, sizeof( file ), "task_profile_%d.json", (int) getpid() );
+   snprintf( args, sizeof( args ), "%s --instrumentation=task_profile --task-profile-file=%s", nx_args ? nx_args : "", file );
+   setenv( "NX_ARGS", args, 1 );
+   setenv( "TASK_PROFILE_CHILD", "1", 1 );
+
+   if ( system( self ) != 0 ) {
+      fprintf( stderr, "The profiled run failed\n" );
+      return 1;
+   }
+
+   f = fopen( file, "r" );
+   if ( f == NULL ) {
+      fprintf( stderr, "No profile written to %s\n", file );
+      return 1;
+   }
+   len = fread( profile, 1, sizeof( profile ) - 1, f );
+   profile[len] = '\0';
+   fclose( f );
+   unlink( file );
+
+   ok = count_is( profile, "outer", NUM_OUTER ) && count_is( profile, "inner", NUM_OUTER * NUM_INNER );
+   return ok ? 0 : 1;
+}
+#endif
+
+int main ( int argc, char **argv )
+{
+#ifdef NANOS_INSTRUMENTATION_ENABLED
+   if ( getenv( "TASK_PROFILE_CHILD" ) == NULL ) return check_profile( argv[0] );
+#endif
+   return run_tasks();
+}
@@ -19,7 +19,7 @@
 
 /*
 <testinfo>
-test_generator="gens/core-generator -a \"--gpus=0\""
+test_generator="gens/core-generator -a \"--gpus=0|--gpus=0 --barrier=combining|--gpus=0 --barrier=combining --barrier-fan-in=2\""
 </testinfo>
 */
 
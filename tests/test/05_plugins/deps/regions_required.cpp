@@ -20,7 +20,7 @@
 /*
 <testinfo>
 test_generator=gens/core-generator
-test_deps_plugins=regions,plain,perfect-regions
+test_deps_plugins=regions,plain,sharded,perfect-regions
 test_schedule=bf
 </testinfo>
 */
@@ -68,7 +68,7 @@ void main_loop( void *args )
    
    // So... was everything ok? If we're using regions, that's good
    // Otherwise, it's an error)
-   if( sys.getDefaultDependenciesManager() == "plain" )
+   if( sys.getDefaultDependenciesManager() == "plain" || sys.getDefaultDependenciesManager() == "sharded" )
       check = !check;
 
 }
@@ -0,0 +1,196 @@
+/*************************************************************************************/
+/*      Copyright 2015 Barcelona Supercomputing Center                               */
+/*                                                                                   */
+/*      This file is part of the NANOS++ library.                                    */
+/*                                                                                   */
+/*      NANOS++ is free software: you can redistribute it and/or modify              */
+/*      it under the terms of the GNU Lesser General Public License as published by  */
+/*      the Free Software Foundation, either version 3 of the License, or            */
+/*      (at your option) any later version.                                          */
+/*                                                                                   */
+/*      NANOS++ is distributed in the hope that it will be useful,                   */
+/*      but WITHOUT ANY WARRANTY; without even the implied warranty of               */
+/*      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                */
+/*      GNU Lesser General Public License for more details.                          */
+/*                                                                                   */
+/*      You should have received a copy of the GNU Lesser General Public License     */
+/*      along with NANOS++.  If not, see <http://www.gnu.org/licenses/>.             */
+/*************************************************************************************/
+
+/*
+<testinfo>
+test_generator=gens/core-generator
+test_generator_ENV=( "NX_TEST_SCHEDULE=hbf" )
+test_exec_command="timeout 1m"
+</testinfo>
+*/
+
+#include "config.hpp"
+#include <iostream>
+#include <string>
+#include <algorithm>
+#include "smpprocessor.hpp"
+#include "system.hpp"
+#include <stdlib.h>
+#include <string.h>
+
+using namespace std;
+
+using namespace nanos;
+using namespace nanos::ext;
+
+#define NUM_PARENTS     64
+#define NUM_CHILDREN    16
+#define MAX_CHAINS      256
+#define CHAIN_LENGTH    200
+#define NUM_ORDERED     100
+
+struct Chain {
+   unsigned int   _step;
+   unsigned int   _socket;      //!< Where the last link ran
+};
+
+Chain chains[MAX_CHAINS];
+WD *chains_wg;
+
+Atomic<int> executed( 0 );
+Atomic<int> links( 0 );
+Atomic<int> migrations( 0 );
+Atomic<int> started( 0 );
+
+int ids[NUM_ORDERED];
+int start_order[NUM_ORDERED];
+
+// Socket of the CPU the policy sees 'thread' on
+static unsigned int thread_socket ( BaseThread *thread )
+{
+   int cpu = thread->getCpuId();
+   unsigned int core, cache, socket;
+   sys._hwloc.getCpuLocation( cpu < 0 ? 0 : (unsigned int) cpu, core, cache, socket );
+   return socket;
+}
+
+void child ( void *args );
+void child ( void *args )
+{
+   executed++;
+}
+
+// Children are queued in the cache queue of their parent, and taken from there by other threads
+void parent ( void *args );
+void parent ( void *args )
+{
+   WD *wg = getMyThreadSafe()->getCurrentWD();
+
+   for ( int i = 0; i < NUM_CHILDREN; i++ ) {
+      WD *wd = new WD( new SMPDD( child ) );
+      wg->addWork( *wd );
+      sys.submit( *wd );
+   }
+   wg->waitCompletion();
+   executed++;
+}
+
+// Every link of a chain submits the next one and counts whether it runs on another socket
+void chain_link ( void *args );
+void chain_link ( void *args )
+{
+   Chain *chain = ( Chain * ) args;
+   unsigned int socket = thread_socket( getMyThreadSafe() );
+
+   if ( chain->_step > 0 && chain->_socket != socket ) migrations++;
+   links++;
+
+   chain->_socket = socket;
+   if ( ++chain->_step < CHAIN_LENGTH ) {
+      WD *wd = new WD( new SMPDD( chain_link ), sizeof( Chain ), __alignof__( Chain ), chain );
+      chains_wg->addWork( *wd );
+      sys.submit( *wd );
+   }
+}
+
+// Records the position in which every task started
+void ordered ( void *args );
+void ordered ( void *args )
+{
+   start_order[started++] = *( int * ) args;
+}
+
+int main ( int argc, char **argv )
+{
+   // The policy is selected by the generator (NX_TEST_SCHEDULE)
+   const char *args = getenv( "NX_ARGS" );
+   bool hbf = args != NULL && strstr( args, "--schedule=hbf" ) != NULL;
+
+   std::string policy = getMyThreadSafe()->getTeam()->getSchedulePolicy().getName();
+   if ( hbf && policy != "Hierarchical Breadth First" ) {
+      cerr << argv[0] << ": unsuccessful (policy " << policy << ")" << endl;
+      return -1;
+   }
+
+   WD *wg = getMyThreadSafe()->getCurrentWD();
+
+   // Tasks queued at the same level start in submission order
+   for ( int i = 0; i < NUM_ORDERED; i++ ) {
+      ids[i] = i;
+      WD *wd = new WD( new SMPDD( ordered ), sizeof( int ), __alignof__( int ), &ids[i] );
+      wg->addWork( *wd );
+      sys.submit( *wd );
+   }
+   wg->waitCompletion();
+
+   // Only a single thread dequeuing makes the start order deterministic
+   if ( hbf && sys.getNumThreads() == 1 ) {
+      for ( int i = 0; i < NUM_ORDERED; i++ ) {
+         if ( start_order[i] != i ) {
+            cerr << argv[0] << ": unsuccessful (task " << start_order[i] << " started in position " << i << ")" << endl;
+            return -1;
+         }
+      }
+   }
+
+   for ( int i = 0; i < NUM_PARENTS; i++ ) {
+      WD *wd = new WD( new SMPDD( parent ) );
+      wg->addWork( *wd );
+      sys.submit( *wd );
+   }
+   wg->waitCompletion();
+
+   if ( executed.value() != NUM_PARENTS * ( NUM_CHILDREN + 1 ) ) {
+      cerr << argv[0] << ": unsuccessful (" << executed.value() << " tasks)" << endl;
+      return -1;
+   }
+
+   // With two chains per thread work is plentiful everywhere: once a chain has been stolen by
+   // a socket, its following links are queued and run there
+   int num_chains = std::min( 2 * sys.getNumThreads(), MAX_CHAINS );
+   chains_wg = wg;
+   for ( int i = 0; i < num_chains; i++ ) {
+      WD *wd = new WD( new SMPDD( chain_link ), sizeof( Chain ), __alignof__( Chain ), &chains[i] );
+      wg->addWork( *wd );
+      sys.submit( *wd );
+   }
+   wg->waitCompletion();
+
+   if ( links.value() != num_chains * CHAIN_LENGTH ) {
+      cerr << argv[0] << ": unsuccessful (" << links.value() << " links)" << endl;
+      return -1;
+   }
+
+   // Locality can only be checked when the threads are bound, not oversubscribed and
+   // spread over more than one socket (it means nothing otherwise)
+   bool multi_socket = false;
+   for ( int i = 1; i < sys.getNumWorkers() && !multi_socket; i++ ) {
+      multi_socket = thread_socket( sys.getWorker( i ) ) != thread_socket( sys.getWorker( 0 ) );
+   }
+   bool check_locality = hbf && multi_socket && sys.getSMPPlugin()->getBinding() &&
+                         sys.getNumThreads() <= sys.getSMPPlugin()->getCpuCount();
+
+   if ( check_locality && migrations.value() > links.value() / 10 ) {
+      cerr << argv[0] << ": unsuccessful (" << migrations.value() << " of " << links.value() << " links changed socket)" << endl;
+      return -1;
+   }
+
+   cerr << argv[0] << ": successful" << endl;
+   return 0;
+}
@@ -0,0 +1,159 @@
+/*************************************************************************************/
+/*      Copyright 2015 Barcelona Supercomputing Center                               */
+/*                                                                                   */
+/*      This file is part of the NANOS++ library.                                    */
+/*                                                                                   */
+/*      NANOS++ is free software: you can redistribute it and/or modify              */
+/*      it under the terms of the GNU Lesser General Public License as published by  */
+/*      the Free Software Foundation, either version 3 of the License, or            */
+/*      (at your option) any later version.                                          */
+/*                                                                                   */
+/*      NANOS++ is distributed in the hope that it will be useful,                   */
+/*      but WITHOUT ANY WARRANTY; without even the implied warranty of               */
+/*      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                */
+/*      GNU Lesser General Public License for more details.                          */
+/*                                                                                   */
+/*      You should have received a copy of the GNU Lesser General Public License     */
+/*      along with NANOS++.  If not, see <http://www.gnu.org/licenses/>.             */
+/*************************************************************************************/
+
+/*
+<testinfo>
+test_generator=gens/core-generator
+test_generator_ENV=( "NX_TEST_SCHEDULE=versioning" )
+test_exec_command="timeout 2m"
+</testinfo>
+*/
+
+#include <iostream>
+#include <string>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include <nanos.h>
+
+using namespace std;
+
+#define NUM_TASKS    32
+#define SLOW_TIME    2000     // us
+
+struct task_args {
+   int   value;
+};
+
+int fast_runs = 0;
+int slow_runs = 0;
+
+// Both versions are run by the single worker, so the counters need no atomics
+void fast_version ( void *args );
+void fast_version ( void *args )
+{
+   ( ( task_args * ) args )->value++;
+   fast_runs++;
+}
+
+void slow_version ( void *args );
+void slow_version ( void *args )
+{
+   usleep( SLOW_TIME );
+   ( ( task_args * ) args )->value++;
+   slow_runs++;
+}
+
+struct nanos_const_wd_definition_2
+{
+   nanos_const_wd_definition_t base;
+   nanos_device_t devices[2];
+};
+
+nanos_smp_args_t fast_args = { fast_version };
+nanos_smp_args_t slow_args = { slow_version };
+
+// The description identifies the task in the database
+struct nanos_const_wd_definition_2 task_data =
+{
+   {
+      { /* mandatory_creation */ true, /* tied */ false, 0, 0, 0, 0, 0, 0 },
+      __alignof__( task_args ), 0, 2, 0, "versioning_db_task"
+   },
+   {
+      { nanos_smp_factory, &fast_args },
+      { nanos_smp_factory, &slow_args }
+   }
+};
+
+// Child run: returns how many times the slow version was run
+static int run_tasks ( void )
+{
+   nanos_wd_dyn_props_t dyn_props;
+   dyn_props.tie_to = 0;
+   dyn_props.priority = 0;
+   dyn_props.flags.is_final = 0;
+
+   for ( int i = 0; i < NUM_TASKS; i++ ) {
+      nanos_wd_t wd = NULL;
+      task_args *args = NULL;
+      NANOS_SAFE( nanos_create_wd_compact( &wd, &task_data.base, &dyn_props, sizeof( task_args ),
+                                           ( void ** ) &args, nanos_current_wd(), NULL, NULL ) );
+      args->value = i;
+      NANOS_SAFE( nanos_submit( wd, 0, NULL, NULL ) );
+   }
+   NANOS_SAFE( nanos_wg_wait_completion( nanos_current_wd(), false ) );
+
+   if ( fast_runs + slow_runs != NUM_TASKS ) return 255;
+   return slow_runs < 254 ? slow_runs : 254;
+}
+
+// Runs this same program with the database, returns the child run result (-1 on failure)
+static int run_child ( const char *self, const char *db, const char *nx_args )
+{
+   string args = string( nx_args != NULL ? nx_args : "" ) + " --smp-workers=1 --versioning-db=" + db;
+   setenv( "NX_ARGS", args.c_str(), 1 );
+   setenv( "VERSIONING_DB_CHILD", "1", 1 );
+
+   int status = system( self );
+   if ( status == -1 || !WIFEXITED( status ) || WEXITSTATUS( status ) == 255 ) return -1;
+   return WEXITSTATUS( status );
+}
+
+int main ( int argc, char **argv )
+{
+   if ( getenv( "VERSIONING_DB_CHILD" ) != NULL ) return run_tasks();
+
+   char db[64];
+   snprintf( db, sizeof( db ), "versioning_db_%d.sqlite", ( int ) getpid() );
+   unlink( db );
+
+   const char *nx_args = getenv( "NX_ARGS" );
+   string saved_args = nx_args != NULL ? nx_args : "";
+
+   // First run: nothing stored, every version is explored
+   int first = run_child( argv[0], db, saved_args.c_str() );
+   if ( first < 0 ) {
+      cerr << argv[0] << ": unsuccessful (first run failed)" << endl;
+      unlink( db );
+      return -1;
+   }
+   if ( access( db, R_OK ) != 0 ) {
+      // Without SQLite3 support the option is ignored
+      cerr << argv[0] << ": successful (no versioning database support)" << endl;
+      return 0;
+   }
+   if ( first == 0 ) {
+      cerr << argv[0] << ": unsuccessful (the slow version was not explored)" << endl;
+      unlink( db );
+      return -1;
+   }
+
+   // Second run: the records written at the end of the first one skip the exploration
+   int second = run_child( argv[0], db, saved_args.c_str() );
+   unlink( db );
+   if ( second != 0 ) {
+      cerr << argv[0] << ": unsuccessful (slow version run " << second << " times with stored records)" << endl;
+      return -1;
+   }
+
+   cerr << argv[0] << ": successful" << endl;
+   return 0;
+}
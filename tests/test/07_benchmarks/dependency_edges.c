@@ -0,0 +1,103 @@
+/*************************************************************************************/
+/*      Copyright 2015 Barcelona Supercomputing Center                               */
+/*                                                                                   */
+/*      This file is part of the NANOS++ library.                                    */
+/*                                                                                   */
+/*      NANOS++ is free software: you can redistribute it and/or modify              */
+/*      it under the terms of the GNU Lesser General Public License as published by  */
+/*      the Free Software Foundation, either version 3 of the License, or            */
+/*      (at your option) any later version.                                          */
+/*                                                                                   */
+/*      NANOS++ is distributed in the hope that it will be useful,                   */
+/*      but WITHOUT ANY WARRANTY; without even the implied warranty of               */
+/*      MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the                */
+/*      GNU Lesser General Public License for more details.                          */
+/*                                                                                   */
+/*      You should have received a copy of the GNU Lesser General Public License     */
+/*      along with NANOS++.  If not, see <http://www.gnu.org/licenses/>.             */
+/*************************************************************************************/
+
+#include "common.h"
+
+/*
+<testinfo>
+test_mode=performance
+test_generator=gens/mcc-openmp-generator
+</testinfo>
+*/
+
+// TEST: Dependency Graph Build and Release Cost (per edge) ***************************************
+// A writer, TEST_NEDGES readers of its output and a second writer are submitted over the same
+// address: TEST_NEDGES edges fan out from the first writer and TEST_NEDGES fan in to the second one.
+// The first writer does not finish until the graph is built, so every edge is actually created.
+// The fan-out is wide enough for any per-edge cost growing with the number of edges to show up
+// when the graph is released.
+#define TEST_NEDGES 4096
+
+typedef struct _nx_data_env_1_t_tag { } _nx_data_env_1_t;
+
+static volatile int graph_built = 0;
+static int dep;
+
+static void _smp__ol_test_dependency_edges_1(_nx_data_env_1_t *const __restrict__ _args) { while ( !graph_built ) usleep(1); }
+static void _smp__ol_test_dependency_edges_2(_nx_data_env_1_t *const __restrict__ _args) { }
+
+static void submit_task ( void (*outline)(_nx_data_env_1_t *), bool input, bool output )
+{
+   nanos_smp_args_t smp_args = {(void (*)(void *)) outline};
+   _nx_data_env_1_t *ol_args = (_nx_data_env_1_t *) 0;
+   nanos_wd_t wd = (nanos_wd_t) 0;
+   struct nanos_const_wd_definition_local_t { nanos_const_wd_definition_t base; nanos_device_t devices[1];
+   };
+   struct nanos_const_wd_definition_local_t _const_def = {
+      { { 1, 0, 0, 0, 0, 0, 0, 0 }, __alignof__(_nx_data_env_1_t), 0, 1, 0, NULL }, {{ nanos_smp_factory, &smp_args }}
+   };
+   nanos_wd_dyn_props_t dyn_props = {0};
+   nanos_region_dimension_t dimensions[1] = {{sizeof(int), 0, sizeof(int)}};
+   nanos_data_access_t data_accesses[1] = {{&dep, {input, output, 0, 0, 0}, 1, dimensions, 0}};
+   nanos_err_t err;
+
+   err = nanos_create_wd_compact(&wd, &_const_def.base, &dyn_props, sizeof(_nx_data_env_1_t),
+                                 (void **) &ol_args, nanos_current_wd(), (nanos_copy_data_t **) 0, NULL
+         );
+   if (err != NANOS_OK) nanos_handle_error(err);
+
+   err = nanos_submit(wd, 1, data_accesses, (nanos_team_t) 0);
+   if (err != NANOS_OK) nanos_handle_error(err);
+}
+
+void test_dependency_edges ( stats_t *build, stats_t *release )
+{
+   int i, j;
+   double build_times[TEST_NSAMPLES], release_times[TEST_NSAMPLES];
+   for ( i = 0; i < TEST_NSAMPLES; i++ ) {
+      graph_built = 0;
+      submit_task( _smp__ol_test_dependency_edges_1, false, true );
+
+      build_times[i] = GET_TIME;
+      for ( j = 0; j < TEST_NEDGES; j++ ) submit_task( _smp__ol_test_dependency_edges_2, true, false );
+      submit_task( _smp__ol_test_dependency_edges_2, false, true );
+      build_times[i] = ( GET_TIME - build_times[i] ) / ( 2 * TEST_NEDGES );
+
+      release_times[i] = GET_TIME;
+      graph_built = 1;
+      nanos_wg_wait_completion( nanos_current_wd(), false );
+      release_times[i] = ( GET_TIME - release_times[i] ) / ( 2 * TEST_NEDGES );
+   }
+   stats( build, build_times, TEST_NSAMPLES);
+   stats( release, release_times, TEST_NSAMPLES);
+}
+
+int main ( int argc, char *argv[] )
+{
+   stats_t build, release;
+
+   test_dependency_edges( &build, &release );
+   print_stats ( "Dependency edge build cost","warm-up", &build );
+   print_stats ( "Dependency edge release cost","warm-up", &release );
+   test_dependency_edges( &build, &release );
+   print_stats ( "Dependency edge build cost","test", &build );
+   print_stats ( "Dependency edge release cost","test", &release );
+
+   return 0;
+}